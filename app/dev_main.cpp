@@ -37,19 +37,9 @@ int main(int argc, char** argv) {
             continue;
         }
 
-        // Match returns many lines, other commands return a single line
-        if (std::holds_alternative<MatchRequest>(*parsed)) {
-            const auto outs = dispatcher.dispatchMatch(*parsed);
-            for (const auto& s : outs) {
-                if (!s.empty())
-                    std::cout << s << "\n";
-            }
-        } else {
-            const std::string out = dispatcher.dispatch(*parsed);
-            if (!out.empty()) {
-                std::cout << out << "\n";
-            }
-        }
+        dispatcher.advanceClock(timestampOf(*parsed), std::cout);
+
+        dispatcher.dispatchTo(*parsed, std::cout);
 
         book.dump(std::cout);
     }
@@ -0,0 +1,147 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "workload/order_flow.hpp"
+
+namespace {
+
+struct GenOptions {
+    std::uint64_t lines{1'000'000};
+    std::string outputPath{};  // empty => stdout
+    workload::OrderFlowConfig flow{};
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+              << "  -n, --lines N            commands to generate (default 1000000)\n"
+              << "  -o, --output FILE        write into FILE instead of stdout\n"
+              << "  --seed S                 random seed (default 1)\n"
+              << "  --symbols K              symbol universe size (default 100)\n"
+              << "  --zipf S                 popularity skew, 0 = uniform (default 1.0)\n"
+              << "  --mix N,A,X              new/amend/cancel percent, rest is match (default 55,20,23)\n"
+              << "  --match-symbol-pct P     share of M commands naming a symbol (default 50)\n"
+              << "  --query-pct P            Q commands, taken from the match share (default 0)\n"
+              << "  --types M,I              market/IOC percent of new orders, rest is limit (default 3,10)\n"
+              << "  --start-price P          initial mid in cents (default 10000)\n"
+              << "  --tick T                 tick size in cents (default 1)\n"
+              << "  --walk-pct P             chance of a one-tick mid move per command (default 20)\n"
+              << "  --spread H               half spread in ticks (default 2)\n"
+              << "  --depth-ticks D          passive quotes spread over D ticks behind the touch (default 20)\n"
+              << "  --cross-pct P            limit/IOC orders priced through the mid (default 5)\n"
+              << "  --depth-target N         resting orders per symbol (default 200)\n"
+              << "  --qty MIN,MAX            order quantity range (default 1,500)\n";
+}
+
+// "a,b" or "a,b,c" -> unsigned values; false on anything else.
+bool parseList(const char* text, std::uint64_t* values, int count) {
+    char* end = nullptr;
+    for (int i = 0; i < count; ++i) {
+        values[i] = std::strtoull(text, &end, 10);
+        if (end == text)
+            return false;
+        if (i + 1 < count) {
+            if (*end != ',')
+                return false;
+            text = end + 1;
+        }
+    }
+    return *end == '\0';
+}
+
+bool parseArgs(int argc, char** argv, GenOptions& opts) {
+    auto& flow = opts.flow;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg.size() < 2 || arg[0] != '-' || !v)
+            return false;
+        ++i;
+
+        std::uint64_t list[3]{};
+        if (arg == "-n" || arg == "--lines") {
+            opts.lines = std::strtoull(v, nullptr, 10);
+        } else if (arg == "-o" || arg == "--output") {
+            opts.outputPath = v;
+        } else if (arg == "--seed") {
+            flow.seed = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--symbols") {
+            flow.symbols = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--zipf") {
+            flow.zipfSkew = std::strtod(v, nullptr);
+        } else if (arg == "--mix") {
+            if (!parseList(v, list, 3) || list[0] + list[1] + list[2] > 100)
+                return false;
+            flow.newPct = static_cast<std::uint32_t>(list[0]);
+            flow.amendPct = static_cast<std::uint32_t>(list[1]);
+            flow.cancelPct = static_cast<std::uint32_t>(list[2]);
+        } else if (arg == "--query-pct") {
+            flow.queryPct = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--match-symbol-pct") {
+            flow.matchSymbolPct = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--types") {
+            if (!parseList(v, list, 2) || list[0] + list[1] > 100)
+                return false;
+            flow.marketPct = static_cast<std::uint32_t>(list[0]);
+            flow.iocPct = static_cast<std::uint32_t>(list[1]);
+        } else if (arg == "--start-price") {
+            flow.startPrice = std::strtoll(v, nullptr, 10);
+        } else if (arg == "--tick") {
+            flow.tick = std::strtoll(v, nullptr, 10);
+        } else if (arg == "--walk-pct") {
+            flow.walkPct = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--spread") {
+            flow.halfSpread = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--depth-ticks") {
+            flow.depthTicks = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--cross-pct") {
+            flow.crossPct = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--depth-target") {
+            flow.depthTarget = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--qty") {
+            if (!parseList(v, list, 2) || list[0] == 0 || list[0] > list[1] || list[1] > 1'000'000'000)
+                return false;
+            flow.minQty = static_cast<int>(list[0]);
+            flow.maxQty = static_cast<int>(list[1]);
+        } else {
+            return false;
+        }
+    }
+    return flow.symbols > 0 && flow.newPct + flow.amendPct + flow.cancelPct + flow.queryPct <= 100;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    GenOptions opts;
+    if (!parseArgs(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::FILE* out = stdout;
+    if (!opts.outputPath.empty()) {
+        out = std::fopen(opts.outputPath.c_str(), "wb");
+        if (!out) {
+            std::cerr << "Cannot open file: " << opts.outputPath << "\n";
+            return 1;
+        }
+    }
+
+    workload::OrderFlowGenerator gen(opts.flow);
+    const bool ok = gen.write(out, opts.lines);
+    if (out != stdout)
+        std::fclose(out);
+    if (!ok) {
+        std::cerr << "[gen_orders] write failed\n";
+        return 1;
+    }
+
+    const auto& st = gen.stats();
+    std::cerr << "[gen_orders] lines=" << st.lines << " new=" << st.news << " amend=" << st.amends
+              << " cancel=" << st.cancels << " match=" << st.matches
+              << " query=" << st.queries << "\n";
+    return 0;
+}
@@ -1,6 +1,551 @@
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
 
-int main() {
-    std::cout << "app running\n";
+#include "book/arena.hpp"
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "engine/response_writer.hpp"
+#include "engine/warmup.hpp"
+#include "marketdata/l2_codec.hpp"
+#include "marketdata/l2_feed.hpp"
+#include "marketdata/top_of_book.hpp"
+#include "marketdata/trade_stats.hpp"
+#include "metrics/perf_counters.hpp"
+#include "metrics/trace.hpp"
+#include "parser/chunked_parser.hpp"
+#include "parser/commands_parser.hpp"
+#include "persistence/journal.hpp"
+#include "persistence/recovery.hpp"
+#include "persistence/snapshot.hpp"
+#include "risk/risk_checker.hpp"
+
+namespace {
+
+struct AppOptions {
+    std::string inputPath{};  // empty => stdin
+    std::string journalDir{};  // empty => no journal
+    persistence::JournalOptions journal{};
+    std::string snapshotDir{};  // empty => no snapshots
+    std::uint64_t snapshotEvery{0};  // journal records between snapshots, 0 => only at exit
+    bool latencyReport{false};
+    std::uint32_t latencySampleEvery{1};
+    std::string tracePath{};  // empty => no stage tracing
+    std::uint32_t traceSampleEvery{1000};
+    std::size_t traceEvents{1u << 20};
+    bool perfCounters{false};
+    std::string l2Path{};  // empty => no market-data feed
+    std::uint64_t l2SnapshotEvery{0};
+    std::string topShmName{};  // empty => no conflated top of book
+    std::uint32_t topSymbols{4096};
+    std::string tradeStatsPath{};  // empty => no trade statistics
+    std::string tradeBarsPath{};
+    std::int64_t barWidth{0};
+    std::string riskPath{};  // empty => no pre-trade risk checks
+    ArenaOptions arena{};
+    bool arenaReport{false};
+    std::size_t parseThreads{0};  // 0 => parse on the main thread
+    std::size_t parseChunkBytes{1u << 20};
+    bool deferredOutput{false};  // format and write responses on a separate thread
+    std::string universePath{};  // empty => no warm-up
+    std::uint64_t warmupCommands{0};
+};
+
+volatile std::sig_atomic_t g_latencyDumpRequested = 0;
+
+void onLatencyDumpSignal(int) {
+    g_latencyDumpRequested = 1;
+}
+
+volatile std::sig_atomic_t g_riskReloadRequested = 0;
+
+void onRiskReloadSignal(int) {
+    g_riskReloadRequested = 1;
+}
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options] [commands-file]\n"
+              << "  --journal DIR            journal accepted commands into DIR, recover from it on start\n"
+              << "  --fsync-batch N          fsync after N pending records (default 512)\n"
+              << "  --fsync-interval-us U    ... or after U microseconds (default 2000)\n"
+              << "  --segment-mb M           rotate journal segments at M MiB (default 64)\n"
+              << "  --no-fsync               write the journal without fsync\n"
+              << "  --snapshot-dir DIR       warm start from the newest snapshot in DIR, write one at exit\n"
+              << "  --snapshot-every N       also snapshot every N journal records\n"
+              << "  --latency-report         print per-command latency histograms at exit\n"
+              << "                           (SIGUSR1 prints them at any time)\n"
+              << "  --latency-sample N       time only every N-th command (default 1)\n"
+              << "  --trace FILE             write per-stage timings of sampled commands as Chrome trace JSON\n"
+              << "  --trace-sample N         trace 1 in N commands (default 1000)\n"
+              << "  --trace-events N         keep the newest N stage events (default 1048576)\n"
+              << "  --perf                   hardware counters per command type (parse + dispatch), printed at exit\n"
+              << "  --l2-out FILE            write the binary L2 delta / snapshot feed to FILE\n"
+              << "  --l2-snapshot-every N    also snapshot a symbol every N of its deltas\n"
+              << "  --top-shm NAME           conflated best bid/ask per symbol in POSIX shm segment NAME\n"
+              << "  --top-symbols N          symbol slots in that segment (default 4096)\n"
+              << "  --trade-stats FILE       per-symbol session OHLC / volume / VWAP as CSV at exit\n"
+              << "  --trade-bars FILE        ... and per time bucket, buckets of --bar-width W timestamp units\n"
+              << "  --risk FILE              pre-trade limits per symbol (reject 305); SIGHUP reloads FILE\n"
+              << "  --huge-pages MODE        book memory on off | thp | explicit 2 MiB pages (default thp;\n"
+              << "                           explicit falls back to thp without a reserved pool)\n"
+              << "  --prefault-mb M          touch M MiB of book memory at startup\n"
+              << "  --arena-report           print book memory usage at exit\n"
+              << "  --parse-threads N        parse the commands file on N threads ahead of the engine (default 0)\n"
+              << "  --parse-chunk-kb K       ... in newline-aligned chunks of K KiB (default 1024)\n"
+              << "  --deferred-output        format and write responses on a separate thread\n"
+              << "  --universe FILE          size the book for the symbols / expected orders in FILE at startup\n"
+              << "  --warmup N               ... and run N synthetic commands through it first (discarded)\n";
+}
+
+bool parseArgs(int argc, char** argv, AppOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto value = [&]() -> const char* {
+            return (i + 1 < argc) ? argv[++i] : nullptr;
+        };
+
+        if (arg == "--journal") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.journalDir = v;
+        } else if (arg == "--fsync-batch") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.journal.fsyncBatchRecords = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--fsync-interval-us") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.journal.fsyncIntervalMicros = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--segment-mb") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.journal.segmentBytes = std::strtoull(v, nullptr, 10) * 1024 * 1024;
+        } else if (arg == "--snapshot-dir") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.snapshotDir = v;
+        } else if (arg == "--snapshot-every") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.snapshotEvery = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--latency-sample") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.latencySampleEvery = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--trace") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.tracePath = v;
+        } else if (arg == "--trace-sample") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.traceSampleEvery = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--trace-events") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.traceEvents = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--l2-out") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.l2Path = v;
+        } else if (arg == "--l2-snapshot-every") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.l2SnapshotEvery = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--top-shm") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.topShmName = v;
+        } else if (arg == "--top-symbols") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.topSymbols = static_cast<std::uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--trade-stats") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.tradeStatsPath = v;
+        } else if (arg == "--trade-bars") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.tradeBarsPath = v;
+        } else if (arg == "--bar-width") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.barWidth = std::strtoll(v, nullptr, 10);
+        } else if (arg == "--risk") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.riskPath = v;
+        } else if (arg == "--huge-pages") {
+            const char* v = value();
+            if (!v)
+                return false;
+            const std::string_view mode = v;
+            if (mode == "off")
+                opts.arena.hugePages = HugePageMode::Off;
+            else if (mode == "thp")
+                opts.arena.hugePages = HugePageMode::Transparent;
+            else if (mode == "explicit")
+                opts.arena.hugePages = HugePageMode::Explicit;
+            else
+                return false;
+        } else if (arg == "--prefault-mb") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.arena.prefaultBytes = std::strtoull(v, nullptr, 10) * 1024 * 1024;
+        } else if (arg == "--parse-threads") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.parseThreads = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--parse-chunk-kb") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.parseChunkBytes = std::strtoull(v, nullptr, 10) * 1024;
+        } else if (arg == "--universe") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.universePath = v;
+        } else if (arg == "--warmup") {
+            const char* v = value();
+            if (!v)
+                return false;
+            opts.warmupCommands = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--deferred-output") {
+            opts.deferredOutput = true;
+        } else if (arg == "--arena-report") {
+            opts.arenaReport = true;
+        } else if (arg == "--perf") {
+            opts.perfCounters = true;
+        } else if (arg == "--latency-report") {
+            opts.latencyReport = true;
+        } else if (arg == "--no-fsync") {
+            opts.journal.fsyncEnabled = false;
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            opts.inputPath = arg;
+        }
+    }
+    return true;
+}
+
+// Snapshot covering everything journaled so far; older journal segments become redundant.
+void takeSnapshot(const OrderBook& book, const AppOptions& opts, persistence::JournalWriter* journal) {
+    const std::uint64_t seq = journal ? journal->lastSeq() : 0;
+    if (!persistence::saveSnapshot(book, opts.snapshotDir, seq)) {
+        std::cerr << "[snapshot] failed to write into " << opts.snapshotDir << "\n";
+        return;
+    }
+    persistence::pruneSnapshots(opts.snapshotDir, 2);
+    if (journal)
+        persistence::pruneJournal(opts.journalDir, seq);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    AppOptions opts;
+    if (!parseArgs(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (!opts.tradeBarsPath.empty() && opts.barWidth <= 0) {
+        std::cerr << "--trade-bars needs --bar-width > 0\n";
+        return 2;
+    }
+
+    // before the first book allocation
+    configureBookArena(opts.arena);
+
+    OrderBook book;
+
+    // on the empty book, before recovery fills it and before anything is attached
+    if (!opts.universePath.empty() || opts.warmupCommands > 0) {
+        Universe universe;
+        if (!opts.universePath.empty()) {
+            std::string error;
+            auto loaded = loadUniverse(opts.universePath, error);
+            if (!loaded) {
+                std::cerr << "[warmup] " << error << "\n";
+                return 1;
+            }
+            universe = std::move(*loaded);
+        }
+        const WarmupResult warm = warmUp(book, universe, opts.warmupCommands);
+        std::cerr << "[warmup] symbols=" << warm.symbols << ", reserved orders=" << warm.reservedOrders
+                  << ", synthetic commands=" << warm.syntheticCommands << ", took " << warm.millis << " ms\n";
+    }
+
+    CommandDispatcher dispatcher(book);
+    dispatcher.setLatencySampling(opts.latencySampleEvery);
+
+    // recovery replays through its own dispatcher: the statistics cover this run only
+    std::unique_ptr<marketdata::TradeStats> tradeStats;
+    if (!opts.tradeStatsPath.empty() || !opts.tradeBarsPath.empty()) {
+        tradeStats = std::make_unique<marketdata::TradeStats>(opts.tradeBarsPath.empty() ? 0 : opts.barWidth);
+        dispatcher.attachTradeStats(tradeStats.get());
+    }
+
+    std::unique_ptr<persistence::JournalWriter> journal;
+    if (!opts.journalDir.empty() || !opts.snapshotDir.empty()) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto recovered = persistence::recoverBook(book, opts.snapshotDir, opts.journalDir);
+        const auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::cerr << "[recovery] snapshot seq=";
+        if (recovered.snapshotSeq)
+            std::cerr << *recovered.snapshotSeq;
+        else
+            std::cerr << "none";
+        std::cerr << ", journal records=" << recovered.journal.replayed << ", last seq=" << recovered.lastSeq()
+                  << ", live orders=" << book.liveCount() << ", took " << ms << " ms\n";
+
+        if (!opts.journalDir.empty()) {
+            opts.journal.directory = opts.journalDir;
+            journal = std::make_unique<persistence::JournalWriter>(opts.journal, recovered.lastSeq() + 1);
+            dispatcher.attachJournal(journal.get());
+        }
+        dispatcher.rescheduleExpiries();
+    }
+    std::uint64_t lastSnapshotSeq = journal ? journal->lastSeq() : 0;
+
+    // attached after recovery as well: the journal holds only what passed the checks when it
+    // came in (a B batch journals just its accepted orders), so the replay runs without them
+    std::unique_ptr<risk::RiskChecker> riskChecker;
+    if (!opts.riskPath.empty()) {
+        std::string error;
+        auto config = risk::loadRiskConfig(opts.riskPath, error);
+        if (!config) {
+            std::cerr << "[risk] " << error << "\n";
+            return 1;
+        }
+        riskChecker = std::make_unique<risk::RiskChecker>(std::move(*config));
+        riskChecker->rebuildOpen(book);
+        dispatcher.attachRisk(riskChecker.get());
+    }
+
+    // attached after recovery: the replay is not part of the feed, the first delta of
+    // each symbol brings a snapshot of what was recovered
+    std::ofstream l2File;
+    std::unique_ptr<marketdata::L2StreamSink> l2Sink;
+    std::unique_ptr<marketdata::TopOfBookTable> topTable;
+    std::unique_ptr<marketdata::TopOfBookConflator> top;
+    marketdata::L2FanOut l2Sinks;
+    std::unique_ptr<marketdata::L2Publisher> l2;
+    if (!opts.l2Path.empty()) {
+        l2File.open(opts.l2Path, std::ios::binary | std::ios::trunc);
+        if (!l2File) {
+            std::cerr << "Cannot open file: " << opts.l2Path << "\n";
+            return 1;
+        }
+        l2Sink = std::make_unique<marketdata::L2StreamSink>(l2File);
+        l2Sinks.add(*l2Sink);
+    }
+    if (!opts.topShmName.empty()) {
+        topTable = marketdata::TopOfBookTable::createShared(opts.topShmName, opts.topSymbols);
+        if (!topTable) {
+            std::cerr << "Cannot create shared memory: " << opts.topShmName << "\n";
+            return 1;
+        }
+        top = std::make_unique<marketdata::TopOfBookConflator>(*topTable);
+        l2Sinks.add(*top);
+        dispatcher.attachTopOfBook(top.get());
+    }
+    if (l2Sink || top) {
+        l2 = std::make_unique<marketdata::L2Publisher>(l2Sinks, opts.l2SnapshotEvery);
+        dispatcher.attachMarketData(l2.get());
+    }
+
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (!opts.inputPath.empty()) {
+        file.open(opts.inputPath);
+        if (!file) {
+            std::cerr << "Cannot open file: " << opts.inputPath << "\n";
+            return 1;
+        }
+        in = &file;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::signal(SIGUSR1, onLatencyDumpSignal);
+    if (riskChecker)
+        std::signal(SIGHUP, onRiskReloadSignal);
+    if (!opts.tracePath.empty())
+        metrics::enableStageTracing(opts.traceSampleEvery, opts.traceEvents);
+
+    std::unique_ptr<metrics::PerfCounters> perf;
+    metrics::PerfByType perfByType;
+    if (opts.perfCounters) {
+        perf = std::make_unique<metrics::PerfCounters>();
+        if (!perf->hardwareAvailable())
+            std::cerr << "[perf] hardware counters unavailable: " << perf->unavailableReason() << "\n";
+        perf->start();
+    }
+
+    std::unique_ptr<ResponseWriter> writer;
+    if (opts.deferredOutput)
+        writer = std::make_unique<ResponseWriter>(std::cout);
+
+    // Everything after parsing one command line. perfBegin is read when the command starts,
+    // so it covers the parse only when the parse runs on this thread.
+    auto execute = [&](std::string_view line, const std::optional<ParsedCommand>& parsed,
+                       const metrics::PerfReading& perfBegin) {
+        if (!parsed) {
+            std::cerr << "[parse] ignored: " << line << "\n";
+            return;
+        }
+
+        if (writer) {
+            // same lines as below, formatted and written by the writer thread
+            dispatcher.advanceClock(timestampOf(*parsed), *writer);
+            dispatcher.dispatchDeferred(*parsed, *writer);
+            if (perf)
+                perfByType.add(messageTypeOf(*parsed), perf->read() - perfBegin);
+        } else {
+            // GTT orders due by this command's timestamp leave the book before it runs
+            dispatcher.advanceClock(timestampOf(*parsed), std::cout);
+
+            dispatcher.dispatchTo(*parsed, std::cout);
+            if (perf)
+                perfByType.add(messageTypeOf(*parsed), perf->read() - perfBegin);
+        }
+
+        // between two commands, so every command sees one complete set of limits
+        if (g_riskReloadRequested) {
+            g_riskReloadRequested = 0;
+            std::string error;
+            if (auto config = risk::loadRiskConfig(opts.riskPath, error)) {
+                riskChecker->reload(std::move(*config));
+                std::cerr << "[risk] reloaded " << opts.riskPath << "\n";
+            } else {
+                std::cerr << "[risk] reload failed, keeping the old limits: " << error << "\n";
+            }
+        }
+
+        if (g_latencyDumpRequested) {
+            g_latencyDumpRequested = 0;
+            dispatcher.reportLatency(std::cerr);
+        }
+
+        if (journal && opts.snapshotEvery > 0 && !opts.snapshotDir.empty() &&
+            journal->lastSeq() - lastSnapshotSeq >= opts.snapshotEvery) {
+            takeSnapshot(book, opts, journal.get());
+            lastSnapshotSeq = journal->lastSeq();
+        }
+    };
+    auto isExit = [](std::string_view line) { return line == "exit" || line == "quit"; };
+
+    if (opts.parseThreads > 0 && in == &file) {
+        // file replay: parsed ahead on worker threads, applied here in order
+        ChunkedParser parser(file, ChunkedParserOptions{.threads = opts.parseThreads, .chunkBytes = opts.parseChunkBytes});
+        ParsedChunk chunk;
+        bool stop = false;
+        while (!stop && parser.next(chunk)) {
+            for (std::size_t i = 0; i < chunk.lines.size(); ++i) {
+                if (isExit(chunk.lines[i])) {
+                    stop = true;
+                    break;
+                }
+                HFT_TRACE_MESSAGE();
+                execute(chunk.lines[i], chunk.commands[i], perf ? perf->read() : metrics::PerfReading{});
+            }
+        }
+    } else {
+        std::string line;
+        while (std::getline(*in, line)) {
+            if (line.empty())
+                continue;
+
+            if (isExit(line))
+                break;
+
+            HFT_TRACE_MESSAGE();
+            const metrics::PerfReading perfBegin = perf ? perf->read() : metrics::PerfReading{};
+            execute(line, parseCommandLine(line), perfBegin);
+        }
+    }
+
+    if (writer)
+        writer->close();  // every response is on stdout before the reports
+
+    if (!opts.snapshotDir.empty())
+        takeSnapshot(book, opts, journal.get());
+
+    if (tradeStats) {
+        if (!opts.tradeStatsPath.empty()) {
+            std::ofstream out(opts.tradeStatsPath);
+            tradeStats->writeSessionCsv(out);
+            if (!out)
+                std::cerr << "[stats] failed to write " << opts.tradeStatsPath << "\n";
+        }
+        if (!opts.tradeBarsPath.empty()) {
+            tradeStats->closeBuckets();
+            std::ofstream out(opts.tradeBarsPath);
+            tradeStats->writeBarsCsv(out);
+            if (!out)
+                std::cerr << "[stats] failed to write " << opts.tradeBarsPath << "\n";
+        }
+    }
+
+    if (opts.latencyReport)
+        dispatcher.reportLatency(std::cerr);
+
+    if (perf) {
+        perf->stop();
+        perfByType.report(std::cerr, *perf);
+    }
+
+    if (!opts.tracePath.empty()) {
+        std::ofstream trace(opts.tracePath);
+        metrics::writeChromeTrace(trace);
+        if (!trace)
+            std::cerr << "[trace] failed to write " << opts.tracePath << "\n";
+    }
+
+    if (l2Sink) {
+        l2File.flush();
+        std::cerr << "[l2] deltas=" << l2Sink->deltas() << " snapshots=" << l2Sink->snapshots() << "\n";
+    }
+    if (top) {
+        std::cerr << "[top] writes=" << top->writes() << " symbols=" << topTable->symbolCount()
+                  << " dropped=" << top->dropped() << "\n";
+    }
+
+    if (journal) {
+        journal->flush();
+        const auto st = journal->stats();
+        std::cerr << "[journal] records=" << st.records << " bytes=" << st.bytes << " writes=" << st.writes
+                  << " fsyncs=" << st.fsyncs << " segments=" << st.segments << "\n";
+    }
+    if (opts.arenaReport)
+        bookArena().report(std::cerr);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,9 @@
+#!/usr/bin/env bash
+# Usage: ./bench_launcher.sh [filter-regex] [out.json]
+# Compare two revisions: compare.py benchmarks base.json head.json (ships with Google Benchmark).
+set -e
+
+cmake -S . -B cmake-build-release -G Ninja -DCMAKE_BUILD_TYPE=Release
+ninja -C cmake-build-release benchmark_suite
+./cmake-build-release/benchmark_suite ${1:+--benchmark_filter="$1"} \
+    --benchmark_out="${2:-bench-$(git rev-parse --short HEAD).json}" --benchmark_out_format=json
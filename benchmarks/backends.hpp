@@ -0,0 +1,16 @@
+#pragma once
+
+// Book backends the suite runs against. BENCHMARK_BOOK(BM_X, ->Apply(...)) registers
+// BM_X<Book> once per backend as "BM_X/<backend>", so a run picks one by name:
+//   ./benchmark_suite --benchmark_filter=/indexed/
+// A new backend goes into the macro below and into the explicit instantiations in
+// src/engine/*.cpp.
+
+#include <benchmark/benchmark.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+
+#define BENCHMARK_BOOK(func, ...)                                          \
+    BENCHMARK_TEMPLATE(func, OrderBook)->Name(#func "/map") __VA_ARGS__; \
+    BENCHMARK_TEMPLATE(func, IndexedOrderBook)->Name(#func "/indexed") __VA_ARGS__
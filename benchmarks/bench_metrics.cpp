@@ -0,0 +1,45 @@
+// benchmarks/bench_metrics.cpp
+//
+// Cost of the latency probe that CommandDispatcher wraps around every message:
+// two counter reads plus one histogram record.
+
+#include <benchmark/benchmark.h>
+
+#include "metrics/histogram.hpp"
+#include "metrics/tsc.hpp"
+
+namespace {
+
+void BM_Metrics_ReadTsc(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(metrics::readTsc());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Metrics_ReadTsc);
+
+void BM_Metrics_HistogramRecord(benchmark::State& state) {
+    metrics::LogLinearHistogram h;
+    std::uint64_t v = 12345;
+    for (auto _ : state) {
+        h.record(v);
+        v = v * 6364136223846793005ull + 1442695040888963407ull;
+        v >>= 50;  // spread over the low buckets
+    }
+    benchmark::DoNotOptimize(h.count());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Metrics_HistogramRecord);
+
+void BM_Metrics_Probe(benchmark::State& state) {
+    metrics::LogLinearHistogram h;
+    for (auto _ : state) {
+        const std::uint64_t start = metrics::readTsc();
+        h.record(metrics::readTsc() - start);
+    }
+    benchmark::DoNotOptimize(h.count());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Metrics_Probe);
+
+}  // namespace
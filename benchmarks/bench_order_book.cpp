@@ -0,0 +1,255 @@
+// benchmarks/bench_order_book.cpp
+//
+// Book primitives at several resting-book sizes (state.range(0) orders), once per
+// backend (see backends.hpp).
+// Benchmarks that shrink or grow the book rebuild it with the timer paused once
+// the size drifted by half, so every measured op sees roughly the nominal size.
+
+#include <benchmark/benchmark.h>
+
+#include "backends.hpp"
+#include "book/arena.hpp"
+#include "perf_region.hpp"
+#include "workload.hpp"
+
+#if defined(__GLIBC__)
+#include <malloc.h>  // mallinfo2
+#endif
+
+namespace {
+
+void bookSizes(benchmark::internal::Benchmark* b) {
+    b->Arg(1'000)->Arg(10'000)->Arg(100'000);
+}
+
+template <typename Book>
+void BM_OrderBook_Add(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Book book;
+    bench::fillBook(book, n);
+    int nextId = n + 1;
+    int added = 0;
+    bench::PerfRegion perf;
+
+    for (auto _ : state) {
+        const bool buy = (nextId & 1) != 0;
+        const domain::Price price = buy ? 10000 - 1 - nextId % 100 : 10000 + 1 + nextId % 100;
+        benchmark::DoNotOptimize(book.add(bench::makeOrder(nextId++, buy ? domain::Side::Buy : domain::Side::Sell, price)));
+
+        if (++added == n / 2) {
+            state.PauseTiming();
+            perf.pause();
+            book.clear();
+            bench::fillBook(book, n);
+            nextId = n + 1;
+            added = 0;
+            perf.resume();
+            state.ResumeTiming();
+        }
+    }
+    perf.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_BOOK(BM_OrderBook_Add, ->Apply(bookSizes));
+
+template <typename Book>
+void BM_OrderBook_AddDuplicate(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Book book;
+    bench::fillBook(book, n);
+    const auto dup = bench::makeOrder(n / 2, domain::Side::Buy, 9990);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.add(dup));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_BOOK(BM_OrderBook_AddDuplicate, ->Apply(bookSizes));
+
+template <typename Book>
+void BM_OrderBook_GetById(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Book book;
+    bench::fillBook(book, n);
+    const auto ids = bench::shuffledIds(n);
+    std::size_t i = 0;
+    bench::PerfRegion perf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.getById(ids[i]));
+        if (++i == ids.size())
+            i = 0;
+    }
+    perf.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_BOOK(BM_OrderBook_GetById, ->Apply(bookSizes));
+
+template <typename Book>
+void BM_OrderBook_IsLive(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Book book;
+    bench::fillBook(book, n);
+    const auto ids = bench::shuffledIds(n);
+    std::size_t i = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.isLive(ids[i]));
+        if (++i == ids.size())
+            i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_BOOK(BM_OrderBook_IsLive, ->Apply(bookSizes));
+
+template <typename Book>
+void BM_OrderBook_Erase(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Book book;
+    bench::fillBook(book, n);
+    const auto ids = bench::shuffledIds(n);
+    std::size_t i = 0;
+    bench::PerfRegion perf;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.erase(ids[i]));
+        if (++i == ids.size() / 2) {
+            state.PauseTiming();
+            perf.pause();
+            book.clear();
+            bench::fillBook(book, n);
+            i = 0;
+            perf.resume();
+            state.ResumeTiming();
+        }
+    }
+    perf.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_BOOK(BM_OrderBook_Erase, ->Apply(bookSizes));
+
+// Flattens one symbol (both sides, ~1/8 of the book) per iteration; items = orders removed.
+template <typename Book>
+void BM_OrderBook_CancelSymbol(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const std::string& sym = bench::symbols()[0];
+    Book book;
+    std::size_t removed = 0;
+    bench::PerfRegion perf;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        perf.pause();
+        book.clear();
+        bench::fillBook(book, n);
+        perf.resume();
+        state.ResumeTiming();
+
+        removed += book.cancelSymbol(sym, domain::Side::Buy, [](const domain::Order&) {});
+        removed += book.cancelSymbol(sym, domain::Side::Sell, [](const domain::Order&) {});
+    }
+    perf.report(state, static_cast<std::int64_t>(removed));
+    state.SetItemsProcessed(static_cast<std::int64_t>(removed));
+}
+BENCHMARK_BOOK(BM_OrderBook_CancelSymbol, ->Apply(bookSizes));
+
+// Consumes the whole front order of the best level on one side.
+template <typename Book, bool Buy, bool BySymbol>
+void consumeBest(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Book book;
+    bench::fillBook(book, n);
+    const std::string& sym = bench::symbols()[0];
+    int consumed = 0;
+
+    for (auto _ : state) {
+        domain::Order* front = nullptr;
+        if constexpr (BySymbol) {
+            front = Buy ? book.bestBidOrder(sym) : book.bestAskOrder(sym);
+        } else {
+            front = Buy ? book.bestBidOrder() : book.bestAskOrder();
+        }
+        if constexpr (BySymbol) {
+            Buy ? book.consumeBestBid(front->quantity, sym) : book.consumeBestAsk(front->quantity, sym);
+        } else {
+            Buy ? book.consumeBestBid(front->quantity) : book.consumeBestAsk(front->quantity);
+        }
+
+        // one side holds n/2 orders, ~1/8 of them for `sym`
+        if (++consumed == n / 32) {
+            state.PauseTiming();
+            book.clear();
+            bench::fillBook(book, n);
+            consumed = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+template <typename Book>
+void BM_OrderBook_ConsumeBestBid(benchmark::State& state) {
+    consumeBest<Book, true, false>(state);
+}
+template <typename Book>
+void BM_OrderBook_ConsumeBestAsk(benchmark::State& state) {
+    consumeBest<Book, false, false>(state);
+}
+template <typename Book>
+void BM_OrderBook_ConsumeBestBidBySymbol(benchmark::State& state) {
+    consumeBest<Book, true, true>(state);
+}
+template <typename Book>
+void BM_OrderBook_ConsumeBestAskBySymbol(benchmark::State& state) {
+    consumeBest<Book, false, true>(state);
+}
+BENCHMARK_BOOK(BM_OrderBook_ConsumeBestBid, ->Apply(bookSizes));
+BENCHMARK_BOOK(BM_OrderBook_ConsumeBestAsk, ->Apply(bookSizes));
+BENCHMARK_BOOK(BM_OrderBook_ConsumeBestBidBySymbol, ->Apply(bookSizes));
+BENCHMARK_BOOK(BM_OrderBook_ConsumeBestAskBySymbol, ->Apply(bookSizes));
+
+// malloc heap plus the book arena
+std::size_t heapInUse() {
+    const std::size_t arena = bookArena().stats().usedBytes;
+#if defined(__GLIBC__)
+    return arena + mallinfo2().uordblks;
+#else
+    return arena;  // bytes_per_order leaves out malloc
+#endif
+}
+
+// Full fills of the front order, alternating sides, at 1M resting orders: every
+// iteration walks one step down a FIFO into an order nothing has touched since it was
+// added. bytes_per_order is the memory the filled book holds per order, indexes included.
+// range(1) is the arena's HugePageMode, so thp:0 vs thp:1 shows what 2 MiB pages save in
+// TLB misses (dTLB-miss/item with HFT_BENCH_PERF=1).
+template <typename Book>
+void BM_OrderBook_FillsAt1M(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    if (!configureBookArena(ArenaOptions{.hugePages = static_cast<HugePageMode>(state.range(1))})) {
+        state.SkipWithError("book arena in use");
+        return;
+    }
+    {
+        const std::size_t before = heapInUse();
+        Book book;
+        bench::fillBook(book, n);
+        const std::size_t after = heapInUse();
+        bench::PerfRegion perf;
+        bool buy = true;
+
+        for (auto _ : state) {
+            domain::Order* front = buy ? book.bestBidOrder() : book.bestAskOrder();
+            buy ? book.consumeBestBid(front->quantity) : book.consumeBestAsk(front->quantity);
+            buy = !buy;
+        }
+        perf.report(state, state.iterations());
+        state.SetItemsProcessed(state.iterations());
+        state.counters["bytes_per_order"] = static_cast<double>(after - before) / n;
+        state.counters["huge_regions"] = static_cast<double>(bookArena().stats().hugeRegions);
+    }
+    configureBookArena(ArenaOptions{});
+}
+// half the book, so every fill still sees roughly 1M resting orders' worth of memory
+BENCHMARK_BOOK(BM_OrderBook_FillsAt1M, ->ArgsProduct({{1'000'000}, {0, 1}})->ArgNames({"orders", "thp"})->Iterations(500'000));
+
+}  // namespace
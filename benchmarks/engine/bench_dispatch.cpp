@@ -0,0 +1,322 @@
+// benchmarks/engine/bench_dispatch.cpp
+//
+// End-to-end: text line -> parseCommandLine -> CommandDispatcher -> formatted output,
+// over generated command streams. One iteration replays the whole stream into a fresh book.
+
+#include <benchmark/benchmark.h>
+
+#include "backends.hpp"
+#include "engine/dispatcher.hpp"
+#include "engine/response_writer.hpp"
+#include "marketdata/l2_codec.hpp"
+#include "marketdata/l2_feed.hpp"
+#include "parser/commands_parser.hpp"
+#include "perf_region.hpp"
+#include "risk/risk_checker.hpp"
+#include "workload.hpp"
+
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+
+namespace {
+
+constexpr std::size_t kStreamLength = 50'000;
+
+const std::vector<std::string>& stream(int mixId) {
+    static const std::vector<std::string> streams[] = {
+        bench::generateCommandLines(kStreamLength, bench::WorkloadMix{60, 15, 20}),  // balanced
+        bench::generateCommandLines(kStreamLength, bench::WorkloadMix{90, 5, 4}),    // new-heavy
+        bench::generateCommandLines(kStreamLength, bench::WorkloadMix{45, 10, 44}),  // cancel-heavy
+    };
+    return streams[mixId];
+}
+
+struct DiscardBuf : std::streambuf {
+    std::size_t written{0};  // keeps the formatted output observable
+    int overflow(int c) override {
+        ++written;
+        return c;
+    }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        written += static_cast<std::size_t>(n);
+        return n;
+    }
+};
+
+// Response bytes of one command, written to a discarding stream.
+template <typename Book>
+std::size_t runLine(CommandDispatcher<Book>& dispatcher, const ParsedCommand& cmd) {
+    thread_local DiscardBuf discard;
+    thread_local std::ostream sink(&discard);
+    const std::size_t before = discard.written;
+    dispatcher.dispatchTo(cmd, sink);
+    return discard.written - before;
+}
+
+template <typename Book>
+void BM_Dispatch_ParseAndDispatch(benchmark::State& state) {
+    const auto& lines = stream(static_cast<int>(state.range(0)));
+    std::size_t outputs = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto book = std::make_unique<Book>();
+        CommandDispatcher dispatcher(*book);
+        state.ResumeTiming();
+
+        for (const auto& line : lines) {
+            if (auto cmd = parseCommandLine(line))
+                outputs += runLine(dispatcher, *cmd);
+        }
+
+        state.PauseTiming();
+        book.reset();
+        state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(outputs);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+BENCHMARK_BOOK(BM_Dispatch_ParseAndDispatch, ->ArgName("mix")->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond));
+
+template <typename Book>
+void BM_Dispatch_PreParsed(benchmark::State& state) {
+    const auto& lines = stream(static_cast<int>(state.range(0)));
+    std::vector<ParsedCommand> cmds;
+    cmds.reserve(lines.size());
+    for (const auto& line : lines) {
+        if (auto cmd = parseCommandLine(line))
+            cmds.push_back(std::move(*cmd));
+    }
+    std::size_t outputs = 0;
+    bench::PerfRegion perf;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        perf.pause();
+        auto book = std::make_unique<Book>();
+        CommandDispatcher dispatcher(*book);
+        perf.resume();
+        state.ResumeTiming();
+
+        for (const auto& cmd : cmds) {
+            outputs += runLine(dispatcher, cmd);
+        }
+
+        state.PauseTiming();
+        perf.pause();
+        book.reset();
+        perf.resume();
+        state.ResumeTiming();
+    }
+    perf.report(state, state.iterations() * static_cast<std::int64_t>(cmds.size()));
+    benchmark::DoNotOptimize(outputs);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(cmds.size()));
+}
+BENCHMARK_BOOK(BM_Dispatch_PreParsed, ->ArgName("mix")->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond));
+
+// Pre-parsed balanced mix with the L2 feed detached (0) / encoded into a discarding
+// stream (1): the difference is the whole market-data cost, 0 shows it is off the path.
+template <typename Book>
+void BM_Dispatch_MarketData(benchmark::State& state) {
+    const auto& lines = stream(0);
+    std::vector<ParsedCommand> cmds;
+    for (const auto& line : lines) {
+        if (auto cmd = parseCommandLine(line))
+            cmds.push_back(std::move(*cmd));
+    }
+    DiscardBuf discard;
+    std::ostream os(&discard);
+    marketdata::L2StreamSink sink(os);
+    std::size_t outputs = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto book = std::make_unique<Book>();
+        CommandDispatcher dispatcher(*book);
+        marketdata::L2Publisher publisher(sink, 1000);
+        if (state.range(0) != 0)
+            dispatcher.attachMarketData(&publisher);
+        state.ResumeTiming();
+
+        for (const auto& cmd : cmds) {
+            outputs += runLine(dispatcher, cmd);
+        }
+
+        state.PauseTiming();
+        book.reset();
+        state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(outputs);
+    state.counters["deltas"] = benchmark::Counter(static_cast<double>(sink.deltas()), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(cmds.size()));
+}
+BENCHMARK_BOOK(BM_Dispatch_MarketData, ->ArgName("l2")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond));
+
+// Pre-parsed balanced mix without (0) / with (1) pre-trade risk checks. The limits are
+// set but never hit, so both runs accept the same orders and the difference is the
+// whole cost of the risk stage plus its open-quantity bookkeeping.
+template <typename Book>
+void BM_Dispatch_RiskChecks(benchmark::State& state) {
+    const auto& lines = stream(0);
+    std::vector<ParsedCommand> cmds;
+    for (const auto& line : lines) {
+        if (auto cmd = parseCommandLine(line))
+            cmds.push_back(std::move(*cmd));
+    }
+    risk::RiskConfig config;
+    config.defaults = risk::SymbolLimits{10000, 100000, 1'000'000, 1'000'000'000'000, 1'000'000'000};
+    std::size_t outputs = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto book = std::make_unique<Book>();
+        CommandDispatcher dispatcher(*book);
+        risk::RiskChecker checker(config);
+        if (state.range(0) != 0)
+            dispatcher.attachRisk(&checker);
+        state.ResumeTiming();
+
+        for (const auto& cmd : cmds) {
+            outputs += runLine(dispatcher, cmd);
+        }
+
+        state.PauseTiming();
+        book.reset();
+        state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(outputs);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(cmds.size()));
+}
+BENCHMARK_BOOK(BM_Dispatch_RiskChecks, ->ArgName("risk")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond));
+
+// Cheapest message there is (cancel of an unknown id): compare builds with
+// ENABLE_LATENCY_METRICS ON/OFF to see the per-message probe overhead.
+void BM_Dispatch_CancelReject(benchmark::State& state) {
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+    dispatcher.setLatencySampling(static_cast<std::uint32_t>(state.range(0)));
+    const ParsedCommand cmd = CancelRequest{42, 1};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dispatcher.dispatch(cmd));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Dispatch_CancelReject)->ArgName("sample")->Arg(1)->Arg(8);
+
+// A burst of `range(0)` orders for one symbol, end to end (parse, dispatch, write):
+// as that many N lines, or as one B line. Items = orders.
+constexpr std::size_t kBursts = 256;
+
+std::vector<std::string> burstLines(std::size_t orders, bool batched) {
+    std::vector<std::string> lines;
+    domain::OrderId id = 1;
+    for (std::size_t b = 0; b < kBursts; ++b) {
+        std::string batch = "B," + std::to_string(b) + ",XYZ";
+        for (std::size_t i = 0; i < orders; ++i, ++id) {
+            const std::string side = (id & 1) ? "B" : "S";
+            const std::string price = (id & 1) ? "99.00" : "101.00";
+            const std::string fields = std::to_string(id) + ",L," + side + "," + price + ",10";
+            if (batched)
+                batch += "," + fields;
+            else
+                lines.push_back("N," + std::to_string(id) + "," + std::to_string(b) + ",XYZ,L," + side + "," + price +
+                                ",10");
+        }
+        if (batched)
+            lines.push_back(std::move(batch));
+    }
+    return lines;
+}
+
+template <bool Batched>
+void BM_Dispatch_NewBurst(benchmark::State& state) {
+    const auto orders = static_cast<std::size_t>(state.range(0));
+    const auto lines = burstLines(orders, Batched);
+    std::ostringstream sink;
+    std::size_t total = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto book = std::make_unique<OrderBook>();
+        CommandDispatcher dispatcher(*book);
+        sink.str("");
+        state.ResumeTiming();
+
+        for (const auto& line : lines) {
+            const auto cmd = parseCommandLine(line);
+            if constexpr (Batched) {
+                dispatcher.dispatchBatch(*cmd, sink);
+            } else {
+                sink << dispatcher.dispatch(*cmd) << '\n';
+            }
+        }
+        total += book->liveCount();
+
+        state.PauseTiming();
+        book.reset();
+        state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kBursts * orders));
+}
+BENCHMARK_TEMPLATE(BM_Dispatch_NewBurst, false)->Name("BM_Dispatch_NewBurst/single")->ArgName("orders")->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(BM_Dispatch_NewBurst, true)->Name("BM_Dispatch_NewBurst/batch")->ArgName("orders")->Arg(8)->Arg(32);
+
+// Pre-parsed balanced mix with the responses written to a discarding stream: formatted
+// and written on the engine thread (0), or pushed as records to a ResponseWriter (1).
+// Timed is the engine thread only; the writer's final drain is not. Its formatting runs
+// on another core, so on a single core the two only swap places.
+template <typename Book>
+void BM_Dispatch_Output(benchmark::State& state) {
+    const auto& lines = stream(0);
+    std::vector<ParsedCommand> cmds;
+    for (const auto& line : lines) {
+        if (auto cmd = parseCommandLine(line))
+            cmds.push_back(std::move(*cmd));
+    }
+    DiscardBuf discard;
+    std::ostream os(&discard);
+    const bool deferred = state.range(0) != 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto book = std::make_unique<Book>();
+        CommandDispatcher dispatcher(*book);
+        std::unique_ptr<ResponseWriter> writer;
+        if (deferred)
+            writer = std::make_unique<ResponseWriter>(os);
+        state.ResumeTiming();
+
+        for (const auto& cmd : cmds) {
+            if (deferred)
+                dispatcher.dispatchDeferred(cmd, *writer);
+            else
+                dispatcher.dispatchTo(cmd, os);
+        }
+
+        state.PauseTiming();
+        writer.reset();
+        book.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(cmds.size()));
+}
+BENCHMARK_BOOK(BM_Dispatch_Output, ->ArgName("deferred")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime());
+
+// Parsing alone over the same stream, to split the end-to-end number.
+void BM_Dispatch_ParseOnly(benchmark::State& state) {
+    const auto& lines = stream(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        for (const auto& line : lines) {
+            auto cmd = parseCommandLine(line);
+            benchmark::DoNotOptimize(cmd);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+BENCHMARK(BM_Dispatch_ParseOnly)->ArgName("mix")->Arg(0)->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,319 @@
+// benchmarks/engine/bench_handlers.cpp
+//
+// execute() and format() of every command handler, accept and reject paths.
+
+#include <benchmark/benchmark.h>
+
+#include "backends.hpp"
+#include "engine/amend.hpp"
+#include "engine/cancel.hpp"
+#include "engine/match.hpp"
+#include "engine/new.hpp"
+#include "risk/risk_checker.hpp"
+#include "workload.hpp"
+
+namespace {
+
+constexpr int kRestingOrders = 10'000;
+
+// ------------------------- New -------------------------
+
+void BM_NewHandler_ExecuteAccept(benchmark::State& state) {
+    OrderBook book;
+    bench::fillBook(book, kRestingOrders);
+    NewCommandHandler handler(book);
+    int nextId = kRestingOrders + 1;
+
+    for (auto _ : state) {
+        const bool buy = (nextId & 1) != 0;
+        auto order = bench::makeOrder(nextId, buy ? domain::Side::Buy : domain::Side::Sell,
+                                      buy ? 9990 - nextId % 50 : 10010 + nextId % 50);
+        ++nextId;
+        benchmark::DoNotOptimize(handler.execute(order));
+
+        if (nextId == 2 * kRestingOrders) {
+            state.PauseTiming();
+            book = OrderBook{};
+            bench::fillBook(book, kRestingOrders);
+            nextId = kRestingOrders + 1;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NewHandler_ExecuteAccept);
+
+void BM_NewHandler_ExecuteRejectInvalid(benchmark::State& state) {
+    OrderBook book;
+    NewCommandHandler handler(book);
+    auto order = bench::makeOrder(1, domain::Side::Buy, 10000, 100, "X1Z");  // non-alpha symbol
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(handler.execute(order));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NewHandler_ExecuteRejectInvalid);
+
+// The risk stage alone (symbol lookup + every limit), on an order that passes.
+void BM_RiskChecker_CheckNew(benchmark::State& state) {
+    risk::RiskConfig config;
+    config.defaults = risk::SymbolLimits{10000, 500, 1'000'000, 1'000'000'000'000, 0};
+    risk::RiskChecker checker(config);
+    const auto order = bench::makeOrder(1, domain::Side::Buy, 10010, 100);
+
+    for (auto _ : state) {
+        const std::uint32_t id = checker.idOf(order.symbol);
+        benchmark::DoNotOptimize(checker.checkNew(id, order));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RiskChecker_CheckNew);
+
+void BM_NewHandler_ExecuteRejectDuplicate(benchmark::State& state) {
+    OrderBook book;
+    bench::fillBook(book, kRestingOrders);
+    NewCommandHandler handler(book);
+    auto order = bench::makeOrder(kRestingOrders / 2, domain::Side::Buy, 9990);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(handler.execute(order));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NewHandler_ExecuteRejectDuplicate);
+
+void BM_NewHandler_Format(benchmark::State& state) {
+    NewCommandResponse r;
+    r.orderId = 123456;
+    r.accepted = state.range(0) != 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(NewCommandHandler<>::format(r));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NewHandler_Format)->ArgName("accepted")->Arg(1)->Arg(0);
+
+// ------------------------- Amend -------------------------
+
+AmendRequest amendFor(const domain::Order& o) {
+    AmendRequest req;
+    req.orderId = o.orderId;
+    req.timeStamp = o.timeStamp + 1;
+    req.symbol = o.symbol;
+    req.orderType = o.orderType;
+    req.side = o.side;
+    return req;
+}
+
+// Quantity down at the same price: the in-place path, priority kept.
+void BM_AmendHandler_ExecuteQtyDown(benchmark::State& state) {
+    OrderBook book;
+    bench::fillBook(book, kRestingOrders);
+    const auto target = bench::makeOrder(kRestingOrders + 1, domain::Side::Buy, 9950, 1'000'000'000);
+    book.add(target);
+    AmendHandler handler(book);
+    auto req = amendFor(target);
+    int qty = target.quantity;
+
+    for (auto _ : state) {
+        req.newQuantity = --qty;
+        benchmark::DoNotOptimize(handler.execute(req));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AmendHandler_ExecuteQtyDown);
+
+// Price change: the order loses priority and is re-queued at another level.
+template <typename Book>
+void BM_AmendHandler_ExecutePriceChange(benchmark::State& state) {
+    Book book;
+    bench::fillBook(book, kRestingOrders);
+    const auto target = bench::makeOrder(kRestingOrders + 1, domain::Side::Buy, 9950);
+    book.add(target);
+    AmendHandler handler(book);
+    auto req = amendFor(target);
+    bool flip = false;
+
+    for (auto _ : state) {
+        req.newPrice = (flip = !flip) ? 9951 : 9950;
+        benchmark::DoNotOptimize(handler.execute(req));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_BOOK(BM_AmendHandler_ExecutePriceChange);
+
+// Quantity up at the same price: priority lost, re-queued at the tail of its own level.
+template <typename Book>
+void BM_AmendHandler_ExecuteQtyUp(benchmark::State& state) {
+    Book book;
+    bench::fillBook(book, kRestingOrders);
+    const auto target = bench::makeOrder(kRestingOrders + 1, domain::Side::Buy, 9950, 1);
+    book.add(target);
+    AmendHandler handler(book);
+    auto req = amendFor(target);
+    int qty = target.quantity;
+
+    for (auto _ : state) {
+        req.newQuantity = ++qty;
+        benchmark::DoNotOptimize(handler.execute(req));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_BOOK(BM_AmendHandler_ExecuteQtyUp);
+
+void BM_AmendHandler_ExecuteReject404(benchmark::State& state) {
+    OrderBook book;
+    bench::fillBook(book, kRestingOrders);
+    AmendHandler handler(book);
+    auto req = amendFor(bench::makeOrder(kRestingOrders * 10, domain::Side::Buy, 9950));
+    req.newQuantity = 10;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(handler.execute(req));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AmendHandler_ExecuteReject404);
+
+void BM_AmendHandler_Format(benchmark::State& state) {
+    AmendResult r;
+    r.orderId = 123456;
+    r.accepted = state.range(0) != 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AmendHandler<>::format(r));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AmendHandler_Format)->ArgName("accepted")->Arg(1)->Arg(0);
+
+// ------------------------- Cancel -------------------------
+
+void BM_CancelHandler_ExecuteAccept(benchmark::State& state) {
+    OrderBook book;
+    bench::fillBook(book, kRestingOrders);
+    CancelHandler handler(book);
+    const auto ids = bench::shuffledIds(kRestingOrders);
+    std::size_t i = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(handler.execute(CancelRequest{ids[i], 1}));
+        if (++i == ids.size() / 2) {
+            state.PauseTiming();
+            book = OrderBook{};
+            bench::fillBook(book, kRestingOrders);
+            i = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CancelHandler_ExecuteAccept);
+
+void BM_CancelHandler_ExecuteReject404(benchmark::State& state) {
+    OrderBook book;
+    bench::fillBook(book, kRestingOrders);
+    CancelHandler handler(book);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(handler.execute(CancelRequest{kRestingOrders * 10, 1}));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CancelHandler_ExecuteReject404);
+
+void BM_CancelHandler_Format(benchmark::State& state) {
+    CancelResponse r;
+    r.orderId = 123456;
+    r.accepted = state.range(0) != 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CancelHandler<>::format(r));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CancelHandler_Format)->ArgName("accepted")->Arg(1)->Arg(0);
+
+// ------------------------- Match -------------------------
+
+// `fills` crossing buy/sell pairs spread over a few levels, one symbol per pair.
+void fillCrossingBook(OrderBook& book, int fills) {
+    const auto& syms = bench::symbols();
+    for (int i = 0; i < fills; ++i) {
+        const auto& sym = syms[static_cast<std::size_t>(i) % syms.size()];
+        book.add(bench::makeOrder(2 * i + 1, domain::Side::Buy, 10010 + i % 10, 100, sym));
+        book.add(bench::makeOrder(2 * i + 2, domain::Side::Sell, 10000 - i % 10, 100, sym));
+    }
+}
+
+template <bool BySymbol>
+void BM_MatchHandler_Execute(benchmark::State& state) {
+    const int fills = static_cast<int>(state.range(0));
+    OrderBook book;
+    MatchHandler handler(book);
+    MatchRequest req{1, std::nullopt};
+    if constexpr (BySymbol)
+        req.symbol = bench::symbols()[0];
+
+    std::int64_t events = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        book = OrderBook{};
+        fillCrossingBook(book, fills);
+        state.ResumeTiming();
+
+        auto resp = handler.execute(req);
+        events += static_cast<std::int64_t>(resp.events.size());
+        benchmark::DoNotOptimize(resp);
+    }
+    state.SetItemsProcessed(events);
+    state.counters["fills"] = benchmark::Counter(static_cast<double>(events), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MatchHandler_Execute<false>)->Name("BM_MatchHandler_ExecuteAll")->Arg(100)->Arg(1'000);
+BENCHMARK(BM_MatchHandler_Execute<true>)->Name("BM_MatchHandler_ExecuteSymbol")->Arg(100)->Arg(1'000);
+
+// 1000 fills with `stops` parked stops none of them cross: each fill pays one lookup and
+// two upper_bounds, whatever the number of stops.
+void BM_MatchHandler_ExecuteWithStops(benchmark::State& state) {
+    const int parked = static_cast<int>(state.range(0));
+    OrderBook book;
+    MatchHandler handler(book);
+    const auto& syms = bench::symbols();
+    for (int i = 0; i < parked; ++i) {
+        const bool buy = (i & 1) != 0;
+        auto order = bench::makeOrder(1'000'000 + i, buy ? domain::Side::Buy : domain::Side::Sell, 10000, 100,
+                                      syms[static_cast<std::size_t>(i) % syms.size()]);
+        book.stops().park(order, buy ? 20000 + i % 100 : 5000 - i % 100);
+    }
+
+    std::int64_t events = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        book.cancelAll([](const domain::Order&) {});  // the levels only, the stops stay
+        fillCrossingBook(book, 1'000);
+        state.ResumeTiming();
+
+        auto resp = handler.execute(MatchRequest{1, std::nullopt});
+        events += static_cast<std::int64_t>(resp.events.size());
+        benchmark::DoNotOptimize(resp);
+    }
+    state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_MatchHandler_ExecuteWithStops)->ArgName("stops")->Arg(0)->Arg(1'000)->Arg(100'000);
+
+void BM_MatchHandler_Format(benchmark::State& state) {
+    MatchResponse resp;
+    for (int i = 0; i < state.range(0); ++i) {
+        resp.events.push_back(TradeEvent{"XYZ", i + 1, i + 2, domain::OrderType::Limit, domain::OrderType::IOC, 100, 10453});
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MatchHandler<>::format(resp));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MatchHandler_Format)->Arg(1)->Arg(100);
+
+}  // namespace
@@ -0,0 +1,79 @@
+// benchmarks/parser/bench_chunked_parser.cpp
+//
+// Parse throughput of a 200k-line generated command file: getline + parseCommandLine on
+// one thread, and ChunkedParser over 1..16 worker threads with the consumer only walking
+// the commands in order (as the engine thread would, minus the book). Wall-clock time;
+// scaling needs as many cores as threads.
+
+#include <benchmark/benchmark.h>
+
+#include "parser/chunked_parser.hpp"
+#include "workload/order_flow.hpp"
+
+#include <istream>
+#include <streambuf>
+#include <string>
+
+namespace {
+
+const std::string& commandFile() {
+    static const std::string text = [] {
+        workload::OrderFlowGenerator gen(workload::OrderFlowConfig{});
+        std::string out;
+        for (int i = 0; i < 200'000; ++i) {
+            gen.appendLine(out);
+        }
+        return out;
+    }();
+    return text;
+}
+
+// Reads the file text in place, so a run does not copy it first.
+class MemoryBuf : public std::streambuf {
+public:
+    explicit MemoryBuf(const std::string& s) {
+        char* p = const_cast<char*>(s.data());
+        setg(p, p, p + s.size());
+    }
+};
+
+void BM_ParseFile_Sequential(benchmark::State& state) {
+    const std::string& text = commandFile();
+    std::size_t commands = 0;
+    for (auto _ : state) {
+        MemoryBuf buf(text);
+        std::istream in(&buf);
+        std::string line;
+        while (std::getline(in, line)) {
+            auto cmd = parseCommandLine(line);
+            benchmark::DoNotOptimize(cmd);
+            ++commands;
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(commands));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_ParseFile_Sequential)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_ParseFile_Chunked(benchmark::State& state) {
+    const std::string& text = commandFile();
+    const auto threads = static_cast<std::size_t>(state.range(0));
+    std::size_t commands = 0;
+    for (auto _ : state) {
+        MemoryBuf buf(text);
+        std::istream in(&buf);
+        ChunkedParser parser(in, ChunkedParserOptions{.threads = threads, .chunkBytes = 256 * 1024});
+        ParsedChunk chunk;
+        while (parser.next(chunk)) {
+            for (const auto& cmd : chunk.commands) {
+                benchmark::DoNotOptimize(cmd);
+            }
+            commands += chunk.commands.size();
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(commands));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_ParseFile_Chunked)->ArgName("threads")->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,27 @@
+// benchmarks/parser/bench_command_parser.cpp
+
+#include <benchmark/benchmark.h>
+
+#include "parser/commands_parser.hpp"
+
+#include <string_view>
+
+namespace {
+
+void BM_ParseCommandLine(benchmark::State& state, std::string_view line) {
+    for (auto _ : state) {
+        auto cmd = parseCommandLine(line);
+        benchmark::DoNotOptimize(cmd);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_ParseCommandLine, New, std::string_view("N,2,00000002,XYZ,L,B,104.53,100"));
+BENCHMARK_CAPTURE(BM_ParseCommandLine, NewInvalidQty, std::string_view("N,3,00000002,XYZ,L,B,104.53,100.3"));
+BENCHMARK_CAPTURE(BM_ParseCommandLine, Amend, std::string_view("A,2,00000003,XYZ,L,B,105.00,150"));
+BENCHMARK_CAPTURE(BM_ParseCommandLine, Cancel, std::string_view("X,2,00000005"));
+BENCHMARK_CAPTURE(BM_ParseCommandLine, MatchAll, std::string_view("M,00000010"));
+BENCHMARK_CAPTURE(BM_ParseCommandLine, MatchSymbol, std::string_view("M,00000010,XYZ"));
+BENCHMARK_CAPTURE(BM_ParseCommandLine, Unknown, std::string_view("Z,1,2,XYZ,L,B,104.53,100"));
@@ -0,0 +1,45 @@
+// benchmarks/parser/bench_fields_parser.cpp
+
+#include <benchmark/benchmark.h>
+
+#include "parser/fields_parser.hpp"
+
+#include <string_view>
+
+namespace {
+
+// Runs one field parser over a fixed input; the parser is a template argument so
+// every benchmark is a direct (inlinable) call, as in commands_parser.cpp.
+template <auto Parser>
+void runField(benchmark::State& state, std::string_view input) {
+    for (auto _ : state) {
+        auto v = Parser(input);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ParseInt64Strict(benchmark::State& s, std::string_view in) { runField<parseInt64Strict>(s, in); }
+void BM_ParseOrderId(benchmark::State& s, std::string_view in) { runField<parseOrderId>(s, in); }
+void BM_ParseTimestamp(benchmark::State& s, std::string_view in) { runField<parseTimestamp>(s, in); }
+void BM_ParseQuantity(benchmark::State& s, std::string_view in) { runField<parseQuantity>(s, in); }
+void BM_ParseSide(benchmark::State& s, std::string_view in) { runField<parseSide>(s, in); }
+void BM_ParseOrderType(benchmark::State& s, std::string_view in) { runField<parseOrderType>(s, in); }
+void BM_ParsePriceCents(benchmark::State& s, std::string_view in) { runField<parsePriceCents>(s, in); }
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_ParseInt64Strict, Valid, std::string_view("00000002"));
+BENCHMARK_CAPTURE(BM_ParseInt64Strict, Invalid, std::string_view("12ab"));
+BENCHMARK_CAPTURE(BM_ParseOrderId, Valid, std::string_view("123456"));
+BENCHMARK_CAPTURE(BM_ParseOrderId, Invalid, std::string_view("0"));
+BENCHMARK_CAPTURE(BM_ParseTimestamp, Valid, std::string_view("00000002"));
+BENCHMARK_CAPTURE(BM_ParseQuantity, Valid, std::string_view("100"));
+BENCHMARK_CAPTURE(BM_ParseQuantity, Decimal, std::string_view("100.3"));
+BENCHMARK_CAPTURE(BM_ParseSide, Buy, std::string_view("B"));
+BENCHMARK_CAPTURE(BM_ParseSide, Invalid, std::string_view("X"));
+BENCHMARK_CAPTURE(BM_ParseOrderType, Limit, std::string_view("L"));
+BENCHMARK_CAPTURE(BM_ParseOrderType, Invalid, std::string_view("Z"));
+BENCHMARK_CAPTURE(BM_ParsePriceCents, Valid, std::string_view("104.53"));
+BENCHMARK_CAPTURE(BM_ParsePriceCents, Zero, std::string_view("0.00"));
+BENCHMARK_CAPTURE(BM_ParsePriceCents, TooManyDecimals, std::string_view("104.5367"));
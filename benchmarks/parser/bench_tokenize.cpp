@@ -0,0 +1,40 @@
+// benchmarks/parser/bench_tokenize.cpp
+
+#include <benchmark/benchmark.h>
+
+#include "parser/tokenize.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace {
+
+void BM_Tokenize(benchmark::State& state, std::string_view line) {
+    for (auto _ : state) {
+        auto tokens = tokenize(line);
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(line.size()));
+}
+
+// views into the line, output vector reused: what parseCommandLine does per line
+void BM_TokenizeInto(benchmark::State& state, std::string_view line) {
+    std::vector<std::string_view> tokens;
+    for (auto _ : state) {
+        tokenizeInto(line, tokens);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(line.size()));
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Tokenize, New, std::string_view("N,2,00000002,XYZ,L,B,104.53,100"));
+BENCHMARK_CAPTURE(BM_Tokenize, Amend, std::string_view("A,2,00000003,XYZ,L,B,105.00,150"));
+BENCHMARK_CAPTURE(BM_Tokenize, Cancel, std::string_view("X,2,00000005"));
+BENCHMARK_CAPTURE(BM_Tokenize, Match, std::string_view("M,00000010,XYZ"));
+BENCHMARK_CAPTURE(BM_Tokenize, NewWithSpacesCrlf, std::string_view(" N , 2 , 00000002 , XYZ , L , B , 104.53 , 100 \r\n"));
+BENCHMARK_CAPTURE(BM_TokenizeInto, New, std::string_view("N,2,00000002,XYZ,L,B,104.53,100"));
+BENCHMARK_CAPTURE(BM_TokenizeInto, NewWithSpacesCrlf, std::string_view(" N , 2 , 00000002 , XYZ , L , B , 104.53 , 100 \r\n"));
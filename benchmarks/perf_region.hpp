@@ -0,0 +1,71 @@
+#pragma once
+
+// Hardware counters around the timed part of a benchmark, reported per item as
+// user counters (cycles/item, L1D-miss/item, ...). Off unless HFT_BENCH_PERF=1 is set,
+// and silently absent when the host exposes no counters (VMs, containers).
+
+#include <benchmark/benchmark.h>
+
+#include "metrics/perf_counters.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace bench {
+
+inline bool perfRequested() {
+    static const bool on = [] {
+        const char* v = std::getenv("HFT_BENCH_PERF");
+        return v && *v && *v != '0';
+    }();
+    return on;
+}
+
+class PerfRegion {
+public:
+    PerfRegion() {
+        if (!perfRequested())
+            return;
+        m_counters = std::make_unique<metrics::PerfCounters>();
+        if (!m_counters->available()) {
+            m_counters.reset();
+            return;
+        }
+        m_counters->start();
+        m_begin = m_counters->read();
+    }
+
+    // Bracket state.PauseTiming()/ResumeTiming() so setup work is not counted.
+    void pause() {
+        if (m_counters)
+            m_total += m_counters->read() - m_begin;
+    }
+    void resume() {
+        if (m_counters)
+            m_begin = m_counters->read();
+    }
+
+    // Call once after the benchmark loop.
+    void report(benchmark::State& state, std::int64_t items) {
+        if (!m_counters || items <= 0)
+            return;
+        pause();
+        m_counters->stop();
+        for (std::size_t e = 0; e < metrics::kPerfEvents; ++e) {
+            const auto event = static_cast<metrics::PerfEvent>(e);
+            if (m_counters->has(event)) {
+                state.counters[std::string(metrics::toString(event)) + "/item"] =
+                    static_cast<double>(m_total.values[e]) / static_cast<double>(items);
+            }
+        }
+    }
+
+private:
+    std::unique_ptr<metrics::PerfCounters> m_counters;
+    metrics::PerfReading m_begin{};
+    metrics::PerfReading m_total{};
+};
+
+}  // namespace bench
@@ -0,0 +1,83 @@
+// benchmarks/persistence/bench_persistence.cpp
+//
+// Journal append cost on the engine thread and snapshot write/load throughput.
+
+#include <benchmark/benchmark.h>
+
+#include "persistence/journal.hpp"
+#include "workload.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+std::string benchDir(const char* name) {
+    const auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    return dir.string();
+}
+
+// What the dispatcher pays per accepted command (encode + buffer append).
+void BM_Journal_Append(benchmark::State& state) {
+    persistence::JournalOptions opts;
+    opts.directory = benchDir("hft_bench_journal");
+    opts.fsyncEnabled = state.range(0) != 0;
+
+    persistence::JournalWriter journal(opts);
+    ParsedCommand cmd = bench::makeOrder(1, domain::Side::Buy, 10453);
+    auto& order = std::get<domain::Order>(cmd);
+
+    for (auto _ : state) {
+        ++order.orderId;
+        benchmark::DoNotOptimize(journal.append(cmd));
+    }
+    journal.flush();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["fsyncs"] = static_cast<double>(journal.stats().fsyncs);
+}
+BENCHMARK(BM_Journal_Append)->ArgName("fsync")->Arg(0)->Arg(1);
+
+void BM_Snapshot_Write(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    OrderBook book;
+    bench::fillBook(book, n, 1000);
+
+    for (auto _ : state) {
+        std::ostringstream out;
+        benchmark::DoNotOptimize(book.writeSnapshot(out, 1));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Snapshot_Write)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+void BM_Snapshot_Load(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::string bytes;
+    {
+        OrderBook book;
+        bench::fillBook(book, n, 1000);
+        std::ostringstream out;
+        book.writeSnapshot(out, 1);
+        bytes = out.str();
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto book = std::make_unique<OrderBook>();
+        std::istringstream in(bytes);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(book->loadSnapshot(in));
+
+        state.PauseTiming();
+        book.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["bytes_per_order"] = static_cast<double>(bytes.size()) / n;
+}
+BENCHMARK(BM_Snapshot_Load)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
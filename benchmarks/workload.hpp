@@ -0,0 +1,98 @@
+#pragma once
+
+// Shared fixtures for the benchmark suite: deterministic orders, pre-filled books
+// and generated command streams for end-to-end dispatch runs.
+
+#include "book/order_book.hpp"
+#include "domain/order.hpp"
+#include "workload/order_flow.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+inline const std::vector<std::string>& symbols() {
+    static const std::vector<std::string> syms = {"AAPL", "MSFT", "XYZ", "ABC", "GOOG", "AMZN", "TSLA", "NVDA"};
+    return syms;
+}
+
+inline domain::Order makeOrder(domain::OrderId id,
+                               domain::Side side,
+                               domain::Price price,
+                               int qty = 100,
+                               const std::string& symbol = "XYZ",
+                               domain::OrderType type = domain::OrderType::Limit) {
+    domain::Order o;
+    o.orderId = id;
+    o.timeStamp = id;
+    o.symbol = symbol;
+    o.orderType = type;
+    o.side = side;
+    o.price = price;
+    o.quantity = qty;
+    return o;
+}
+
+// Non-crossing book: BUY levels below 100.00, SELL levels above it.
+// Ids are 1..n, sides alternate, `levels` distinct prices per side.
+template <typename Book>
+void fillBook(Book& book, int n, int levels = 100, std::uint32_t seed = 1) {
+    std::mt19937 rng(seed);
+    const auto& syms = symbols();
+    for (int id = 1; id <= n; ++id) {
+        const bool buy = (id & 1) != 0;
+        const auto offset = static_cast<domain::Price>(1 + rng() % levels);
+        book.add(makeOrder(id,
+                           buy ? domain::Side::Buy : domain::Side::Sell,
+                           buy ? 10000 - offset : 10000 + offset,
+                           1 + static_cast<int>(rng() % 500),
+                           syms[rng() % syms.size()]));
+    }
+}
+
+// Random permutation of 1..n (lookup / erase order).
+inline std::vector<domain::OrderId> shuffledIds(int n, std::uint32_t seed = 2) {
+    std::vector<domain::OrderId> ids(static_cast<std::size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        ids[static_cast<std::size_t>(i)] = i + 1;
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(seed));
+    return ids;
+}
+
+struct WorkloadMix {
+    std::uint32_t newPct{60};
+    std::uint32_t amendPct{15};
+    std::uint32_t cancelPct{20};  // remainder => match
+};
+
+// Text command stream in the input file format, produced by workload::OrderFlowGenerator
+// with as many symbols as fillBook() spreads orders over.
+inline std::vector<std::string> generateCommandLines(std::size_t count,
+                                                     WorkloadMix mix = {},
+                                                     std::uint64_t seed = 42) {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = seed;
+    cfg.symbols = static_cast<std::uint32_t>(symbols().size());
+    cfg.newPct = mix.newPct;
+    cfg.amendPct = mix.amendPct;
+    cfg.cancelPct = mix.cancelPct;
+    workload::OrderFlowGenerator gen(cfg);
+
+    std::vector<std::string> lines;
+    lines.reserve(count);
+    std::string line;
+    for (std::size_t i = 0; i < count; ++i) {
+        line.clear();
+        gen.appendLine(line);
+        line.pop_back();  // '\n'
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+}  // namespace bench
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+// Where the books' long-lived memory comes from: order nodes / queues, price-level map
+// nodes and IdIndex pages all go through BookAllocator into one process-wide Arena.
+//
+// The arena maps large anonymous regions (2 MiB aligned) and bumps through them; freed
+// blocks go to per-size free lists and are handed out again, never back to the OS. A
+// region can be backed by huge pages so a book of millions of orders needs few TLB
+// entries:
+// - Transparent: madvise(MADV_HUGEPAGE), honoured when THP is "always" or "madvise";
+// - Explicit: MAP_HUGETLB from the reserved pool (vm.nr_hugepages), falling back to a
+//   Transparent region when the pool is empty.
+// prefaultBytes are touched when the arena is created, so the first orders of a session
+// do not take page faults.
+//
+// Not thread-safe: the books are driven from one thread.
+enum class HugePageMode : std::uint8_t {
+    Off,
+    Transparent,
+    Explicit
+};
+
+struct ArenaOptions {
+    HugePageMode hugePages{HugePageMode::Transparent};
+    std::size_t regionBytes{64u << 20};  // mapped at a time, rounded up to 2 MiB
+    std::size_t prefaultBytes{0};
+};
+
+struct ArenaStats {
+    std::size_t mappedBytes{0};
+    std::size_t usedBytes{0};        // handed out and not freed
+    std::size_t freeListBytes{0};    // freed, waiting in the free lists
+    std::size_t prefaultedBytes{0};
+    std::size_t regions{0};
+    std::size_t hugeRegions{0};      // backed by MAP_HUGETLB or accepted MADV_HUGEPAGE
+    std::size_t explicitRegions{0};  // of those, MAP_HUGETLB
+};
+
+class Arena {
+public:
+    explicit Arena(const ArenaOptions& options = {});
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // bytes are rounded up to 16; align is a power of two
+    void* allocate(std::size_t bytes, std::size_t align);
+    void deallocate(void* p, std::size_t bytes) noexcept;
+
+    const ArenaOptions& options() const { return m_options; }
+    ArenaStats stats() const { return m_stats; }
+    void report(std::ostream& os) const;
+
+private:
+    struct Region {
+        void* base;
+        std::size_t bytes;
+    };
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static constexpr std::size_t kGranule = 16;
+    static constexpr std::size_t kSmallClasses = 256;  // up to 4 KiB, one list per granule
+
+    static std::size_t classOf(std::size_t bytes) { return bytes == 0 ? kGranule : (bytes + kGranule - 1) & ~(kGranule - 1); }
+    FreeBlock*& freeList(std::size_t size);
+    void mapRegion(std::size_t minBytes);
+    void prefault(std::size_t bytes);
+
+    ArenaOptions m_options;
+    ArenaStats m_stats;
+    std::vector<Region> m_regions;
+    std::uintptr_t m_cursor{0};
+    std::uintptr_t m_end{0};
+    std::array<FreeBlock*, kSmallClasses> m_small{};
+    std::unordered_map<std::size_t, FreeBlock*> m_large;
+};
+
+// The arena every BookAllocator draws from; created with default options on first use.
+Arena& bookArena();
+
+// Replaces the book arena. Only possible before any book memory is in use (call it at
+// startup); returns false and keeps the current arena otherwise.
+bool configureBookArena(const ArenaOptions& options);
+
+// Stateless allocator over bookArena(), for the books' containers.
+template <typename T>
+struct BookAllocator {
+    using value_type = T;
+
+    BookAllocator() noexcept = default;
+    template <typename U>
+    BookAllocator(const BookAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(bookArena().allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, std::size_t n) noexcept { bookArena().deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const BookAllocator<U>&) const noexcept {
+        return true;
+    }
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "book/level_summary.hpp"
+#include "book/order_visitor.hpp"
+#include "book/stop_book.hpp"
+#include "domain/order.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+namespace marketdata {
+class L2Publisher;
+}
+
+// What the handlers and CommandDispatcher need from an order book. OrderBook
+// (std::map of std::deque) is the reference; every other backend must produce the
+// same responses and the same dump() for the same command stream (see
+// engine/differential.hpp).
+//
+// Semantics a backend has to reproduce:
+// - one book for all symbols: levels are shared, FIFO inside a level spans symbols,
+//   so bestBidOrder()/bestAskOrder() may return any symbol;
+// - the symbol overloads return the first order of that symbol scanning levels
+//   best -> worst, FIFO inside a level;
+// - getById() pointers stay valid until the order leaves the book (amend updates
+//   quantity / timeStamp through them);
+// - consume*(qty) is a no-op unless 0 < qty <= order quantity; a filled order leaves
+//   the book and an empty level disappears;
+// - relocate() moves a live order to the tail of the `price` level on its side (its own
+//   level when the price is unchanged) with new quantity / timeStamp; getById() then
+//   still finds it, at its new place;
+// - quantities change only through the book (consume*, reduceQuantity, relocate), so the
+//   per-symbol level totals behind depth() stay exact;
+// - addBatch() behaves like add() called on each order in turn (all orders share one
+//   symbol, so it is resolved once);
+// - cancelAll() / cancelSymbol() visit the orders they drop best level first, FIFO
+//   inside a level (cancelAll: all BUY levels, then all SELL levels);
+// - with a publisher attached, every change of a per-symbol level total is reported as
+//   it happens (marketdata/l2_feed.hpp), and a mass cancel reports each level it drops;
+// - parked stop orders live in the backend's StopBook (stops()), outside the levels and
+//   every count; clear() drops them and dump() lists them after the levels;
+// - reserve() / prepareSymbol() only size storage and change no response or dump().
+template <typename Book>
+concept BookBackend = requires(Book& book,
+                               const Book& cbook,
+                               const domain::Order& order,
+                               domain::OrderId id,
+                               int qty,
+                               domain::Price price,
+                               const domain::Symbol& symbol,
+                               domain::Side side,
+                               domain::Timestamp ts,
+                               LevelSummary* levels,
+                               const OrderVisitor& visit,
+                               bool* added,
+                               std::ostream& os) {
+    { book.add(order) } -> std::same_as<bool>;
+    { book.addBatch(&order, std::size_t{}, added) } -> std::same_as<std::size_t>;
+    { cbook.isLive(id) } -> std::same_as<bool>;
+    { book.getById(id) } -> std::same_as<domain::Order*>;
+    { book.erase(id) } -> std::same_as<bool>;
+    { cbook.findOrder(id) } -> std::same_as<const domain::Order*>;
+    book.reduceQuantity(*book.getById(id), qty, ts);
+    book.relocate(*book.getById(id), price, qty, ts);
+    { book.cancelSymbol(symbol, side, visit) } -> std::same_as<std::size_t>;
+    { book.cancelAll(visit) } -> std::same_as<std::size_t>;
+
+    { cbook.hasBuy() } -> std::same_as<bool>;
+    { cbook.hasSell() } -> std::same_as<bool>;
+    { cbook.bestBidPrice() } -> std::same_as<std::optional<domain::Price>>;
+    { cbook.bestAskPrice() } -> std::same_as<std::optional<domain::Price>>;
+    { cbook.bestBidPrice(symbol) } -> std::same_as<std::optional<domain::Price>>;
+    { cbook.bestAskPrice(symbol) } -> std::same_as<std::optional<domain::Price>>;
+
+    { book.bestBidOrder() } -> std::same_as<domain::Order*>;
+    { book.bestAskOrder() } -> std::same_as<domain::Order*>;
+    { book.bestBidOrder(symbol) } -> std::same_as<domain::Order*>;
+    { book.bestAskOrder(symbol) } -> std::same_as<domain::Order*>;
+
+    book.consumeBestBid(qty);
+    book.consumeBestAsk(qty);
+    book.consumeBestBid(qty, symbol);
+    book.consumeBestAsk(qty, symbol);
+
+    { cbook.liveCount() } -> std::same_as<std::size_t>;
+    { cbook.buyCount() } -> std::same_as<std::size_t>;
+    { cbook.sellCount() } -> std::same_as<std::size_t>;
+    { cbook.depth(symbol, side, std::size_t{}, levels) } -> std::same_as<std::size_t>;
+
+    book.attachMarketData(static_cast<marketdata::L2Publisher*>(nullptr));
+    { cbook.marketData() } -> std::same_as<marketdata::L2Publisher*>;
+
+    { book.stops() } -> std::same_as<StopBook&>;
+    cbook.forEach(visit);
+    cbook.dump(os);
+    book.reserve(std::size_t{});
+    book.prepareSymbol(symbol);
+    book.clear();
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "book/arena.hpp"
+#include "domain/types.hpp"
+
+#include <algorithm>  // std::min, std::max
+#include <array>
+#include <bit>  // std::countr_zero
+#include <cstddef>
+#include <cstdint>
+#include <functional>  // std::hash, std::equal_to
+#include <memory>
+#include <new>  // placement new
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Order id -> T for ids that arrive nearly contiguous (a gateway counting up).
+//
+// Ids in [base, base + kWindow) live in a paged dense array keyed by id - base: a
+// lookup is a shift, a mask, a bitmap test and one load, with no hashing or probing.
+// Pages of kPageSize slots are allocated when their first id arrives and freed when
+// their last one leaves (one spare is kept, so a page flapping between 0 and 1 live ids
+// does not hit the allocator; reserve() keeps more). Ids outside the window go to a hash map. The window starts
+// at 0; an id outside it that arrives while no page is live moves it to that id's page,
+// so a session whose ids outgrow the window slides it forward instead of hashing
+// everything after that.
+//
+// Pages and the hash map come from the book arena (book/arena.hpp).
+//
+// Pointers returned by find() / tryEmplace() stay valid until that id is erased, except
+// that an insert which moves the window may move hashed entries into pages.
+template <typename T>
+class IdIndex {
+public:
+    static constexpr std::size_t kPageBits = 12;
+    static constexpr std::size_t kPageSize = std::size_t{1} << kPageBits;  // ids per page
+    static constexpr std::size_t kMaxPages = 4096;
+    static constexpr std::int64_t kWindow = static_cast<std::int64_t>(kPageSize * kMaxPages);  // 16M ids
+
+    T* find(domain::OrderId id) { return const_cast<T*>(std::as_const(*this).find(id)); }
+
+    const T* find(domain::OrderId id) const {
+        std::size_t page = 0;
+        std::size_t slot = 0;
+        if (locate(id, page, slot)) {
+            if (page >= m_pages.size() || !m_pages[page] || !m_pages[page]->test(slot))
+                return nullptr;
+            return &m_pages[page]->slots[slot];
+        }
+        if (m_hashed.empty())
+            return nullptr;
+        const auto it = m_hashed.find(id);
+        return it != m_hashed.end() ? &it->second : nullptr;
+    }
+
+    bool contains(domain::OrderId id) const { return find(id) != nullptr; }
+
+    // {slot, true} when `id` was absent and now maps to `value`; {existing, false} otherwise.
+    std::pair<T*, bool> tryEmplace(domain::OrderId id, const T& value) {
+        std::size_t page = 0;
+        std::size_t slot = 0;
+        bool dense = locate(id, page, slot);
+        if (!dense && m_livePages == 0) {
+            rebase(id);
+            dense = locate(id, page, slot);
+        }
+        if (!dense) {
+            const auto [it, inserted] = m_hashed.try_emplace(id, value);
+            return {&it->second, inserted};
+        }
+        Page& p = pageAt(page);
+        if (p.test(slot))
+            return {&p.slots[slot], false};
+        p.set(slot);
+        p.slots[slot] = value;
+        ++p.live;
+        ++m_dense;
+        return {&p.slots[slot], true};
+    }
+
+    bool erase(domain::OrderId id) {
+        std::size_t page = 0;
+        std::size_t slot = 0;
+        if (!locate(id, page, slot))
+            return m_hashed.erase(id) != 0;
+        if (page >= m_pages.size() || !m_pages[page] || !m_pages[page]->test(slot))
+            return false;
+        Page& p = *m_pages[page];
+        p.reset(slot);
+        --m_dense;
+        if (--p.live == 0) {
+            keepSpare(std::move(m_pages[page]));
+            --m_livePages;
+        }
+        return true;
+    }
+
+    // Allocates (and touches) enough pages for `ids` contiguous ids up front and keeps
+    // that many around as spares from then on, clear() included.
+    void reserve(std::size_t ids) {
+        m_reservedPages = std::min((ids + kPageSize - 1) / kPageSize, kMaxPages);
+        m_pages.reserve(m_reservedPages);
+        while (m_livePages + m_spares.size() < m_reservedPages) {
+            m_spares.push_back(newPage());
+        }
+    }
+
+    std::size_t size() const { return m_dense + m_hashed.size(); }
+    bool empty() const { return size() == 0; }
+    std::size_t livePages() const { return m_livePages; }
+    std::size_t sparePages() const { return m_spares.size(); }
+    std::size_t hashedCount() const { return m_hashed.size(); }
+
+    void clear() {
+        for (auto& page : m_pages) {
+            if (page)
+                keepSpare(std::move(page));
+        }
+        m_pages.clear();
+        m_hashed.clear();
+        m_livePages = 0;
+        m_dense = 0;
+    }
+
+    // fn(id, T&): the dense window in id order, then the hashed ids in no particular order.
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (std::size_t page = 0; page < m_pages.size(); ++page) {
+            if (!m_pages[page])
+                continue;
+            Page& p = *m_pages[page];
+            for (std::size_t w = 0; w < p.used.size(); ++w) {
+                for (std::uint64_t bits = p.used[w]; bits != 0; bits &= bits - 1) {
+                    const std::size_t slot = w * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+                    fn(idAt(page, slot), p.slots[slot]);
+                }
+            }
+        }
+        for (auto& [id, value] : m_hashed) {
+            fn(id, value);
+        }
+    }
+
+private:
+    struct Page {
+        std::array<std::uint64_t, kPageSize / 64> used{};
+        std::array<T, kPageSize> slots{};
+        std::uint32_t live{0};
+
+        bool test(std::size_t slot) const { return (used[slot >> 6] >> (slot & 63)) & 1; }
+        void set(std::size_t slot) { used[slot >> 6] |= std::uint64_t{1} << (slot & 63); }
+        void reset(std::size_t slot) { used[slot >> 6] &= ~(std::uint64_t{1} << (slot & 63)); }
+    };
+
+    struct PageDeleter {
+        void operator()(Page* page) const {
+            page->~Page();
+            BookAllocator<Page>().deallocate(page, 1);
+        }
+    };
+    using PagePtr = std::unique_ptr<Page, PageDeleter>;
+
+    bool locate(domain::OrderId id, std::size_t& page, std::size_t& slot) const {
+        const std::int64_t offset = static_cast<std::int64_t>(id) - m_base;
+        if (offset < 0 || offset >= kWindow)
+            return false;
+        page = static_cast<std::size_t>(offset) >> kPageBits;
+        slot = static_cast<std::size_t>(offset) & (kPageSize - 1);
+        return true;
+    }
+
+    domain::OrderId idAt(std::size_t page, std::size_t slot) const {
+        return static_cast<domain::OrderId>(m_base + static_cast<std::int64_t>((page << kPageBits) | slot));
+    }
+
+    Page& pageAt(std::size_t page) {
+        if (page >= m_pages.size())
+            m_pages.resize(page + 1);
+        if (!m_pages[page]) {
+            if (!m_spares.empty()) {
+                m_pages[page] = std::move(m_spares.back());
+                m_spares.pop_back();
+                m_pages[page]->used.fill(0);
+            } else {
+                m_pages[page] = newPage();
+            }
+            ++m_livePages;
+        }
+        return *m_pages[page];
+    }
+
+    static PagePtr newPage() { return PagePtr(new (BookAllocator<Page>().allocate(1)) Page()); }
+
+    void keepSpare(PagePtr page) {
+        if (m_spares.size() < std::max<std::size_t>(m_reservedPages, 1))
+            m_spares.push_back(std::move(page));
+    }
+
+    // Only with no live page: the window restarts at `id`'s page and takes over the
+    // hashed ids that now fall inside it.
+    void rebase(domain::OrderId id) {
+        m_pages.clear();
+        m_base = (static_cast<std::int64_t>(id) >> kPageBits) << kPageBits;
+        for (auto it = m_hashed.begin(); it != m_hashed.end();) {
+            std::size_t page = 0;
+            std::size_t slot = 0;
+            if (!locate(it->first, page, slot)) {
+                ++it;
+                continue;
+            }
+            Page& p = pageAt(page);
+            p.set(slot);
+            p.slots[slot] = std::move(it->second);
+            ++p.live;
+            ++m_dense;
+            it = m_hashed.erase(it);
+        }
+    }
+
+    std::int64_t m_base{0};
+    std::vector<PagePtr> m_pages;  // null => no live id in that page
+    std::vector<PagePtr> m_spares;
+    std::size_t m_reservedPages{0};
+    std::size_t m_livePages{0};
+    std::size_t m_dense{0};
+    std::unordered_map<domain::OrderId, T, std::hash<domain::OrderId>, std::equal_to<domain::OrderId>,
+                       BookAllocator<std::pair<const domain::OrderId, T>>>
+        m_hashed;  // outside the window
+};
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "book/arena.hpp"
+#include "book/id_index.hpp"
+#include "book/level_summary.hpp"
+#include "book/order_visitor.hpp"
+#include "book/stop_book.hpp"
+#include "domain/order.hpp"
+
+#include <array>
+#include <cstddef>
+#include <functional>  // std::less, std::hash, std::equal_to
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace marketdata {
+class L2Publisher;
+}
+
+// Same behaviour as OrderBook (see book/book_backend.hpp), different structure:
+// - orders live in pooled nodes, so getById() / erase() are a hash lookup instead of
+//   a scan of the whole book;
+// - every node sits in two intrusive FIFOs: its price level (all symbols, used by
+//   match-all and dump) and its symbol's price level, so the symbol queries read the
+//   front of a per-symbol map instead of scanning levels for the first match; those
+//   per-symbol levels also carry the quantity / order totals depth() reports.
+class IndexedOrderBook {
+public:
+    IndexedOrderBook();
+    ~IndexedOrderBook();
+
+    IndexedOrderBook(const IndexedOrderBook&) = delete;
+    IndexedOrderBook& operator=(const IndexedOrderBook&) = delete;
+
+    bool hasBuy() const;
+    bool hasSell() const;
+
+    std::optional<domain::Price> bestBidPrice() const;
+    std::optional<domain::Price> bestAskPrice() const;
+
+    domain::Order* bestBidOrder();
+    domain::Order* bestAskOrder();
+
+    void consumeBestBid(int matchedQty);
+    void consumeBestAsk(int matchedQty);
+
+    std::optional<domain::Price> bestBidPrice(const domain::Symbol& symbol) const;
+    std::optional<domain::Price> bestAskPrice(const domain::Symbol& symbol) const;
+
+    domain::Order* bestBidOrder(const domain::Symbol& symbol);
+    domain::Order* bestAskOrder(const domain::Symbol& symbol);
+
+    void consumeBestBid(int matchedQty, const domain::Symbol& symbol);
+    void consumeBestAsk(int matchedQty, const domain::Symbol& symbol);
+
+    bool isLive(domain::OrderId id) const;
+    bool add(const domain::Order& order);
+    std::size_t addBatch(const domain::Order* orders, std::size_t count, bool* added);
+
+    std::size_t liveCount() const;
+    std::size_t buyCount() const;
+    std::size_t sellCount() const;
+
+    domain::Order* getById(domain::OrderId id);
+    const domain::Order* findOrder(domain::OrderId id) const;
+    bool erase(domain::OrderId id);
+
+    void reduceQuantity(domain::Order& order, int newQty, domain::Timestamp ts);
+    // Relinks the node at the tail of the new level; no allocation, index untouched.
+    void relocate(domain::Order& order, domain::Price newPrice, int newQty, domain::Timestamp ts);
+
+    // Walks the symbol's own level lists and drops them whole; cancelAll() releases
+    // every node in one pass over the index.
+    std::size_t cancelSymbol(const domain::Symbol& symbol, domain::Side side, const OrderVisitor& onCancel);
+    std::size_t cancelAll(const OrderVisitor& onCancel);
+
+    std::size_t depth(const domain::Symbol& symbol, domain::Side side, std::size_t maxLevels, LevelSummary* out) const;
+
+    // Byte-for-byte the OrderBook format.
+    void dump(std::ostream& os) const;
+
+    // Every live order in OrderBook::forEach() order.
+    void forEach(const OrderVisitor& visit) const;
+
+    // Same deltas as OrderBook::attachMarketData(), taken from the symbol level totals.
+    void attachMarketData(marketdata::L2Publisher* publisher) { m_l2 = publisher; }
+    marketdata::L2Publisher* marketData() const { return m_l2; }
+
+    StopBook& stops() { return m_stops; }
+    const StopBook& stops() const { return m_stops; }
+
+    // As OrderBook::reserve() / prepareSymbol(); reserve() also fills the node pool.
+    void reserve(std::size_t orders);
+    void prepareSymbol(const domain::Symbol& symbol);
+
+    void clear();
+
+private:
+    struct Node;
+
+    struct Level {
+        domain::Price price{};
+        Node* head{nullptr};
+        Node* tail{nullptr};
+        std::size_t count{0};
+    };
+
+    struct SymbolLevel {
+        Node* head{nullptr};
+        Node* tail{nullptr};
+        LevelSummary totals{};
+    };
+
+    // Keyed by price for SELL and -price for BUY, so begin() is the best level on both sides.
+    // Nodes and every map node come from the book arena.
+    using Levels = std::map<domain::Price, Level, std::less<domain::Price>, BookAllocator<std::pair<const domain::Price, Level>>>;
+    using SymbolLevels =
+        std::map<domain::Price, SymbolLevel, std::less<domain::Price>, BookAllocator<std::pair<const domain::Price, SymbolLevel>>>;
+    using SymbolSides = std::array<SymbolLevels, 2>;
+
+    // Two cache lines. The first holds what a match touches per order: both FIFO links,
+    // the symbol level whose totals a fill adjusts and the hot head of the order (id,
+    // price, quantity, type, side); the time stamps, the symbol and the level iterators
+    // only needed to unlink the order sit in the second.
+    struct alignas(64) Node {
+        Node* prev{nullptr};
+        Node* next{nullptr};  // doubles as the free-list link
+        Node* symPrev{nullptr};
+        Node* symNext{nullptr};
+        SymbolLevels::iterator symLevel{};
+        domain::Order order{};
+        // cold
+        Levels::iterator level{};
+        SymbolLevels* symSide{nullptr};
+    };
+    static_assert(sizeof(Node) == 128);
+    static_assert(offsetof(Node, order) + domain::kHotBytes <= 64);
+
+    static std::size_t sideIndex(domain::Side side) { return side == domain::Side::Buy ? 0 : 1; }
+    static domain::Price levelKey(std::size_t side, domain::Price price) { return side == 0 ? -price : price; }
+
+    bool addTo(SymbolSides& symbol, const domain::Order& order);
+    Node* frontOf(std::size_t side) const;
+    Node* frontOf(std::size_t side, const domain::Symbol& symbol) const;
+    void consume(Node* node, int matchedQty);
+    void link(std::size_t side, Node* node);
+    void unlink(Node* node);
+    void unlinkFromLevel(std::size_t side, Node* node);
+    void unlinkFromSymbolLevel(Node* node);
+    void publishLevel(const Node* node, bool existed);
+    void publishDeleted(const domain::Symbol& symbol, std::size_t side, const SymbolLevels& levels);
+
+    void addChunk();
+    Node* acquireNode();
+    void releaseNode(Node* node);
+    void clearLevels();  // clear() without the stops
+
+    std::array<Levels, 2> m_levels{};
+    std::array<std::size_t, 2> m_counts{};
+    std::unordered_map<domain::Symbol, SymbolSides, std::hash<domain::Symbol>, std::equal_to<domain::Symbol>,
+                       BookAllocator<std::pair<const domain::Symbol, SymbolSides>>>
+        m_symbols;  // entries are kept once created
+    IdIndex<Node*> m_index;
+
+    std::vector<Node*> m_chunks;  // kNodesPerChunk nodes each, from the arena
+    Node* m_free{nullptr};
+
+    StopBook m_stops;
+
+    marketdata::L2Publisher* m_l2{nullptr};
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "domain/types.hpp"
+
+#include <cstdint>
+
+// One aggregated price level of a single symbol (quantity and order count summed).
+struct LevelSummary {
+    domain::Price price{};
+    std::int64_t quantity{};
+    std::uint32_t orders{};
+};
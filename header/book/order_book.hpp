@@ -1,12 +1,26 @@
 #pragma once
 
+#include "book/arena.hpp"
+#include "book/id_index.hpp"
+#include "book/level_summary.hpp"
+#include "book/order_visitor.hpp"
+#include "book/stop_book.hpp"
 #include "domain/order.hpp"
 
 #include <cstddef>  // std::size_t
+#include <cstdint>
 #include <deque>
-#include <functional>  // std::greater
+#include <functional>  // std::greater, std::less, std::hash
+#include <iosfwd>
 #include <map>
-#include <unordered_set>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace marketdata {
+class L2Publisher;
+}
 
 class OrderBook {
 public:
@@ -24,7 +38,7 @@ public:
 
     // Consume quantity from the best/front order.
     // - Decrements qty by matchedQty
-    // - If qty reaches 0: pops it from deque and removes id from m_liveIds
+    // - If qty reaches 0: pops it from deque and removes id from m_live
     // - If price level becomes empty: removes the price level from the map
     // Precondition: side not empty, matchedQty > 0, matchedQty <= front.qty
     void consumeBestBid(int matchedQty);
@@ -32,14 +46,14 @@ public:
 
     // the same set of methods overloading to handle with 'symbol' parameter
 
-    std::optional<domain::Price> bestBidPrice(const std::string& symbol) const;
-    std::optional<domain::Price> bestAskPrice(const std::string& symbol) const;
+    std::optional<domain::Price> bestBidPrice(const domain::Symbol& symbol) const;
+    std::optional<domain::Price> bestAskPrice(const domain::Symbol& symbol) const;
 
-    domain::Order* bestBidOrder(const std::string& symbol);
-    domain::Order* bestAskOrder(const std::string& symbol);
+    domain::Order* bestBidOrder(const domain::Symbol& symbol);
+    domain::Order* bestAskOrder(const domain::Symbol& symbol);
 
-    void consumeBestBid(int matchedQty, const std::string& symbol);
-    void consumeBestAsk(int matchedQty, const std::string& symbol);
+    void consumeBestBid(int matchedQty, const domain::Symbol& symbol);
+    void consumeBestAsk(int matchedQty, const domain::Symbol& symbol);
 
     // Check if an orderId is already live (duplicate prevention)
     bool isLive(domain::OrderId id) const;
@@ -47,22 +61,108 @@ public:
     // Try to add a new order. Returns false if duplicate orderId.
     bool add(const domain::Order& order);
 
+    // add() for `count` orders of ONE symbol; the symbol's totals are looked up once.
+    // added[i] = whether orders[i] went in. Returns how many did.
+    std::size_t addBatch(const domain::Order* orders, std::size_t count, bool* added);
+
     // Helpers for tests / diagnostics
     std::size_t liveCount() const;
     std::size_t buyCount() const;
     std::size_t sellCount() const;
 
     domain::Order* getById(domain::OrderId id);
+    const domain::Order* findOrder(domain::OrderId id) const;
     bool erase(domain::OrderId id);
 
+    // Quantity-down amend in place: keeps the order's FIFO position.
+    // Precondition: `order` came from getById(), 0 < newQty.
+    void reduceQuantity(domain::Order& order, int newQty, domain::Timestamp ts);
+
+    // Any other amend: moves the order (no copy) to the tail of the `newPrice` level,
+    // which is its own level when the price is unchanged; the id stays in m_live.
+    // Precondition: `order` came from getById(), 0 < newQty. `order` is dangling afterwards.
+    void relocate(domain::Order& order, domain::Price newPrice, int newQty, domain::Timestamp ts);
+
+    // Mass cancel: removes every order of `symbol` on `side` (levels found through the
+    // symbol's totals, so untouched levels are never visited) / every order in the book.
+    // `onCancel` sees each order before it is dropped. Returns the number removed.
+    std::size_t cancelSymbol(const domain::Symbol& symbol, domain::Side side, const OrderVisitor& onCancel);
+    std::size_t cancelAll(const OrderVisitor& onCancel);
+
+    // Up to `maxLevels` aggregated levels of `symbol` on `side`, best first, written
+    // to `out`; returns how many. O(maxLevels), served from per-symbol level totals.
+    std::size_t depth(const domain::Symbol& symbol, domain::Side side, std::size_t maxLevels, LevelSummary* out) const;
+
     void dump(std::ostream& os) const;
 
-private:
-    using OrderQueue = std::deque<domain::Order>;
+    // Every live order, BUY levels then SELL levels, best first, FIFO inside a level.
+    void forEach(const OrderVisitor& visit) const;
+
+    // Binary point-in-time snapshot: both sides level by level, each FIFO in queue order.
+    // seq = last journal sequence number already reflected in this state.
+    // Layout is documented in src/book/order_book_snapshot.cpp.
+    bool writeSnapshot(std::ostream& os, std::uint64_t seq) const;
 
-    std::unordered_set<domain::OrderId> m_liveIds;
+    // Replaces the whole book with the snapshot content and returns the seq it covers.
+    // nullopt => corrupt / truncated data, the book is left empty.
+    std::optional<std::uint64_t> loadSnapshot(std::istream& is);
+
+    // Every change of a per-symbol level total is reported to `publisher` (nullptr
+    // detaches). cancelSymbol()/cancelAll() report each dropped level; clear() and
+    // loadSnapshot() do not - a consumer needs a fresh snapshot after them.
+    void attachMarketData(marketdata::L2Publisher* publisher) { m_l2 = publisher; }
+    marketdata::L2Publisher* marketData() const { return m_l2; }
+
+    // Parked stop orders; dump(), clear() and the snapshot include them.
+    StopBook& stops() { return m_stops; }
+    const StopBook& stops() const { return m_stops; }
+
+    // Sizing only, no visible effect (startup warm-up, engine/warmup.hpp): room for
+    // `orders` live ids and an empty entry for `symbol`, so neither grows on the first
+    // orders. clear() keeps the room and drops the symbol entries.
+    void reserve(std::size_t orders);
+    void prepareSymbol(const domain::Symbol& symbol);
+
+    void clear();
+
+private:
+    // Queues, level and depth maps come from the book arena.
+    template <typename K, typename V, typename Compare = std::less<K>>
+    using Map = std::map<K, V, Compare, BookAllocator<std::pair<const K, V>>>;
+    using OrderQueue = std::deque<domain::Order, BookAllocator<domain::Order>>;
+
+    struct OrderLocation {
+        domain::Side side;
+        domain::Price price;
+    };
+
+    // Per-symbol totals of every level the symbol has orders at.
+    struct SymbolDepth {
+        Map<domain::Price, LevelSummary, std::greater<domain::Price>> buy;
+        Map<domain::Price, LevelSummary> sell;
+    };
+
+    OrderQueue* levelOf(domain::Side side, domain::Price price);
+    const OrderQueue* levelOf(domain::Side side, domain::Price price) const;
+    const SymbolDepth* depthOf(const domain::Symbol& symbol) const;
+    void adjustDepth(const domain::Order& order, std::int64_t qtyDelta, int orderDelta);
+    void adjustDepth(SymbolDepth& depth, const domain::Order& order, std::int64_t qtyDelta, int orderDelta);
+    void publishDeleted(const domain::Symbol& symbol, domain::Side side, domain::Price price);
+    bool addTo(SymbolDepth& depth, const domain::Order& order);
+    void rebuildDepth();  // after loadSnapshot
+    void clearLevels();   // clear() without the stops
+
+    // live id -> where its order rests; lookups scan one level instead of the book
+    IdIndex<OrderLocation> m_live;
+    std::unordered_map<domain::Symbol, SymbolDepth, std::hash<domain::Symbol>, std::equal_to<domain::Symbol>,
+                       BookAllocator<std::pair<const domain::Symbol, SymbolDepth>>>
+        m_symbolDepth;
 
     // price-time priority: each price level keeps FIFO queue
-    std::map<domain::Price, OrderQueue, std::greater<domain::Price>> m_buyBook;
-    std::map<domain::Price, OrderQueue> m_sellBook;
+    Map<domain::Price, OrderQueue, std::greater<domain::Price>> m_buyBook;
+    Map<domain::Price, OrderQueue> m_sellBook;
+
+    StopBook m_stops;
+
+    marketdata::L2Publisher* m_l2{nullptr};
 };
\ No newline at end of file
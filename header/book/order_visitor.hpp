@@ -0,0 +1,9 @@
+#pragma once
+
+#include "domain/order.hpp"
+
+#include <functional>
+
+// Called once per order a bulk operation (cancelAll / cancelSymbol) removes, in book
+// order, while the order is still intact.
+using OrderVisitor = std::function<void(const domain::Order&)>;
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "book/order_visitor.hpp"
+#include "domain/order.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Parked stop (Market) and stop-limit (Limit / IOC) orders, kept apart from the price
+// levels in one trigger book per symbol.
+//
+// A BUY stop triggers on a trade at or above its stop price, a SELL stop on a trade at or
+// below it. Each side is sorted in the order its stops trigger as the price moves away
+// from them (BUY: lowest stop first, SELL: highest first; FIFO among equal stop prices),
+// so everything a trade crosses is one prefix of each side: release() finds its end with
+// one upper_bound and drops it with one range erase, O(log n + released).
+//
+// It also keeps each symbol's last trade price, which decides whether an S crosses its
+// stop already when it arrives.
+//
+// Owned by the book backends (stops()), so it is cleared, snapshotted and recovered
+// together with the levels.
+class StopBook {
+public:
+    // `stopPrice` is the order's trigger; the order itself is what enters the book.
+    using StopVisitor = std::function<void(const domain::Order&, domain::Price stopPrice)>;
+
+    // false => the id is already parked
+    bool park(const domain::Order& order, domain::Price stopPrice);
+    bool contains(domain::OrderId id) const { return m_byId.count(id) != 0; }
+    bool erase(domain::OrderId id);
+
+    // Moves every stop of `symbol` crossed by a trade at `tradePrice` to the end of `out`:
+    // BUY stops first, then SELL stops, each in trigger order. Returns how many.
+    std::size_t release(const domain::Symbol& symbol, domain::Price tradePrice, std::vector<domain::Order>& out);
+
+    // A trade of `symbol` at `price` that a stop arriving later is checked against.
+    void recordTrade(const domain::Symbol& symbol, domain::Price price) { m_lastTrade[symbol] = price; }
+    // 0 => no trade of `symbol` yet
+    domain::Price lastTrade(const domain::Symbol& symbol) const {
+        const auto it = m_lastTrade.find(symbol);
+        return it == m_lastTrade.end() ? 0 : it->second;
+    }
+    // true => a stop of `side` at `stopPrice` is crossed by a trade at `tradePrice`
+    static bool crossed(domain::Side side, domain::Price stopPrice, domain::Price tradePrice) {
+        return side == domain::Side::Buy ? tradePrice >= stopPrice : tradePrice <= stopPrice;
+    }
+    // Symbols in no particular order; for snapshots.
+    void forEachLastTrade(const std::function<void(const domain::Symbol&, domain::Price)>& visit) const;
+
+    // Same visiting order as release(); the book's mass cancel calls these after its own.
+    std::size_t cancelSymbol(const domain::Symbol& symbol, domain::Side side, const OrderVisitor& onCancel);
+    std::size_t cancelAll(const OrderVisitor& onCancel);
+
+    // Symbol by symbol (sorted), BUY stops then SELL stops, in trigger order.
+    void forEach(const StopVisitor& visit) const;
+    void dump(std::ostream& os) const;
+
+    std::size_t size() const { return m_byId.size(); }
+    bool empty() const { return m_byId.empty(); }
+    void clear();  // last trades included
+
+private:
+    struct StopKey {
+        domain::Price stopPrice;
+        std::uint64_t seq;  // arrival order among equal stop prices
+    };
+    struct LowestFirst {
+        bool operator()(const StopKey& a, const StopKey& b) const {
+            return a.stopPrice != b.stopPrice ? a.stopPrice < b.stopPrice : a.seq < b.seq;
+        }
+    };
+    struct HighestFirst {
+        bool operator()(const StopKey& a, const StopKey& b) const {
+            return a.stopPrice != b.stopPrice ? a.stopPrice > b.stopPrice : a.seq < b.seq;
+        }
+    };
+
+    struct SymbolStops {
+        std::map<StopKey, domain::Order, LowestFirst> buy;
+        std::map<StopKey, domain::Order, HighestFirst> sell;
+    };
+    using Symbols = std::map<domain::Symbol, SymbolStops>;
+
+    struct Location {
+        Symbols::iterator symbol;
+        domain::Side side;
+        StopKey key;
+    };
+
+    template <typename Side>
+    void releaseUpTo(Side& side, typename Side::iterator end, std::vector<domain::Order>& out);
+    template <typename Side>
+    std::size_t cancelSide(Side& side, const OrderVisitor& onCancel);
+    void dropIfEmpty(Symbols::iterator it);
+
+    Symbols m_symbols;
+    std::unordered_map<domain::OrderId, Location> m_byId;
+    std::unordered_map<domain::Symbol, domain::Price> m_lastTrade;  // outlives the symbol's stops
+    std::uint64_t m_seq{0};
+};
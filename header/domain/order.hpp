@@ -1,7 +1,9 @@
 #pragma once
 
+#include "domain/symbol.hpp"
 #include "domain/types.hpp"
 
+#include <cstddef>  // offsetof
 #include <cstdlib>  // std::llabs
 #include <iomanip>
 #include <ostream>
@@ -9,16 +11,25 @@
 
 namespace domain {
 
+// Hot fields first: matching reads only the first kHotBytes (id, price, quantity, type,
+// side); the time stamps and the symbol follow, so a book node can keep its links and the
+// hot part of the order in one cache line.
 struct Order {
     OrderId orderId{};
-    Timestamp timeStamp{};
-    std::string symbol{};
-    OrderType orderType{OrderType::Limit};
-    Side side{Side::Buy};
     Price price{};  // cents
     int quantity{};
+    OrderType orderType{OrderType::Limit};
+    Side side{Side::Buy};
+    // cold
+    Timestamp timeStamp{};
+    Timestamp expireAt{};  // good-till-time; 0 => rests until filled or cancelled
+    Symbol symbol{};
 };
 
+inline constexpr std::size_t kHotBytes = offsetof(Order, timeStamp);
+static_assert(kHotBytes == 24);
+static_assert(sizeof(Order) == 56);
+
 // Mały helper tylko do debug-print (jedno źródło prawdy w tym pliku)
 inline void printPrice(std::ostream& os, Price p) {
     const auto whole = p / 100;
@@ -52,8 +63,10 @@ inline std::ostream& operator<<(std::ostream& os, const Order& o) {
        << ", side=" << toChar(o.side)
        << ", price=";
     printPrice(os, o.price);
-    os << ", qty=" << o.quantity
-       << "}";
+    os << ", qty=" << o.quantity;
+    if (o.expireAt != 0)
+        os << ", exp=" << o.expireAt;
+    os << "}";
     return os;
 }
 
@@ -0,0 +1,73 @@
+// header/domain/symbol.hpp
+#pragma once
+
+#include <algorithm>  // std::min
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>  // std::memcmp
+#include <functional>  // std::hash
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace domain {
+
+// Ticker kept inline: up to kCapacity chars plus a length byte, 16 bytes in all.
+// Trivially copyable, so a command holding one can be memcpy'd and never allocates.
+//
+// Longer input is cut to kCapacity chars and flagged (tooLong()); such a symbol never
+// compares equal to one that fits, and the handlers reject it like any invalid symbol.
+// Two over-long symbols sharing their first kCapacity chars do compare (and hash) equal,
+// so one is only good for being rejected and must never be used as a key.
+// No implicit conversion back to text (view() / str()), so == against a string literal
+// goes through Symbol's own operator== and stays unambiguous.
+class Symbol {
+public:
+    static constexpr std::size_t kCapacity = 15;
+
+    constexpr Symbol() = default;
+    constexpr Symbol(std::string_view s) { assign(s); }
+    constexpr Symbol(const char* s)
+        : Symbol(std::string_view(s)) {}
+    Symbol(const std::string& s)
+        : Symbol(std::string_view(s)) {}
+
+    constexpr const char* data() const { return m_chars.data(); }
+    constexpr std::size_t size() const { return std::min<std::size_t>(m_size, kCapacity); }
+    constexpr bool empty() const { return m_size == 0; }
+    constexpr bool tooLong() const { return m_size > kCapacity; }
+    constexpr const char* begin() const { return data(); }
+    constexpr const char* end() const { return data() + size(); }
+
+    constexpr std::string_view view() const { return std::string_view(data(), size()); }
+    std::string str() const { return std::string(view()); }
+
+    friend bool operator==(const Symbol& a, const Symbol& b) {
+        return a.m_size == b.m_size && std::memcmp(a.m_chars.data(), b.m_chars.data(), a.size()) == 0;
+    }
+    friend bool operator<(const Symbol& a, const Symbol& b) { return a.view() < b.view(); }
+
+private:
+    constexpr void assign(std::string_view s) {
+        const std::size_t n = std::min(s.size(), kCapacity);
+        for (std::size_t i = 0; i < n; ++i) {
+            m_chars[i] = s[i];
+        }
+        m_size = static_cast<std::uint8_t>(s.size() > kCapacity ? kCapacity + 1 : n);
+    }
+
+    std::array<char, kCapacity> m_chars{};
+    std::uint8_t m_size{0};  // kCapacity + 1 => tooLong()
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Symbol& s) {
+    return os << s.view();
+}
+
+}  // namespace domain
+
+template <>
+struct std::hash<domain::Symbol> {
+    std::size_t operator()(const domain::Symbol& s) const noexcept { return std::hash<std::string_view>{}(s.view()); }
+};
@@ -1,10 +1,16 @@
 #pragma once
 
+#include "book/book_backend.hpp"
 #include "book/order_book.hpp"
 #include "domain/order.hpp"
 
 #include <optional>
 #include <string>
+#include <string_view>
+
+namespace risk {
+class RiskChecker;
+}
 
 struct AmendRequest {
     domain::OrderId orderId{};
@@ -12,7 +18,7 @@ struct AmendRequest {
 
     // Te pola przychodzą w komendzie A i służą do weryfikacji,
     // że nie próbujesz zmieniać "niemodyfikowalnych" pól.
-    std::string symbol{};
+    domain::Symbol symbol{};
     domain::OrderType orderType{};
     domain::Side side{};
 
@@ -29,24 +35,31 @@ struct AmendResult {
 
     // 101 - invalid amendment details
     // 404 - order does not exist
+    // 305 - pre-trade risk limit (message names it)
     int rejectCode{101};
-    std::string rejectMessage{"Invalid amendement details"};  // trzymam pisownię jak w specu
+    std::string_view rejectMessage{"Invalid amendement details"};  // static text; trzymam pisownię jak w specu
 };
 
+// Instantiated for OrderBook and IndexedOrderBook in src/engine/amend.cpp.
+template <BookBackend Book = OrderBook>
 class AmendHandler {
 public:
-    explicit AmendHandler(OrderBook& book);
+    explicit AmendHandler(Book& book);
 
     AmendResult execute(const AmendRequest& req);
 
+    // The amended price / quantity also go through `risk` (nullptr detaches).
+    void attachRisk(risk::RiskChecker* risk) { m_risk = risk; }
+
     static std::string format(const AmendResult& r);
 
 private:
-    bool isAlphaSymbol(const std::string& s) const;
+    bool isAlphaSymbol(const domain::Symbol& s) const;
 
     // walidacja reguł A (bez parsowania!)
     bool isValidAmendRequest(const AmendRequest& req) const;
 
 private:
-    OrderBook& m_book;
+    Book& m_book;
+    risk::RiskChecker* m_risk{nullptr};
 };
\ No newline at end of file
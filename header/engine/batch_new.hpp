@@ -0,0 +1,72 @@
+#pragma once
+
+#include "book/book_backend.hpp"
+#include "book/order_book.hpp"
+#include "domain/order.hpp"
+#include "risk/risk_checker.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// B,<Timestamp>,<Symbol>,<OrderID>,<OrderType>,<Side>,<Price>,<Quantity>[,<OrderID>,...]
+// N orders sharing a symbol and timestamp; each one is accepted / rejected exactly as
+// the same N line would be, in batch order.
+inline constexpr std::size_t kMaxBatchOrders = 256;
+
+struct BatchOrder {
+    domain::OrderId orderId{};
+    domain::OrderType orderType{domain::OrderType::Limit};
+    domain::Side side{domain::Side::Buy};
+    domain::Price price{};
+    int quantity{};
+};
+
+struct BatchNewRequest {
+    domain::Timestamp timeStamp{};
+    domain::Symbol symbol{};
+    std::vector<BatchOrder> orders{};
+};
+
+struct BatchNewResult {
+    domain::OrderId orderId{};
+    bool accepted{false};
+    // None => a reject is 303 - Invalid order details, as for N; otherwise 305 - <reason>
+    risk::RiskReject riskReject{risk::RiskReject::None};
+};
+
+struct BatchNewResponse {
+    std::vector<BatchNewResult> results{};  // one per order, batch order
+    std::size_t accepted{0};
+};
+
+// Validates the shared fields once, then hands all valid orders to Book::addBatch(),
+// which resolves the symbol once. The parser refuses a B line over kMaxBatchOrders; a
+// request built in code with more is rejected whole.
+// Instantiated for OrderBook and IndexedOrderBook in src/engine/batch_new.cpp.
+template <BookBackend Book = OrderBook>
+class BatchNewHandler {
+public:
+    explicit BatchNewHandler(Book& book);
+
+    BatchNewResponse execute(const BatchNewRequest& req);
+
+    // Valid orders also go through `risk`, in batch order (nullptr detaches).
+    void attachRisk(risk::RiskChecker* risk) { m_risk = risk; }
+
+    // One N-style line per order ("<OrderID> - Accept" / "<OrderID> - Reject - 303 - ..." / 305),
+    // written straight to `os`.
+    static void format(std::ostream& os, const BatchNewResponse& r);
+
+private:
+    static bool isValidShared(const BatchNewRequest& req);
+    static bool isValidOrder(const BatchOrder& o);
+    // `id` among the first `kept` orders of m_valid
+    bool takenEarlier(domain::OrderId id, std::size_t kept) const;
+
+    Book& m_book;
+    risk::RiskChecker* m_risk{nullptr};
+    std::vector<domain::Order> m_valid;  // scratch, reused across batches
+    std::vector<std::size_t> m_slots;    // m_valid[i] answers results[m_slots[i]]
+};
@@ -1,9 +1,15 @@
 #pragma once
 
+#include "book/book_backend.hpp"
 #include "book/order_book.hpp"
 #include "domain/order.hpp"
 
 #include <string>
+#include <string_view>
+
+namespace risk {
+class RiskChecker;
+}
 
 struct CancelRequest {
     domain::OrderId orderId{};
@@ -17,18 +23,24 @@ struct CancelResponse {
     // 101 - invalid cancel details
     // 404 - order does not exist
     int rejectCode{101};
-    std::string rejectMessage{"Invalid cancel details"};
+    std::string_view rejectMessage{"Invalid cancel details"};  // static text
 };
 
+// Instantiated for OrderBook and IndexedOrderBook in src/engine/cancel.cpp.
+template <BookBackend Book = OrderBook>
 class CancelHandler {
 public:
-    explicit CancelHandler(OrderBook& book);
+    explicit CancelHandler(Book& book);
 
     CancelResponse execute(const CancelRequest& req);
 
+    // A cancelled order's quantity leaves the open quantity of `risk` (nullptr detaches).
+    void attachRisk(risk::RiskChecker* risk) { m_risk = risk; }
+
     static std::string format(const CancelResponse& res);
 
 private:
     bool isValidCancelRequest(const CancelRequest& req) const;
-    OrderBook& m_book;
+    Book& m_book;
+    risk::RiskChecker* m_risk{nullptr};
 };
\ No newline at end of file
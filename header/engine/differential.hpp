@@ -0,0 +1,80 @@
+#pragma once
+
+#include "book/book_backend.hpp"
+#include "engine/dispatcher.hpp"
+#include "parser/commands_parser.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+// First point where two book backends disagree on the same command stream.
+struct BookDivergence {
+    std::size_t line{0};  // 0-based index into the stream
+    std::string command;
+    std::string what;      // "output" or "state"
+    std::string expected;  // reference output / dump
+    std::string actual;    // candidate output / dump
+};
+
+namespace detail {
+
+// The expiries the command's timestamp triggers come first, as in the app.
+template <BookBackend Book>
+std::string runCommand(CommandDispatcher<Book>& dispatcher, const ParsedCommand& cmd) {
+    std::ostringstream oss;
+    dispatcher.advanceClock(timestampOf(cmd), oss);
+    dispatcher.dispatchTo(cmd, oss);
+    return oss.str();
+}
+
+template <BookBackend Book>
+std::string bookState(const Book& book) {
+    std::ostringstream oss;
+    oss << "live=" << book.liveCount() << " buy=" << book.buyCount() << " sell=" << book.sellCount() << "\n";
+    book.dump(oss);
+    return oss.str();
+}
+
+}  // namespace detail
+
+// Replays `lines` through a Reference and a Candidate backend in lockstep. Every
+// response must match; the dumps and counts are compared every `stateCheckEvery`
+// lines (0 => only at the end) and after the last line. Unparsable lines are skipped,
+// as the app does. Returns nullopt when the backends agree throughout.
+template <BookBackend Reference, BookBackend Candidate>
+std::optional<BookDivergence> runDifferential(const std::vector<std::string>& lines, std::size_t stateCheckEvery = 1) {
+    Reference referenceBook;
+    Candidate candidateBook;
+    CommandDispatcher<Reference> reference(referenceBook);
+    CommandDispatcher<Candidate> candidate(candidateBook);
+
+    auto checkState = [&](std::size_t i) -> std::optional<BookDivergence> {
+        auto expected = detail::bookState(referenceBook);
+        auto actual = detail::bookState(candidateBook);
+        if (expected == actual)
+            return std::nullopt;
+        return BookDivergence{i, i < lines.size() ? lines[i] : std::string{}, "state", std::move(expected),
+                              std::move(actual)};
+    };
+
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        const auto cmd = parseCommandLine(lines[i]);
+        if (!cmd)
+            continue;
+
+        auto expected = detail::runCommand(reference, *cmd);
+        auto actual = detail::runCommand(candidate, *cmd);
+        if (expected != actual)
+            return BookDivergence{i, lines[i], "output", std::move(expected), std::move(actual)};
+
+        if (stateCheckEvery != 0 && (i + 1) % stateCheckEvery == 0) {
+            if (auto d = checkState(i))
+                return d;
+        }
+    }
+    return lines.empty() ? std::nullopt : checkState(lines.size() - 1);
+}
@@ -1,28 +1,166 @@
 #pragma once
 
+#include <iosfwd>
+#include <memory>
 #include <string>
 
+#include "book/book_backend.hpp"
 #include "book/order_book.hpp"
 
 #include "engine/amend.hpp"   // AmendCommandHandler / AmendCommandResponse
+#include "engine/batch_new.hpp"  // BatchNewHandler / BatchNewResponse
 #include "engine/cancel.hpp"  // CancelCommandHandler / CancelCommandResponse
+#include "engine/expiry_wheel.hpp"
+#include "engine/mass_cancel.hpp"  // MassCancelHandler / MassCancelResponse
+#include "engine/match.hpp"   // MatchHandler / MatchResponse
 #include "engine/new.hpp"     // NewCommandHandler / NewCommandResponse
+#include "engine/query.hpp"   // QueryHandler / QueryResponse
+#include "engine/stop.hpp"    // StopOrderHandler
+
+#include "metrics/dispatch_metrics.hpp"
+#include "metrics/tsc.hpp"  // HFT_LATENCY_METRICS
 
 #include "parser/commands_parser.hpp"  // ParsedCommand
 
+namespace marketdata {
+class L2Publisher;
+class TopOfBookConflator;
+class TradeStats;
+}
+
+class ResponseWriter;
+
+namespace persistence {
+class JournalWriter;
+}
+
+namespace risk {
+class RiskChecker;
+}
+
+// Latency / perf-counter bucket of a command.
+metrics::MessageType messageTypeOf(const ParsedCommand& cmd);
+
+// The book backend is a compile-time policy; OrderBook is the reference and the one
+// the app, journal and snapshots use. Instantiated for OrderBook and IndexedOrderBook
+// in src/engine/dispatcher.cpp.
+template <BookBackend Book = OrderBook>
 class CommandDispatcher {
 public:
-    explicit CommandDispatcher(OrderBook& book);
+    explicit CommandDispatcher(Book& book);
+    ~CommandDispatcher();
+
+    // Any command, its response lines written to `out` ('\n'-terminated, as the app prints
+    // them). The one place that routes a ParsedCommand to the functions below.
+    void dispatchTo(const ParsedCommand& cmd, std::ostream& out);
 
-    // Takes a parsed command and returns a formatted output line
+    // Takes a parsed command and returns its formatted output: one line for N/A/X/S; for
+    // M/Q/B/C the lines of dispatchTo() joined by '\n' (built in one string - prefer dispatchTo()).
     std::string dispatch(const ParsedCommand& cmd);
     std::vector<std::string> dispatchMatch(const ParsedCommand& cmd);
+    // Q: read-only, one or more lines, never journaled
+    std::vector<std::string> dispatchQuery(const ParsedCommand& cmd);
+    // C: one "<id> - CancelAccept" line per dropped order written to `out` as the
+    // orders leave the book, then the summary line; returns the number cancelled.
+    std::size_t dispatchMassCancel(const ParsedCommand& cmd, std::ostream& out);
+    // B: one N-style line per order written to `out` in one go; returns how many were accepted.
+    std::size_t dispatchBatch(const ParsedCommand& cmd, std::ostream& out);
+    // Any command, with its response pushed to `writer` as typed records (N/A/X/S/M/B/C; C
+    // one per dropped order, as they leave) to be formatted on the writer's thread; Q is
+    // still formatted here and pushed as text.
+    // The output is the same lines, in the same order, as the functions above.
+    void dispatchDeferred(const ParsedCommand& cmd, ResponseWriter& writer);
+
+    // Executes any command (N/B/A/X/S/M/C; Q is a no-op) without formatting and without journaling.
+    // Used to rebuild the book on restart. Expiries are not run here: live ones reach the
+    // journal as X records (see advanceClock()).
+    void apply(const ParsedCommand& cmd);
+
+    // Good-till-time: moves the expiry clock to `now` (normally timestampOf() of the command
+    // about to be dispatched) and removes every resting order whose expiry is <= now, writing
+    // "<id> - Expired" for each to `out`. Each expiry is journaled as an X of that order, so
+    // a replay does not depend on the clock. Returns how many orders expired. An N whose
+    // expiry is already <= the clock is rejected 303 instead of resting.
+    std::size_t advanceClock(domain::Timestamp now, std::ostream& out);
+    std::size_t advanceClock(domain::Timestamp now, ResponseWriter& writer);
+    // Schedules the expiry of every GTT order already in the book, e.g. after recovery.
+    void rescheduleExpiries();
+    std::size_t pendingExpiries() const { return m_wheel.size(); }
+
+    // Every command that changes the book (accepted N/A/X, B or C that changed anything, M with fills)
+    // is appended to the journal before its response is returned; a B with rejects is journaled
+    // with its accepted orders only.
+    // nullptr detaches.
+    void attachJournal(persistence::JournalWriter* journal);
+
+    // Attaches `publisher` to the book (level deltas, trades) and publishes the
+    // snapshots it has due after each N/B/A/X/M/C, once the command is fully applied.
+    // nullptr detaches.
+    void attachMarketData(marketdata::L2Publisher* publisher);
+    // Refreshed at the same point from the symbols whose levels changed during the
+    // command; it has to be (one of) the sinks of the attached publisher.
+    void attachTopOfBook(marketdata::TopOfBookConflator* conflator);
+    void publishMarketData();
+
+    // Per-symbol trade statistics updated by every fill of M (replays through apply() included).
+    void attachTradeStats(marketdata::TradeStats* stats);
+
+    // Pre-trade limits for N / B / A / S (reject 305), fed with every change of open quantity
+    // and every fill. Attach it to a dispatcher whose book it has seen from the start, or
+    // call risk->rebuildOpen(book) first. nullptr detaches.
+    void attachRisk(risk::RiskChecker* risk);
+
+    // Latency histograms of dispatch()/dispatchMatch(); nullptr when built with
+    // HFT_LATENCY_METRICS=0. reportLatency() prints a note in that case.
+    const metrics::DispatchMetrics* latencyMetrics() const;
+    void reportLatency(std::ostream& os) const;
+
+    // Time only every n-th message (default 1 = all). The two counter reads are the
+    // whole probe cost, so sampling divides it; fills per M are always recorded.
+    void setLatencySampling(std::uint32_t every);
 
 private:
-    OrderBook& m_book;
+    std::uint64_t startProbe();
+    void recordLatency(metrics::MessageType type, bool accepted, std::uint64_t startTsc);
+
+    // The bodies of dispatch() / dispatchMatch() / advanceClock(); `emit` receives the
+    // response (an expired order id) in place of the formatting step.
+    template <typename Emit>
+    void dispatchWith(const ParsedCommand& cmd, Emit&& emit);
+    template <typename Emit>
+    void dispatchMatchWith(const ParsedCommand& cmd, Emit&& emit);
+    // B / C bodies: `emit` receives the response, `ack` each order C drops.
+    template <typename Emit>
+    std::size_t dispatchBatchWith(const ParsedCommand& cmd, Emit&& emit);
+    template <typename Ack, typename Emit>
+    std::size_t dispatchMassCancelWith(const ParsedCommand& cmd, Ack&& ack, Emit&& emit);
+    template <typename Emit>
+    std::size_t expireWith(domain::Timestamp now, Emit&& emit);
+
+    Book& m_book;
+
+    NewCommandHandler<Book> m_new;
+    BatchNewHandler<Book> m_batch;
+    AmendHandler<Book> m_amend;
+    CancelHandler<Book> m_cancel;
+    MassCancelHandler<Book> m_massCancel;
+    MatchHandler<Book> m_match;
+    QueryHandler<Book> m_query;
+    StopOrderHandler<Book> m_stop;
+
+    // orders with expireAt != 0; fills / amends are not tracked, an entry is checked
+    // against the book when it fires
+    ExpiryWheel m_wheel;
+    domain::Timestamp m_clock{0};  // latest advanceClock() time; the wheel skips it while empty
+
+    persistence::JournalWriter* m_journal{nullptr};
+    marketdata::L2Publisher* m_l2{nullptr};
+    marketdata::TopOfBookConflator* m_top{nullptr};
+    risk::RiskChecker* m_risk{nullptr};
 
-    NewCommandHandler m_new;
-    AmendHandler m_amend;
-    CancelHandler m_cancel;
-    MatchHandler m_match;
-};
\ No newline at end of file
+#if HFT_LATENCY_METRICS
+    std::unique_ptr<metrics::DispatchMetrics> m_metrics;  // ~270 KiB of buckets, kept off the stack
+    std::uint32_t m_sampleEvery{1};
+    std::uint32_t m_sampleCountdown{1};
+#endif
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "domain/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Hierarchical timing wheel of good-till-time expiries, in command timestamp units.
+//
+// 11 levels of 64 slots cover the whole 64-bit range: an entry sits at the level of the
+// highest base-64 digit in which its expiry differs from the wheel's clock, in the slot
+// named by that digit. Reaching a slot at level L > 0 re-files its entries at lower
+// levels, so each entry moves at most 10 times. A 64-bit occupancy mask per level lets
+// advance() jump straight to the next non-empty slot, however far time moves.
+//
+// schedule() / cancel() are O(1) (pooled nodes in intrusive lists, an id index).
+// An id scheduled again replaces its earlier entry in the index; the earlier entry
+// still fires, so the caller checks what it gets against the order it has.
+class ExpiryWheel {
+public:
+    ExpiryWheel();
+
+    void schedule(domain::OrderId id, domain::Timestamp expireAt);
+    bool cancel(domain::OrderId id);
+
+    // Moves the clock to `now` (never backwards) and calls fn(id, expireAt) for every
+    // entry with expireAt <= now, in expiry order (ones scheduled already late go first).
+    template <typename Fn>
+    std::size_t advance(domain::Timestamp now, Fn&& fn) {
+        std::size_t fired = 0;
+        const std::uint64_t target = now > 0 ? static_cast<std::uint64_t>(now) : 0;
+        while (true) {
+            if (m_due != kNil) {
+                fired += fireList(fn);
+                continue;
+            }
+            if (target <= m_now || !moveToNextSlot(target))
+                break;
+        }
+        if (target > m_now)
+            m_now = target;
+        return fired;
+    }
+
+    std::size_t size() const { return m_index.size(); }
+    bool empty() const { return m_index.empty(); }
+    domain::Timestamp now() const { return static_cast<domain::Timestamp>(m_now); }
+
+    void clear();
+
+private:
+    static constexpr std::size_t kLevels = 11;  // 11 x 6 bits >= 64
+    static constexpr std::size_t kSlots = 64;
+    static constexpr std::uint32_t kNil = UINT32_MAX;
+    static constexpr std::uint16_t kDueList = kLevels * kSlots;
+
+    struct Node {
+        domain::OrderId id{};
+        std::uint64_t at{};
+        std::uint32_t prev{kNil};
+        std::uint32_t next{kNil};
+        std::uint16_t list{0};  // level * kSlots + slot, or kDueList
+    };
+
+    void file(std::uint32_t n);  // into the list its expiry and m_now call for
+    void pushBack(std::uint16_t list, std::uint32_t n);
+    void unlink(std::uint32_t n);
+    std::uint32_t& headOf(std::uint16_t list) { return list == kDueList ? m_due : m_heads[list]; }
+    std::uint32_t& tailOf(std::uint16_t list) { return list == kDueList ? m_dueTail : m_tails[list]; }
+    bool moveToNextSlot(std::uint64_t target);  // false => nothing due until target
+    void release(std::uint32_t n);
+
+    // Pops the due list (everything with at <= m_now) in order.
+    template <typename Fn>
+    std::size_t fireList(Fn& fn) {
+        std::size_t fired = 0;
+        while (m_due != kNil) {
+            const std::uint32_t n = m_due;
+            unlink(n);
+            const Node node = m_nodes[n];
+            const auto it = m_index.find(node.id);
+            if (it != m_index.end() && it->second == n)
+                m_index.erase(it);
+            release(n);
+            fn(node.id, static_cast<domain::Timestamp>(node.at));
+            ++fired;
+        }
+        return fired;
+    }
+
+    std::uint64_t m_now{0};
+    std::array<std::uint32_t, kLevels * kSlots> m_heads{};
+    std::array<std::uint32_t, kLevels * kSlots> m_tails{};
+    std::array<std::uint64_t, kLevels> m_occupied{};
+    std::uint32_t m_due{kNil};
+    std::uint32_t m_dueTail{kNil};
+
+    std::vector<Node> m_nodes;
+    std::uint32_t m_free{kNil};
+    std::unordered_map<domain::OrderId, std::uint32_t> m_index;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "book/book_backend.hpp"
+#include "book/order_book.hpp"
+#include "book/order_visitor.hpp"
+#include "domain/order.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+// C forms (journaled like X):
+//   C,<Timestamp>                        every order in the book
+//   C,<Timestamp>,<Symbol>               both sides of one symbol
+//   C,<Timestamp>,<Symbol>,<Side>        one side of one symbol
+enum class MassCancelScope : std::uint8_t {
+    All,
+    Symbol,
+    SymbolSide
+};
+
+struct MassCancelRequest {
+    domain::Timestamp timeStamp{};
+    MassCancelScope scope{MassCancelScope::All};
+    domain::Symbol symbol{};               // Symbol / SymbolSide
+    domain::Side side{domain::Side::Buy};  // SymbolSide
+};
+
+struct MassCancelResponse {
+    MassCancelScope scope{MassCancelScope::All};
+    domain::Symbol symbol{};
+    domain::Side side{domain::Side::Buy};
+
+    bool accepted{false};
+    // 101 - invalid mass cancel details
+    int rejectCode{101};
+    std::string_view rejectMessage{"Invalid mass cancel details"};  // static text
+
+    std::size_t cancelled{0};
+};
+
+// Drops whole scopes through the book's bulk primitives; the per-order acks go to
+// `onCancel` as the orders leave, so a huge flatten is never collected in memory.
+// Parked stops of the scope go after the resting orders, through `onStopCancel`.
+// `cancelled` counts both.
+// Instantiated for OrderBook and IndexedOrderBook in src/engine/mass_cancel.cpp.
+template <BookBackend Book = OrderBook>
+class MassCancelHandler {
+public:
+    explicit MassCancelHandler(Book& book);
+
+    MassCancelResponse execute(const MassCancelRequest& req,
+                               const OrderVisitor& onCancel,
+                               const OrderVisitor& onStopCancel);
+
+    // Per order: "<OrderID> - CancelAccept" (same line as X), written straight to `os`.
+    static void formatAck(std::ostream& os, const domain::Order& order);
+    // Summary after the acks: "<Scope> - MassCancelAccept - <Count>", scope being
+    // "*", "<Symbol>" or "<Symbol>,<Side>"; a reject is "<Scope> - MassCancelReject - <Code> - <Message>".
+    static std::string format(const MassCancelResponse& res);
+
+private:
+    bool isValidMassCancel(const MassCancelRequest& req) const;
+
+    Book& m_book;
+};
@@ -1,17 +1,28 @@
 #pragma once
 
+#include "book/book_backend.hpp"
 #include "book/order_book.hpp"
 
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <vector>
+
+namespace marketdata {
+class TradeStats;
+}
+
+namespace risk {
+class RiskChecker;
+}
 
 struct MatchRequest {
     domain::Timestamp timestamp{};
-    std::optional<std::string> symbol;  // if empty → match all symbols
+    std::optional<domain::Symbol> symbol;  // if empty → match all symbols
 };
 
 struct TradeEvent {
-    std::string symbol;
+    domain::Symbol symbol;
 
     domain::OrderId buyOrderId{};
     domain::OrderId sellOrderId{};
@@ -23,19 +34,42 @@ struct TradeEvent {
     domain::Price executionPrice{};
 };
 
+// A parked stop released by a fill and added to the book, where the same M may fill it.
+struct StopTrigger {
+    std::size_t afterEvents{};  // number of trades before it, i.e. printed after events[afterEvents - 1]
+    domain::OrderId orderId{};
+};
+
 struct MatchResponse {
     std::vector<TradeEvent> events;
+    std::vector<StopTrigger> triggered;
 };
 
+// Instantiated for OrderBook and IndexedOrderBook in src/engine/match.cpp.
+template <BookBackend Book = OrderBook>
 class MatchHandler {
 public:
-    explicit MatchHandler(OrderBook& book);
+    explicit MatchHandler(Book& book);
 
     MatchResponse execute(const MatchRequest& req);
 
-    // Helper to format output exactly as required by spec
+    // Every fill is also recorded into `stats` (nullptr detaches).
+    void attachTradeStats(marketdata::TradeStats* stats) { m_stats = stats; }
+    // ... and into `risk`: the last trade price and the open quantity of both sides.
+    void attachRisk(risk::RiskChecker* risk) { m_risk = risk; }
+
+    // Helper to format output exactly as required by spec; every stop a fill triggered
+    // follows that fill's line as "<OrderID> - Triggered".
     static std::vector<std::string> format(const MatchResponse& response);
 
 private:
-    OrderBook& m_book;
+    // After each fill: the stops of `symbol` the trade crossed enter the book in trigger
+    // order with the M's timestamp.
+    void releaseStops(const domain::Symbol& symbol, domain::Price tradePrice, domain::Timestamp ts,
+                      MatchResponse& response);
+
+    Book& m_book;
+    marketdata::TradeStats* m_stats{nullptr};
+    risk::RiskChecker* m_risk{nullptr};
+    std::vector<domain::Order> m_released;  // scratch of releaseStops(), keeps its capacity
 };
\ No newline at end of file
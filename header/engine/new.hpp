@@ -1,9 +1,15 @@
 #pragma once
 
+#include "book/book_backend.hpp"
 #include "book/order_book.hpp"
 #include "domain/order.hpp"
 
 #include <string>
+#include <string_view>
+
+namespace risk {
+class RiskChecker;
+}
 
 struct NewCommandResponse {
     // only for store the result of the command
@@ -11,23 +17,33 @@ struct NewCommandResponse {
     bool accepted{false};
 
     // for reject
+    // 303 - invalid order details
+    // 305 - pre-trade risk limit (message names it)
     int rejectCode{303};
-    std::string rejectMessage{"Invalid order details"};
+    std::string_view rejectMessage{"Invalid order details"};  // static text
 };
 
 // This class handles ONLY the business logic for N (New) command.
+// Instantiated for OrderBook and IndexedOrderBook in src/engine/new.cpp.
+template <BookBackend Book = OrderBook>
 class NewCommandHandler {
 public:
-    explicit NewCommandHandler(OrderBook& book);
+    explicit NewCommandHandler(Book& book);
 
     NewCommandResponse execute(const domain::Order& order) const;
 
+    // Orders that pass validation also go through `risk` (nullptr detaches).
+    void attachRisk(risk::RiskChecker* risk) { m_risk = risk; }
+
     // helper to format exactly as required
     static std::string format(const NewCommandResponse& r);
 
+    // Field rules of N (S applies them to the order it parks).
+    static bool isValidNew(const domain::Order& order);
+
 private:
-    bool isValidNew(const domain::Order& order) const;
-    static bool isAlphaSymbol(const std::string& s);
+    static bool isAlphaSymbol(const domain::Symbol& s);
 
-    OrderBook& m_book;
+    Book& m_book;
+    risk::RiskChecker* m_risk{nullptr};
 };
\ No newline at end of file
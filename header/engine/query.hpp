@@ -0,0 +1,75 @@
+#pragma once
+
+#include "book/book_backend.hpp"
+#include "book/level_summary.hpp"
+#include "book/order_book.hpp"
+#include "domain/order.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Q forms (read-only, never journaled):
+//   Q,<Timestamp>,O,<OrderID>            order status
+//   Q,<Timestamp>,T,<Symbol>             top of book (= depth 1)
+//   Q,<Timestamp>,D,<Symbol>,<Levels>    aggregated depth, 1..kMaxQueryLevels levels
+enum class QueryKind : std::uint8_t {
+    Order,
+    Top,
+    Depth
+};
+
+inline constexpr int kMaxQueryLevels = 50;
+
+struct QueryRequest {
+    domain::Timestamp timeStamp{};
+    QueryKind kind{QueryKind::Top};
+    domain::OrderId orderId{};  // Order
+    domain::Symbol symbol{};    // Top / Depth
+    int levels{1};              // Depth
+};
+
+struct QueryResponse {
+    QueryKind kind{QueryKind::Top};
+    domain::OrderId orderId{};
+    domain::Symbol symbol{};
+
+    bool accepted{false};
+    // 101 - invalid query details
+    // 404 - order does not exist
+    int rejectCode{101};
+    std::string_view rejectMessage{"Invalid query details"};  // static text
+
+    domain::Order order{};  // Order
+
+    // Top / Depth, best first; fixed capacity so a query does not allocate
+    std::array<LevelSummary, kMaxQueryLevels> bids{};
+    std::array<LevelSummary, kMaxQueryLevels> asks{};
+    std::size_t bidLevels{0};
+    std::size_t askLevels{0};
+};
+
+// Answers Q from the book's indexes: order status is one id lookup, depth reads the
+// symbol's level totals (O(levels)); nothing scans the book.
+// Instantiated for OrderBook and IndexedOrderBook in src/engine/query.cpp.
+template <BookBackend Book = OrderBook>
+class QueryHandler {
+public:
+    explicit QueryHandler(const Book& book);
+
+    QueryResponse execute(const QueryRequest& req) const;
+
+    // Order: "<OrderID> - OrderStatus - <Symbol>,<OrderType>,<Side>,<Price>,<Quantity>".
+    // Top / Depth: one line per level, best first, a missing side left blank:
+    // "<Symbol>|<Orders>,<Qty>,<BidPrice>|<AskPrice>,<Qty>,<Orders>" ("<Symbol>||" if empty).
+    static std::vector<std::string> format(const QueryResponse& r);
+
+private:
+    bool isValidQuery(const QueryRequest& req) const;
+    static bool isAlphaSymbol(const domain::Symbol& s);
+
+    const Book& m_book;
+};
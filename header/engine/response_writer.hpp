@@ -0,0 +1,97 @@
+#pragma once
+
+#include "domain/symbol.hpp"
+#include "domain/types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class MassCancelScope : std::uint8_t;  // engine/mass_cancel.hpp
+
+// One response line as typed data, what CommandDispatcher would otherwise format on the
+// engine thread. Trivially copyable; rendered by renderResponse() into exactly the text
+// the dispatcher's format functions produce.
+enum class ResponseKind : std::uint8_t {
+    New,        // N and S: "<id> - Accept" / "<id> - Reject - <code> - <message>"
+    Amend,      // "<id> - AmendAccept" / "<id> - AmendReject - <code> - <message>"
+    Cancel,     // "<id> - CancelAccept" / "<id> - CancelReject - <code> - <message>"
+    Expired,    // "<id> - Expired"
+    Trade,      // "<symbol>|<buy id>,<type>,<qty>,<price>|<price>,<qty>,<type>,<sell id>"
+    Triggered,  // "<id> - Triggered"
+    MassCancel, // C summary: "<scope> - MassCancelAccept - <count>" / "<scope> - MassCancelReject - <code> - <message>"
+    Text        // lines formatted on the engine thread (Q), owned by the record
+};
+
+struct ResponseRecord {
+    ResponseKind kind{};
+    bool accepted{false};
+    domain::OrderType buyType{};   // Trade
+    domain::OrderType sellType{};  // Trade
+    int rejectCode{0};
+    domain::OrderId orderId{};      // Trade: the buy order
+    domain::OrderId sellOrderId{};  // Trade
+    int quantity{0};                // Trade
+    domain::Price price{0};         // Trade
+    domain::Symbol symbol{};        // Trade, MassCancel
+    MassCancelScope scope{};        // MassCancel
+    domain::Side side{};            // MassCancel
+    std::uint64_t count{0};         // MassCancel
+    std::string_view message{};     // reject text, always static
+    std::string* text{nullptr};     // Text, newline-terminated; deleted once rendered
+};
+static_assert(std::is_trivially_copyable_v<ResponseRecord>);
+
+// Appends the record's line(s), each terminated by '\n'.
+void renderResponse(const ResponseRecord& record, std::string& out);
+
+struct ResponseWriterStats {
+    std::uint64_t records{};
+    std::uint64_t writes{};     // batches handed to the stream
+    std::uint64_t fullWaits{};  // push() calls that found the ring full
+};
+
+// Deferred formatting: the engine thread push()es records into a single-producer /
+// single-consumer ring, a formatter thread renders them and writes the text to `out` in
+// batches of about batchBytes (less when the ring runs dry, then `out` is flushed as well,
+// so output never lags behind an idle engine). push() does no string work and no syscall; it only waits, yielding,
+// while the ring is full. `out` belongs to the formatter thread until close().
+class ResponseWriter {
+public:
+    explicit ResponseWriter(std::ostream& out, std::size_t capacity = 1u << 16, std::size_t batchBytes = 64u << 10);
+    ~ResponseWriter();  // close()
+
+    ResponseWriter(const ResponseWriter&) = delete;
+    ResponseWriter& operator=(const ResponseWriter&) = delete;
+
+    void push(const ResponseRecord& record);
+    void pushText(std::string text);  // newline-terminated lines
+
+    // Writes everything pushed so far, flushes `out` and joins the formatter. Idempotent.
+    void close();
+
+    ResponseWriterStats stats() const;  // complete after close()
+
+private:
+    void run();
+
+    std::ostream& m_out;
+    std::size_t m_batchBytes;
+    std::vector<ResponseRecord> m_ring;  // power-of-two size
+    std::uint64_t m_mask;
+
+    alignas(64) std::atomic<std::uint64_t> m_head{0};  // next slot to write (engine)
+    std::uint64_t m_cachedTail{0};                     // engine only, last m_tail seen
+    std::uint64_t m_fullWaits{0};                      // engine only
+    alignas(64) std::atomic<std::uint64_t> m_tail{0};  // next slot to render (formatter)
+    std::uint64_t m_writes{0};                         // formatter only
+    alignas(64) std::atomic<bool> m_closing{false};
+
+    std::thread m_thread;
+};
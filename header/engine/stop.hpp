@@ -0,0 +1,51 @@
+#pragma once
+
+#include "book/book_backend.hpp"
+#include "book/order_book.hpp"
+#include "domain/order.hpp"
+#include "engine/new.hpp"  // NewCommandResponse
+
+namespace risk {
+class RiskChecker;
+}
+
+// S,<OrderID>,<Timestamp>,<Symbol>,<OrderType>,<Side>,<Price>,<Quantity>,<StopPrice>
+// `order` is what enters the book once a trade crosses `stopPrice`: OrderType M makes
+// a stop, L / I a stop-limit (I as an IOC order).
+struct StopOrderRequest {
+    domain::Order order;
+    domain::Price stopPrice{};
+};
+
+// What a triggered stop enters the book as. A stop-limit is its order as it is; a stop
+// (Market) becomes a limit at the best opposite price - `triggerPrice` while that side is
+// empty - since a market order's price 0 never crosses in MatchHandler.
+template <BookBackend Book>
+domain::Order triggeredOrder(Book& book, domain::Order order, domain::Price triggerPrice) {
+    if (order.orderType != domain::OrderType::Market)
+        return order;
+    const domain::Order* best =
+        order.side == domain::Side::Buy ? book.bestAskOrder(order.symbol) : book.bestBidOrder(order.symbol);
+    order.orderType = domain::OrderType::Limit;
+    order.price = best ? best->price : triggerPrice;
+    return order;
+}
+
+// Parks S orders in the book's StopBook; MatchHandler releases them. An S whose stop the
+// symbol's last trade has already crossed enters the book at once instead.
+// Answers like N: "<id> - Accept" or "<id> - Reject - 303 / 305 - ...".
+// Instantiated for OrderBook and IndexedOrderBook in src/engine/stop.cpp.
+template <BookBackend Book = OrderBook>
+class StopOrderHandler {
+public:
+    explicit StopOrderHandler(Book& book);
+
+    NewCommandResponse execute(const StopOrderRequest& req) const;
+
+    // Checked like an N of the same order when parked; not again when it triggers.
+    void attachRisk(risk::RiskChecker* risk) { m_risk = risk; }
+
+private:
+    Book& m_book;
+    risk::RiskChecker* m_risk{nullptr};
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "book/book_backend.hpp"
+#include "domain/symbol.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Symbol universe of a session and how many resting orders to size the book for. One
+// line per symbol, the count is optional:
+//   # symbol,expected_orders
+//   XYZ,200000
+//   ABC
+// Empty lines and '#' comments are skipped.
+struct Universe {
+    std::vector<domain::Symbol> symbols;
+    std::size_t expectedOrders{0};  // sum over the symbols
+};
+
+// nullopt on any malformed line (bad symbol or count, a symbol listed twice); `error` then names it.
+std::optional<Universe> parseUniverse(std::istream& is, std::string& error);
+std::optional<Universe> loadUniverse(const std::string& path, std::string& error);
+
+struct WarmupResult {
+    std::size_t symbols{0};
+    std::size_t reservedOrders{0};
+    std::uint64_t syntheticCommands{0};
+    double millis{0};
+};
+
+// Gets an empty book to steady state before the session starts:
+// - reserve() for the expected orders, so id-index pages and pooled nodes exist up front;
+// - with syntheticCommands > 0, that many generated commands (workload::OrderFlowGenerator
+//   over the universe) go through parse, a scratch CommandDispatcher and response
+//   formatting, warming code, caches and the book arena's free lists; the book is cleared
+//   afterwards and nothing is journaled or published;
+// - prepareSymbol() for every symbol of the universe.
+// Run it before recovery and before attaching anything to the book.
+template <BookBackend Book>
+WarmupResult warmUp(Book& book, const Universe& universe, std::uint64_t syntheticCommands);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "book/level_summary.hpp"
+#include "marketdata/l2_feed.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>  // std::greater
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace marketdata {
+
+// Consumer side of the feed: rebuilds every symbol's levels from snapshots and deltas.
+// A symbol is usable once a snapshot arrived; deltas already covered by it are skipped,
+// a gap in seq marks the symbol stale until the next snapshot.
+class L2BookBuilder : public L2Sink {
+public:
+    void onDelta(const L2Delta& delta) override;
+    void onSnapshot(const L2Snapshot& snapshot) override;
+
+    bool isLive(const domain::Symbol& symbol) const;  // snapshot seen and no gap since
+    std::uint64_t seqOf(const domain::Symbol& symbol) const;
+    std::uint64_t gaps() const { return m_gaps; }
+
+    // Same contract as Book::depth().
+    std::size_t depth(const domain::Symbol& symbol, domain::Side side, std::size_t maxLevels, LevelSummary* out) const;
+
+private:
+    struct SymbolBook {
+        std::uint64_t seq{0};
+        bool live{false};
+        std::map<domain::Price, LevelSummary, std::greater<domain::Price>> bids;
+        std::map<domain::Price, LevelSummary> asks;
+    };
+
+    std::unordered_map<domain::Symbol, SymbolBook> m_books;
+    std::uint64_t m_gaps{0};
+};
+
+}  // namespace marketdata
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "marketdata/l2_feed.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace marketdata {
+
+// Compact binary form of the feed (varints + length-prefixed symbol, see
+// persistence/binary_io.hpp). A level delta is typically 10-14 bytes.
+//   delta:    kind u8 | symbol | seq | side u8, price, quantity, orders      (levels)
+//                                    | price, quantity, buyId, sellId        (trade)
+//   snapshot: symbol | seq | bid count | (price, quantity, orders)... | ask count | ...
+void encodeDelta(const L2Delta& delta, std::vector<char>& out);  // appends to out
+void encodeSnapshot(const L2Snapshot& snapshot, std::vector<char>& out);
+
+// false on truncated / invalid input; delta.symbol points into `data`.
+bool decodeDelta(const char* data, std::size_t size, L2Delta& delta);
+bool decodeSnapshot(const char* data, std::size_t size, L2Snapshot& snapshot);
+
+// Frames: record type u8 ('D' delta / 'S' snapshot) | payload length varint | payload.
+enum class L2Record : std::uint8_t {
+    Delta = 'D',
+    Snapshot = 'S'
+};
+
+// Writes the feed to a stream as frames; one reused buffer, no per-event allocation.
+class L2StreamSink : public L2Sink {
+public:
+    explicit L2StreamSink(std::ostream& os);
+
+    void onDelta(const L2Delta& delta) override;
+    void onSnapshot(const L2Snapshot& snapshot) override;
+
+    std::uint64_t deltas() const { return m_deltas; }
+    std::uint64_t snapshots() const { return m_snapshots; }
+
+private:
+    void writeFrame(L2Record type);
+
+    std::ostream& m_os;
+    std::vector<char> m_payload;
+    std::vector<char> m_frame;
+    std::uint64_t m_deltas{0};
+    std::uint64_t m_snapshots{0};
+};
+
+// Replays a framed stream into `sink`; returns false on a corrupt / truncated frame.
+bool readL2Stream(std::istream& is, L2Sink& sink);
+
+}  // namespace marketdata
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "book/level_summary.hpp"
+#include "domain/order.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace marketdata {
+
+// Aggregated (L2) view of one symbol: its price levels on each side, as reported by
+// Book::depth(). Every change of a level total, and every trade, is one delta.
+enum class DeltaKind : std::uint8_t {
+    LevelAdd,     // first order at a price
+    LevelChange,  // quantity and/or order count changed
+    LevelDelete,  // last order left the price
+    Trade
+};
+
+struct L2Delta {
+    std::string_view symbol;  // valid for the duration of the callback / the decoded buffer
+    std::uint64_t seq{0};     // per symbol, 1, 2, 3, ... with no gaps
+    DeltaKind kind{DeltaKind::LevelAdd};
+    domain::Side side{domain::Side::Buy};  // levels only
+    domain::Price price{};
+    std::int64_t quantity{};  // level total after the change (0 on delete) / traded quantity
+    std::uint32_t orders{};   // level order count after the change
+    domain::OrderId buyOrderId{};   // trades only
+    domain::OrderId sellOrderId{};  // trades only
+};
+
+// Every level of one symbol as of `seq` (the last delta it already contains).
+struct L2Snapshot {
+    std::string symbol;
+    std::uint64_t seq{0};
+    std::vector<LevelSummary> bids;  // best first
+    std::vector<LevelSummary> asks;
+};
+
+class L2Sink {
+public:
+    virtual ~L2Sink() = default;
+    virtual void onDelta(const L2Delta& delta) = 0;
+    virtual void onSnapshot(const L2Snapshot& snapshot) = 0;
+};
+
+// Hands every event to each of its sinks, in the order they were added.
+class L2FanOut : public L2Sink {
+public:
+    void add(L2Sink& sink) { m_sinks.push_back(&sink); }
+
+    void onDelta(const L2Delta& delta) override {
+        for (L2Sink* sink : m_sinks) {
+            sink->onDelta(delta);
+        }
+    }
+    void onSnapshot(const L2Snapshot& snapshot) override {
+        for (L2Sink* sink : m_sinks) {
+            sink->onSnapshot(snapshot);
+        }
+    }
+
+private:
+    std::vector<L2Sink*> m_sinks;
+};
+
+// Attached to a book (Book::attachMarketData) it turns level total changes into
+// sequenced deltas; MatchHandler reports trades through it. With nothing attached the
+// book pays one null-pointer test per change.
+//
+// Recovery: a consumer takes any snapshot of a symbol and applies the deltas with a
+// higher seq (L2BookBuilder). A symbol becomes due for a snapshot with its first delta
+// and, with `snapshotEvery` > 0, again after that many deltas; the dispatcher publishes
+// due snapshots between commands, when the book is consistent.
+class L2Publisher {
+public:
+    explicit L2Publisher(L2Sink& sink, std::uint64_t snapshotEvery = 0);
+
+    void level(const domain::Symbol& symbol, domain::Side side, const LevelSummary& after, bool existed);
+    void trade(const domain::Symbol& symbol,
+               domain::Price price,
+               int quantity,
+               domain::OrderId buyOrderId,
+               domain::OrderId sellOrderId);
+
+    std::uint64_t seqOf(const domain::Symbol& symbol) const;
+
+    // Marks `symbol` due, e.g. for a consumer that just joined.
+    void requestSnapshot(const domain::Symbol& symbol);
+    bool hasDue() const { return !m_due.empty(); }
+
+    // Publishes a snapshot of every due symbol, read through Book::depth().
+    template <typename Book>
+    void publishDue(const Book& book) {
+        for (const auto& symbol : m_due) {
+            publishSnapshot(book, symbol);
+        }
+        m_due.clear();
+    }
+
+    template <typename Book>
+    void publishSnapshot(const Book& book, const domain::Symbol& symbol) {
+        L2Snapshot snap;
+        snap.symbol = symbol.str();
+        readSide(book, symbol, domain::Side::Buy, snap.bids);
+        readSide(book, symbol, domain::Side::Sell, snap.asks);
+        auto& state = m_symbols[symbol];
+        snap.seq = state.seq;
+        state.sinceSnapshot = 0;
+        state.due = false;
+        m_sink.onSnapshot(snap);
+    }
+
+private:
+    struct SymbolState {
+        std::uint64_t seq{0};
+        std::uint64_t sinceSnapshot{0};
+        bool due{false};
+    };
+
+    template <typename Book>
+    static void readSide(const Book& book, const domain::Symbol& symbol, domain::Side side, std::vector<LevelSummary>& out) {
+        out.resize(64);
+        std::size_t n;
+        while ((n = book.depth(symbol, side, out.size(), out.data())) == out.size()) {
+            out.resize(out.size() * 2);
+        }
+        out.resize(n);
+    }
+
+    void next(const domain::Symbol& symbol, L2Delta& delta);
+
+    L2Sink& m_sink;
+    std::uint64_t m_snapshotEvery;
+    std::unordered_map<domain::Symbol, SymbolState> m_symbols;
+    std::vector<domain::Symbol> m_due;
+};
+
+}  // namespace marketdata
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "book/level_summary.hpp"
+#include "marketdata/l2_feed.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace marketdata {
+
+// Best bid / ask of one symbol. An empty side has orders == 0 (price and quantity 0).
+struct TopOfBook {
+    std::string_view symbol;  // points into the table, valid as long as it is mapped
+    LevelSummary bid{};
+    LevelSummary ask{};
+    std::uint64_t updates{0};  // how many values were written to the slot so far
+};
+
+// Conflated top of book: one latest-value slot per symbol plus a ring of dirty slot
+// indices. The writer overwrites a slot and queues it only if it is not queued yet, so
+// the ring never holds a symbol twice and can never overflow; a reader that falls behind
+// skips the intermediate values instead of queueing them. Memory is fixed at creation.
+//
+// One writer (the engine thread) and one reader, which may be another thread or, with
+// createShared()/openShared(), another process mapping the same POSIX shm segment.
+// Slots are seqlocks, so neither side ever blocks the other.
+class TopOfBookTable {
+public:
+    static constexpr std::size_t kMaxSymbolLength = 15;
+
+    // Process-local table for up to `capacity` symbols.
+    explicit TopOfBookTable(std::uint32_t capacity);
+    ~TopOfBookTable();
+
+    TopOfBookTable(const TopOfBookTable&) = delete;
+    TopOfBookTable& operator=(const TopOfBookTable&) = delete;
+
+    // Creates (replacing any stale one) / maps an existing segment called `name`
+    // ("/hft_top"). nullptr on failure. The creator unlinks the name on destruction.
+    static std::unique_ptr<TopOfBookTable> createShared(const std::string& name, std::uint32_t capacity);
+    static std::unique_ptr<TopOfBookTable> openShared(const std::string& name);
+
+    std::uint32_t capacity() const;
+    std::uint32_t symbolCount() const;
+
+    // --- writer ---
+
+    // Slot of `symbol`, allocated on first use; -1 when the table is full or the name
+    // is longer than kMaxSymbolLength.
+    std::int32_t slotOf(const domain::Symbol& symbol);
+    void write(std::int32_t slot, const LevelSummary& bid, const LevelSummary& ask);
+
+    // --- reader ---
+
+    // Latest value of every symbol written since the last drain, each once; returns
+    // how many. The value handed to `fn` is a consistent copy of the slot.
+    template <typename Fn>
+    std::size_t drain(Fn&& fn) {
+        std::size_t n = 0;
+        TopOfBook top;
+        std::uint32_t slot;
+        while (popDirty(slot)) {
+            read(slot, top);
+            fn(static_cast<const TopOfBook&>(top));
+            ++n;
+        }
+        return n;
+    }
+
+    // Current value of `symbol` without touching the dirty ring; false if never written.
+    bool latest(std::string_view symbol, TopOfBook& out) const;
+
+private:
+    struct Header;
+    struct Slot;
+
+    TopOfBookTable(void* memory, std::size_t bytes, std::string shmName, bool owner);
+
+    static std::size_t bytesFor(std::uint32_t capacity);
+    static void format(void* memory, std::uint32_t capacity);
+
+    Slot* slots() const;
+    std::atomic<std::uint32_t>* ring() const;
+    bool popDirty(std::uint32_t& slot);
+    void read(std::uint32_t slot, TopOfBook& out) const;
+
+    Header* m_header;
+    std::size_t m_bytes;
+    std::string m_shmName;  // empty => heap memory
+    bool m_owner;
+    std::unordered_map<domain::Symbol, std::int32_t> m_slotOf;  // writer side
+};
+
+// Engine side: fed by an L2Publisher, it only notes which symbols had a level change
+// (O(1), no book access). refresh() - called by the dispatcher after each command -
+// reads the top of each noted symbol once and writes it to the table if it changed.
+// A burst of deltas for one symbol therefore costs one book read and one slot write.
+class TopOfBookConflator : public L2Sink {
+public:
+    explicit TopOfBookConflator(TopOfBookTable& table);
+
+    void onDelta(const L2Delta& delta) override;
+    void onSnapshot(const L2Snapshot&) override {}
+
+    bool hasPending() const { return !m_pending.empty(); }
+
+    template <typename Book>
+    void refresh(const Book& book) {
+        for (const std::uint32_t i : m_pending) {
+            Symbol& s = m_symbols[i];
+            s.pending = false;
+            LevelSummary bid{};
+            LevelSummary ask{};
+            book.depth(s.name, domain::Side::Buy, 1, &bid);
+            book.depth(s.name, domain::Side::Sell, 1, &ask);
+            publish(s, bid, ask);
+        }
+        m_pending.clear();
+    }
+
+    std::uint64_t writes() const { return m_writes; }
+    std::uint64_t dropped() const { return m_dropped; }  // symbols the table had no room for
+
+private:
+    static constexpr std::int32_t kNoRoom = -2;
+
+    struct Symbol {
+        domain::Symbol name;
+        std::int32_t slot{-1};  // -1 until first written, kNoRoom when the table was full
+        bool pending{false};
+        LevelSummary bid{};
+        LevelSummary ask{};
+    };
+
+    void publish(Symbol& s, const LevelSummary& bid, const LevelSummary& ask);
+
+    TopOfBookTable& m_table;
+    std::unordered_map<domain::Symbol, std::uint32_t> m_index;  // symbol -> m_symbols
+    std::vector<Symbol> m_symbols;
+    std::vector<std::uint32_t> m_pending;
+    std::uint64_t m_writes{0};
+    std::uint64_t m_dropped{0};
+};
+
+}  // namespace marketdata
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "domain/symbol.hpp"
+#include "domain/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace marketdata {
+
+// OHLC + volume of the trades of one symbol over some period (the whole session, or
+// one time bucket). trades == 0 => nothing traded, the prices are meaningless.
+struct TradeBar {
+    domain::Timestamp start{};  // first trade of the session / bucket start
+    domain::Price open{};
+    domain::Price high{};
+    domain::Price low{};
+    domain::Price close{};
+    std::int64_t volume{};    // shares
+    std::int64_t notional{};  // sum of price (cents) * quantity
+    std::uint32_t trades{};
+
+    // Volume-weighted average price in cents; 0 without trades.
+    double vwap() const { return volume == 0 ? 0.0 : static_cast<double>(notional) / static_cast<double>(volume); }
+
+    void add(domain::Price price, int quantity) {
+        if (trades == 0) {
+            open = high = low = price;
+        } else {
+            high = price > high ? price : high;
+            low = price < low ? price : low;
+        }
+        close = price;
+        volume += quantity;
+        notional += price * quantity;
+        ++trades;
+    }
+};
+
+struct SymbolTradeStats {
+    domain::Symbol symbol;
+    TradeBar session;  // everything since start / reset()
+    TradeBar bucket;   // the open time bucket (bucketWidth > 0)
+    // both sides of every fill, by the order type of that side (Market, Limit, IOC)
+    std::array<std::uint64_t, 3> fillsByType{};
+};
+
+// Running per-symbol trade statistics, updated by MatchHandler once per fill.
+// Symbols get dense ids on first trade and their stats sit in one flat array indexed by
+// that id, so record() is an array access and a handful of adds.
+//
+// With bucketWidth > 0 each symbol also keeps an OHLC bar per [k * width, (k + 1) * width)
+// of the M command timestamps; a bar is closed (moved to bars()) by the first trade of a
+// later bucket or by closeBuckets().
+class TradeStats {
+public:
+    explicit TradeStats(domain::Timestamp bucketWidth = 0);
+
+    // Dense id of `symbol`, allocated on first use.
+    std::uint32_t idOf(const domain::Symbol& symbol);
+
+    void record(std::uint32_t id,
+                domain::Timestamp ts,
+                domain::Price price,
+                int quantity,
+                domain::OrderType buyType,
+                domain::OrderType sellType) {
+        SymbolTradeStats& s = m_stats[id];
+        if (s.session.trades == 0)
+            s.session.start = ts;
+        s.session.add(price, quantity);
+        ++s.fillsByType[static_cast<std::size_t>(buyType)];
+        ++s.fillsByType[static_cast<std::size_t>(sellType)];
+        if (m_bucketWidth > 0)
+            addToBucket(id, s, ts, price, quantity);
+    }
+
+    // nullptr if `symbol` never traded.
+    const SymbolTradeStats* find(const domain::Symbol& symbol) const;
+    const std::vector<SymbolTradeStats>& all() const { return m_stats; }  // indexed by id
+    std::size_t symbolCount() const { return m_stats.size(); }
+
+    struct ClosedBar {
+        std::uint32_t id;
+        TradeBar bar;
+    };
+    const std::vector<ClosedBar>& bars() const { return m_bars; }
+
+    // Closes every open bucket, e.g. before exporting at the end of a session.
+    void closeBuckets();
+
+    // CSV: symbol,start,open,high,low,close,volume,notional,vwap,trades (prices as 123.45)
+    void writeSessionCsv(std::ostream& os) const;
+    void writeBarsCsv(std::ostream& os) const;
+
+    void reset();
+
+private:
+    void addToBucket(std::uint32_t id, SymbolTradeStats& s, domain::Timestamp ts, domain::Price price, int quantity);
+
+    domain::Timestamp m_bucketWidth;
+    std::unordered_map<domain::Symbol, std::uint32_t> m_ids;
+    std::vector<SymbolTradeStats> m_stats;
+    std::vector<ClosedBar> m_bars;
+};
+
+}  // namespace marketdata
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "metrics/histogram.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace metrics {
+
+enum class MessageType : std::uint8_t {
+    New,
+    Amend,
+    Cancel,
+    Match,
+    Query,
+    MassCancel,
+    BatchNew,
+    Stop,
+};
+inline constexpr std::size_t kMessageTypes = 8;
+
+const char* toString(MessageType t);
+
+// Per message type and outcome latency (TSC ticks, dispatch entry -> formatted response)
+// plus the number of fills produced by every M command.
+class DispatchMetrics {
+public:
+    void recordLatency(MessageType type, bool accepted, std::uint64_t ticks) {
+        m_latency[static_cast<std::size_t>(type)][accepted ? 0 : 1].record(ticks);
+    }
+    void recordFills(std::uint64_t fills) { m_fillsPerMatch.record(fills); }
+
+    const LogLinearHistogram& latency(MessageType type, bool accepted) const {
+        return m_latency[static_cast<std::size_t>(type)][accepted ? 0 : 1];
+    }
+    const LogLinearHistogram& fillsPerMatch() const { return m_fillsPerMatch; }
+
+    // One row per non-empty histogram: count, p50/p90/p99/p99.9/max in ns.
+    void report(std::ostream& os) const;
+    void reset();
+
+private:
+    std::array<std::array<LogLinearHistogram, 2>, kMessageTypes> m_latency{};  // [type][accept, reject]
+    LogLinearHistogram m_fillsPerMatch{};
+};
+
+}  // namespace metrics
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace metrics {
+
+// HDR-style log-linear histogram of non-negative integers.
+// Values below 2^kSubBits are exact; above that every power-of-two range is split
+// into 2^kSubBits linear buckets, so a reported value is within 1/64 (~1.6%) of the
+// recorded one. record() is a handful of instructions and never allocates.
+class LogLinearHistogram {
+public:
+    static constexpr unsigned kSubBits = 6;
+    static constexpr std::uint64_t kSubBuckets = 1ull << kSubBits;
+    static constexpr std::size_t kBuckets = kSubBuckets + (64 - kSubBits) * kSubBuckets;
+
+    void record(std::uint64_t value) {
+        ++m_counts[bucketOf(value)];
+        ++m_count;
+        m_sum += value;
+        if (value > m_max)
+            m_max = value;
+        if (value < m_min)
+            m_min = value;
+    }
+
+    std::uint64_t count() const { return m_count; }
+    std::uint64_t max() const { return m_count ? m_max : 0; }
+    std::uint64_t min() const { return m_count ? m_min : 0; }
+    double mean() const { return m_count ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0; }
+
+    // Smallest recorded value v such that at least p percent of the samples are <= v,
+    // reported as the upper edge of its bucket (capped by max()). 0 when empty.
+    std::uint64_t valueAtPercentile(double p) const;
+
+    void merge(const LogLinearHistogram& other);
+    void reset();
+
+    static std::size_t bucketOf(std::uint64_t value) {
+        if (value < kSubBuckets)
+            return static_cast<std::size_t>(value);
+        const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - kSubBits;
+        return static_cast<std::size_t>(kSubBuckets * (shift + 1) + ((value >> shift) - kSubBuckets));
+    }
+
+    // Largest value that falls into the bucket.
+    static std::uint64_t bucketHigh(std::size_t bucket);
+
+private:
+    std::array<std::uint64_t, kBuckets> m_counts{};
+    std::uint64_t m_count{0};
+    std::uint64_t m_sum{0};
+    std::uint64_t m_max{0};
+    std::uint64_t m_min{~0ull};
+};
+
+}  // namespace metrics
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "metrics/dispatch_metrics.hpp"  // MessageType
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace metrics {
+
+enum class PerfEvent : std::uint8_t {
+    Cycles,
+    Instructions,
+    L1dMisses,
+    LlcMisses,
+    BranchMisses,
+    DtlbMisses,
+    PageFaults,  // software event, usually available even without a PMU
+};
+inline constexpr std::size_t kPerfEvents = 7;
+
+const char* toString(PerfEvent e);
+
+struct PerfReading {
+    std::array<std::uint64_t, kPerfEvents> values{};
+
+    std::uint64_t operator[](PerfEvent e) const { return values[static_cast<std::size_t>(e)]; }
+    PerfReading& operator+=(const PerfReading& other);
+};
+
+PerfReading operator-(const PerfReading& end, const PerfReading& begin);
+
+// One perf_event_open group (user space only) over the events above, for the calling
+// thread. Whatever the kernel / VM / container refuses is simply left out: in the
+// worst case available() is false and every reading is zero. Never throws.
+// read() is one syscall (~0.5 us); the kernel part of it is not counted.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return m_leaderFd >= 0; }
+    bool has(PerfEvent e) const { return m_fds[static_cast<std::size_t>(e)] >= 0; }
+    bool hardwareAvailable() const { return has(PerfEvent::Cycles) || has(PerfEvent::Instructions); }
+    // Why hardware counters are missing ("" when they are not).
+    const std::string& unavailableReason() const { return m_reason; }
+
+    void start();  // reset + enable
+    void stop();
+
+    // Cumulative counts since start(), scaled up if the group was multiplexed.
+    PerfReading read() const;
+
+private:
+    std::array<int, kPerfEvents> m_fds{};
+    std::array<std::size_t, kPerfEvents> m_slot{};  // position in the group read buffer
+    std::size_t m_opened{0};
+    int m_leaderFd{-1};
+    std::string m_reason{};
+};
+
+// Counter deltas accumulated per message type, reported per command.
+class PerfByType {
+public:
+    void add(MessageType type, const PerfReading& delta) {
+        auto& t = m_types[static_cast<std::size_t>(type)];
+        t.total += delta;
+        ++t.commands;
+    }
+
+    std::uint64_t commands(MessageType type) const { return m_types[static_cast<std::size_t>(type)].commands; }
+    const PerfReading& total(MessageType type) const { return m_types[static_cast<std::size_t>(type)].total; }
+
+    // Per-command averages for each type that saw commands; "n/a" for missing counters.
+    void report(std::ostream& os, const PerfCounters& counters) const;
+
+private:
+    struct Tally {
+        std::uint64_t commands{0};
+        PerfReading total{};
+    };
+    std::array<Tally, kMessageTypes> m_types{};
+};
+
+}  // namespace metrics
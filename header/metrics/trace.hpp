@@ -0,0 +1,124 @@
+#pragma once
+
+#include "metrics/tsc.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Set by CMake (ENABLE_STAGE_TRACING). 0 turns every HFT_TRACE_* probe into nothing.
+#ifndef HFT_STAGE_TRACING
+#define HFT_STAGE_TRACING 1
+#endif
+
+namespace metrics {
+
+// Pipeline stages of one message. Message spans the whole line (parse + dispatch).
+enum class Stage : std::uint8_t {
+    Message,
+    Tokenize,
+    Parse,
+    Validate,
+    Book,
+    Format,
+    Risk,  // pre-trade limits of N / B / A
+};
+
+const char* toString(Stage s);
+
+struct TraceEvent {
+    std::uint64_t startTsc;
+    std::uint64_t ticks;
+    std::uint32_t message;  // per-thread message sequence number
+    Stage stage;
+};
+
+// Per-thread tracer state. Trivially constructible, so probes reach it with a plain
+// TLS access; the ring itself is allocated by enableStageTracing(), never on the hot path.
+struct TraceThreadState {
+    TraceEvent* ring{nullptr};
+    std::uint64_t mask{0};
+    std::uint64_t head{0};  // events ever written; the ring keeps the newest mask + 1
+    std::uint32_t sampleEvery{0};  // 0 => tracing off on this thread
+    std::uint32_t countdown{0};
+    std::uint32_t message{0};
+    bool sampling{false};  // the current message is being traced
+};
+
+extern thread_local constinit TraceThreadState t_trace;
+
+// Starts tracing 1 in sampleEvery messages on the calling thread into a ring of
+// `capacity` events (rounded up to a power of two; the oldest are overwritten).
+void enableStageTracing(std::uint32_t sampleEvery, std::size_t capacity = 1u << 20);
+void disableStageTracing();
+
+// Drops recorded events: detached rings are freed, live ones start over.
+void clearStageTraces();
+
+// Chrome trace-event JSON ("X" events, µs) of every thread that enabled tracing.
+// Call when the traced threads are quiescent.
+void writeChromeTrace(std::ostream& os);
+
+inline void recordStage(Stage stage, std::uint64_t startTsc, std::uint64_t endTsc) {
+    auto& t = t_trace;
+    t.ring[t.head++ & t.mask] = TraceEvent{startTsc, endTsc - startTsc, t.message, stage};
+}
+
+class ScopedStage {
+public:
+    explicit ScopedStage(Stage stage)
+        : m_start(t_trace.sampling ? readTsc() : 0),
+          m_stage(stage) {}
+    ~ScopedStage() {
+        if (m_start != 0)
+            recordStage(m_stage, m_start, readTsc());
+    }
+
+    ScopedStage(const ScopedStage&) = delete;
+    ScopedStage& operator=(const ScopedStage&) = delete;
+
+private:
+    std::uint64_t m_start;
+    Stage m_stage;
+};
+
+// Decides whether this message is sampled; stages only record inside a sampled message.
+class ScopedMessage {
+public:
+    ScopedMessage() {
+        auto& t = t_trace;
+        if (t.sampleEvery == 0)
+            return;
+        ++t.message;
+        if (--t.countdown != 0)
+            return;
+        t.countdown = t.sampleEvery;
+        t.sampling = true;
+        m_start = readTsc();
+    }
+    ~ScopedMessage() {
+        if (m_start == 0)
+            return;
+        recordStage(Stage::Message, m_start, readTsc());
+        t_trace.sampling = false;
+    }
+
+    ScopedMessage(const ScopedMessage&) = delete;
+    ScopedMessage& operator=(const ScopedMessage&) = delete;
+
+private:
+    std::uint64_t m_start{0};
+};
+
+}  // namespace metrics
+
+#define HFT_TRACE_CONCAT_INNER(a, b) a##b
+#define HFT_TRACE_CONCAT(a, b) HFT_TRACE_CONCAT_INNER(a, b)
+
+#if HFT_STAGE_TRACING
+#define HFT_TRACE_MESSAGE() ::metrics::ScopedMessage HFT_TRACE_CONCAT(hftTraceMessage_, __LINE__)
+#define HFT_TRACE_STAGE(stage) ::metrics::ScopedStage HFT_TRACE_CONCAT(hftTraceStage_, __LINE__)(::metrics::Stage::stage)
+#else
+#define HFT_TRACE_MESSAGE() static_cast<void>(0)
+#define HFT_TRACE_STAGE(stage) static_cast<void>(0)
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Set by CMake (ENABLE_LATENCY_METRICS). 0 removes every probe from the hot path.
+#ifndef HFT_LATENCY_METRICS
+#define HFT_LATENCY_METRICS 1
+#endif
+
+namespace metrics {
+
+// Raw cycle counter: rdtsc on x86, the virtual counter on aarch64, steady_clock
+// nanoseconds elsewhere. Not serializing - fine for per-message latencies, where the
+// few cycles of reordering disappear in the bucket width.
+inline std::uint64_t readTsc() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t v;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Counter ticks per nanosecond, measured once against steady_clock (~10 ms on first call).
+double tscTicksPerNs();
+
+inline double tscToNs(std::uint64_t ticks) {
+    return static_cast<double>(ticks) / tscTicksPerNs();
+}
+
+}  // namespace metrics
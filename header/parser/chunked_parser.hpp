@@ -0,0 +1,76 @@
+#pragma once
+
+#include "parser/commands_parser.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// One newline-aligned piece of the input, parsed. lines[i] views `text` (a vector, so the
+// views survive moving the chunk) and commands[i] is its parse (nullopt => it did not
+// parse). Empty lines are left out.
+struct ParsedChunk {
+    std::uint64_t index{0};  // position among the chunks of the input
+    std::vector<char> text;
+    std::vector<std::string_view> lines;
+    std::vector<std::optional<ParsedCommand>> commands;
+};
+
+struct ChunkedParserOptions {
+    std::size_t threads{4};
+    std::size_t chunkBytes{1u << 20};  // extended to the next newline
+    std::size_t maxChunksAhead{0};     // parsed but not yet taken, 0 => 2 * threads
+};
+
+// Parses a command stream on worker threads while the caller applies it in order
+// (file replays: commands only depend on each other in the book, not in parsing).
+//
+// Workers take turns cutting the next chunk off the input, parse it with no lock held
+// and park it in a reorder window; next() hands the chunks out strictly in input order.
+// A worker does not cut a new chunk while maxChunksAhead are waiting, which bounds the
+// memory held. Lines are split on '\n' as std::getline does.
+//
+// Not for interactive input: a worker waits for chunkBytes (or EOF) before parsing.
+// `in` must outlive the parser.
+class ChunkedParser {
+public:
+    explicit ChunkedParser(std::istream& in, const ChunkedParserOptions& options = {});
+    ~ChunkedParser();  // stops and joins the workers, the rest of the input is left unread
+
+    ChunkedParser(const ChunkedParser&) = delete;
+    ChunkedParser& operator=(const ChunkedParser&) = delete;
+
+    // The next chunk in input order; false once the input is exhausted.
+    bool next(ParsedChunk& chunk);
+
+private:
+    void run();
+    bool readChunk(std::vector<char>& text);  // under m_inputMutex
+    static void parseChunk(ParsedChunk& chunk);
+
+    std::istream& m_in;
+    std::size_t m_chunkBytes;
+
+    // input side: the worker cutting a chunk holds it (then m_mutex, never the reverse)
+    std::mutex m_inputMutex;
+    std::uint64_t m_nextRead{0};
+    bool m_inputDone{false};
+
+    std::mutex m_mutex;
+    std::condition_variable m_readyCv;  // workers -> next()
+    std::condition_variable m_spaceCv;  // next() -> workers
+    // guarded by m_mutex
+    std::vector<std::optional<ParsedChunk>> m_window;  // chunk i parks in slot i % size
+    std::uint64_t m_nextOut{0};
+    std::uint64_t m_endIndex{std::numeric_limits<std::uint64_t>::max()};  // chunk count, once known
+    bool m_stopping{false};
+
+    std::vector<std::thread> m_threads;
+};
@@ -2,19 +2,41 @@
 
 #include <optional>
 #include <string_view>
+#include <type_traits>
 #include <variant>
 
 #include "engine/amend.hpp"
+#include "engine/batch_new.hpp"
 #include "engine/cancel.hpp"
+#include "engine/mass_cancel.hpp"
 #include "engine/match.hpp"
 #include "engine/new.hpp"
+#include "engine/query.hpp"
+#include "engine/stop.hpp"
 
 // ParsedCommand = one of the supported requests
 using ParsedCommand = std::variant<
     domain::Order,  // for the new command we don't have a request because new introduce new object (order) and requires all fields
     AmendRequest,
     CancelRequest,
-    MatchRequest>;
+    MatchRequest,
+    QueryRequest,
+    MassCancelRequest,
+    BatchNewRequest,
+    StopOrderRequest>;
+
+// Symbols are inline (domain::Symbol), so every single-order command is a flat value that can
+// be memcpy'd through a queue or a journal and never allocates. B is the one exception: its
+// orders (up to kMaxBatchOrders) stay in a vector rather than inflating every command.
+static_assert(std::is_trivially_copyable_v<domain::Order>);
+static_assert(std::is_trivially_copyable_v<AmendRequest>);
+static_assert(std::is_trivially_copyable_v<CancelRequest>);
+static_assert(std::is_trivially_copyable_v<MatchRequest>);
+static_assert(std::is_trivially_copyable_v<QueryRequest>);
+static_assert(std::is_trivially_copyable_v<MassCancelRequest>);
+static_assert(std::is_trivially_copyable_v<StopOrderRequest>);
 
 // Main entry: line -> tokenize -> parse fields -> build request
-std::optional<ParsedCommand> parseCommandLine(std::string_view line);
\ No newline at end of file
+std::optional<ParsedCommand> parseCommandLine(std::string_view line);
+// Timestamp field of any command (M included, whose field is spelled differently).
+domain::Timestamp timestampOf(const ParsedCommand& cmd);
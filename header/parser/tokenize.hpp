@@ -8,4 +8,8 @@
 // - Trims leading/trailing whitespace in each token.
 // - Preserves empty tokens (e.g. "A,,1" -> {"A","","1"}).
 // - Handles lines ending with '\n' or '\r\n'.
-std::vector<std::string> tokenize(std::string_view line);
\ No newline at end of file
+std::vector<std::string> tokenize(std::string_view line);
+
+// Same splitting, but the tokens are views into `line` written to `out` (cleared first),
+// so a caller that keeps `out` around tokenizes without allocating.
+void tokenizeInto(std::string_view line, std::vector<std::string_view>& out);
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Little helpers shared by the journal and the snapshot files.
+// Everything is little-endian on disk; we only run on LE hosts (x86_64 / arm64).
+static_assert(std::endian::native == std::endian::little, "binary formats assume a little-endian host");
+
+namespace persistence {
+
+// --- fixed width ---
+
+template <typename T>
+inline void putFixed(std::vector<char>& out, T value) {
+    const auto pos = out.size();
+    out.resize(pos + sizeof(T));
+    std::memcpy(out.data() + pos, &value, sizeof(T));
+}
+
+template <typename T>
+inline T loadFixed(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+// --- varints (LEB128, zig-zag for signed) ---
+
+inline void putVarU64(std::vector<char>& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+inline void putVarI64(std::vector<char>& out, std::int64_t v) {
+    putVarU64(out, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+inline void putBytes(std::vector<char>& out, std::string_view s) {
+    putVarU64(out, s.size());
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+// Bounds-checked cursor over an in-memory buffer.
+// Every get* returns false (and leaves the cursor unusable) on truncated input.
+class ByteReader {
+public:
+    ByteReader(const char* data, std::size_t size)
+        : m_p(data), m_end(data + size) {}
+
+    bool getVarU64(std::uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_p == m_end)
+                return false;
+            const auto byte = static_cast<std::uint8_t>(*m_p++);
+            v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;  // more than 10 bytes => corrupt
+    }
+
+    bool getVarI64(std::int64_t& v) {
+        std::uint64_t u = 0;
+        if (!getVarU64(u))
+            return false;
+        v = static_cast<std::int64_t>((u >> 1) ^ (~(u & 1) + 1));
+        return true;
+    }
+
+    bool getU8(std::uint8_t& v) {
+        if (m_p == m_end)
+            return false;
+        v = static_cast<std::uint8_t>(*m_p++);
+        return true;
+    }
+
+    bool getBytes(std::string_view& s) {
+        std::uint64_t n = 0;
+        if (!getVarU64(n) || n > remaining())
+            return false;
+        s = std::string_view(m_p, n);
+        m_p += n;
+        return true;
+    }
+
+    template <typename T>
+    bool getFixed(T& v) {
+        if (remaining() < sizeof(T))
+            return false;
+        v = loadFixed<T>(m_p);
+        m_p += sizeof(T);
+        return true;
+    }
+
+    std::size_t remaining() const { return static_cast<std::size_t>(m_end - m_p); }
+    const char* position() const { return m_p; }
+
+private:
+    const char* m_p;
+    const char* m_end;
+};
+
+// CRC-32 (IEEE, reflected) used to detect torn / corrupted records.
+std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t seed = 0);
+
+}  // namespace persistence
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "parser/commands_parser.hpp"  // ParsedCommand
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace persistence {
+
+// First byte of every encoded command.
+enum class CommandKind : std::uint8_t {
+    New = 1,
+    Amend = 2,
+    Cancel = 3,
+    Match = 4,
+    Query = 5,  // never journaled (read-only), encodable for completeness
+    MassCancel = 6,
+    BatchNew = 7,
+    Stop = 8
+};
+
+// Compact binary form of a ParsedCommand (varints + length-prefixed symbol).
+// A typical N command is ~15 bytes instead of ~35 bytes of text.
+void encodeCommand(const ParsedCommand& cmd, std::vector<char>& out);  // appends to out
+
+// Returns nullopt on truncated / unknown input.
+std::optional<ParsedCommand> decodeCommand(const char* data, std::size_t size);
+
+}  // namespace persistence
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "parser/commands_parser.hpp"  // ParsedCommand
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace persistence {
+
+// On-disk layout (all little-endian):
+//   segment file  "journal-<first seq, 20 digits>.log"
+//   record        u32 bodySize | u32 crc32(seq + body) | u64 seq | body (see command_codec.hpp)
+// A record with a short read or a bad CRC marks the torn tail of a segment.
+struct JournalOptions {
+    std::string directory{};
+
+    // Current segment is closed and a new one started once it grows past this size
+    // (checked at batch boundaries, so a segment may overshoot by one batch).
+    std::size_t segmentBytes{64u * 1024 * 1024};
+
+    // Group commit: one fsync covers every record written since the previous one.
+    // It is issued as soon as fsyncBatchRecords are pending or the oldest pending
+    // record is fsyncIntervalMicros old - whichever comes first.
+    std::size_t fsyncBatchRecords{512};
+    std::uint32_t fsyncIntervalMicros{2000};
+
+    // false => write() only, durability is left to the OS page cache.
+    bool fsyncEnabled{true};
+};
+
+struct JournalStats {
+    std::uint64_t records{};
+    std::uint64_t bytes{};
+    std::uint64_t writes{};  // write() batches
+    std::uint64_t fsyncs{};
+    std::uint64_t segments{};
+};
+
+// Append-only journal of accepted commands.
+// append() only encodes into an in-memory buffer; a dedicated writer thread
+// drains it, writes whole batches and applies the fsync policy above.
+class JournalWriter {
+public:
+    // nextSeq = sequence number of the first record this writer will produce
+    // (last recovered seq + 1). It always starts a fresh segment.
+    explicit JournalWriter(JournalOptions options, std::uint64_t nextSeq = 1);
+    ~JournalWriter();  // flushes everything and joins the writer thread
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Returns the sequence number assigned to the command.
+    std::uint64_t append(const ParsedCommand& cmd);
+
+    // Blocks until every record up to seq is written (and fsynced if enabled).
+    void waitDurable(std::uint64_t seq);
+    void flush();
+
+    std::uint64_t lastSeq() const;
+    std::uint64_t durableSeq() const;
+    JournalStats stats() const;
+
+private:
+    void run();
+    void writeBatch(const std::vector<char>& batch, std::uint64_t firstSeq);
+    void openSegment(std::uint64_t firstSeq);
+    void closeSegment();
+    void syncSegment();
+
+    JournalOptions m_options;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workCv;     // producer -> writer
+    std::condition_variable m_durableCv;  // writer -> waitDurable()
+
+    // guarded by m_mutex
+    std::vector<char> m_active;
+    std::uint64_t m_activeFirstSeq{0};
+    std::uint64_t m_nextSeq;
+    std::uint64_t m_durableSeq;
+    std::size_t m_waiters{0};
+    bool m_stopping{false};
+    JournalStats m_stats{};
+
+    // writer thread only
+    int m_fd{-1};
+    std::size_t m_segmentSize{0};
+
+    std::thread m_thread;
+};
+
+struct ReplayResult {
+    std::uint64_t lastSeq{0};    // last sequence number delivered (or afterSeq)
+    std::uint64_t replayed{0};   // records delivered to the callback
+    std::uint64_t tornTails{0};  // segments that ended in a partial / corrupt record
+};
+
+// Calls fn for every intact record with seq > afterSeq, in sequence order.
+// A torn tail ends its segment; replay stops at the first sequence gap.
+ReplayResult replayJournal(const std::string& directory,
+                           std::uint64_t afterSeq,
+                           const std::function<void(std::uint64_t, const ParsedCommand&)>& fn);
+
+// Deletes segments whose records are all <= uptoSeq (e.g. covered by a snapshot).
+// The newest segment is always kept. Returns the number of segments removed.
+std::size_t pruneJournal(const std::string& directory, std::uint64_t uptoSeq);
+
+}  // namespace persistence
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "book/order_book.hpp"
+#include "persistence/journal.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace persistence {
+
+// Rebuilds the book by re-executing every journaled command in order.
+// Commands are applied straight to the handlers (no formatting, no re-journaling).
+// Start the JournalWriter afterwards with nextSeq = result.lastSeq + 1.
+ReplayResult recoverFromJournal(OrderBook& book, const std::string& journalDir);
+
+struct RecoveryResult {
+    std::optional<std::uint64_t> snapshotSeq{};  // nullopt => started from an empty book
+    ReplayResult journal{};                      // the tail replayed on top of the snapshot
+
+    std::uint64_t lastSeq() const { return journal.lastSeq; }
+};
+
+// Newest valid snapshot from snapshotDir (if any) + journal records after its seq.
+RecoveryResult recoverBook(OrderBook& book, const std::string& snapshotDir, const std::string& journalDir);
+
+}  // namespace persistence
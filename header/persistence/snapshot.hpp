@@ -0,0 +1,23 @@
+#pragma once
+
+#include "book/order_book.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace persistence {
+
+// Snapshot files live in one directory as "snapshot-<seq, 20 digits>.bin".
+// A snapshot is written to a temporary file, fsynced and renamed into place,
+// so a crash never leaves a half-written file under the final name.
+bool saveSnapshot(const OrderBook& book, const std::string& directory, std::uint64_t seq);
+
+// Loads the newest snapshot that passes its checksum (older ones are tried if it is damaged).
+// Returns the seq it covers; nullopt => no usable snapshot, the book is left empty.
+std::optional<std::uint64_t> loadLatestSnapshot(OrderBook& book, const std::string& directory);
+
+// Keeps the newest `keep` snapshots and deletes the rest. Returns the number removed.
+std::size_t pruneSnapshots(const std::string& directory, std::size_t keep);
+
+}  // namespace persistence
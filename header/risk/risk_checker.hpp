@@ -0,0 +1,123 @@
+#pragma once
+
+#include "domain/order.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace risk {
+
+// Pre-trade limits of one symbol; 0 disables a limit.
+struct SymbolLimits {
+    domain::Price referencePrice{0};  // collar centre until the symbol's first trade
+    std::int64_t bandBps{0};          // collar half-width, basis points of the centre
+    std::int64_t maxOrderQuantity{0};
+    std::int64_t maxNotional{0};      // cents (price * quantity)
+    std::int64_t maxOpenQuantity{0};  // resting quantity of the symbol, both sides
+};
+
+// Parsed limits file. One line per symbol, '*' for every symbol not listed:
+//   # symbol,reference,band_bps,max_qty,max_notional,max_open
+//   *,0.00,0,100000,0.00,0
+//   XYZ,100.00,500,10000,1000000.00,50000
+// Prices in the usual 123.45 form, empty lines and '#' comments are skipped.
+struct RiskConfig {
+    SymbolLimits defaults{};
+    std::unordered_map<domain::Symbol, SymbolLimits> symbols;
+
+    const SymbolLimits& limitsFor(const domain::Symbol& symbol) const;
+};
+
+// nullopt on any malformed line; `error` then names it.
+std::optional<RiskConfig> parseRiskConfig(std::istream& is, std::string& error);
+std::optional<RiskConfig> loadRiskConfig(const std::string& path, std::string& error);
+
+enum class RiskReject : std::uint8_t { None, PriceBand, OrderQuantity, Notional, OpenQuantity };
+
+// Reject code of every risk reject (N, B and A).
+inline constexpr int kRiskRejectCode = 305;
+const char* rejectMessage(RiskReject reason);
+
+// Risk-check stage of N / B / A, attached to the handlers by CommandDispatcher.
+//
+// Symbols get dense ids on first use; limits, open quantity and last trade price sit in
+// flat arrays indexed by that id, so a check is one symbol lookup plus a few compares.
+// Open quantity is kept up to date by the handlers (accepts, amends, cancels, fills) and
+// by the dispatcher (mass cancel, expiry); rebuildOpen() recomputes it from a book.
+//
+// reload() swaps in a new config between two messages: every row is rebuilt first, then
+// the whole table is replaced, so no message ever sees a mix of old and new limits.
+class RiskChecker {
+public:
+    explicit RiskChecker(RiskConfig config = {});
+
+    std::uint32_t idOf(const domain::Symbol& symbol);
+
+    RiskReject checkNew(std::uint32_t id, const domain::Order& order) {
+        return check(id, order.orderType, order.price, order.quantity, order.quantity);
+    }
+    // `order` as it rests now; the open quantity only grows by the difference.
+    RiskReject checkAmend(std::uint32_t id, const domain::Order& order, domain::Price newPrice, int newQty) {
+        return check(id, order.orderType, newPrice, newQty, static_cast<std::int64_t>(newQty) - order.quantity);
+    }
+
+    void addOpen(std::uint32_t id, std::int64_t quantity) { m_open[id] += quantity; }
+    void onFill(std::uint32_t id, domain::Price price, int quantity) {
+        m_lastTrade[id] = price;
+        m_open[id] -= quantity;  // once per side
+    }
+
+    template <typename Book>
+    void rebuildOpen(const Book& book) {
+        std::fill(m_open.begin(), m_open.end(), 0);
+        book.forEach([this](const domain::Order& o) { addOpen(idOf(o.symbol), o.quantity); });
+    }
+
+    void reload(RiskConfig config);
+
+    std::int64_t openQuantity(const domain::Symbol& symbol) const;
+    const SymbolLimits* limits(const domain::Symbol& symbol) const;
+    std::uint64_t rejects() const { return m_rejects; }
+
+private:
+    RiskReject check(std::uint32_t id, domain::OrderType type, domain::Price price, int quantity, std::int64_t openDelta) {
+        const RiskReject r = evaluate(id, type, price, quantity, openDelta);
+        m_rejects += r != RiskReject::None;
+        return r;
+    }
+
+    RiskReject evaluate(std::uint32_t id, domain::OrderType type, domain::Price price, int quantity, std::int64_t openDelta) const {
+        const SymbolLimits& l = m_limits[id];
+        if (l.maxOrderQuantity != 0 && quantity > l.maxOrderQuantity)
+            return RiskReject::OrderQuantity;
+        if (l.maxOpenQuantity != 0 && openDelta > 0 && m_open[id] + openDelta > l.maxOpenQuantity)
+            return RiskReject::OpenQuantity;
+
+        const domain::Price reference = m_lastTrade[id] != 0 ? m_lastTrade[id] : l.referencePrice;
+        // a market order is valued at the reference (skipped without one)
+        const domain::Price valuedAt = type == domain::OrderType::Market ? reference : price;
+        if (l.maxNotional != 0 && valuedAt * quantity > l.maxNotional)
+            return RiskReject::Notional;
+        if (l.bandBps != 0 && reference != 0 && type != domain::OrderType::Market) {
+            const domain::Price distance = price > reference ? price - reference : reference - price;
+            if (distance * 10000 > reference * l.bandBps)
+                return RiskReject::PriceBand;
+        }
+        return RiskReject::None;
+    }
+
+    RiskConfig m_config;
+    std::unordered_map<domain::Symbol, std::uint32_t> m_ids;
+    std::vector<domain::Symbol> m_names;  // by id
+    std::vector<SymbolLimits> m_limits;
+    std::vector<std::int64_t> m_open;
+    std::vector<domain::Price> m_lastTrade;  // 0 => no trade yet
+    std::uint64_t m_rejects{0};
+};
+
+}  // namespace risk
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "domain/types.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace workload {
+
+// Synthetic order flow in the input file format (N / A / X / M lines).
+// Output depends only on the config: same seed => byte-identical stream on every platform
+// (no std::*_distribution, whose algorithms are implementation defined).
+struct OrderFlowConfig {
+    std::uint64_t seed{1};
+
+    // Symbol universe; popularity rank k gets weight 1 / k^zipfSkew (0 => uniform).
+    // symbolNames, when set, is the universe (in rank order) and `symbols` is ignored.
+    std::uint32_t symbols{100};
+    std::vector<std::string> symbolNames{};
+    double zipfSkew{1.0};
+
+    // Command mix in percent, the remainder are M commands.
+    std::uint32_t newPct{55};
+    std::uint32_t amendPct{20};
+    std::uint32_t cancelPct{23};
+    std::uint32_t queryPct{0};  // Q commands (order status / top / depth 5), taken from the M share
+    std::uint32_t matchSymbolPct{50};  // share of M commands that name a symbol
+
+    // New order types in percent, the remainder are limit orders.
+    std::uint32_t marketPct{3};
+    std::uint32_t iocPct{10};
+
+    // Per-symbol mid price: random walk of one tick on walkPct percent of its commands.
+    domain::Price startPrice{10000};  // cents
+    domain::Price tick{1};
+    std::uint32_t walkPct{20};
+
+    // Passive quotes rest halfSpread..halfSpread + depthTicks ticks away from the mid;
+    // crossPct percent of limit/IOC orders are priced through the mid instead.
+    std::uint32_t halfSpread{2};
+    std::uint32_t depthTicks{20};
+    std::uint32_t crossPct{5};
+
+    // Resting orders per symbol the flow gravitates to: above it new orders turn into
+    // cancels, at zero amends/cancels turn into new orders.
+    std::uint32_t depthTarget{200};
+
+    int minQty{1};
+    int maxQty{500};
+};
+
+struct OrderFlowStats {
+    std::uint64_t lines{};
+    std::uint64_t news{};
+    std::uint64_t amends{};
+    std::uint64_t cancels{};
+    std::uint64_t matches{};
+    std::uint64_t queries{};
+};
+
+class OrderFlowGenerator {
+public:
+    explicit OrderFlowGenerator(const OrderFlowConfig& config);
+
+    // Appends the next command line, terminated by '\n'.
+    void appendLine(std::string& out);
+
+    // Streams `lines` commands to out in large chunks. Returns false on a write error.
+    bool write(std::FILE* out, std::uint64_t lines);
+
+    const std::vector<std::string>& symbols() const { return m_symbols; }
+    const OrderFlowStats& stats() const { return m_stats; }
+
+private:
+    // What the generator believes is resting; matches are not simulated, so amends and
+    // cancels of orders that already traded produce the usual 404 rejects downstream.
+    struct Resting {
+        domain::OrderId id;
+        domain::OrderType type;
+        domain::Side side;
+        domain::Price price;
+    };
+
+    struct SymbolState {
+        domain::Price mid;
+        std::vector<Resting> resting;
+    };
+
+    std::uint64_t below(std::uint64_t n);  // uniform in [0, n)
+    bool chance(std::uint32_t pct);
+    std::uint32_t pickSymbol();
+    domain::Price quotePrice(const SymbolState& s, domain::Side side, domain::OrderType type);
+    int pickQuantity();
+
+    void appendNew(std::string& out, std::uint32_t sym);
+    void appendAmend(std::string& out, std::uint32_t sym);
+    void appendCancel(std::string& out, std::uint32_t sym);
+    void appendMatch(std::string& out);
+    void appendQuery(std::string& out, std::uint32_t sym);
+    void appendHead(std::string& out, char action, domain::OrderId id);
+
+    OrderFlowConfig m_config;
+    std::mt19937_64 m_rng;
+    std::vector<std::string> m_symbols;
+    std::vector<double> m_popularityCdf;
+    std::vector<SymbolState> m_state;
+    domain::OrderId m_nextId{1};
+    domain::Timestamp m_timestamp{0};
+    OrderFlowStats m_stats{};
+};
+
+// Alphabetic ticker for index i: AAA, AAB, ... (longer once three letters run out).
+std::string symbolName(std::uint32_t index);
+
+}  // namespace workload
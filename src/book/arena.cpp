@@ -0,0 +1,172 @@
+#include "book/arena.hpp"
+
+#include <algorithm>  // std::max
+#include <fstream>
+#include <new>
+#include <ostream>
+#include <string>
+
+#include <sys/mman.h>
+
+namespace {
+
+constexpr std::size_t kHugePage = std::size_t{2} << 20;
+constexpr std::size_t kPage = 4096;
+
+std::size_t roundUp(std::size_t n, std::size_t to) {
+    return (n + to - 1) / to * to;
+}
+
+// madvise(MADV_HUGEPAGE) succeeds whatever the THP policy is; "[never]" makes it a no-op.
+bool thpAvailable() {
+    std::ifstream in("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string policy;
+    return std::getline(in, policy) && policy.find("[never]") == std::string::npos;
+}
+
+const char* modeName(HugePageMode mode) {
+    switch (mode) {
+    case HugePageMode::Off:
+        return "off";
+    case HugePageMode::Transparent:
+        return "transparent";
+    case HugePageMode::Explicit:
+        return "explicit";
+    }
+    return "?";
+}
+
+Arena*& bookArenaSlot() {
+    static Arena* arena = nullptr;  // never destroyed: books with static storage may outlive any owner
+    return arena;
+}
+
+}  // namespace
+
+Arena::Arena(const ArenaOptions& options)
+    : m_options(options) {
+    m_options.regionBytes = roundUp(m_options.regionBytes == 0 ? kHugePage : m_options.regionBytes, kHugePage);
+    if (m_options.prefaultBytes != 0)
+        prefault(m_options.prefaultBytes);
+}
+
+Arena::~Arena() {
+    for (const Region& r : m_regions) {
+        ::munmap(r.base, r.bytes);
+    }
+}
+
+Arena::FreeBlock*& Arena::freeList(std::size_t size) {
+    if (size / kGranule <= kSmallClasses)
+        return m_small[size / kGranule - 1];
+    return m_large[size];
+}
+
+void* Arena::allocate(std::size_t bytes, std::size_t align) {
+    const std::size_t size = classOf(bytes);
+    FreeBlock*& head = freeList(size);
+    // a freed block is reused when it happens to be aligned enough, which is the usual case:
+    // a size class is mostly asked for by one type
+    if (head && (reinterpret_cast<std::uintptr_t>(head) & (align - 1)) == 0) {
+        FreeBlock* block = head;
+        head = block->next;
+        m_stats.freeListBytes -= size;
+        m_stats.usedBytes += size;
+        return block;
+    }
+
+    std::uintptr_t p = (m_cursor + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1);
+    if (m_cursor == 0 || p + size > m_end) {
+        mapRegion(size + align);  // the tail of the old region is left unused
+        p = (m_cursor + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1);
+    }
+    m_cursor = p + size;
+    m_stats.usedBytes += size;
+    return reinterpret_cast<void*>(p);
+}
+
+void Arena::deallocate(void* p, std::size_t bytes) noexcept {
+    if (!p)
+        return;
+    const std::size_t size = classOf(bytes);
+    FreeBlock*& head = freeList(size);
+    auto* block = static_cast<FreeBlock*>(p);
+    block->next = head;
+    head = block;
+    m_stats.usedBytes -= size;
+    m_stats.freeListBytes += size;
+}
+
+void Arena::mapRegion(std::size_t minBytes) {
+    const std::size_t bytes = std::max(m_options.regionBytes, roundUp(minBytes, kHugePage));
+    void* base = MAP_FAILED;
+    bool huge = false;
+    bool explicitPages = false;
+
+    if (m_options.hugePages == HugePageMode::Explicit) {
+        base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        huge = explicitPages = base != MAP_FAILED;
+    }
+    if (base == MAP_FAILED) {
+        // over-map by one huge page and trim, so the region starts on a 2 MiB boundary and
+        // THP can back all of it
+        const std::size_t padded = bytes + kHugePage;
+        void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            throw std::bad_alloc();
+        const auto start = reinterpret_cast<std::uintptr_t>(raw);
+        const std::uintptr_t aligned = roundUp(start, kHugePage);
+        if (aligned != start)
+            ::munmap(raw, aligned - start);
+        if (const std::size_t tail = padded - (aligned - start) - bytes; tail != 0)
+            ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+        base = reinterpret_cast<void*>(aligned);
+        if (m_options.hugePages != HugePageMode::Off) {
+            static const bool thp = thpAvailable();
+            huge = thp && ::madvise(base, bytes, MADV_HUGEPAGE) == 0;
+        }
+    }
+
+    m_regions.push_back(Region{base, bytes});
+    m_cursor = reinterpret_cast<std::uintptr_t>(base);
+    m_end = m_cursor + bytes;
+    m_stats.mappedBytes += bytes;
+    ++m_stats.regions;
+    m_stats.hugeRegions += huge ? 1 : 0;
+    m_stats.explicitRegions += explicitPages ? 1 : 0;
+}
+
+// Touches `bytes` from the cursor on, so the kernel backs them now rather than on the
+// first orders.
+void Arena::prefault(std::size_t bytes) {
+    if (m_cursor == 0 || m_end - m_cursor < bytes)
+        mapRegion(bytes);
+    for (std::uintptr_t p = m_cursor; p < m_cursor + bytes; p += kPage) {
+        *reinterpret_cast<volatile char*>(p) = 0;
+    }
+    m_stats.prefaultedBytes += bytes;
+}
+
+void Arena::report(std::ostream& os) const {
+    constexpr double kMiB = 1024.0 * 1024.0;
+    os << "book arena: huge pages " << modeName(m_options.hugePages) << ", " << m_stats.regions << " region(s), "
+       << m_stats.hugeRegions << " huge (" << m_stats.explicitRegions << " explicit)\n"
+       << "  mapped " << m_stats.mappedBytes / kMiB << " MiB, used " << m_stats.usedBytes / kMiB << " MiB, free lists "
+       << m_stats.freeListBytes / kMiB << " MiB, prefaulted " << m_stats.prefaultedBytes / kMiB << " MiB\n";
+}
+
+Arena& bookArena() {
+    Arena*& arena = bookArenaSlot();
+    if (!arena)
+        arena = new Arena();
+    return *arena;
+}
+
+bool configureBookArena(const ArenaOptions& options) {
+    Arena*& arena = bookArenaSlot();
+    if (arena && arena->stats().usedBytes != 0)
+        return false;
+    delete arena;
+    arena = new Arena(options);
+    return true;
+}
@@ -0,0 +1,443 @@
+#include "book/indexed_order_book.hpp"
+
+#include "marketdata/l2_feed.hpp"
+
+#include <memory>  // std::uninitialized_default_construct_n, std::destroy_n
+#include <ostream>
+
+namespace {
+
+constexpr std::size_t kNodesPerChunk = 1024;
+
+}  // namespace
+
+IndexedOrderBook::IndexedOrderBook() = default;
+
+IndexedOrderBook::~IndexedOrderBook() {
+    for (Node* chunk : m_chunks) {
+        std::destroy_n(chunk, kNodesPerChunk);
+        BookAllocator<Node>().deallocate(chunk, kNodesPerChunk);
+    }
+}
+
+bool IndexedOrderBook::hasBuy() const {
+    return !m_levels[0].empty();
+}
+
+bool IndexedOrderBook::hasSell() const {
+    return !m_levels[1].empty();
+}
+
+std::optional<domain::Price> IndexedOrderBook::bestBidPrice() const {
+    if (const Node* n = frontOf(0))
+        return n->order.price;
+    return std::nullopt;
+}
+
+std::optional<domain::Price> IndexedOrderBook::bestAskPrice() const {
+    if (const Node* n = frontOf(1))
+        return n->order.price;
+    return std::nullopt;
+}
+
+domain::Order* IndexedOrderBook::bestBidOrder() {
+    Node* n = frontOf(0);
+    return n ? &n->order : nullptr;
+}
+
+domain::Order* IndexedOrderBook::bestAskOrder() {
+    Node* n = frontOf(1);
+    return n ? &n->order : nullptr;
+}
+
+void IndexedOrderBook::consumeBestBid(int matchedQty) {
+    consume(frontOf(0), matchedQty);
+}
+
+void IndexedOrderBook::consumeBestAsk(int matchedQty) {
+    consume(frontOf(1), matchedQty);
+}
+
+std::optional<domain::Price> IndexedOrderBook::bestBidPrice(const domain::Symbol& symbol) const {
+    if (const Node* n = frontOf(0, symbol))
+        return n->order.price;
+    return std::nullopt;
+}
+
+std::optional<domain::Price> IndexedOrderBook::bestAskPrice(const domain::Symbol& symbol) const {
+    if (const Node* n = frontOf(1, symbol))
+        return n->order.price;
+    return std::nullopt;
+}
+
+domain::Order* IndexedOrderBook::bestBidOrder(const domain::Symbol& symbol) {
+    Node* n = frontOf(0, symbol);
+    return n ? &n->order : nullptr;
+}
+
+domain::Order* IndexedOrderBook::bestAskOrder(const domain::Symbol& symbol) {
+    Node* n = frontOf(1, symbol);
+    return n ? &n->order : nullptr;
+}
+
+void IndexedOrderBook::consumeBestBid(int matchedQty, const domain::Symbol& symbol) {
+    consume(frontOf(0, symbol), matchedQty);
+}
+
+void IndexedOrderBook::consumeBestAsk(int matchedQty, const domain::Symbol& symbol) {
+    consume(frontOf(1, symbol), matchedQty);
+}
+
+bool IndexedOrderBook::isLive(domain::OrderId id) const {
+    return m_index.contains(id);
+}
+
+bool IndexedOrderBook::add(const domain::Order& order) {
+    return addTo(m_symbols[order.symbol], order);
+}
+
+std::size_t IndexedOrderBook::addBatch(const domain::Order* orders, std::size_t count, bool* added) {
+    if (count == 0)
+        return 0;
+    SymbolSides& symbol = m_symbols[orders[0].symbol];
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        added[i] = addTo(symbol, orders[i]);
+        n += added[i] ? 1 : 0;
+    }
+    return n;
+}
+
+bool IndexedOrderBook::addTo(SymbolSides& symbol, const domain::Order& order) {
+    auto [slot, inserted] = m_index.tryEmplace(order.orderId, nullptr);
+    if (!inserted)
+        return false;
+
+    const std::size_t side = sideIndex(order.side);
+    Node* n = acquireNode();
+    n->order = order;
+    n->symSide = &symbol[side];
+    *slot = n;
+    link(side, n);
+
+    ++m_counts[side];
+    return true;
+}
+
+// Appends `n` to its price level FIFO (all symbols) and to its symbol's FIFO at that
+// price, both keyed by n->order.price.
+void IndexedOrderBook::link(std::size_t side, Node* n) {
+    const domain::Price key = levelKey(side, n->order.price);
+
+    n->level = m_levels[side].try_emplace(key, Level{n->order.price}).first;
+    Level& level = n->level->second;
+    n->prev = level.tail;
+    n->next = nullptr;
+    (level.tail ? level.tail->next : level.head) = n;
+    level.tail = n;
+    ++level.count;
+
+    const auto [symIt, inserted] =
+        n->symSide->try_emplace(key, SymbolLevel{nullptr, nullptr, LevelSummary{n->order.price, 0, 0}});
+    n->symLevel = symIt;
+    SymbolLevel& symLevel = n->symLevel->second;
+    symLevel.totals.quantity += n->order.quantity;
+    ++symLevel.totals.orders;
+    n->symPrev = symLevel.tail;
+    n->symNext = nullptr;
+    (symLevel.tail ? symLevel.tail->symNext : symLevel.head) = n;
+    symLevel.tail = n;
+    publishLevel(n, !inserted);
+}
+
+std::size_t IndexedOrderBook::liveCount() const {
+    return m_index.size();
+}
+
+std::size_t IndexedOrderBook::buyCount() const {
+    return m_counts[0];
+}
+
+std::size_t IndexedOrderBook::sellCount() const {
+    return m_counts[1];
+}
+
+domain::Order* IndexedOrderBook::getById(domain::OrderId id) {
+    Node* const* n = m_index.find(id);
+    return n ? &(*n)->order : nullptr;
+}
+
+const domain::Order* IndexedOrderBook::findOrder(domain::OrderId id) const {
+    Node* const* n = m_index.find(id);
+    return n ? &(*n)->order : nullptr;
+}
+
+bool IndexedOrderBook::erase(domain::OrderId id) {
+    Node* const* n = m_index.find(id);
+    if (!n)
+        return false;
+    unlink(*n);
+    return true;
+}
+
+void IndexedOrderBook::reduceQuantity(domain::Order& order, int newQty, domain::Timestamp ts) {
+    Node* n = *m_index.find(order.orderId);
+    const std::int64_t qtyDelta = static_cast<std::int64_t>(newQty) - order.quantity;
+    n->symLevel->second.totals.quantity += qtyDelta;
+    order.quantity = newQty;
+    order.timeStamp = ts;
+    if (qtyDelta != 0)
+        publishLevel(n, true);
+}
+
+void IndexedOrderBook::relocate(domain::Order& order, domain::Price newPrice, int newQty, domain::Timestamp ts) {
+    Node* n = *m_index.find(order.orderId);
+    const std::size_t side = sideIndex(n->order.side);
+
+    if (newPrice == n->order.price) {
+        // same level: move to the tail of both FIFOs, the levels themselves stay
+        Level& level = n->level->second;
+        if (level.tail != n) {
+            (n->prev ? n->prev->next : level.head) = n->next;
+            n->next->prev = n->prev;
+            n->prev = level.tail;
+            n->next = nullptr;
+            level.tail->next = n;
+            level.tail = n;
+        }
+        SymbolLevel& symLevel = n->symLevel->second;
+        if (symLevel.tail != n) {
+            (n->symPrev ? n->symPrev->symNext : symLevel.head) = n->symNext;
+            n->symNext->symPrev = n->symPrev;
+            n->symPrev = symLevel.tail;
+            n->symNext = nullptr;
+            symLevel.tail->symNext = n;
+            symLevel.tail = n;
+        }
+        const std::int64_t qtyDelta = static_cast<std::int64_t>(newQty) - n->order.quantity;
+        symLevel.totals.quantity += qtyDelta;
+        n->order.quantity = newQty;
+        n->order.timeStamp = ts;
+        if (qtyDelta != 0)
+            publishLevel(n, true);
+        return;
+    }
+
+    unlinkFromLevel(side, n);
+    unlinkFromSymbolLevel(n);
+    n->order.price = newPrice;
+    n->order.quantity = newQty;
+    n->order.timeStamp = ts;
+    link(side, n);
+}
+
+std::size_t IndexedOrderBook::cancelSymbol(const domain::Symbol& symbol,
+                                           domain::Side side,
+                                           const OrderVisitor& onCancel) {
+    const auto it = m_symbols.find(symbol);
+    if (it == m_symbols.end())
+        return 0;
+    const std::size_t s = sideIndex(side);
+    SymbolLevels& levels = it->second[s];
+    publishDeleted(symbol, s, levels);
+    std::size_t removed = 0;
+    for (auto& [key, symLevel] : levels) {
+        for (Node* n = symLevel.head; n;) {
+            Node* next = n->symNext;
+            onCancel(n->order);
+            unlinkFromLevel(s, n);
+            m_index.erase(n->order.orderId);
+            releaseNode(n);
+            ++removed;
+            n = next;
+        }
+    }
+    // the symbol lists go away whole instead of node by node
+    levels.clear();
+    m_counts[s] -= removed;
+    return removed;
+}
+
+std::size_t IndexedOrderBook::cancelAll(const OrderVisitor& onCancel) {
+    const std::size_t removed = m_index.size();
+    for (const auto& levels : m_levels) {
+        for (const auto& [key, level] : levels) {
+            for (const Node* n = level.head; n; n = n->next) {
+                onCancel(n->order);
+            }
+        }
+    }
+    if (m_l2) {
+        for (const auto& [symbol, sides] : m_symbols) {
+            publishDeleted(symbol, 0, sides[0]);
+            publishDeleted(symbol, 1, sides[1]);
+        }
+    }
+    clearLevels();  // parked stops are not part of the levels
+    return removed;
+}
+
+std::size_t IndexedOrderBook::depth(const domain::Symbol& symbol,
+                                    domain::Side side,
+                                    std::size_t maxLevels,
+                                    LevelSummary* out) const {
+    const auto it = m_symbols.find(symbol);
+    if (it == m_symbols.end())
+        return 0;
+    std::size_t n = 0;
+    const SymbolLevels& levels = it->second[sideIndex(side)];
+    for (auto level = levels.begin(); level != levels.end() && n < maxLevels; ++level) {
+        out[n++] = level->second.totals;
+    }
+    return n;
+}
+
+void IndexedOrderBook::dump(std::ostream& os) const {
+    os << "=== ORDER BOOK DUMP ===\n";
+
+    const char* titles[2] = {"BUY (highest -> lowest)\n", "SELL (lowest -> highest)\n"};
+    for (std::size_t side = 0; side < 2; ++side) {
+        os << titles[side];
+        if (m_levels[side].empty()) {
+            os << "  <empty>\n";
+            continue;
+        }
+        for (const auto& [key, level] : m_levels[side]) {
+            os << "  price=";
+            domain::printPrice(os, level.price);
+            os << " | count=" << level.count << "\n";
+            for (const Node* n = level.head; n; n = n->next) {
+                os << "    " << n->order << "\n";
+            }
+        }
+    }
+
+    if (!m_stops.empty())
+        m_stops.dump(os);
+    os << "========================\n";
+}
+
+void IndexedOrderBook::forEach(const OrderVisitor& visit) const {
+    for (const auto& levels : m_levels) {
+        for (const auto& [key, level] : levels) {
+            for (const Node* n = level.head; n; n = n->next) {
+                visit(n->order);
+            }
+        }
+    }
+}
+
+void IndexedOrderBook::reserve(std::size_t orders) {
+    m_index.reserve(orders);
+    while (m_chunks.size() * kNodesPerChunk < orders) {
+        addChunk();
+    }
+}
+
+void IndexedOrderBook::prepareSymbol(const domain::Symbol& symbol) {
+    m_symbols.try_emplace(symbol);
+}
+
+void IndexedOrderBook::clear() {
+    clearLevels();
+    m_stops.clear();
+}
+
+void IndexedOrderBook::clearLevels() {
+    m_index.forEach([this](domain::OrderId, Node* node) { releaseNode(node); });
+    m_index.clear();
+    m_levels[0].clear();
+    m_levels[1].clear();
+    m_symbols.clear();
+    m_counts = {};
+}
+
+IndexedOrderBook::Node* IndexedOrderBook::frontOf(std::size_t side) const {
+    const Levels& levels = m_levels[side];
+    return levels.empty() ? nullptr : levels.begin()->second.head;
+}
+
+IndexedOrderBook::Node* IndexedOrderBook::frontOf(std::size_t side, const domain::Symbol& symbol) const {
+    const auto it = m_symbols.find(symbol);
+    if (it == m_symbols.end() || it->second[side].empty())
+        return nullptr;
+    return it->second[side].begin()->second.head;
+}
+
+void IndexedOrderBook::consume(Node* node, int matchedQty) {
+    if (!node || matchedQty <= 0 || matchedQty > node->order.quantity)
+        return;
+    node->order.quantity -= matchedQty;
+    node->symLevel->second.totals.quantity -= matchedQty;
+    if (node->order.quantity == 0)
+        unlink(node);  // publishes the level with the order gone
+    else
+        publishLevel(node, true);
+}
+
+void IndexedOrderBook::unlink(Node* n) {
+    const std::size_t side = sideIndex(n->order.side);
+    unlinkFromLevel(side, n);
+    unlinkFromSymbolLevel(n);
+
+    m_index.erase(n->order.orderId);
+    --m_counts[side];
+    releaseNode(n);
+}
+
+void IndexedOrderBook::unlinkFromLevel(std::size_t side, Node* n) {
+    Level& level = n->level->second;
+    (n->prev ? n->prev->next : level.head) = n->next;
+    (n->next ? n->next->prev : level.tail) = n->prev;
+    if (--level.count == 0)
+        m_levels[side].erase(n->level);
+}
+
+void IndexedOrderBook::unlinkFromSymbolLevel(Node* n) {
+    SymbolLevel& symLevel = n->symLevel->second;
+    symLevel.totals.quantity -= n->order.quantity;
+    --symLevel.totals.orders;
+    (n->symPrev ? n->symPrev->symNext : symLevel.head) = n->symNext;
+    (n->symNext ? n->symNext->symPrev : symLevel.tail) = n->symPrev;
+    publishLevel(n, true);
+    if (!symLevel.head)
+        n->symSide->erase(n->symLevel);
+}
+
+void IndexedOrderBook::publishLevel(const Node* n, bool existed) {
+    if (m_l2)
+        m_l2->level(n->order.symbol, n->order.side, n->symLevel->second.totals, existed);
+}
+
+void IndexedOrderBook::publishDeleted(const domain::Symbol& symbol, std::size_t side, const SymbolLevels& levels) {
+    if (!m_l2)
+        return;
+    const domain::Side s = side == 0 ? domain::Side::Buy : domain::Side::Sell;
+    for (const auto& [key, symLevel] : levels) {
+        m_l2->level(symbol, s, LevelSummary{symLevel.totals.price, 0, 0}, true);
+    }
+}
+
+void IndexedOrderBook::addChunk() {
+    Node* chunk = BookAllocator<Node>().allocate(kNodesPerChunk);
+    std::uninitialized_default_construct_n(chunk, kNodesPerChunk);
+    // handed out in address order, so orders added in a row sit next to each other
+    for (std::size_t i = kNodesPerChunk; i-- > 0;) {
+        chunk[i].next = m_free;
+        m_free = &chunk[i];
+    }
+    m_chunks.push_back(chunk);
+}
+
+IndexedOrderBook::Node* IndexedOrderBook::acquireNode() {
+    if (!m_free)
+        addChunk();
+    Node* n = m_free;
+    m_free = n->next;
+    return n;
+}
+
+void IndexedOrderBook::releaseNode(Node* node) {
+    node->next = m_free;
+    m_free = node;
+}
@@ -1,7 +1,31 @@
 #include "book/order_book.hpp"
 
+#include "marketdata/l2_feed.hpp"
+
+#include <utility>  // std::as_const
+
+namespace {
+
+struct LevelChange {
+    LevelSummary after;  // orders == 0 => the level is gone
+    bool existed;
+};
+
+template <typename Levels>
+LevelChange adjustLevel(Levels& levels, domain::Price price, std::int64_t qtyDelta, int orderDelta) {
+    auto [it, inserted] = levels.try_emplace(price, LevelSummary{price, 0, 0});
+    it->second.quantity += qtyDelta;
+    it->second.orders += static_cast<std::uint32_t>(orderDelta);
+    const LevelChange change{it->second, !inserted};
+    if (it->second.orders == 0)
+        levels.erase(it);
+    return change;
+}
+
+}  // namespace
+
 bool OrderBook::isLive(domain::OrderId id) const {
-    return m_liveIds.find(id) != m_liveIds.end();
+    return m_live.contains(id);
 }
 
 bool OrderBook::hasBuy() const {
@@ -19,17 +43,10 @@ std::optional<domain::Price> OrderBook::bestBidPrice() const {
     return std::nullopt;
 }
 
-std::optional<domain::Price> OrderBook::bestBidPrice(const std::string& symbol) const {
-    if (hasBuy()) {
-        for (const auto& items : m_buyBook) {
-            const auto& q = items.second;
-            for (const auto& o : q) {
-                if (o.symbol == symbol) {
-                    return items.first;
-                }
-            }
-        }
-        return std::nullopt;
+std::optional<domain::Price> OrderBook::bestBidPrice(const domain::Symbol& symbol) const {
+    const SymbolDepth* d = depthOf(symbol);
+    if (d && !d->buy.empty()) {
+        return d->buy.begin()->first;
     }
     return std::nullopt;
 }
@@ -41,17 +58,10 @@ std::optional<domain::Price> OrderBook::bestAskPrice() const {
     return std::nullopt;
 }
 
-std::optional<domain::Price> OrderBook::bestAskPrice(const std::string& symbol) const {
-    if (hasSell()) {
-        for (const auto& items : m_sellBook) {
-            const auto& q = items.second;
-            for (const auto& o : q) {
-                if (o.symbol == symbol) {
-                    return items.first;
-                }
-            }
-        }
-        return std::nullopt;
+std::optional<domain::Price> OrderBook::bestAskPrice(const domain::Symbol& symbol) const {
+    const SymbolDepth* d = depthOf(symbol);
+    if (d && !d->sell.empty()) {
+        return d->sell.begin()->first;
     }
     return std::nullopt;
 }
@@ -63,16 +73,15 @@ domain::Order* OrderBook::bestBidOrder() {
     return nullptr;
 }
 
-domain::Order* OrderBook::bestBidOrder(const std::string& symbol) {
-    if (!hasBuy())
+domain::Order* OrderBook::bestBidOrder(const domain::Symbol& symbol) {
+    const auto price = bestBidPrice(symbol);
+    if (!price)
         return nullptr;
 
-    for (auto& items : m_buyBook) {
-        auto& q = items.second;
-        for (auto& o : q) {
-            if (o.symbol == symbol) {
-                return &o;
-            }
+    // the symbol's best level is known from its totals - only that queue is scanned
+    for (auto& o : *levelOf(domain::Side::Buy, *price)) {
+        if (o.symbol == symbol) {
+            return &o;
         }
     }
     return nullptr;
@@ -85,16 +94,14 @@ domain::Order* OrderBook::bestAskOrder() {
     return nullptr;
 }
 
-domain::Order* OrderBook::bestAskOrder(const std::string& symbol) {
-    if (!hasSell())
+domain::Order* OrderBook::bestAskOrder(const domain::Symbol& symbol) {
+    const auto price = bestAskPrice(symbol);
+    if (!price)
         return nullptr;
 
-    for (auto& items : m_sellBook) {
-        auto& q = items.second;
-        for (auto& o : q) {
-            if (o.symbol == symbol) {
-                return &o;
-            }
+    for (auto& o : *levelOf(domain::Side::Sell, *price)) {
+        if (o.symbol == symbol) {
+            return &o;
         }
     }
     return nullptr;
@@ -111,10 +118,11 @@ void OrderBook::consumeBestBid(int matchedQty) {
         auto& q = it->second;
 
         ord->quantity -= matchedQty;
+        adjustDepth(*ord, -matchedQty, ord->quantity == 0 ? -1 : 0);
         if (ord->quantity == 0) {
             auto id = ord->orderId;  // extract becasue it will disapear for a moment
             q.pop_front();
-            m_liveIds.erase(id);
+            m_live.erase(id);
             if (q.empty()) {
                 // there are no more levels for the same price
                 // we may remove level from the map (order_book)
@@ -135,10 +143,11 @@ void OrderBook::consumeBestAsk(int matchedQty) {
         auto& q = it->second;
 
         ord->quantity -= matchedQty;
+        adjustDepth(*ord, -matchedQty, ord->quantity == 0 ? -1 : 0);
         if (ord->quantity == 0) {
             auto id = ord->orderId;  // extract becasue it will disapear for a moment
             q.pop_front();
-            m_liveIds.erase(id);
+            m_live.erase(id);
             if (q.empty()) {
                 // there are no more levels for the same price
                 // we may remove level from the map (order_book)
@@ -149,80 +158,95 @@ void OrderBook::consumeBestAsk(int matchedQty) {
         return;
 }
 
-void OrderBook::consumeBestBid(int matchedQty, const std::string& symbol) {
+void OrderBook::consumeBestBid(int matchedQty, const domain::Symbol& symbol) {
     if (matchedQty <= 0)
         return;
-    if (!hasBuy())
+    const auto price = bestBidPrice(symbol);
+    if (!price)
         return;
-    // Iterate BUY price levels from best to worst (map is already sorted best->worst)
-    for (auto levelIt = m_buyBook.begin(); levelIt != m_buyBook.end(); ++levelIt) {
-        auto& q = levelIt->second;
-        // find first FIFO order in this price level they matches the symbol
-        for (auto ordIt = q.begin(); ordIt != q.end(); ++ordIt) {
-            if (ordIt->symbol != symbol) {
-                continue;
-            }
-            // Found the order to consume
-            if (matchedQty > ordIt->quantity) {
-                // This should not happen if matcher computed matchedQty correctly.
-                // MVP: just ignore.
-                return;
-            }
-            ordIt->quantity -= matchedQty;
-            if (ordIt->quantity == 0) {
-                const auto id = ordIt->orderId;
-                // Remove the order from this price level queue
-                q.erase(ordIt);
-                m_liveIds.erase(id);
-                // If the whole price level is empty, remove the level from the map
-                if (q.empty()) {
-                    m_buyBook.erase(levelIt);
-                }
+    // Only the symbol's best level can hold its first FIFO order
+    auto levelIt = m_buyBook.find(*price);
+    auto& q = levelIt->second;
+    for (auto ordIt = q.begin(); ordIt != q.end(); ++ordIt) {
+        if (ordIt->symbol != symbol) {
+            continue;
+        }
+        // Found the order to consume
+        if (matchedQty > ordIt->quantity) {
+            // This should not happen if matcher computed matchedQty correctly.
+            // MVP: just ignore.
+            return;
+        }
+        ordIt->quantity -= matchedQty;
+        adjustDepth(*ordIt, -matchedQty, ordIt->quantity == 0 ? -1 : 0);
+        if (ordIt->quantity == 0) {
+            const auto id = ordIt->orderId;
+            // Remove the order from this price level queue
+            q.erase(ordIt);
+            m_live.erase(id);
+            // If the whole price level is empty, remove the level from the map
+            if (q.empty()) {
+                m_buyBook.erase(levelIt);
             }
-            return;  // consumed exactly one order
         }
-        // If we reach here: no BUY order for given symbol was found -> nothing to consume
+        return;  // consumed exactly one order
     }
 }
 
-void OrderBook::consumeBestAsk(int matchedQty, const std::string& symbol) {
+void OrderBook::consumeBestAsk(int matchedQty, const domain::Symbol& symbol) {
     if (matchedQty <= 0)
         return;
-    if (!hasSell())
+    const auto price = bestAskPrice(symbol);
+    if (!price)
         return;
-    // Iterate BUY price levels from best to worst (map is already sorted best->worst)
-    for (auto levelIt = m_sellBook.begin(); levelIt != m_sellBook.end(); ++levelIt) {
-        auto& q = levelIt->second;
-        // find first FIFO order in this price level they matches the symbol
-        for (auto ordIt = q.begin(); ordIt != q.end(); ++ordIt) {
-            if (ordIt->symbol != symbol) {
-                continue;
-            }
-            // Found the order to consume
-            if (matchedQty > ordIt->quantity) {
-                // This should not happen if matcher computed matchedQty correctly.
-                // MVP: just ignore.
-                return;
-            }
-            ordIt->quantity -= matchedQty;
-            if (ordIt->quantity == 0) {
-                const auto id = ordIt->orderId;
-                // Remove the order from this price level queue
-                q.erase(ordIt);
-                m_liveIds.erase(id);
-                // If the whole price level is empty, remove the level from the map
-                if (q.empty()) {
-                    m_sellBook.erase(levelIt);
-                }
+    // Only the symbol's best level can hold its first FIFO order
+    auto levelIt = m_sellBook.find(*price);
+    auto& q = levelIt->second;
+    for (auto ordIt = q.begin(); ordIt != q.end(); ++ordIt) {
+        if (ordIt->symbol != symbol) {
+            continue;
+        }
+        // Found the order to consume
+        if (matchedQty > ordIt->quantity) {
+            // This should not happen if matcher computed matchedQty correctly.
+            // MVP: just ignore.
+            return;
+        }
+        ordIt->quantity -= matchedQty;
+        adjustDepth(*ordIt, -matchedQty, ordIt->quantity == 0 ? -1 : 0);
+        if (ordIt->quantity == 0) {
+            const auto id = ordIt->orderId;
+            // Remove the order from this price level queue
+            q.erase(ordIt);
+            m_live.erase(id);
+            // If the whole price level is empty, remove the level from the map
+            if (q.empty()) {
+                m_sellBook.erase(levelIt);
             }
-            return;  // consumed exactly one order
         }
-        // If we reach here: no BUY order for given symbol was found -> nothing to consume
+        return;  // consumed exactly one order
     }
 }
 
 bool OrderBook::add(const domain::Order& order) {
-    if (isLive(order.orderId)) {
+    return addTo(m_symbolDepth[order.symbol], order);
+}
+
+std::size_t OrderBook::addBatch(const domain::Order* orders, std::size_t count, bool* added) {
+    if (count == 0) {
+        return 0;
+    }
+    SymbolDepth& depth = m_symbolDepth[orders[0].symbol];
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        added[i] = addTo(depth, orders[i]);
+        n += added[i] ? 1 : 0;
+    }
+    return n;
+}
+
+bool OrderBook::addTo(SymbolDepth& depth, const domain::Order& order) {
+    if (!m_live.tryEmplace(order.orderId, OrderLocation{order.side, order.price}).second) {
         return false;
     }
 
@@ -232,12 +256,12 @@ bool OrderBook::add(const domain::Order& order) {
         m_sellBook[order.price].push_back(order);
     }
 
-    m_liveIds.insert(order.orderId);
+    adjustDepth(depth, order, order.quantity, 1);
     return true;
 }
 
 std::size_t OrderBook::liveCount() const {
-    return m_liveIds.size();
+    return m_live.size();
 }
 
 std::size_t OrderBook::buyCount() const {
@@ -257,66 +281,233 @@ std::size_t OrderBook::sellCount() const {
 }
 
 domain::Order* OrderBook::getById(domain::OrderId id) {
-    // scan buy side
-    for (auto& [price, q] : m_buyBook) {
-        for (auto& ord : q) {
-            if (ord.orderId == id) {
-                return &ord;
-            }
-        }
-    }
+    return const_cast<domain::Order*>(std::as_const(*this).findOrder(id));
+}
 
-    // scan sell side
-    for (auto& [price, q] : m_sellBook) {
-        for (auto& ord : q) {
-            if (ord.orderId == id) {
-                return &ord;
-            }
+const domain::Order* OrderBook::findOrder(domain::OrderId id) const {
+    const OrderLocation* loc = m_live.find(id);
+    if (!loc) {
+        return nullptr;
+    }
+    for (const auto& ord : *levelOf(loc->side, loc->price)) {
+        if (ord.orderId == id) {
+            return &ord;
         }
     }
-
     return nullptr;
 }
 
 bool OrderBook::erase(domain::OrderId id) {
-    // buy side
-    for (auto levelIt = m_buyBook.begin(); levelIt != m_buyBook.end(); ++levelIt) {
-        auto& q = levelIt->second;
+    const OrderLocation* live = m_live.find(id);
+    if (!live) {
+        return false;
+    }
+    const OrderLocation loc = *live;
+    m_live.erase(id);
 
-        for (auto it = q.begin(); it != q.end(); ++it) {
-            if (it->orderId == id) {
-                q.erase(it);
+    auto removeFrom = [&](auto& side) {
+        auto levelIt = side.find(loc.price);
+        auto& q = levelIt->second;
+        for (auto ordIt = q.begin(); ordIt != q.end(); ++ordIt) {
+            if (ordIt->orderId == id) {
+                adjustDepth(*ordIt, -ordIt->quantity, -1);
+                q.erase(ordIt);
 
                 // remove empty price level
                 if (q.empty()) {
-                    m_buyBook.erase(levelIt);
+                    side.erase(levelIt);
                 }
-
-                m_liveIds.erase(id);
-                return true;
+                return;
             }
         }
+    };
+    if (loc.side == domain::Side::Buy) {
+        removeFrom(m_buyBook);
+    } else {
+        removeFrom(m_sellBook);
     }
+    return true;
+}
 
-    // sell side
-    for (auto levelIt = m_sellBook.begin(); levelIt != m_sellBook.end(); ++levelIt) {
-        auto& q = levelIt->second;
+void OrderBook::reduceQuantity(domain::Order& order, int newQty, domain::Timestamp ts) {
+    adjustDepth(order, static_cast<std::int64_t>(newQty) - order.quantity, 0);
+    order.quantity = newQty;
+    order.timeStamp = ts;
+}
 
-        for (auto it = q.begin(); it != q.end(); ++it) {
-            if (it->orderId == id) {
-                q.erase(it);
+void OrderBook::relocate(domain::Order& order, domain::Price newPrice, int newQty, domain::Timestamp ts) {
+    OrderLocation* live = m_live.find(order.orderId);
+    const domain::Price oldPrice = live->price;
+    live->price = newPrice;
 
-                if (q.empty()) {
-                    m_sellBook.erase(levelIt);
-                }
+    auto moveIn = [&](auto& side) {
+        auto levelIt = side.find(oldPrice);
+        auto& q = levelIt->second;
+        auto ordIt = q.begin();
+        while (&*ordIt != &order) {
+            ++ordIt;
+        }
+        domain::Order moved = std::move(*ordIt);
+        q.erase(ordIt);
+
+        if (oldPrice == newPrice) {
+            // same level: only the quantity total changes
+            adjustDepth(moved, static_cast<std::int64_t>(newQty) - moved.quantity, 0);
+            moved.quantity = newQty;
+            moved.timeStamp = ts;
+            q.push_back(std::move(moved));
+            return;
+        }
+        adjustDepth(moved, -moved.quantity, -1);
+        if (q.empty()) {
+            side.erase(levelIt);
+        }
+        moved.price = newPrice;
+        moved.quantity = newQty;
+        moved.timeStamp = ts;
+        adjustDepth(moved, newQty, 1);
+        side[newPrice].push_back(std::move(moved));
+    };
+    if (live->side == domain::Side::Buy) {
+        moveIn(m_buyBook);
+    } else {
+        moveIn(m_sellBook);
+    }
+}
 
-                m_liveIds.erase(id);
+std::size_t OrderBook::cancelSymbol(const domain::Symbol& symbol, domain::Side side, const OrderVisitor& onCancel) {
+    const auto d = m_symbolDepth.find(symbol);
+    if (d == m_symbolDepth.end()) {
+        return 0;
+    }
+    std::size_t removed = 0;
+    // the symbol's totals name exactly the levels holding its orders on that side
+    auto dropFrom = [&](auto& book, auto& symbolLevels) {
+        for (const auto& [price, totals] : symbolLevels) {
+            publishDeleted(symbol, side, price);
+            auto levelIt = book.find(price);
+            auto& q = levelIt->second;
+            std::erase_if(q, [&](const domain::Order& o) {
+                if (o.symbol != symbol) {
+                    return false;
+                }
+                onCancel(o);
+                m_live.erase(o.orderId);
+                ++removed;
                 return true;
+            });
+            if (q.empty()) {
+                book.erase(levelIt);
+            }
+        }
+        symbolLevels.clear();
+    };
+    if (side == domain::Side::Buy) {
+        dropFrom(m_buyBook, d->second.buy);
+    } else {
+        dropFrom(m_sellBook, d->second.sell);
+    }
+    return removed;
+}
+
+std::size_t OrderBook::cancelAll(const OrderVisitor& onCancel) {
+    const std::size_t removed = m_live.size();
+    for (const auto& [price, q] : m_buyBook) {
+        for (const auto& o : q) {
+            onCancel(o);
+        }
+    }
+    for (const auto& [price, q] : m_sellBook) {
+        for (const auto& o : q) {
+            onCancel(o);
+        }
+    }
+    if (m_l2) {
+        for (const auto& [symbol, d] : m_symbolDepth) {
+            for (const auto& [price, totals] : d.buy) {
+                publishDeleted(symbol, domain::Side::Buy, price);
+            }
+            for (const auto& [price, totals] : d.sell) {
+                publishDeleted(symbol, domain::Side::Sell, price);
             }
         }
     }
+    clearLevels();  // parked stops are not part of the levels
+    return removed;
+}
 
-    return false;
+std::size_t OrderBook::depth(const domain::Symbol& symbol,
+                             domain::Side side,
+                             std::size_t maxLevels,
+                             LevelSummary* out) const {
+    const SymbolDepth* d = depthOf(symbol);
+    if (!d) {
+        return 0;
+    }
+    std::size_t n = 0;
+    auto copy = [&](const auto& levels) {
+        for (auto it = levels.begin(); it != levels.end() && n < maxLevels; ++it) {
+            out[n++] = it->second;
+        }
+    };
+    if (side == domain::Side::Buy) {
+        copy(d->buy);
+    } else {
+        copy(d->sell);
+    }
+    return n;
+}
+
+OrderBook::OrderQueue* OrderBook::levelOf(domain::Side side, domain::Price price) {
+    return const_cast<OrderQueue*>(std::as_const(*this).levelOf(side, price));
+}
+
+const OrderBook::OrderQueue* OrderBook::levelOf(domain::Side side, domain::Price price) const {
+    if (side == domain::Side::Buy) {
+        const auto it = m_buyBook.find(price);
+        return it != m_buyBook.end() ? &it->second : nullptr;
+    }
+    const auto it = m_sellBook.find(price);
+    return it != m_sellBook.end() ? &it->second : nullptr;
+}
+
+const OrderBook::SymbolDepth* OrderBook::depthOf(const domain::Symbol& symbol) const {
+    const auto it = m_symbolDepth.find(symbol);
+    return it != m_symbolDepth.end() ? &it->second : nullptr;
+}
+
+void OrderBook::adjustDepth(const domain::Order& order, std::int64_t qtyDelta, int orderDelta) {
+    adjustDepth(m_symbolDepth[order.symbol], order, qtyDelta, orderDelta);
+}
+
+void OrderBook::adjustDepth(SymbolDepth& depth, const domain::Order& order, std::int64_t qtyDelta, int orderDelta) {
+    const LevelChange change = order.side == domain::Side::Buy
+                                   ? adjustLevel(depth.buy, order.price, qtyDelta, orderDelta)
+                                   : adjustLevel(depth.sell, order.price, qtyDelta, orderDelta);
+    if (m_l2 && (qtyDelta != 0 || orderDelta != 0)) {
+        m_l2->level(order.symbol, order.side, change.after, change.existed);
+    }
+}
+
+void OrderBook::publishDeleted(const domain::Symbol& symbol, domain::Side side, domain::Price price) {
+    if (m_l2) {
+        m_l2->level(symbol, side, LevelSummary{price, 0, 0}, true);
+    }
+}
+
+void OrderBook::rebuildDepth() {
+    // straight into the totals: a reload is not a stream of level changes
+    m_symbolDepth.clear();
+    for (const auto& [price, q] : m_buyBook) {
+        for (const auto& o : q) {
+            adjustLevel(m_symbolDepth[o.symbol].buy, price, o.quantity, 1);
+        }
+    }
+    for (const auto& [price, q] : m_sellBook) {
+        for (const auto& o : q) {
+            adjustLevel(m_symbolDepth[o.symbol].sell, price, o.quantity, 1);
+        }
+    }
 }
 
 void OrderBook::dump(std::ostream& os) const {
@@ -350,5 +541,40 @@ void OrderBook::dump(std::ostream& os) const {
         }
     }
 
+    if (!m_stops.empty())
+        m_stops.dump(os);
     os << "========================\n";
 }
+
+void OrderBook::forEach(const OrderVisitor& visit) const {
+    for (const auto& [price, q] : m_buyBook) {
+        for (const auto& o : q) {
+            visit(o);
+        }
+    }
+    for (const auto& [price, q] : m_sellBook) {
+        for (const auto& o : q) {
+            visit(o);
+        }
+    }
+}
+
+void OrderBook::reserve(std::size_t orders) {
+    m_live.reserve(orders);
+}
+
+void OrderBook::prepareSymbol(const domain::Symbol& symbol) {
+    m_symbolDepth.try_emplace(symbol);
+}
+
+void OrderBook::clear() {
+    clearLevels();
+    m_stops.clear();
+}
+
+void OrderBook::clearLevels() {
+    m_buyBook.clear();
+    m_sellBook.clear();
+    m_live.clear();
+    m_symbolDepth.clear();
+}
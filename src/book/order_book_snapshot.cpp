@@ -0,0 +1,332 @@
+#include "book/order_book.hpp"
+
+#include "persistence/binary_io.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Snapshot layout (little-endian, varints as in persistence/binary_io.hpp):
+//
+//   char[8]  magic "HFTBOOK1"
+//   u64      seq            last journal seq covered by this state
+//   u64      liveCount      size of the live id set
+//   varint   symbolCount, then symbolCount x bytes     (symbol dictionary)
+//   2 x side (BUY best->worst, then SELL best->worst):
+//       varint levelCount
+//       per level:  varint price | varint orderCount
+//       per order:  varint id | varint ts | varint symbolIdx | u8 orderType | varint qty | varint expireAt
+//   varint   stopCount, then per parked stop in StopBook::forEach() order:
+//       varint id | varint ts | varint symbolIdx | u8 side | u8 orderType | varint price | varint qty |
+//       varint stopPrice
+//   varint   lastTradeCount, then per symbol traded so far: varint symbolIdx | varint price
+//   u32      crc32 of everything above
+//
+// Side and price are implied by the section/level, so an order costs ~9 bytes.
+// The live id index and the per-symbol level totals are exactly what the FIFOs hold:
+// both are rebuilt from them and liveCount is only used to presize the index and as a
+// consistency check.
+
+namespace {
+
+constexpr char kMagic[8] = {'H', 'F', 'T', 'B', 'O', 'O', 'K', '1'};
+constexpr std::size_t kFlushBytes = 1u << 20;
+
+// Streams the snapshot in ~1 MiB chunks while keeping a running CRC.
+class ChunkWriter {
+public:
+    explicit ChunkWriter(std::ostream& os)
+        : m_os(os) {
+        m_buf.reserve(kFlushBytes + 256);
+    }
+
+    std::vector<char>& buf() { return m_buf; }
+
+    void maybeFlush() {
+        if (m_buf.size() >= kFlushBytes)
+            flush();
+    }
+
+    void flush() {
+        m_crc = persistence::crc32(m_buf.data(), m_buf.size(), m_crc);
+        m_os.write(m_buf.data(), static_cast<std::streamsize>(m_buf.size()));
+        m_buf.clear();
+    }
+
+    bool finish() {
+        flush();
+        persistence::putFixed<std::uint32_t>(m_buf, m_crc);
+        m_os.write(m_buf.data(), static_cast<std::streamsize>(m_buf.size()));
+        m_buf.clear();
+        m_os.flush();
+        return static_cast<bool>(m_os);
+    }
+
+private:
+    std::ostream& m_os;
+    std::vector<char> m_buf;
+    std::uint32_t m_crc{0};
+};
+
+template <typename Book>
+void writeSide(ChunkWriter& w, const Book& side,
+               const std::unordered_map<std::string_view, std::uint64_t>& symbolIdx) {
+    persistence::putVarU64(w.buf(), side.size());
+    for (const auto& [price, q] : side) {
+        persistence::putVarI64(w.buf(), price);
+        persistence::putVarU64(w.buf(), q.size());
+        for (const auto& o : q) {
+            auto& out = w.buf();
+            persistence::putVarI64(out, o.orderId);
+            persistence::putVarI64(out, o.timeStamp);
+            persistence::putVarU64(out, symbolIdx.find(o.symbol.view())->second);
+            out.push_back(static_cast<char>(o.orderType));
+            persistence::putVarI64(out, o.quantity);
+            persistence::putVarI64(out, o.expireAt);
+            w.maybeFlush();
+        }
+    }
+}
+
+struct LiveEntry {
+    domain::OrderId id;
+    domain::Side side;
+    domain::Price price;
+};
+
+// Levels come in the map's own order, so every insert is an O(1) hinted append.
+template <typename Book>
+bool readSide(persistence::ByteReader& in, Book& side, domain::Side sideTag,
+              const std::vector<std::string>& symbols,
+              std::vector<LiveEntry>& liveIds) {
+    std::uint64_t levelCount = 0;
+    if (!in.getVarU64(levelCount))
+        return false;
+
+    for (std::uint64_t l = 0; l < levelCount; ++l) {
+        std::int64_t price = 0;
+        std::uint64_t orderCount = 0;
+        if (!in.getVarI64(price) || !in.getVarU64(orderCount) || orderCount == 0)
+            return false;
+        if (!side.empty() && !side.key_comp()(std::prev(side.end())->first, price))
+            return false;  // levels must be strictly in book order
+
+        auto& q = side.emplace_hint(side.end(), price, typename Book::mapped_type{})->second;
+        for (std::uint64_t i = 0; i < orderCount; ++i) {
+            domain::Order o;
+            std::int64_t id = 0;
+            std::int64_t qty = 0;
+            std::uint64_t sym = 0;
+            std::uint8_t type = 0;
+            if (!in.getVarI64(id) || !in.getVarI64(o.timeStamp) || !in.getVarU64(sym) || !in.getU8(type) ||
+                !in.getVarI64(qty) || !in.getVarI64(o.expireAt))
+                return false;
+            if (sym >= symbols.size() || type > static_cast<std::uint8_t>(domain::OrderType::IOC))
+                return false;
+
+            o.orderId = static_cast<domain::OrderId>(id);
+            o.symbol = symbols[sym];
+            o.orderType = static_cast<domain::OrderType>(type);
+            o.side = sideTag;
+            o.price = price;
+            o.quantity = static_cast<int>(qty);
+            liveIds.push_back(LiveEntry{o.orderId, sideTag, price});
+            q.push_back(std::move(o));
+        }
+    }
+    return true;
+}
+
+void writeStops(ChunkWriter& w, const StopBook& stops,
+                const std::unordered_map<std::string_view, std::uint64_t>& symbolIdx) {
+    persistence::putVarU64(w.buf(), stops.size());
+    stops.forEach([&](const domain::Order& o, domain::Price stopPrice) {
+        auto& out = w.buf();
+        persistence::putVarI64(out, o.orderId);
+        persistence::putVarI64(out, o.timeStamp);
+        persistence::putVarU64(out, symbolIdx.find(o.symbol.view())->second);
+        out.push_back(static_cast<char>(o.side));
+        out.push_back(static_cast<char>(o.orderType));
+        persistence::putVarI64(out, o.price);
+        persistence::putVarI64(out, o.quantity);
+        persistence::putVarI64(out, stopPrice);
+        w.maybeFlush();
+    });
+}
+
+// Parked in the order written, which is their trigger order.
+bool readStops(persistence::ByteReader& in, StopBook& stops, const std::vector<std::string>& symbols) {
+    std::uint64_t count = 0;
+    if (!in.getVarU64(count))
+        return false;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        domain::Order o;
+        std::int64_t id = 0;
+        std::int64_t qty = 0;
+        std::uint64_t sym = 0;
+        std::uint8_t side = 0;
+        std::uint8_t type = 0;
+        domain::Price stopPrice = 0;
+        if (!in.getVarI64(id) || !in.getVarI64(o.timeStamp) || !in.getVarU64(sym) || !in.getU8(side) ||
+            !in.getU8(type) || !in.getVarI64(o.price) || !in.getVarI64(qty) || !in.getVarI64(stopPrice))
+            return false;
+        if (sym >= symbols.size() || side > static_cast<std::uint8_t>(domain::Side::Sell) ||
+            type > static_cast<std::uint8_t>(domain::OrderType::IOC))
+            return false;
+        o.orderId = static_cast<domain::OrderId>(id);
+        o.symbol = symbols[sym];
+        o.side = static_cast<domain::Side>(side);
+        o.orderType = static_cast<domain::OrderType>(type);
+        o.quantity = static_cast<int>(qty);
+        if (!stops.park(o, stopPrice))
+            return false;
+    }
+    return true;
+}
+
+void writeLastTrades(ChunkWriter& w, const StopBook& stops,
+                     const std::unordered_map<std::string_view, std::uint64_t>& symbolIdx) {
+    std::uint64_t count = 0;
+    stops.forEachLastTrade([&count](const domain::Symbol&, domain::Price) { ++count; });
+    persistence::putVarU64(w.buf(), count);
+    stops.forEachLastTrade([&](const domain::Symbol& symbol, domain::Price price) {
+        persistence::putVarU64(w.buf(), symbolIdx.find(symbol.view())->second);
+        persistence::putVarI64(w.buf(), price);
+    });
+}
+
+bool readLastTrades(persistence::ByteReader& in, StopBook& stops, const std::vector<std::string>& symbols) {
+    std::uint64_t count = 0;
+    if (!in.getVarU64(count))
+        return false;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t sym = 0;
+        domain::Price price = 0;
+        if (!in.getVarU64(sym) || !in.getVarI64(price) || sym >= symbols.size())
+            return false;
+        stops.recordTrade(domain::Symbol(symbols[sym]), price);
+    }
+    return true;
+}
+
+bool readAll(std::istream& is, std::vector<char>& out) {
+    const auto start = is.tellg();
+    if (start != std::istream::pos_type(-1) && is.seekg(0, std::ios::end)) {
+        const auto end = is.tellg();
+        is.seekg(start);
+        out.resize(static_cast<std::size_t>(end - start));
+        return static_cast<bool>(is.read(out.data(), static_cast<std::streamsize>(out.size())));
+    }
+    // not seekable (pipe) - fall back to streaming
+    is.clear();
+    out.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    return true;
+}
+
+}  // namespace
+
+bool OrderBook::writeSnapshot(std::ostream& os, std::uint64_t seq) const {
+    ChunkWriter w(os);
+    auto& out = w.buf();
+    out.insert(out.end(), std::begin(kMagic), std::end(kMagic));
+    persistence::putFixed<std::uint64_t>(out, seq);
+    persistence::putFixed<std::uint64_t>(out, m_live.size());
+
+    // symbol dictionary (first-seen order)
+    std::unordered_map<std::string_view, std::uint64_t> symbolIdx;
+    std::vector<std::string_view> symbols;
+    auto collect = [&](const auto& side) {
+        for (const auto& [price, q] : side) {
+            for (const auto& o : q) {
+                if (symbolIdx.emplace(o.symbol.view(), symbols.size()).second)
+                    symbols.push_back(o.symbol.view());
+            }
+        }
+    };
+    collect(m_buyBook);
+    collect(m_sellBook);
+    m_stops.forEach([&](const domain::Order& o, domain::Price) {
+        if (symbolIdx.emplace(o.symbol.view(), symbols.size()).second)
+            symbols.push_back(o.symbol.view());
+    });
+    m_stops.forEachLastTrade([&](const domain::Symbol& symbol, domain::Price) {
+        if (symbolIdx.emplace(symbol.view(), symbols.size()).second)
+            symbols.push_back(symbol.view());
+    });
+
+    persistence::putVarU64(out, symbols.size());
+    for (auto s : symbols) {
+        persistence::putBytes(out, s);
+    }
+
+    writeSide(w, m_buyBook, symbolIdx);
+    writeSide(w, m_sellBook, symbolIdx);
+    writeStops(w, m_stops, symbolIdx);
+    writeLastTrades(w, m_stops, symbolIdx);
+    return w.finish();
+}
+
+std::optional<std::uint64_t> OrderBook::loadSnapshot(std::istream& is) {
+    clear();
+
+    // one read of the whole file; everything else is parsed in place
+    std::vector<char> data;
+    if (!readAll(is, data))
+        return std::nullopt;
+    constexpr std::size_t kHeader = sizeof(kMagic) + 8 + 8;
+    if (data.size() < kHeader + 4)
+        return std::nullopt;
+    if (std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0)
+        return std::nullopt;
+
+    const std::size_t bodySize = data.size() - 4;
+    if (persistence::crc32(data.data(), bodySize) != persistence::loadFixed<std::uint32_t>(data.data() + bodySize))
+        return std::nullopt;
+
+    const auto seq = persistence::loadFixed<std::uint64_t>(data.data() + sizeof(kMagic));
+    const auto liveCount = persistence::loadFixed<std::uint64_t>(data.data() + sizeof(kMagic) + 8);
+
+    persistence::ByteReader in(data.data() + kHeader, bodySize - kHeader);
+    std::uint64_t symbolCount = 0;
+    if (!in.getVarU64(symbolCount) || symbolCount > in.remaining())
+        return std::nullopt;
+    std::vector<std::string> symbols;
+    symbols.reserve(symbolCount);
+    for (std::uint64_t i = 0; i < symbolCount; ++i) {
+        std::string_view s;
+        if (!in.getBytes(s))
+            return std::nullopt;
+        symbols.emplace_back(s);
+    }
+
+    std::vector<LiveEntry> ids;
+    ids.reserve(std::min<std::uint64_t>(liveCount, data.size()));  // count is untrusted input
+    bool ok = readSide(in, m_buyBook, domain::Side::Buy, symbols, ids) &&
+              readSide(in, m_sellBook, domain::Side::Sell, symbols, ids) && readStops(in, m_stops, symbols) &&
+              readLastTrades(in, m_stops, symbols) && in.remaining() == 0 && ids.size() == liveCount;
+
+    // Ids arrive in book order, i.e. random. Sorted, they fill the IdIndex pages one
+    // after another, and a duplicate id ends up next to its twin.
+    if (ok) {
+        auto byId = [](const LiveEntry& a, const LiveEntry& b) { return a.id < b.id; };
+        auto sameId = [](const LiveEntry& a, const LiveEntry& b) { return a.id == b.id; };
+        std::sort(ids.begin(), ids.end(), byId);
+        ok = std::adjacent_find(ids.begin(), ids.end(), sameId) == ids.end();
+    }
+    if (ok) {
+        for (const auto& e : ids) {
+            m_live.tryEmplace(e.id, OrderLocation{e.side, e.price});
+        }
+        rebuildDepth();
+    }
+    if (!ok) {
+        clear();
+        return std::nullopt;
+    }
+    return seq;
+}
@@ -0,0 +1,123 @@
+#include "book/stop_book.hpp"
+
+#include <limits>
+#include <ostream>
+
+bool StopBook::park(const domain::Order& order, domain::Price stopPrice) {
+    if (m_byId.count(order.orderId) != 0)
+        return false;
+    const auto symbol = m_symbols.try_emplace(order.symbol).first;
+    const StopKey key{stopPrice, m_seq++};
+    if (order.side == domain::Side::Buy)
+        symbol->second.buy.emplace(key, order);
+    else
+        symbol->second.sell.emplace(key, order);
+    m_byId.emplace(order.orderId, Location{symbol, order.side, key});
+    return true;
+}
+
+bool StopBook::erase(domain::OrderId id) {
+    const auto it = m_byId.find(id);
+    if (it == m_byId.end())
+        return false;
+    const Location loc = it->second;
+    m_byId.erase(it);
+    if (loc.side == domain::Side::Buy)
+        loc.symbol->second.buy.erase(loc.key);
+    else
+        loc.symbol->second.sell.erase(loc.key);
+    dropIfEmpty(loc.symbol);
+    return true;
+}
+
+template <typename Side>
+void StopBook::releaseUpTo(Side& side, typename Side::iterator end, std::vector<domain::Order>& out) {
+    for (auto it = side.begin(); it != end; ++it) {
+        m_byId.erase(it->second.orderId);
+        out.push_back(std::move(it->second));
+    }
+    side.erase(side.begin(), end);
+}
+
+std::size_t StopBook::release(const domain::Symbol& symbol, domain::Price tradePrice, std::vector<domain::Order>& out) {
+    const auto it = m_symbols.find(symbol);
+    if (it == m_symbols.end())
+        return 0;
+    const std::size_t before = out.size();
+    // the last key at tradePrice in either order, so the bound is past every crossed stop
+    const StopKey bound{tradePrice, std::numeric_limits<std::uint64_t>::max()};
+    SymbolStops& stops = it->second;
+    releaseUpTo(stops.buy, stops.buy.upper_bound(bound), out);
+    releaseUpTo(stops.sell, stops.sell.upper_bound(bound), out);
+    dropIfEmpty(it);
+    return out.size() - before;
+}
+
+template <typename Side>
+std::size_t StopBook::cancelSide(Side& side, const OrderVisitor& onCancel) {
+    const std::size_t n = side.size();
+    for (const auto& [key, order] : side) {
+        onCancel(order);
+        m_byId.erase(order.orderId);
+    }
+    side.clear();
+    return n;
+}
+
+std::size_t StopBook::cancelSymbol(const domain::Symbol& symbol, domain::Side side, const OrderVisitor& onCancel) {
+    const auto it = m_symbols.find(symbol);
+    if (it == m_symbols.end())
+        return 0;
+    const std::size_t n = side == domain::Side::Buy ? cancelSide(it->second.buy, onCancel)
+                                                    : cancelSide(it->second.sell, onCancel);
+    dropIfEmpty(it);
+    return n;
+}
+
+std::size_t StopBook::cancelAll(const OrderVisitor& onCancel) {
+    std::size_t n = 0;
+    for (auto& [symbol, stops] : m_symbols) {
+        n += cancelSide(stops.buy, onCancel);
+        n += cancelSide(stops.sell, onCancel);
+    }
+    m_symbols.clear();
+    return n;
+}
+
+void StopBook::forEach(const StopVisitor& visit) const {
+    for (const auto& [symbol, stops] : m_symbols) {
+        for (const auto& [key, order] : stops.buy) {
+            visit(order, key.stopPrice);
+        }
+        for (const auto& [key, order] : stops.sell) {
+            visit(order, key.stopPrice);
+        }
+    }
+}
+
+void StopBook::forEachLastTrade(const std::function<void(const domain::Symbol&, domain::Price)>& visit) const {
+    for (const auto& [symbol, price] : m_lastTrade) {
+        visit(symbol, price);
+    }
+}
+
+void StopBook::dump(std::ostream& os) const {
+    os << "STOPS (per symbol, in trigger order)\n";
+    forEach([&os](const domain::Order& o, domain::Price stopPrice) {
+        os << "  stop=";
+        domain::printPrice(os, stopPrice);
+        os << " " << o << "\n";
+    });
+}
+
+void StopBook::clear() {
+    m_symbols.clear();
+    m_byId.clear();
+    m_lastTrade.clear();
+    m_seq = 0;
+}
+
+void StopBook::dropIfEmpty(Symbols::iterator it) {
+    if (it->second.buy.empty() && it->second.sell.empty())
+        m_symbols.erase(it);
+}
@@ -1,13 +1,19 @@
 #include "engine/amend.hpp"
 
+#include "book/indexed_order_book.hpp"
+#include "metrics/trace.hpp"
+#include "risk/risk_checker.hpp"
+
 #include <cctype>
 #include <sstream>
 
-AmendHandler::AmendHandler(OrderBook& book)
+template <BookBackend Book>
+AmendHandler<Book>::AmendHandler(Book& book)
     : m_book(book) {}
 
-bool AmendHandler::isAlphaSymbol(const std::string& s) const {
-    if (s.empty())
+template <BookBackend Book>
+bool AmendHandler<Book>::isAlphaSymbol(const domain::Symbol& s) const {
+    if (s.empty() || s.tooLong())
         return false;
     for (unsigned char ch : s) {
         if (!std::isalpha(ch))
@@ -16,7 +22,8 @@ bool AmendHandler::isAlphaSymbol(const std::string& s) const {
     return true;
 }
 
-bool AmendHandler::isValidAmendRequest(const AmendRequest& req) const {
+template <BookBackend Book>
+bool AmendHandler<Book>::isValidAmendRequest(const AmendRequest& req) const {
     if (req.orderId <= 0)
         return false;
     if (req.timeStamp < 0)
@@ -47,18 +54,26 @@ bool AmendHandler::isValidAmendRequest(const AmendRequest& req) const {
     return true;
 }
 
-AmendResult AmendHandler::execute(const AmendRequest& req) {
+template <BookBackend Book>
+AmendResult AmendHandler<Book>::execute(const AmendRequest& req) {
     AmendResult res;
     res.orderId = req.orderId;
 
     // 1) walidacja samego requestu (format/typy już są poprawne – parser jutro)
-    if (!isValidAmendRequest(req)) {
+    bool valid;
+    {
+        HFT_TRACE_STAGE(Validate);
+        valid = isValidAmendRequest(req);
+    }
+    if (!valid) {
         res.accepted = false;
         res.rejectCode = 101;
         res.rejectMessage = "Invalid amendement details";
         return res;
     }
 
+    HFT_TRACE_STAGE(Book);
+
     // 2) znajdź istniejący order
     // Zakładamy minimalną funkcję w OrderBook: getById(orderId) -> Order*
     domain::Order* existingOrderPtr = m_book.getById(req.orderId);
@@ -97,6 +112,21 @@ AmendResult AmendHandler::execute(const AmendRequest& req) {
         return res;
     }
 
+    // pre-trade limits on the amended order; the open quantity only grows by the difference
+    std::uint32_t riskId = 0;
+    if (m_risk) {
+        HFT_TRACE_STAGE(Risk);
+        riskId = m_risk->idOf(existingOrderPtr->symbol);
+        if (const auto reason = m_risk->checkAmend(riskId, *existingOrderPtr, newPrice, newQty);
+            reason != risk::RiskReject::None) {
+            res.accepted = false;
+            res.rejectCode = risk::kRiskRejectCode;
+            res.rejectMessage = risk::rejectMessage(reason);
+            return res;
+        }
+        m_risk->addOpen(riskId, static_cast<std::int64_t>(newQty) - oldQty);
+    }
+
     // 5) reguła priorytetu:
     // - tylko qty down i bez zmiany ceny -> nie tracisz priorytetu (update in place)
     const bool priceChanged = (newPrice != oldPrice);
@@ -105,38 +135,22 @@ AmendResult AmendHandler::execute(const AmendRequest& req) {
     const bool onlyQtyDownNoPriceChange = (qtyChanged && qtyDecreased && !priceChanged);
 
     if (onlyQtyDownNoPriceChange) {
-        existingOrderPtr->quantity = newQty;
-        existingOrderPtr->timeStamp = req.timeStamp;  // timestamp w obiekcie możesz aktualizować albo nie; spec mówi, że priorytet nie ginie
+        // przez book, żeby sumy poziomów (depth) zostały dokładne; spec mówi, że priorytet nie ginie
+        m_book.reduceQuantity(*existingOrderPtr, newQty, req.timeStamp);
         res.accepted = true;
         return res;
     }
 
-    // 6) wszystkie inne amendy -> mogą zmienić priorytet:
-    // Najprościej: usuń i dodaj jako "nowy" (na koniec kolejki przy danym price level)
-    domain::Order amended = *existingOrderPtr;
-    amended.price = newPrice;
-    amended.quantity = newQty;
-    amended.timeStamp = req.timeStamp;
-
-    // usuń stary wpis (z jego kolejki) i wstaw nowy
-    m_book.erase(req.orderId);
-
-    // add powinien dodać do końca FIFO na poziomie ceny i wrzucić id do liveIds
-    // (jeśli erase usuwa liveIds, to add je z powrotem doda)
-    const bool inserted = m_book.add(amended);
-    if (!inserted) {
-        // w praktyce nie powinno się zdarzyć, ale jeśli tak — to traktuj jak błąd amend
-        res.accepted = false;
-        res.rejectCode = 101;
-        res.rejectMessage = "Invalid amendement details";
-        return res;
-    }
-
+    // 6) wszystkie inne amendy -> tracą priorytet:
+    // book przenosi order na koniec kolejki nowego (albo tego samego) poziomu,
+    // bez kopii i bez ruszania indeksu id
+    m_book.relocate(*existingOrderPtr, newPrice, newQty, req.timeStamp);
     res.accepted = true;
     return res;
 }
 
-std::string AmendHandler::format(const AmendResult& r) {
+template <BookBackend Book>
+std::string AmendHandler<Book>::format(const AmendResult& r) {
     std::ostringstream oss;
     if (r.accepted) {
         oss << r.orderId << " - AmendAccept";
@@ -144,4 +158,7 @@ std::string AmendHandler::format(const AmendResult& r) {
         oss << r.orderId << " - AmendReject - " << r.rejectCode << " - " << r.rejectMessage;
     }
     return oss.str();
-}
\ No newline at end of file
+}
+
+template class AmendHandler<OrderBook>;
+template class AmendHandler<IndexedOrderBook>;
@@ -0,0 +1,131 @@
+#include "engine/batch_new.hpp"
+
+#include "book/indexed_order_book.hpp"
+#include "metrics/trace.hpp"
+
+#include <array>
+#include <cctype>
+#include <ostream>
+#include <utility>  // std::swap
+
+template <BookBackend Book>
+BatchNewHandler<Book>::BatchNewHandler(Book& book)
+    : m_book(book) {}
+
+template <BookBackend Book>
+bool BatchNewHandler<Book>::isValidShared(const BatchNewRequest& req) {
+    if (req.timeStamp < 0 || req.symbol.empty() || req.symbol.tooLong() || req.orders.size() > kMaxBatchOrders)
+        return false;
+    for (unsigned char ch : req.symbol) {
+        if (!std::isalpha(ch))
+            return false;
+    }
+    return true;
+}
+
+// Same per-order rules as NewCommandHandler::isValidNew.
+template <BookBackend Book>
+bool BatchNewHandler<Book>::isValidOrder(const BatchOrder& o) {
+    if (o.orderId <= 0 || o.quantity <= 0)
+        return false;
+    if (o.orderType == domain::OrderType::Market)
+        return o.price == 0;
+    return o.price > 0;
+}
+
+// Linear over the orders kept so far: batches are short and repeated ids within one are rare.
+template <BookBackend Book>
+bool BatchNewHandler<Book>::takenEarlier(domain::OrderId id, std::size_t kept) const {
+    for (std::size_t v = 0; v < kept; ++v) {
+        if (m_valid[v].orderId == id)
+            return true;
+    }
+    return false;
+}
+
+template <BookBackend Book>
+BatchNewResponse BatchNewHandler<Book>::execute(const BatchNewRequest& req) {
+    BatchNewResponse res;
+    res.results.resize(req.orders.size());
+    for (std::size_t i = 0; i < req.orders.size(); ++i) {
+        res.results[i].orderId = req.orders[i].orderId;
+    }
+
+    // m_valid keeps its capacity between batches
+    std::size_t valid = 0;
+    m_slots.clear();
+    {
+        HFT_TRACE_STAGE(Validate);
+        if (!isValidShared(req))
+            return res;  // every order rejected 303
+        for (std::size_t i = 0; i < req.orders.size(); ++i) {
+            const BatchOrder& o = req.orders[i];
+            if (!isValidOrder(o) || (!m_book.stops().empty() && m_book.stops().contains(o.orderId)))
+                continue;
+            // duplicates are dropped before risk sees them, so they never count as open quantity
+            if (m_book.isLive(o.orderId) || takenEarlier(o.orderId, valid))
+                continue;
+            if (valid == m_valid.size())
+                m_valid.emplace_back();
+            domain::Order& order = m_valid[valid++];
+            order.orderId = o.orderId;
+            order.timeStamp = req.timeStamp;
+            order.symbol = req.symbol;
+            order.orderType = o.orderType;
+            order.side = o.side;
+            order.price = o.price;
+            order.quantity = o.quantity;
+            m_slots.push_back(i);
+        }
+    }
+
+    // the symbol is shared, so it is resolved once; each passing order counts towards
+    // the open quantity the next one is checked against (every one of them is added)
+    std::uint32_t riskId = 0;
+    if (m_risk && valid != 0) {
+        HFT_TRACE_STAGE(Risk);
+        riskId = m_risk->idOf(req.symbol);
+        std::size_t kept = 0;
+        for (std::size_t v = 0; v < valid; ++v) {
+            const auto reason = m_risk->checkNew(riskId, m_valid[v]);
+            if (reason != risk::RiskReject::None) {
+                res.results[m_slots[v]].riskReject = reason;
+                continue;
+            }
+            m_risk->addOpen(riskId, m_valid[v].quantity);
+            if (kept != v) {
+                std::swap(m_valid[kept], m_valid[v]);
+                m_slots[kept] = m_slots[v];
+            }
+            ++kept;
+        }
+        valid = kept;
+        m_slots.resize(kept);
+    }
+
+    HFT_TRACE_STAGE(Book);
+    std::array<bool, kMaxBatchOrders> added{};
+    res.accepted = m_book.addBatch(m_valid.data(), valid, added.data());
+    for (std::size_t i = 0; i < m_slots.size(); ++i) {
+        res.results[m_slots[i]].accepted = added[i];
+        if (m_risk && !added[i])
+            m_risk->addOpen(riskId, -m_valid[i].quantity);  // not expected: duplicates are dropped above
+    }
+    return res;
+}
+
+template <BookBackend Book>
+void BatchNewHandler<Book>::format(std::ostream& os, const BatchNewResponse& r) {
+    for (const auto& result : r.results) {
+        os << result.orderId;
+        if (result.accepted)
+            os << " - Accept\n";
+        else if (result.riskReject != risk::RiskReject::None)
+            os << " - Reject - " << risk::kRiskRejectCode << " - " << risk::rejectMessage(result.riskReject) << "\n";
+        else
+            os << " - Reject - 303 - Invalid order details\n";
+    }
+}
+
+template class BatchNewHandler<OrderBook>;
+template class BatchNewHandler<IndexedOrderBook>;
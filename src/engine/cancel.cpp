@@ -1,11 +1,17 @@
 #include "engine/cancel.hpp"
 
+#include "book/indexed_order_book.hpp"
+#include "metrics/trace.hpp"
+#include "risk/risk_checker.hpp"
+
 #include <sstream>
 
-CancelHandler::CancelHandler(OrderBook& book)
+template <BookBackend Book>
+CancelHandler<Book>::CancelHandler(Book& book)
     : m_book(book) {}
 
-bool CancelHandler::isValidCancelRequest(const CancelRequest& req) const {
+template <BookBackend Book>
+bool CancelHandler<Book>::isValidCancelRequest(const CancelRequest& req) const {
     if (req.orderId <= 0)
         return false;
     if (req.timeStamp < 0)
@@ -13,20 +19,32 @@ bool CancelHandler::isValidCancelRequest(const CancelRequest& req) const {
     return true;
 }
 
-CancelResponse CancelHandler::execute(const CancelRequest& req) {
+template <BookBackend Book>
+CancelResponse CancelHandler<Book>::execute(const CancelRequest& req) {
     CancelResponse res;
     res.orderId = req.orderId;
 
     // 1) biznesowa walidacja requestu (bez parsowania)
-    if (!isValidCancelRequest(req)) {
+    bool valid;
+    {
+        HFT_TRACE_STAGE(Validate);
+        valid = isValidCancelRequest(req);
+    }
+    if (!valid) {
         res.accepted = false;
         res.rejectCode = 101;
         res.rejectMessage = "Invalid cancel details";
         return res;
     }
 
-    // 2) czy order istnieje (live)?
+    HFT_TRACE_STAGE(Book);
+
+    // 2) czy order istnieje (live)? a parked stop just leaves the StopBook
     if (!m_book.isLive(req.orderId)) {
+        if (!m_book.stops().empty() && m_book.stops().erase(req.orderId)) {
+            res.accepted = true;
+            return res;
+        }
         res.accepted = false;
         res.rejectCode = 404;
         res.rejectMessage = "Order does not exist";
@@ -34,13 +52,18 @@ CancelResponse CancelHandler::execute(const CancelRequest& req) {
     }
 
     // 3) usuń z booka
+    if (m_risk) {
+        const domain::Order& order = *m_book.findOrder(req.orderId);
+        m_risk->addOpen(m_risk->idOf(order.symbol), -order.quantity);
+    }
     (void)m_book.erase(req.orderId);
 
     res.accepted = true;
     return res;
 }
 
-std::string CancelHandler::format(const CancelResponse& res) {
+template <BookBackend Book>
+std::string CancelHandler<Book>::format(const CancelResponse& res) {
     std::ostringstream oss;
     if (res.accepted) {
         oss << res.orderId << " - CancelAccept";
@@ -48,4 +71,7 @@ std::string CancelHandler::format(const CancelResponse& res) {
         oss << res.orderId << " - CancelReject - " << res.rejectCode << " - " << res.rejectMessage;
     }
     return oss.str();
-}
\ No newline at end of file
+}
+
+template class CancelHandler<OrderBook>;
+template class CancelHandler<IndexedOrderBook>;
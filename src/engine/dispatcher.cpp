@@ -1,37 +1,588 @@
 #include "engine/dispatcher.hpp"
 
-CommandDispatcher::CommandDispatcher(OrderBook& book)
+#include "book/indexed_order_book.hpp"
+#include "engine/response_writer.hpp"
+#include "marketdata/l2_feed.hpp"
+#include "marketdata/top_of_book.hpp"
+#include "metrics/trace.hpp"
+#include "persistence/journal.hpp"
+#include "risk/risk_checker.hpp"
+
+#include <ostream>
+#include <sstream>
+#include <type_traits>
+#include <variant>
+
+namespace {
+
+template <BookBackend Book>
+std::string formatLine(const NewCommandResponse& r) {
+    return NewCommandHandler<Book>::format(r);
+}
+
+template <BookBackend Book>
+std::string formatLine(const AmendResult& r) {
+    return AmendHandler<Book>::format(r);
+}
+
+template <BookBackend Book>
+std::string formatLine(const CancelResponse& r) {
+    return CancelHandler<Book>::format(r);
+}
+
+ResponseRecord toRecord(const NewCommandResponse& r) {
+    ResponseRecord rec;
+    rec.kind = ResponseKind::New;
+    rec.accepted = r.accepted;
+    rec.orderId = r.orderId;
+    rec.rejectCode = r.rejectCode;
+    rec.message = r.rejectMessage;
+    return rec;
+}
+
+ResponseRecord toRecord(const AmendResult& r) {
+    ResponseRecord rec;
+    rec.kind = ResponseKind::Amend;
+    rec.accepted = r.accepted;
+    rec.orderId = r.orderId;
+    rec.rejectCode = r.rejectCode;
+    rec.message = r.rejectMessage;
+    return rec;
+}
+
+ResponseRecord toRecord(const CancelResponse& r) {
+    ResponseRecord rec;
+    rec.kind = ResponseKind::Cancel;
+    rec.accepted = r.accepted;
+    rec.orderId = r.orderId;
+    rec.rejectCode = r.rejectCode;
+    rec.message = r.rejectMessage;
+    return rec;
+}
+
+ResponseRecord toRecord(const MassCancelResponse& r) {
+    ResponseRecord rec;
+    rec.kind = ResponseKind::MassCancel;
+    rec.accepted = r.accepted;
+    rec.scope = r.scope;
+    rec.symbol = r.symbol;
+    rec.side = r.side;
+    rec.count = r.cancelled;
+    rec.rejectCode = r.rejectCode;
+    rec.message = r.rejectMessage;
+    return rec;
+}
+
+// One order dropped by C, as MassCancelHandler::formatAck() writes it.
+ResponseRecord cancelAck(const domain::Order& order) {
+    ResponseRecord rec;
+    rec.kind = ResponseKind::Cancel;
+    rec.accepted = true;
+    rec.orderId = order.orderId;
+    return rec;
+}
+
+// Same lines as BatchNewHandler::format(), one New record per order.
+void pushBatch(ResponseWriter& writer, const BatchNewResponse& response) {
+    for (const auto& result : response.results) {
+        ResponseRecord rec;
+        rec.kind = ResponseKind::New;
+        rec.accepted = result.accepted;
+        rec.orderId = result.orderId;
+        if (result.riskReject != risk::RiskReject::None) {
+            rec.rejectCode = risk::kRiskRejectCode;
+            rec.message = risk::rejectMessage(result.riskReject);
+        } else {
+            rec.rejectCode = 303;
+            rec.message = "Invalid order details";
+        }
+        writer.push(rec);
+    }
+}
+
+// Same order as MatchHandler::format(): each trade, then the stops it triggered.
+void pushMatch(ResponseWriter& writer, const MatchResponse& response) {
+    auto trigger = response.triggered.begin();
+    std::size_t trades = 0;
+    for (const auto& event : response.events) {
+        ResponseRecord rec;
+        rec.kind = ResponseKind::Trade;
+        rec.buyType = event.buyOrderType;
+        rec.sellType = event.sellOrderType;
+        rec.orderId = event.buyOrderId;
+        rec.sellOrderId = event.sellOrderId;
+        rec.quantity = event.quantity;
+        rec.price = event.executionPrice;
+        rec.symbol = event.symbol;
+        writer.push(rec);
+        for (++trades; trigger != response.triggered.end() && trigger->afterEvents == trades; ++trigger) {
+            ResponseRecord stop;
+            stop.kind = ResponseKind::Triggered;
+            stop.orderId = trigger->orderId;
+            writer.push(stop);
+        }
+    }
+}
+
+// The orders of `batch` that `resp` accepted, in batch order.
+BatchNewRequest acceptedOrders(const BatchNewRequest& batch, const BatchNewResponse& resp) {
+    BatchNewRequest kept;
+    kept.timeStamp = batch.timeStamp;
+    kept.symbol = batch.symbol;
+    kept.orders.reserve(resp.accepted);
+    for (std::size_t i = 0; i < batch.orders.size(); ++i) {
+        if (resp.results[i].accepted)
+            kept.orders.push_back(batch.orders[i]);
+    }
+    return kept;
+}
+
+// Commands whose response is not exactly one line.
+bool isMultiLine(const ParsedCommand& cmd) {
+    return std::visit(
+        [](const auto& req) {
+            using T = std::decay_t<decltype(req)>;
+            return std::is_same_v<T, MatchRequest> || std::is_same_v<T, QueryRequest> ||
+                   std::is_same_v<T, BatchNewRequest> || std::is_same_v<T, MassCancelRequest>;
+        },
+        cmd);
+}
+
+}  // namespace
+
+metrics::MessageType messageTypeOf(const ParsedCommand& cmd) {
+    return std::visit(
+        [](const auto& req) {
+            using T = std::decay_t<decltype(req)>;
+            if constexpr (std::is_same_v<T, domain::Order>)
+                return metrics::MessageType::New;
+            else if constexpr (std::is_same_v<T, AmendRequest>)
+                return metrics::MessageType::Amend;
+            else if constexpr (std::is_same_v<T, CancelRequest>)
+                return metrics::MessageType::Cancel;
+            else if constexpr (std::is_same_v<T, MatchRequest>)
+                return metrics::MessageType::Match;
+            else if constexpr (std::is_same_v<T, QueryRequest>)
+                return metrics::MessageType::Query;
+            else if constexpr (std::is_same_v<T, MassCancelRequest>)
+                return metrics::MessageType::MassCancel;
+            else if constexpr (std::is_same_v<T, BatchNewRequest>)
+                return metrics::MessageType::BatchNew;
+            else
+                return metrics::MessageType::Stop;
+        },
+        cmd);
+}
+
+template <BookBackend Book>
+CommandDispatcher<Book>::CommandDispatcher(Book& book)
     : m_book(book),
       m_new(book),
+      m_batch(book),
       m_amend(book),
       m_cancel(book),
-      m_match(book) {
+      m_massCancel(book),
+      m_match(book),
+      m_query(book),
+      m_stop(book)
+#if HFT_LATENCY_METRICS
+      ,
+      m_metrics(std::make_unique<metrics::DispatchMetrics>())
+#endif
+{
+}
+
+template <BookBackend Book>
+CommandDispatcher<Book>::~CommandDispatcher() = default;
+
+template <BookBackend Book>
+const metrics::DispatchMetrics* CommandDispatcher<Book>::latencyMetrics() const {
+#if HFT_LATENCY_METRICS
+    return m_metrics.get();
+#else
+    return nullptr;
+#endif
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::reportLatency(std::ostream& os) const {
+    if (const auto* m = latencyMetrics())
+        m->report(os);
+    else
+        os << "latency metrics compiled out (HFT_LATENCY_METRICS=0)\n";
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::setLatencySampling(std::uint32_t every) {
+#if HFT_LATENCY_METRICS
+    m_sampleEvery = every == 0 ? 1 : every;
+    m_sampleCountdown = m_sampleEvery;
+#else
+    (void)every;
+#endif
+}
+
+// 0 => this message is not sampled. Compiles to nothing when the probes are disabled.
+template <BookBackend Book>
+std::uint64_t CommandDispatcher<Book>::startProbe() {
+#if HFT_LATENCY_METRICS
+    if (--m_sampleCountdown != 0)
+        return 0;
+    m_sampleCountdown = m_sampleEvery;
+    return metrics::readTsc();
+#else
+    return 0;
+#endif
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::recordLatency(metrics::MessageType type, bool accepted, std::uint64_t startTsc) {
+#if HFT_LATENCY_METRICS
+    if (startTsc != 0)
+        m_metrics->recordLatency(type, accepted, metrics::readTsc() - startTsc);
+#else
+    (void)type;
+    (void)accepted;
+    (void)startTsc;
+#endif
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::attachJournal(persistence::JournalWriter* journal) {
+    m_journal = journal;
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::attachMarketData(marketdata::L2Publisher* publisher) {
+    m_l2 = publisher;
+    m_book.attachMarketData(publisher);
 }
 
-std::string CommandDispatcher::dispatch(const ParsedCommand& cmd) {
+template <BookBackend Book>
+void CommandDispatcher<Book>::attachTopOfBook(marketdata::TopOfBookConflator* conflator) {
+    m_top = conflator;
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::attachTradeStats(marketdata::TradeStats* stats) {
+    m_match.attachTradeStats(stats);
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::attachRisk(risk::RiskChecker* risk) {
+    m_risk = risk;
+    m_new.attachRisk(risk);
+    m_batch.attachRisk(risk);
+    m_amend.attachRisk(risk);
+    m_cancel.attachRisk(risk);
+    m_match.attachRisk(risk);
+    m_stop.attachRisk(risk);
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::publishMarketData() {
+    if (!m_l2)
+        return;
+    if (m_l2->hasDue())
+        m_l2->publishDue(m_book);
+    if (m_top && m_top->hasPending())
+        m_top->refresh(m_book);
+}
+
+template <BookBackend Book>
+template <typename Emit>
+void CommandDispatcher<Book>::dispatchWith(const ParsedCommand& cmd, Emit&& emit) {
+    const std::uint64_t start = startProbe();
     if (std::holds_alternative<domain::Order>(cmd)) {
         const auto& payload = std::get<domain::Order>(cmd);
-        auto resp = m_new.execute(payload);
-        return NewCommandHandler::format(resp);
+        // an expiry the clock has already passed (the order is timestamped behind it) is
+        // rejected 303: scheduled, it would rest and match until the next advanceClock()
+        const bool expired = payload.expireAt != 0 && payload.expireAt <= m_clock;
+        auto resp = expired ? NewCommandResponse{payload.orderId} : m_new.execute(payload);
+        if (m_journal && resp.accepted)
+            m_journal->append(cmd);
+        if (resp.accepted && payload.expireAt != 0)
+            m_wheel.schedule(payload.orderId, payload.expireAt);
+        {
+            HFT_TRACE_STAGE(Format);
+            emit(resp);
+        }
+        recordLatency(metrics::MessageType::New, resp.accepted, start);
+        publishMarketData();
+        return;
     }
 
     if (std::holds_alternative<AmendRequest>(cmd)) {
         const auto& payload = std::get<AmendRequest>(cmd);
         auto resp = m_amend.execute(payload);
-        return AmendHandler::format(resp);
+        if (m_journal && resp.accepted)
+            m_journal->append(cmd);
+        {
+            HFT_TRACE_STAGE(Format);
+            emit(resp);
+        }
+        recordLatency(metrics::MessageType::Amend, resp.accepted, start);
+        publishMarketData();
+        return;
     }
 
     if (std::holds_alternative<CancelRequest>(cmd)) {
         const auto& payload = std::get<CancelRequest>(cmd);
         auto resp = m_cancel.execute(payload);
-        return CancelHandler::format(resp);
+        if (m_journal && resp.accepted)
+            m_journal->append(cmd);
+        if (resp.accepted && !m_wheel.empty())
+            (void)m_wheel.cancel(payload.orderId);
+        {
+            HFT_TRACE_STAGE(Format);
+            emit(resp);
+        }
+        recordLatency(metrics::MessageType::Cancel, resp.accepted, start);
+        publishMarketData();
+        return;
+    }
+
+    if (std::holds_alternative<StopOrderRequest>(cmd)) {
+        auto resp = m_stop.execute(std::get<StopOrderRequest>(cmd));
+        if (m_journal && resp.accepted)
+            m_journal->append(cmd);
+        {
+            HFT_TRACE_STAGE(Format);
+            emit(resp);
+        }
+        recordLatency(metrics::MessageType::Stop, resp.accepted, start);
+        publishMarketData();  // an S the last trade already crossed went straight into the levels
+        return;
     }
-    return "";
 }
 
-// we need a slightly different dispatch for Match becasue it returns vector<string> not string
-std::vector<std::string> CommandDispatcher::dispatchMatch(const ParsedCommand& cmd) {
+template <BookBackend Book>
+std::string CommandDispatcher<Book>::dispatch(const ParsedCommand& cmd) {
+    if (isMultiLine(cmd)) {
+        std::ostringstream lines;
+        dispatchTo(cmd, lines);
+        std::string out = std::move(lines).str();
+        if (!out.empty())
+            out.pop_back();  // the last '\n', as for the single-line commands
+        return out;
+    }
+    std::string out;
+    dispatchWith(cmd, [&out](const auto& resp) { out = formatLine<Book>(resp); });
+    return out;
+}
+
+template <BookBackend Book>
+template <typename Emit>
+void CommandDispatcher<Book>::dispatchMatchWith(const ParsedCommand& cmd, Emit&& emit) {
+    const std::uint64_t start = startProbe();
     const auto& payload = std::get<MatchRequest>(cmd);
     auto resp = m_match.execute(payload);
-    return MatchHandler::format(resp);
+    // a match without fills left the book untouched - nothing to replay
+    if (m_journal && !resp.events.empty())
+        m_journal->append(cmd);
+    {
+        HFT_TRACE_STAGE(Format);
+        emit(resp);
+    }
+    recordLatency(metrics::MessageType::Match, true, start);
+#if HFT_LATENCY_METRICS
+    m_metrics->recordFills(resp.events.size());
+#endif
+    publishMarketData();
+}
+
+// we need a slightly different dispatch for Match becasue it returns vector<string> not string
+template <BookBackend Book>
+std::vector<std::string> CommandDispatcher<Book>::dispatchMatch(const ParsedCommand& cmd) {
+    std::vector<std::string> out;
+    dispatchMatchWith(cmd, [&out](const MatchResponse& resp) { out = MatchHandler<Book>::format(resp); });
+    return out;
 }
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::dispatchTo(const ParsedCommand& cmd, std::ostream& out) {
+    std::visit(
+        [&](const auto& req) {
+            using T = std::decay_t<decltype(req)>;
+            if constexpr (std::is_same_v<T, MatchRequest> || std::is_same_v<T, QueryRequest>) {
+                const auto lines = std::is_same_v<T, MatchRequest> ? dispatchMatch(cmd) : dispatchQuery(cmd);
+                for (const auto& line : lines) {
+                    if (!line.empty())
+                        out << line << '\n';
+                }
+            } else if constexpr (std::is_same_v<T, BatchNewRequest>) {
+                (void)dispatchBatch(cmd, out);
+            } else if constexpr (std::is_same_v<T, MassCancelRequest>) {
+                (void)dispatchMassCancel(cmd, out);
+            } else {
+                dispatchWith(cmd, [&out](const auto& resp) { out << formatLine<Book>(resp) << '\n'; });
+            }
+        },
+        cmd);
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::dispatchDeferred(const ParsedCommand& cmd, ResponseWriter& writer) {
+    std::visit(
+        [&](const auto& req) {
+            using T = std::decay_t<decltype(req)>;
+            if constexpr (std::is_same_v<T, MatchRequest>) {
+                dispatchMatchWith(cmd, [&writer](const MatchResponse& resp) { pushMatch(writer, resp); });
+            } else if constexpr (std::is_same_v<T, BatchNewRequest>) {
+                (void)dispatchBatchWith(cmd, [&writer](const BatchNewResponse& resp) { pushBatch(writer, resp); });
+            } else if constexpr (std::is_same_v<T, MassCancelRequest>) {
+                (void)dispatchMassCancelWith(
+                    cmd, [&writer](const domain::Order& order) { writer.push(cancelAck(order)); },
+                    [&writer](const MassCancelResponse& resp) { writer.push(toRecord(resp)); });
+            } else if constexpr (std::is_same_v<T, QueryRequest>) {
+                // formatted here, written by the writer thread
+                std::ostringstream out;
+                dispatchTo(cmd, out);
+                if (out.tellp() > 0)
+                    writer.pushText(std::move(out).str());
+            } else {
+                dispatchWith(cmd, [&writer](const auto& resp) { writer.push(toRecord(resp)); });
+            }
+        },
+        cmd);
+}
+
+template <BookBackend Book>
+std::vector<std::string> CommandDispatcher<Book>::dispatchQuery(const ParsedCommand& cmd) {
+    const std::uint64_t start = startProbe();
+    const auto resp = m_query.execute(std::get<QueryRequest>(cmd));
+    std::vector<std::string> out;
+    {
+        HFT_TRACE_STAGE(Format);
+        out = QueryHandler<Book>::format(resp);
+    }
+    recordLatency(metrics::MessageType::Query, resp.accepted, start);
+    return out;
+}
+
+template <BookBackend Book>
+std::size_t CommandDispatcher<Book>::dispatchBatch(const ParsedCommand& cmd, std::ostream& out) {
+    return dispatchBatchWith(cmd, [&out](const BatchNewResponse& resp) { BatchNewHandler<Book>::format(out, resp); });
+}
+
+template <BookBackend Book>
+template <typename Emit>
+std::size_t CommandDispatcher<Book>::dispatchBatchWith(const ParsedCommand& cmd, Emit&& emit) {
+    const std::uint64_t start = startProbe();
+    const auto& batch = std::get<BatchNewRequest>(cmd);
+    const auto resp = m_batch.execute(batch);
+    // a replay runs without risk checks, so a partly rejected batch is journaled with only
+    // the orders that went in
+    if (m_journal && resp.accepted == batch.orders.size())
+        m_journal->append(cmd);
+    else if (m_journal && resp.accepted != 0)
+        m_journal->append(ParsedCommand{acceptedOrders(batch, resp)});
+    {
+        HFT_TRACE_STAGE(Format);
+        emit(resp);
+    }
+    recordLatency(metrics::MessageType::BatchNew, resp.accepted != 0, start);
+    publishMarketData();
+    return resp.accepted;
+}
+
+template <BookBackend Book>
+std::size_t CommandDispatcher<Book>::dispatchMassCancel(const ParsedCommand& cmd, std::ostream& out) {
+    return dispatchMassCancelWith(
+        cmd, [&out](const domain::Order& order) { MassCancelHandler<Book>::formatAck(out, order); },
+        [&out](const MassCancelResponse& resp) { out << MassCancelHandler<Book>::format(resp) << "\n"; });
+}
+
+template <BookBackend Book>
+template <typename Ack, typename Emit>
+std::size_t CommandDispatcher<Book>::dispatchMassCancelWith(const ParsedCommand& cmd, Ack&& ack, Emit&& emit) {
+    const std::uint64_t start = startProbe();
+    const auto resp = m_massCancel.execute(std::get<MassCancelRequest>(cmd), [this, &ack](const domain::Order& order) {
+        if (order.expireAt != 0)
+            (void)m_wheel.cancel(order.orderId);
+        if (m_risk)
+            m_risk->addOpen(m_risk->idOf(order.symbol), -order.quantity);
+        ack(order);
+    }, [&ack](const domain::Order& stop) { ack(stop); });
+    if (m_journal && resp.cancelled != 0)
+        m_journal->append(cmd);
+    {
+        HFT_TRACE_STAGE(Format);
+        emit(resp);
+    }
+    recordLatency(metrics::MessageType::MassCancel, resp.accepted, start);
+    publishMarketData();
+    return resp.cancelled;
+}
+
+template <BookBackend Book>
+template <typename Emit>
+std::size_t CommandDispatcher<Book>::expireWith(domain::Timestamp now, Emit&& emit) {
+    if (now > m_clock)
+        m_clock = now;
+    if (m_wheel.empty())
+        return 0;
+    std::size_t expired = 0;
+    m_wheel.advance(now, [&](domain::OrderId id, domain::Timestamp at) {
+        // filled, cancelled in bulk or replaced by a new order with the same id since
+        const domain::Order* order = m_book.findOrder(id);
+        if (!order || order->expireAt != at)
+            return;
+        if (m_risk)
+            m_risk->addOpen(m_risk->idOf(order->symbol), -order->quantity);
+        (void)m_book.erase(id);
+        if (m_journal)
+            m_journal->append(ParsedCommand{CancelRequest{id, at}});
+        emit(id);
+        ++expired;
+    });
+    if (expired != 0)
+        publishMarketData();
+    return expired;
+}
+
+template <BookBackend Book>
+std::size_t CommandDispatcher<Book>::advanceClock(domain::Timestamp now, std::ostream& out) {
+    return expireWith(now, [&out](domain::OrderId id) { out << id << " - Expired\n"; });
+}
+
+template <BookBackend Book>
+std::size_t CommandDispatcher<Book>::advanceClock(domain::Timestamp now, ResponseWriter& writer) {
+    return expireWith(now, [&writer](domain::OrderId id) {
+        ResponseRecord r;
+        r.kind = ResponseKind::Expired;
+        r.orderId = id;
+        writer.push(r);
+    });
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::rescheduleExpiries() {
+    m_wheel.clear();
+    m_book.forEach([this](const domain::Order& order) {
+        if (order.expireAt != 0)
+            m_wheel.schedule(order.orderId, order.expireAt);
+    });
+}
+
+template <BookBackend Book>
+void CommandDispatcher<Book>::apply(const ParsedCommand& cmd) {
+    if (const auto* order = std::get_if<domain::Order>(&cmd)) {
+        (void)m_new.execute(*order);
+    } else if (const auto* batch = std::get_if<BatchNewRequest>(&cmd)) {
+        (void)m_batch.execute(*batch);
+    } else if (const auto* amend = std::get_if<AmendRequest>(&cmd)) {
+        (void)m_amend.execute(*amend);
+    } else if (const auto* cancel = std::get_if<CancelRequest>(&cmd)) {
+        (void)m_cancel.execute(*cancel);
+    } else if (const auto* match = std::get_if<MatchRequest>(&cmd)) {
+        (void)m_match.execute(*match);
+    } else if (const auto* massCancel = std::get_if<MassCancelRequest>(&cmd)) {
+        (void)m_massCancel.execute(*massCancel, [](const domain::Order&) {}, [](const domain::Order&) {});
+    } else if (const auto* stop = std::get_if<StopOrderRequest>(&cmd)) {
+        (void)m_stop.execute(*stop);
+    }
+}
+
+template class CommandDispatcher<OrderBook>;
+template class CommandDispatcher<IndexedOrderBook>;
@@ -0,0 +1,132 @@
+#include "engine/expiry_wheel.hpp"
+
+namespace {
+
+constexpr unsigned kBits = 6;  // log2(slots per level)
+
+std::uint64_t digitOf(std::uint64_t t, std::size_t level) {
+    return (t >> (kBits * level)) & 63u;
+}
+
+// Bits of t above `level` (zero for the top level, which holds the highest digit).
+std::uint64_t prefixAbove(std::uint64_t t, std::size_t level) {
+    const std::size_t shift = kBits * (level + 1);
+    return shift >= 64 ? 0 : t & ~((std::uint64_t{1} << shift) - 1);
+}
+
+}  // namespace
+
+ExpiryWheel::ExpiryWheel() {
+    m_heads.fill(kNil);
+    m_tails.fill(kNil);
+}
+
+void ExpiryWheel::schedule(domain::OrderId id, domain::Timestamp expireAt) {
+    std::uint32_t n;
+    if (m_free != kNil) {
+        n = m_free;
+        m_free = m_nodes[n].next;
+    } else {
+        n = static_cast<std::uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    Node& node = m_nodes[n];
+    node.id = id;
+    node.at = expireAt > 0 ? static_cast<std::uint64_t>(expireAt) : 0;
+    file(n);
+    m_index[id] = n;
+}
+
+bool ExpiryWheel::cancel(domain::OrderId id) {
+    const auto it = m_index.find(id);
+    if (it == m_index.end())
+        return false;
+    unlink(it->second);
+    release(it->second);
+    m_index.erase(it);
+    return true;
+}
+
+void ExpiryWheel::clear() {
+    m_heads.fill(kNil);
+    m_tails.fill(kNil);
+    m_occupied.fill(0);
+    m_due = m_dueTail = kNil;
+    m_nodes.clear();
+    m_free = kNil;
+    m_index.clear();
+    m_now = 0;
+}
+
+void ExpiryWheel::file(std::uint32_t n) {
+    const std::uint64_t at = m_nodes[n].at;
+    if (at <= m_now) {
+        pushBack(kDueList, n);
+        return;
+    }
+    const std::size_t level = (63u - static_cast<unsigned>(__builtin_clzll(at ^ m_now))) / kBits;
+    const std::uint64_t slot = digitOf(at, level);
+    pushBack(static_cast<std::uint16_t>(level * kSlots + slot), n);
+    m_occupied[level] |= std::uint64_t{1} << slot;
+}
+
+void ExpiryWheel::pushBack(std::uint16_t list, std::uint32_t n) {
+    Node& node = m_nodes[n];
+    node.list = list;
+    node.next = kNil;
+    node.prev = tailOf(list);
+    if (node.prev != kNil)
+        m_nodes[node.prev].next = n;
+    else
+        headOf(list) = n;
+    tailOf(list) = n;
+}
+
+void ExpiryWheel::unlink(std::uint32_t n) {
+    const Node& node = m_nodes[n];
+    if (node.prev != kNil)
+        m_nodes[node.prev].next = node.next;
+    else
+        headOf(node.list) = node.next;
+    if (node.next != kNil)
+        m_nodes[node.next].prev = node.prev;
+    else
+        tailOf(node.list) = node.prev;
+    if (node.list != kDueList && m_heads[node.list] == kNil)
+        m_occupied[node.list / kSlots] &= ~(std::uint64_t{1} << (node.list % kSlots));
+}
+
+void ExpiryWheel::release(std::uint32_t n) {
+    m_nodes[n].next = m_free;
+    m_free = n;
+}
+
+// Every entry at level L shares the digits above L with m_now and has a larger digit L,
+// so the lowest level with an occupied slot holds the next time anything can happen:
+// m_now's prefix, that slot's digit, zeros below. Jumping there keeps the invariant for
+// the other levels; the slot's entries are then due or re-filed lower.
+bool ExpiryWheel::moveToNextSlot(std::uint64_t target) {
+    for (std::size_t level = 0; level < kLevels; ++level) {
+        const std::uint64_t digit = digitOf(m_now, level);
+        const std::uint64_t later = digit == 63 ? 0 : m_occupied[level] & (~std::uint64_t{0} << (digit + 1));
+        if (later == 0)
+            continue;
+        const auto slot = static_cast<std::uint64_t>(__builtin_ctzll(later));
+        const std::uint64_t next = prefixAbove(m_now, level) | (slot << (kBits * level));
+        if (next > target)
+            break;
+        m_now = next;
+        const auto list = static_cast<std::uint16_t>(level * kSlots + slot);
+        std::uint32_t n = m_heads[list];
+        m_heads[list] = m_tails[list] = kNil;
+        m_occupied[level] &= ~(std::uint64_t{1} << slot);
+        while (n != kNil) {
+            const std::uint32_t following = m_nodes[n].next;
+            file(n);
+            n = following;
+        }
+        return true;
+    }
+    m_now = target;
+    return false;
+}
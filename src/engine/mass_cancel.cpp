@@ -0,0 +1,96 @@
+#include "engine/mass_cancel.hpp"
+
+#include "book/indexed_order_book.hpp"
+#include "metrics/trace.hpp"
+
+#include <cctype>
+#include <ostream>
+#include <sstream>
+
+template <BookBackend Book>
+MassCancelHandler<Book>::MassCancelHandler(Book& book)
+    : m_book(book) {}
+
+template <BookBackend Book>
+bool MassCancelHandler<Book>::isValidMassCancel(const MassCancelRequest& req) const {
+    if (req.timeStamp < 0)
+        return false;
+    if (req.scope == MassCancelScope::All)
+        return true;
+    if (req.symbol.empty() || req.symbol.tooLong())
+        return false;
+    for (unsigned char ch : req.symbol) {
+        if (!std::isalpha(ch))
+            return false;
+    }
+    return true;
+}
+
+template <BookBackend Book>
+MassCancelResponse MassCancelHandler<Book>::execute(const MassCancelRequest& req,
+                                                    const OrderVisitor& onCancel,
+                                                    const OrderVisitor& onStopCancel) {
+    MassCancelResponse res;
+    res.scope = req.scope;
+    res.symbol = req.symbol;
+    res.side = req.side;
+
+    bool valid;
+    {
+        HFT_TRACE_STAGE(Validate);
+        valid = isValidMassCancel(req);
+    }
+    if (!valid)
+        return res;  // reject 101
+
+    HFT_TRACE_STAGE(Book);
+
+    StopBook& stops = m_book.stops();
+    switch (req.scope) {
+    case MassCancelScope::All:
+        res.cancelled = m_book.cancelAll(onCancel);
+        if (!stops.empty())
+            res.cancelled += stops.cancelAll(onStopCancel);
+        break;
+    case MassCancelScope::Symbol:
+        res.cancelled = m_book.cancelSymbol(req.symbol, domain::Side::Buy, onCancel);
+        res.cancelled += m_book.cancelSymbol(req.symbol, domain::Side::Sell, onCancel);
+        if (!stops.empty()) {
+            res.cancelled += stops.cancelSymbol(req.symbol, domain::Side::Buy, onStopCancel);
+            res.cancelled += stops.cancelSymbol(req.symbol, domain::Side::Sell, onStopCancel);
+        }
+        break;
+    case MassCancelScope::SymbolSide:
+        res.cancelled = m_book.cancelSymbol(req.symbol, req.side, onCancel);
+        if (!stops.empty())
+            res.cancelled += stops.cancelSymbol(req.symbol, req.side, onStopCancel);
+        break;
+    }
+    res.accepted = true;
+    return res;
+}
+
+template <BookBackend Book>
+void MassCancelHandler<Book>::formatAck(std::ostream& os, const domain::Order& order) {
+    os << order.orderId << " - CancelAccept\n";
+}
+
+template <BookBackend Book>
+std::string MassCancelHandler<Book>::format(const MassCancelResponse& res) {
+    std::ostringstream oss;
+    if (res.scope == MassCancelScope::All)
+        oss << "*";
+    else
+        oss << res.symbol;
+    if (res.scope == MassCancelScope::SymbolSide)
+        oss << "," << domain::toChar(res.side);
+
+    if (res.accepted)
+        oss << " - MassCancelAccept - " << res.cancelled;
+    else
+        oss << " - MassCancelReject - " << res.rejectCode << " - " << res.rejectMessage;
+    return oss.str();
+}
+
+template class MassCancelHandler<OrderBook>;
+template class MassCancelHandler<IndexedOrderBook>;
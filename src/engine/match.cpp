@@ -1,17 +1,29 @@
 #include "engine/match.hpp"
 
+#include "book/indexed_order_book.hpp"
+#include "engine/stop.hpp"  // triggeredOrder
+#include "marketdata/l2_feed.hpp"
+#include "marketdata/trade_stats.hpp"
+#include "metrics/trace.hpp"
+#include "risk/risk_checker.hpp"
+
 #include <sstream>
 
-MatchHandler::MatchHandler(OrderBook& book)
+template <BookBackend Book>
+MatchHandler<Book>::MatchHandler(Book& book)
     : m_book(book) {
 }
 
-MatchResponse MatchHandler::execute(const MatchRequest& req) {
+template <BookBackend Book>
+MatchResponse MatchHandler<Book>::execute(const MatchRequest& req) {
+    HFT_TRACE_STAGE(Book);
     MatchResponse response;
 
     // --- match only one symbol ---
     if (req.symbol.has_value()) {
-        const std::string& sym = *req.symbol;
+        const domain::Symbol& sym = *req.symbol;
+        std::optional<std::uint32_t> statsId;  // resolved on the first fill
+        std::optional<std::uint32_t> riskId;
 
         while (true) {
             auto* buyPtr = m_book.bestBidOrder(sym);
@@ -37,9 +49,30 @@ MatchResponse MatchHandler::execute(const MatchRequest& req) {
                 matchedQuantity,
                 executionPrice});
 
+            // the trade goes out ahead of the level changes it causes
+            if (auto* l2 = m_book.marketData())
+                l2->trade(sym, executionPrice, matchedQuantity, buyPtr->orderId, sellPtr->orderId);
+            if (m_stats) {
+                if (!statsId)
+                    statsId = m_stats->idOf(sym);
+                m_stats->record(*statsId, req.timestamp, executionPrice, matchedQuantity, buyPtr->orderType,
+                                sellPtr->orderType);
+            }
+            if (m_risk) {
+                if (!riskId)
+                    riskId = m_risk->idOf(sym);
+                m_risk->onFill(*riskId, executionPrice, matchedQuantity);  // buy side
+                m_risk->onFill(*riskId, executionPrice, matchedQuantity);  // sell side
+            }
+
             m_book.consumeBestAsk(matchedQuantity, sym);
             m_book.consumeBestBid(matchedQuantity, sym);
+            if (!m_book.stops().empty())
+                releaseStops(sym, executionPrice, req.timestamp, response);
         }
+        // one symbol: only its final trade price matters to the stops that come later
+        if (!response.events.empty())
+            m_book.stops().recordTrade(sym, response.events.back().executionPrice);
 
         return response;
     }
@@ -67,27 +100,70 @@ MatchResponse MatchHandler::execute(const MatchRequest& req) {
             matchedQuantity,
             executionPrice});
 
+        if (auto* l2 = m_book.marketData())
+            l2->trade(buyPtr->symbol, executionPrice, matchedQuantity, buyPtr->orderId, sellPtr->orderId);
+        if (m_stats)
+            m_stats->record(m_stats->idOf(buyPtr->symbol), req.timestamp, executionPrice, matchedQuantity,
+                            buyPtr->orderType, sellPtr->orderType);
+        if (m_risk) {
+            m_risk->onFill(m_risk->idOf(buyPtr->symbol), executionPrice, matchedQuantity);
+            m_risk->onFill(m_risk->idOf(sellPtr->symbol), executionPrice, matchedQuantity);
+        }
+
         m_book.consumeBestAsk(matchedQuantity);
         m_book.consumeBestBid(matchedQuantity);
+        m_book.stops().recordTrade(response.events.back().symbol, executionPrice);
+        if (!m_book.stops().empty())
+            releaseStops(response.events.back().symbol, executionPrice, req.timestamp, response);
     }
 
     return response;
 }
 
-std::vector<std::string> MatchHandler::format(const MatchResponse& response) {
+template <BookBackend Book>
+void MatchHandler<Book>::releaseStops(const domain::Symbol& symbol,
+                                      domain::Price tradePrice,
+                                      domain::Timestamp ts,
+                                      MatchResponse& response) {
+    m_released.clear();
+    if (m_book.stops().release(symbol, tradePrice, m_released) == 0)
+        return;
+    for (auto& order : m_released) {
+        order.timeStamp = ts;
+        // N / B / S keep ids of parked stops out of the book, so this only fails on a replay
+        // of a journal written without that rule
+        if (!m_book.add(triggeredOrder(m_book, order, tradePrice)))
+            continue;
+        response.triggered.push_back(StopTrigger{response.events.size(), order.orderId});
+        if (m_risk)
+            m_risk->addOpen(m_risk->idOf(symbol), order.quantity);
+    }
+}
+
+template <BookBackend Book>
+std::vector<std::string> MatchHandler<Book>::format(const MatchResponse& response) {
     std::vector<std::string> out;
     std::string buyPart;
     std::string sellPart;
 
+    auto trigger = response.triggered.begin();
+    std::size_t trades = 0;
+
     for (const auto& event : response.events) {
         std::ostringstream ossBuy;
         std::ostringstream ossSell;
         std::string temp;
         ossBuy << event.buyOrderId << "," << domain::toChar(event.buyOrderType) << "," << event.quantity << "," << event.executionPrice;
         ossSell << event.executionPrice << "," << event.quantity << "," << domain::toChar(event.sellOrderType) << "," << event.sellOrderId;
-        temp = event.symbol + "|" + ossBuy.str() + "|" + ossSell.str();
+        temp = event.symbol.str() + "|" + ossBuy.str() + "|" + ossSell.str();
         out.push_back(temp);
+        for (++trades; trigger != response.triggered.end() && trigger->afterEvents == trades; ++trigger) {
+            out.push_back(std::to_string(trigger->orderId) + " - Triggered");
+        }
     }
 
     return out;
 }
+
+template class MatchHandler<OrderBook>;
+template class MatchHandler<IndexedOrderBook>;
@@ -1,13 +1,19 @@
 #include "engine/new.hpp"
 
+#include "book/indexed_order_book.hpp"
+#include "metrics/trace.hpp"
+#include "risk/risk_checker.hpp"
+
 #include <cctype>  // std::isalpha
 #include <sstream>
 
-NewCommandHandler::NewCommandHandler(OrderBook& book)
+template <BookBackend Book>
+NewCommandHandler<Book>::NewCommandHandler(Book& book)
     : m_book(book) {}
 
-bool NewCommandHandler::isAlphaSymbol(const std::string& s) {
-    if (s.empty())
+template <BookBackend Book>
+bool NewCommandHandler<Book>::isAlphaSymbol(const domain::Symbol& s) {
+    if (s.empty() || s.tooLong())
         return false;
     for (unsigned char ch : s) {
         if (!std::isalpha(ch))
@@ -16,7 +22,8 @@ bool NewCommandHandler::isAlphaSymbol(const std::string& s) {
     return true;
 }
 
-bool NewCommandHandler::isValidNew(const domain::Order& o) const {
+template <BookBackend Book>
+bool NewCommandHandler<Book>::isValidNew(const domain::Order& o) {
     if (o.orderId <= 0)
         return false;
     if (o.timeStamp < 0)
@@ -25,6 +32,9 @@ bool NewCommandHandler::isValidNew(const domain::Order& o) const {
         return false;
     if (!isAlphaSymbol(o.symbol))
         return false;
+    // an expiry must lie after the order's own timestamp
+    if (o.expireAt < 0 || (o.expireAt != 0 && o.expireAt <= o.timeStamp))
+        return false;
 
     // Market: price must be 0
     if (o.orderType == domain::OrderType::Market) {
@@ -35,28 +45,51 @@ bool NewCommandHandler::isValidNew(const domain::Order& o) const {
     return o.price > 0;
 }
 
-NewCommandResponse NewCommandHandler::execute(const domain::Order& order) const {
+template <BookBackend Book>
+NewCommandResponse NewCommandHandler<Book>::execute(const domain::Order& order) const {
     NewCommandResponse r;
     r.orderId = order.orderId;
 
     // 1) validate fields
-    if (!isValidNew(order)) {
+    bool valid;
+    {
+        HFT_TRACE_STAGE(Validate);
+        valid = isValidNew(order);
+    }
+    if (!valid) {
         r.accepted = false;
         return r;  // reject 303
     }
 
-    // 2) reject duplicates
-    if (!m_book.add(order)) {
+    // 2) pre-trade limits
+    std::uint32_t riskId = 0;
+    if (m_risk) {
+        HFT_TRACE_STAGE(Risk);
+        riskId = m_risk->idOf(order.symbol);
+        if (const auto reason = m_risk->checkNew(riskId, order); reason != risk::RiskReject::None) {
+            r.accepted = false;
+            r.rejectCode = risk::kRiskRejectCode;
+            r.rejectMessage = risk::rejectMessage(reason);
+            return r;
+        }
+    }
+
+    // 3) reject duplicates (parked stops included)
+    HFT_TRACE_STAGE(Book);
+    if ((!m_book.stops().empty() && m_book.stops().contains(order.orderId)) || !m_book.add(order)) {
         r.accepted = false;
         return r;  // today: duplicate maps to same 303
     }
+    if (m_risk)
+        m_risk->addOpen(riskId, order.quantity);
 
-    // 3) accept
+    // 4) accept
     r.accepted = true;
     return r;
 }
 
-std::string NewCommandHandler::format(const NewCommandResponse& r) {
+template <BookBackend Book>
+std::string NewCommandHandler<Book>::format(const NewCommandResponse& r) {
     std::ostringstream oss;
     if (r.accepted) {
         oss << r.orderId << " - Accept";
@@ -64,4 +97,7 @@ std::string NewCommandHandler::format(const NewCommandResponse& r) {
         oss << r.orderId << " - Reject - " << r.rejectCode << " - " << r.rejectMessage;
     }
     return oss.str();
-}
\ No newline at end of file
+}
+
+template class NewCommandHandler<OrderBook>;
+template class NewCommandHandler<IndexedOrderBook>;
@@ -0,0 +1,123 @@
+#include "engine/query.hpp"
+
+#include "book/indexed_order_book.hpp"
+#include "metrics/trace.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+template <BookBackend Book>
+QueryHandler<Book>::QueryHandler(const Book& book)
+    : m_book(book) {}
+
+template <BookBackend Book>
+bool QueryHandler<Book>::isAlphaSymbol(const domain::Symbol& s) {
+    if (s.empty() || s.tooLong())
+        return false;
+    for (unsigned char ch : s) {
+        if (!std::isalpha(ch))
+            return false;
+    }
+    return true;
+}
+
+template <BookBackend Book>
+bool QueryHandler<Book>::isValidQuery(const QueryRequest& req) const {
+    if (req.timeStamp < 0)
+        return false;
+    switch (req.kind) {
+    case QueryKind::Order:
+        return req.orderId > 0;
+    case QueryKind::Top:
+        return isAlphaSymbol(req.symbol);
+    case QueryKind::Depth:
+        return isAlphaSymbol(req.symbol) && req.levels >= 1 && req.levels <= kMaxQueryLevels;
+    }
+    return false;
+}
+
+template <BookBackend Book>
+QueryResponse QueryHandler<Book>::execute(const QueryRequest& req) const {
+    QueryResponse res;
+    res.kind = req.kind;
+    res.orderId = req.orderId;
+    res.symbol = req.symbol;
+
+    bool valid;
+    {
+        HFT_TRACE_STAGE(Validate);
+        valid = isValidQuery(req);
+    }
+    if (!valid)
+        return res;  // reject 101
+
+    HFT_TRACE_STAGE(Book);
+
+    if (req.kind == QueryKind::Order) {
+        const domain::Order* order = m_book.findOrder(req.orderId);
+        if (!order) {
+            res.rejectCode = 404;
+            res.rejectMessage = "Order does not exist";
+            return res;
+        }
+        res.order = *order;
+        res.accepted = true;
+        return res;
+    }
+
+    const auto levels = static_cast<std::size_t>(req.kind == QueryKind::Top ? 1 : req.levels);
+    res.bidLevels = m_book.depth(req.symbol, domain::Side::Buy, levels, res.bids.data());
+    res.askLevels = m_book.depth(req.symbol, domain::Side::Sell, levels, res.asks.data());
+    res.accepted = true;
+    return res;
+}
+
+template <BookBackend Book>
+std::vector<std::string> QueryHandler<Book>::format(const QueryResponse& r) {
+    std::vector<std::string> out;
+    std::ostringstream oss;
+
+    if (!r.accepted) {
+        if (r.kind == QueryKind::Order)
+            oss << r.orderId;
+        else
+            oss << r.symbol;
+        oss << " - QueryReject - " << r.rejectCode << " - " << r.rejectMessage;
+        out.push_back(oss.str());
+        return out;
+    }
+
+    if (r.kind == QueryKind::Order) {
+        const auto& o = r.order;
+        oss << o.orderId << " - OrderStatus - " << o.symbol << "," << domain::toChar(o.orderType) << ","
+            << domain::toChar(o.side) << ",";
+        domain::printPrice(oss, o.price);
+        oss << "," << o.quantity;
+        out.push_back(oss.str());
+        return out;
+    }
+
+    const std::size_t lines = std::max<std::size_t>(1, std::max(r.bidLevels, r.askLevels));
+    out.reserve(lines);
+    for (std::size_t i = 0; i < lines; ++i) {
+        oss.str("");
+        oss << r.symbol << "|";
+        if (i < r.bidLevels) {
+            const auto& b = r.bids[i];
+            oss << b.orders << "," << b.quantity << ",";
+            domain::printPrice(oss, b.price);
+        }
+        oss << "|";
+        if (i < r.askLevels) {
+            const auto& a = r.asks[i];
+            domain::printPrice(oss, a.price);
+            oss << "," << a.quantity << "," << a.orders;
+        }
+        out.push_back(oss.str());
+    }
+    return out;
+}
+
+template class QueryHandler<OrderBook>;
+template class QueryHandler<IndexedOrderBook>;
@@ -0,0 +1,194 @@
+#include "engine/response_writer.hpp"
+
+#include "domain/order.hpp"  // toChar
+#include "engine/mass_cancel.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <ostream>
+
+namespace {
+
+template <typename Int>
+void appendInt(std::string& out, Int v) {
+    char buf[24];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+// "<id> - <accept>" or "<id> - <reject> - <code> - <message>"
+void appendAck(std::string& out, const ResponseRecord& r, std::string_view accept, std::string_view reject) {
+    appendInt(out, r.orderId);
+    out += " - ";
+    if (r.accepted) {
+        out += accept;
+        return;
+    }
+    out += reject;
+    out += " - ";
+    appendInt(out, r.rejectCode);
+    out += " - ";
+    out += r.message;
+}
+
+std::size_t ringSizeFor(std::size_t capacity) {
+    std::size_t n = 1;
+    while (n < capacity) {
+        n <<= 1;
+    }
+    return n;
+}
+
+}  // namespace
+
+void renderResponse(const ResponseRecord& r, std::string& out) {
+    switch (r.kind) {
+    case ResponseKind::New:
+        appendAck(out, r, "Accept", "Reject");
+        break;
+    case ResponseKind::Amend:
+        appendAck(out, r, "AmendAccept", "AmendReject");
+        break;
+    case ResponseKind::Cancel:
+        appendAck(out, r, "CancelAccept", "CancelReject");
+        break;
+    case ResponseKind::Expired:
+        appendInt(out, r.orderId);
+        out += " - Expired";
+        break;
+    case ResponseKind::Triggered:
+        appendInt(out, r.orderId);
+        out += " - Triggered";
+        break;
+    case ResponseKind::Trade:
+        out += r.symbol.view();
+        out += '|';
+        appendInt(out, r.orderId);
+        out += ',';
+        out += domain::toChar(r.buyType);
+        out += ',';
+        appendInt(out, r.quantity);
+        out += ',';
+        appendInt(out, r.price);
+        out += '|';
+        appendInt(out, r.price);
+        out += ',';
+        appendInt(out, r.quantity);
+        out += ',';
+        out += domain::toChar(r.sellType);
+        out += ',';
+        appendInt(out, r.sellOrderId);
+        break;
+    case ResponseKind::MassCancel:
+        if (r.scope == MassCancelScope::All)
+            out += '*';
+        else
+            out += r.symbol.view();
+        if (r.scope == MassCancelScope::SymbolSide) {
+            out += ',';
+            out += domain::toChar(r.side);
+        }
+        if (r.accepted) {
+            out += " - MassCancelAccept - ";
+            appendInt(out, r.count);
+        } else {
+            out += " - MassCancelReject - ";
+            appendInt(out, r.rejectCode);
+            out += " - ";
+            out += r.message;
+        }
+        break;
+    case ResponseKind::Text:
+        if (r.text)
+            out += *r.text;
+        return;  // already newline-terminated
+    }
+    out += '\n';
+}
+
+ResponseWriter::ResponseWriter(std::ostream& out, std::size_t capacity, std::size_t batchBytes)
+    : m_out(out),
+      m_batchBytes(batchBytes),
+      m_ring(ringSizeFor(capacity == 0 ? 1 : capacity)),
+      m_mask(m_ring.size() - 1),
+      m_thread([this] { run(); }) {}
+
+ResponseWriter::~ResponseWriter() {
+    close();
+}
+
+void ResponseWriter::push(const ResponseRecord& record) {
+    const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_cachedTail == m_ring.size()) {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        if (head - m_cachedTail == m_ring.size()) {
+            ++m_fullWaits;
+            do {
+                std::this_thread::yield();
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+            } while (head - m_cachedTail == m_ring.size());
+        }
+    }
+    m_ring[head & m_mask] = record;
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+void ResponseWriter::pushText(std::string text) {
+    ResponseRecord r;
+    r.kind = ResponseKind::Text;
+    r.text = new std::string(std::move(text));
+    push(r);
+}
+
+void ResponseWriter::close() {
+    if (!m_thread.joinable())
+        return;
+    m_closing.store(true, std::memory_order_release);
+    m_thread.join();
+}
+
+ResponseWriterStats ResponseWriter::stats() const {
+    return ResponseWriterStats{m_head.load(std::memory_order_acquire), m_writes, m_fullWaits};
+}
+
+void ResponseWriter::run() {
+    std::string batch;
+    batch.reserve(m_batchBytes + 4096);
+    auto write = [&] {
+        m_out.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        batch.clear();
+        ++m_writes;
+    };
+
+    std::uint64_t tail = 0;
+    unsigned idle = 0;
+    for (;;) {
+        const std::uint64_t head = m_head.load(std::memory_order_acquire);
+        if (tail == head) {
+            if (!batch.empty()) {
+                write();
+                m_out.flush();  // idle engine: hand the lines on now, not at close()
+            }
+            // closing is set after the last push, so head is final once it is seen
+            if (m_closing.load(std::memory_order_acquire) && m_head.load(std::memory_order_acquire) == tail)
+                break;
+            if (++idle < 64)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+        idle = 0;
+        for (; tail != head; ++tail) {
+            const ResponseRecord& r = m_ring[tail & m_mask];
+            renderResponse(r, batch);
+            delete r.text;
+            if (batch.size() >= m_batchBytes) {
+                m_tail.store(tail + 1, std::memory_order_release);
+                write();
+            }
+        }
+        m_tail.store(tail, std::memory_order_release);
+    }
+    m_out.flush();
+}
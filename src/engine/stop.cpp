@@ -0,0 +1,57 @@
+#include "engine/stop.hpp"
+
+#include "book/indexed_order_book.hpp"
+#include "metrics/trace.hpp"
+#include "risk/risk_checker.hpp"
+
+template <BookBackend Book>
+StopOrderHandler<Book>::StopOrderHandler(Book& book)
+    : m_book(book) {}
+
+template <BookBackend Book>
+NewCommandResponse StopOrderHandler<Book>::execute(const StopOrderRequest& req) const {
+    NewCommandResponse r;
+    r.orderId = req.order.orderId;
+
+    // 1) the order's own fields as for N, plus a trigger; stops never expire
+    bool valid;
+    {
+        HFT_TRACE_STAGE(Validate);
+        valid = NewCommandHandler<Book>::isValidNew(req.order) && req.stopPrice > 0 && req.order.expireAt == 0;
+    }
+    if (!valid)
+        return r;  // reject 303
+
+    // 2) pre-trade limits
+    if (m_risk) {
+        HFT_TRACE_STAGE(Risk);
+        const auto reason = m_risk->checkNew(m_risk->idOf(req.order.symbol), req.order);
+        if (reason != risk::RiskReject::None) {
+            r.rejectCode = risk::kRiskRejectCode;
+            r.rejectMessage = risk::rejectMessage(reason);
+            return r;
+        }
+    }
+
+    // 3) the id must be free in the book and among the stops
+    HFT_TRACE_STAGE(Book);
+    if (m_book.isLive(req.order.orderId) || m_book.stops().contains(req.order.orderId))
+        return r;  // duplicate, 303
+
+    // 4) already crossed by the last trade => triggered now, otherwise parked
+    const domain::Price lastTrade = m_book.stops().lastTrade(req.order.symbol);
+    if (lastTrade != 0 && StopBook::crossed(req.order.side, req.stopPrice, lastTrade)) {
+        if (!m_book.add(triggeredOrder(m_book, req.order, lastTrade)))
+            return r;
+        if (m_risk)
+            m_risk->addOpen(m_risk->idOf(req.order.symbol), req.order.quantity);
+    } else if (!m_book.stops().park(req.order, req.stopPrice)) {
+        return r;
+    }
+
+    r.accepted = true;
+    return r;
+}
+
+template class StopOrderHandler<OrderBook>;
+template class StopOrderHandler<IndexedOrderBook>;
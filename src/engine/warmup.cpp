@@ -0,0 +1,93 @@
+#include "engine/warmup.hpp"
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "parser/commands_parser.hpp"
+#include "parser/fields_parser.hpp"
+#include "parser/tokenize.hpp"
+#include "workload/order_flow.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <unordered_set>
+
+namespace {
+
+bool validSymbol(const std::string& s) {
+    return !s.empty() && s.size() <= domain::Symbol::kCapacity &&
+           std::all_of(s.begin(), s.end(), [](unsigned char c) { return std::isalpha(c) != 0; });
+}
+
+}  // namespace
+
+std::optional<Universe> parseUniverse(std::istream& is, std::string& error) {
+    Universe universe;
+    std::unordered_set<domain::Symbol> seen;
+    std::string line;
+    for (std::size_t lineNo = 1; std::getline(is, line); ++lineNo) {
+        const auto tokens = tokenize(line);
+        if (tokens.empty() || tokens[0].empty() || tokens[0][0] == '#')
+            continue;
+        const auto orders = tokens.size() == 2 ? parseInt64Strict(tokens[1]) : std::optional<std::int64_t>{0};
+        if (tokens.size() > 2 || !validSymbol(tokens[0]) || !orders || *orders < 0 || !seen.insert(tokens[0]).second) {
+            error = "line " + std::to_string(lineNo) + ": " + line;
+            return std::nullopt;
+        }
+        universe.symbols.emplace_back(tokens[0]);
+        universe.expectedOrders += static_cast<std::size_t>(*orders);
+    }
+    return universe;
+}
+
+std::optional<Universe> loadUniverse(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return std::nullopt;
+    }
+    return parseUniverse(file, error);
+}
+
+template <BookBackend Book>
+WarmupResult warmUp(Book& book, const Universe& universe, std::uint64_t syntheticCommands) {
+    const auto t0 = std::chrono::steady_clock::now();
+    book.reserve(universe.expectedOrders);
+
+    if (syntheticCommands > 0) {
+        workload::OrderFlowConfig config;
+        for (const auto& symbol : universe.symbols) {
+            config.symbolNames.push_back(symbol.str());
+        }
+        workload::OrderFlowGenerator flow(config);
+        CommandDispatcher<Book> dispatcher(book);
+        std::ostream discard(nullptr);
+        std::string line;
+        for (std::uint64_t i = 0; i < syntheticCommands; ++i) {
+            line.clear();
+            flow.appendLine(line);
+            line.pop_back();  // '\n'
+            const auto parsed = parseCommandLine(line);
+            if (!parsed)
+                continue;
+            // the same calls the app makes per command, responses included
+            dispatcher.advanceClock(timestampOf(*parsed), discard);
+            dispatcher.dispatchTo(*parsed, discard);
+        }
+        book.clear();
+    }
+
+    for (const auto& symbol : universe.symbols) {
+        book.prepareSymbol(symbol);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - t0;
+    return WarmupResult{universe.symbols.size(), universe.expectedOrders, syntheticCommands,
+                        std::chrono::duration<double, std::milli>(elapsed).count()};
+}
+
+template WarmupResult warmUp(OrderBook& book, const Universe& universe, std::uint64_t syntheticCommands);
+template WarmupResult warmUp(IndexedOrderBook& book, const Universe& universe, std::uint64_t syntheticCommands);
@@ -0,0 +1,85 @@
+#include "marketdata/l2_book_builder.hpp"
+
+namespace marketdata {
+
+namespace {
+
+template <typename Levels>
+void applyLevel(Levels& levels, const L2Delta& delta) {
+    if (delta.kind == DeltaKind::LevelDelete) {
+        levels.erase(delta.price);
+        return;
+    }
+    levels[delta.price] = LevelSummary{delta.price, delta.quantity, delta.orders};
+}
+
+}  // namespace
+
+void L2BookBuilder::onSnapshot(const L2Snapshot& snapshot) {
+    auto& book = m_books[snapshot.symbol];
+    book.bids.clear();
+    book.asks.clear();
+    for (const auto& level : snapshot.bids) {
+        book.bids.emplace(level.price, level);
+    }
+    for (const auto& level : snapshot.asks) {
+        book.asks.emplace(level.price, level);
+    }
+    book.seq = snapshot.seq;
+    book.live = true;
+}
+
+void L2BookBuilder::onDelta(const L2Delta& delta) {
+    const domain::Symbol symbol(delta.symbol);
+    auto it = m_books.find(symbol);
+    if (it == m_books.end())
+        it = m_books.emplace(symbol, SymbolBook{}).first;
+    SymbolBook& book = it->second;
+
+    if (!book.live || delta.seq <= book.seq)
+        return;  // waiting for a snapshot / already in the snapshot
+    if (delta.seq != book.seq + 1) {
+        book.live = false;  // lost deltas: only a snapshot can fix the levels
+        ++m_gaps;
+        return;
+    }
+    book.seq = delta.seq;
+    if (delta.kind == DeltaKind::Trade)
+        return;
+    if (delta.side == domain::Side::Buy)
+        applyLevel(book.bids, delta);
+    else
+        applyLevel(book.asks, delta);
+}
+
+bool L2BookBuilder::isLive(const domain::Symbol& symbol) const {
+    const auto it = m_books.find(symbol);
+    return it != m_books.end() && it->second.live;
+}
+
+std::uint64_t L2BookBuilder::seqOf(const domain::Symbol& symbol) const {
+    const auto it = m_books.find(symbol);
+    return it != m_books.end() ? it->second.seq : 0;
+}
+
+std::size_t L2BookBuilder::depth(const domain::Symbol& symbol,
+                                 domain::Side side,
+                                 std::size_t maxLevels,
+                                 LevelSummary* out) const {
+    const auto it = m_books.find(symbol);
+    if (it == m_books.end())
+        return 0;
+    std::size_t n = 0;
+    auto copy = [&](const auto& levels) {
+        for (auto level = levels.begin(); level != levels.end() && n < maxLevels; ++level) {
+            out[n++] = level->second;
+        }
+    };
+    if (side == domain::Side::Buy)
+        copy(it->second.bids);
+    else
+        copy(it->second.asks);
+    return n;
+}
+
+}  // namespace marketdata
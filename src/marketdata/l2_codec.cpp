@@ -0,0 +1,169 @@
+#include "marketdata/l2_codec.hpp"
+
+#include "persistence/binary_io.hpp"
+
+#include <istream>
+#include <ostream>
+
+namespace marketdata {
+
+using persistence::ByteReader;
+using persistence::putBytes;
+using persistence::putVarI64;
+using persistence::putVarU64;
+
+namespace {
+
+constexpr std::uint8_t kMaxDeltaKind = static_cast<std::uint8_t>(DeltaKind::Trade);
+
+void putLevel(std::vector<char>& out, const LevelSummary& level) {
+    putVarI64(out, level.price);
+    putVarI64(out, level.quantity);
+    putVarU64(out, level.orders);
+}
+
+bool getLevels(ByteReader& in, std::vector<LevelSummary>& levels) {
+    std::uint64_t count = 0;
+    if (!in.getVarU64(count) || count > in.remaining())  // every level takes >= 3 bytes
+        return false;
+    levels.resize(count);
+    for (auto& level : levels) {
+        std::int64_t price = 0;
+        std::uint64_t orders = 0;
+        if (!in.getVarI64(price) || !in.getVarI64(level.quantity) || !in.getVarU64(orders))
+            return false;
+        level.price = price;
+        level.orders = static_cast<std::uint32_t>(orders);
+    }
+    return true;
+}
+
+}  // namespace
+
+void encodeDelta(const L2Delta& delta, std::vector<char>& out) {
+    out.push_back(static_cast<char>(delta.kind));
+    putBytes(out, delta.symbol);
+    putVarU64(out, delta.seq);
+    if (delta.kind == DeltaKind::Trade) {
+        putVarI64(out, delta.price);
+        putVarI64(out, delta.quantity);
+        putVarI64(out, delta.buyOrderId);
+        putVarI64(out, delta.sellOrderId);
+        return;
+    }
+    out.push_back(static_cast<char>(delta.side));
+    putVarI64(out, delta.price);
+    putVarI64(out, delta.quantity);
+    putVarU64(out, delta.orders);
+}
+
+void encodeSnapshot(const L2Snapshot& snapshot, std::vector<char>& out) {
+    putBytes(out, snapshot.symbol);
+    putVarU64(out, snapshot.seq);
+    putVarU64(out, snapshot.bids.size());
+    for (const auto& level : snapshot.bids) {
+        putLevel(out, level);
+    }
+    putVarU64(out, snapshot.asks.size());
+    for (const auto& level : snapshot.asks) {
+        putLevel(out, level);
+    }
+}
+
+bool decodeDelta(const char* data, std::size_t size, L2Delta& delta) {
+    ByteReader in(data, size);
+    std::uint8_t kind = 0;
+    std::int64_t price = 0;
+    if (!in.getU8(kind) || kind > kMaxDeltaKind || !in.getBytes(delta.symbol) || !in.getVarU64(delta.seq))
+        return false;
+    delta.kind = static_cast<DeltaKind>(kind);
+    if (delta.kind == DeltaKind::Trade) {
+        std::int64_t buy = 0;
+        std::int64_t sell = 0;
+        if (!in.getVarI64(price) || !in.getVarI64(delta.quantity) || !in.getVarI64(buy) || !in.getVarI64(sell))
+            return false;
+        delta.price = price;
+        delta.buyOrderId = static_cast<domain::OrderId>(buy);
+        delta.sellOrderId = static_cast<domain::OrderId>(sell);
+        return in.remaining() == 0;
+    }
+    std::uint8_t side = 0;
+    std::uint64_t orders = 0;
+    if (!in.getU8(side) || !in.getVarI64(price) || !in.getVarI64(delta.quantity) || !in.getVarU64(orders))
+        return false;
+    if (side != static_cast<std::uint8_t>(domain::Side::Buy) && side != static_cast<std::uint8_t>(domain::Side::Sell))
+        return false;
+    delta.side = static_cast<domain::Side>(side);
+    delta.price = price;
+    delta.orders = static_cast<std::uint32_t>(orders);
+    return in.remaining() == 0;
+}
+
+bool decodeSnapshot(const char* data, std::size_t size, L2Snapshot& snapshot) {
+    ByteReader in(data, size);
+    std::string_view symbol;
+    if (!in.getBytes(symbol) || !in.getVarU64(snapshot.seq))
+        return false;
+    snapshot.symbol.assign(symbol);
+    return getLevels(in, snapshot.bids) && getLevels(in, snapshot.asks) && in.remaining() == 0;
+}
+
+L2StreamSink::L2StreamSink(std::ostream& os)
+    : m_os(os) {}
+
+void L2StreamSink::onDelta(const L2Delta& delta) {
+    m_payload.clear();
+    encodeDelta(delta, m_payload);
+    writeFrame(L2Record::Delta);
+    ++m_deltas;
+}
+
+void L2StreamSink::onSnapshot(const L2Snapshot& snapshot) {
+    m_payload.clear();
+    encodeSnapshot(snapshot, m_payload);
+    writeFrame(L2Record::Snapshot);
+    ++m_snapshots;
+}
+
+void L2StreamSink::writeFrame(L2Record type) {
+    m_frame.clear();
+    m_frame.push_back(static_cast<char>(type));
+    putVarU64(m_frame, m_payload.size());
+    m_os.write(m_frame.data(), static_cast<std::streamsize>(m_frame.size()));
+    m_os.write(m_payload.data(), static_cast<std::streamsize>(m_payload.size()));
+}
+
+bool readL2Stream(std::istream& is, L2Sink& sink) {
+    std::vector<char> payload;
+    L2Snapshot snapshot;
+    L2Delta delta;
+    for (int c; (c = is.get()) != std::istream::traits_type::eof();) {
+        std::uint64_t size = 0;
+        for (int shift = 0;; shift += 7) {
+            const int byte = is.get();
+            if (byte == std::istream::traits_type::eof() || shift >= 64)
+                return false;
+            size |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+        payload.resize(size);
+        if (!is.read(payload.data(), static_cast<std::streamsize>(size)))
+            return false;
+
+        if (c == static_cast<int>(L2Record::Delta)) {
+            if (!decodeDelta(payload.data(), payload.size(), delta))
+                return false;
+            sink.onDelta(delta);
+        } else if (c == static_cast<int>(L2Record::Snapshot)) {
+            if (!decodeSnapshot(payload.data(), payload.size(), snapshot))
+                return false;
+            sink.onSnapshot(snapshot);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace marketdata
@@ -0,0 +1,61 @@
+#include "marketdata/l2_feed.hpp"
+
+namespace marketdata {
+
+L2Publisher::L2Publisher(L2Sink& sink, std::uint64_t snapshotEvery)
+    : m_sink(sink), m_snapshotEvery(snapshotEvery) {}
+
+void L2Publisher::next(const domain::Symbol& symbol, L2Delta& delta) {
+    auto& state = m_symbols[symbol];
+    delta.symbol = symbol.view();
+    delta.seq = ++state.seq;
+    ++state.sinceSnapshot;
+    // a symbol's first delta makes it due too: whatever the book held before the
+    // publisher was attached reaches the consumers through that snapshot
+    const bool periodic = m_snapshotEvery != 0 && state.sinceSnapshot >= m_snapshotEvery;
+    if (!state.due && (delta.seq == 1 || periodic)) {
+        state.due = true;
+        m_due.push_back(symbol);
+    }
+}
+
+void L2Publisher::level(const domain::Symbol& symbol, domain::Side side, const LevelSummary& after, bool existed) {
+    L2Delta delta;
+    next(symbol, delta);
+    delta.kind = !existed ? DeltaKind::LevelAdd : after.orders == 0 ? DeltaKind::LevelDelete : DeltaKind::LevelChange;
+    delta.side = side;
+    delta.price = after.price;
+    delta.quantity = after.orders == 0 ? 0 : after.quantity;
+    delta.orders = after.orders;
+    m_sink.onDelta(delta);
+}
+
+void L2Publisher::trade(const domain::Symbol& symbol,
+                        domain::Price price,
+                        int quantity,
+                        domain::OrderId buyOrderId,
+                        domain::OrderId sellOrderId) {
+    L2Delta delta;
+    next(symbol, delta);
+    delta.kind = DeltaKind::Trade;
+    delta.price = price;
+    delta.quantity = quantity;
+    delta.buyOrderId = buyOrderId;
+    delta.sellOrderId = sellOrderId;
+    m_sink.onDelta(delta);
+}
+
+std::uint64_t L2Publisher::seqOf(const domain::Symbol& symbol) const {
+    const auto it = m_symbols.find(symbol);
+    return it != m_symbols.end() ? it->second.seq : 0;
+}
+
+void L2Publisher::requestSnapshot(const domain::Symbol& symbol) {
+    auto& state = m_symbols[symbol];
+    if (!state.due) {
+        state.due = true;
+        m_due.push_back(symbol);
+    }
+}
+
+}  // namespace marketdata
@@ -0,0 +1,269 @@
+#include "marketdata/top_of_book.hpp"
+
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace marketdata {
+
+namespace {
+
+constexpr std::uint64_t kMagic = 0x31504f544b4f4f42ull;  // "BOOKTOP1"
+constexpr std::size_t kCacheLine = 64;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(std::atomic<std::int64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+std::uint32_t ringSizeFor(std::uint32_t capacity) {
+    std::uint32_t n = 1;
+    while (n < capacity) {
+        n <<= 1;
+    }
+    return n;
+}
+
+}  // namespace
+
+// Everything below lives in the mapped block, so no pointers and no std types other
+// than lock-free atomics. Layout: Header | Slot[capacity] | ring[ringSize].
+struct TopOfBookTable::Header {
+    std::uint64_t magic;
+    std::uint32_t capacity;
+    std::uint32_t ringMask;
+    std::atomic<std::uint32_t> symbols;  // slots [0, symbols) have a name
+    alignas(kCacheLine) std::atomic<std::uint64_t> head;  // writer
+    alignas(kCacheLine) std::atomic<std::uint64_t> tail;  // reader
+};
+
+struct alignas(kCacheLine) TopOfBookTable::Slot {
+    std::atomic<std::uint32_t> version;  // odd while the writer is in the middle of an update
+    std::atomic<std::uint32_t> queued;   // 1 while the index sits in the ring
+    char symbol[kMaxSymbolLength + 1];
+    std::atomic<std::int64_t> bidPrice;
+    std::atomic<std::int64_t> bidQuantity;
+    std::atomic<std::int64_t> askPrice;
+    std::atomic<std::int64_t> askQuantity;
+    std::atomic<std::uint32_t> bidOrders;
+    std::atomic<std::uint32_t> askOrders;
+    std::atomic<std::uint64_t> updates;
+};
+
+std::size_t TopOfBookTable::bytesFor(std::uint32_t capacity) {
+    return sizeof(Header) + sizeof(Slot) * capacity + sizeof(std::atomic<std::uint32_t>) * ringSizeFor(capacity);
+}
+
+void TopOfBookTable::format(void* memory, std::uint32_t capacity) {
+    std::memset(memory, 0, bytesFor(capacity));
+    auto* header = new (memory) Header{};
+    header->magic = kMagic;
+    header->capacity = capacity;
+    header->ringMask = ringSizeFor(capacity) - 1;
+    auto* slot = reinterpret_cast<Slot*>(header + 1);
+    for (std::uint32_t i = 0; i < capacity; ++i) {
+        new (slot + i) Slot{};
+    }
+    auto* ring = reinterpret_cast<std::atomic<std::uint32_t>*>(slot + capacity);
+    for (std::uint32_t i = 0; i <= header->ringMask; ++i) {
+        new (ring + i) std::atomic<std::uint32_t>{0};
+    }
+}
+
+TopOfBookTable::TopOfBookTable(std::uint32_t capacity)
+    : m_header(nullptr), m_bytes(bytesFor(capacity)), m_owner(true) {
+    void* memory = ::operator new(m_bytes, std::align_val_t{kCacheLine});
+    format(memory, capacity);
+    m_header = static_cast<Header*>(memory);
+}
+
+TopOfBookTable::TopOfBookTable(void* memory, std::size_t bytes, std::string shmName, bool owner)
+    : m_header(static_cast<Header*>(memory)), m_bytes(bytes), m_shmName(std::move(shmName)), m_owner(owner) {}
+
+TopOfBookTable::~TopOfBookTable() {
+    if (m_shmName.empty()) {
+        ::operator delete(m_header, std::align_val_t{kCacheLine});
+        return;
+    }
+    ::munmap(m_header, m_bytes);
+    if (m_owner)
+        ::shm_unlink(m_shmName.c_str());
+}
+
+std::unique_ptr<TopOfBookTable> TopOfBookTable::createShared(const std::string& name, std::uint32_t capacity) {
+    if (capacity == 0)
+        return nullptr;
+    ::shm_unlink(name.c_str());  // a segment left behind by a crashed run
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return nullptr;
+    const std::size_t bytes = bytesFor(capacity);
+    void* memory = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+        memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+    format(memory, capacity);
+    return std::unique_ptr<TopOfBookTable>(new TopOfBookTable(memory, bytes, name, true));
+}
+
+std::unique_ptr<TopOfBookTable> TopOfBookTable::openShared(const std::string& name) {
+    // the reader writes too: the ring tail and the queued flags
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        return nullptr;
+    struct stat st{};
+    void* memory = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(Header))
+        memory = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED)
+        return nullptr;
+
+    const auto bytes = static_cast<std::size_t>(st.st_size);
+    const auto* header = static_cast<const Header*>(memory);
+    if (header->magic != kMagic || header->capacity == 0 || bytesFor(header->capacity) != bytes) {
+        ::munmap(memory, bytes);
+        return nullptr;
+    }
+    return std::unique_ptr<TopOfBookTable>(new TopOfBookTable(memory, bytes, name, false));
+}
+
+std::uint32_t TopOfBookTable::capacity() const {
+    return m_header->capacity;
+}
+
+std::uint32_t TopOfBookTable::symbolCount() const {
+    return m_header->symbols.load(std::memory_order_acquire);
+}
+
+TopOfBookTable::Slot* TopOfBookTable::slots() const {
+    return reinterpret_cast<Slot*>(m_header + 1);
+}
+
+std::atomic<std::uint32_t>* TopOfBookTable::ring() const {
+    return reinterpret_cast<std::atomic<std::uint32_t>*>(slots() + m_header->capacity);
+}
+
+std::int32_t TopOfBookTable::slotOf(const domain::Symbol& symbol) {
+    if (const auto it = m_slotOf.find(symbol); it != m_slotOf.end())
+        return it->second;
+    const std::uint32_t n = m_header->symbols.load(std::memory_order_relaxed);
+    if (n == m_header->capacity || symbol.size() > kMaxSymbolLength)
+        return -1;
+    std::memcpy(slots()[n].symbol, symbol.data(), symbol.size());
+    m_header->symbols.store(n + 1, std::memory_order_release);  // publishes the name
+    m_slotOf.emplace(symbol, static_cast<std::int32_t>(n));
+    return static_cast<std::int32_t>(n);
+}
+
+void TopOfBookTable::write(std::int32_t index, const LevelSummary& bid, const LevelSummary& ask) {
+    Slot& s = slots()[index];
+    const std::uint32_t v = s.version.load(std::memory_order_relaxed);
+    s.version.store(v + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.bidPrice.store(bid.price, std::memory_order_relaxed);
+    s.bidQuantity.store(bid.quantity, std::memory_order_relaxed);
+    s.bidOrders.store(bid.orders, std::memory_order_relaxed);
+    s.askPrice.store(ask.price, std::memory_order_relaxed);
+    s.askQuantity.store(ask.quantity, std::memory_order_relaxed);
+    s.askOrders.store(ask.orders, std::memory_order_relaxed);
+    s.updates.store(s.updates.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    s.version.store(v + 2, std::memory_order_release);
+
+    // already queued => the reader will pick this value up when it gets there
+    if (s.queued.exchange(1, std::memory_order_seq_cst) == 0) {
+        const std::uint64_t head = m_header->head.load(std::memory_order_relaxed);
+        ring()[head & m_header->ringMask].store(static_cast<std::uint32_t>(index), std::memory_order_relaxed);
+        m_header->head.store(head + 1, std::memory_order_release);
+    }
+}
+
+bool TopOfBookTable::popDirty(std::uint32_t& slot) {
+    const std::uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+    if (tail == m_header->head.load(std::memory_order_acquire))
+        return false;
+    slot = ring()[tail & m_header->ringMask].load(std::memory_order_relaxed);
+    m_header->tail.store(tail + 1, std::memory_order_release);
+    // cleared before reading: a write after this point queues the slot again
+    slots()[slot].queued.exchange(0, std::memory_order_seq_cst);
+    return true;
+}
+
+void TopOfBookTable::read(std::uint32_t index, TopOfBook& out) const {
+    const Slot& s = slots()[index];
+    out.symbol = std::string_view(s.symbol, ::strnlen(s.symbol, sizeof(s.symbol)));
+    std::uint32_t before;
+    std::uint32_t after;
+    do {
+        before = s.version.load(std::memory_order_acquire);
+        out.bid.price = s.bidPrice.load(std::memory_order_relaxed);
+        out.bid.quantity = s.bidQuantity.load(std::memory_order_relaxed);
+        out.bid.orders = s.bidOrders.load(std::memory_order_relaxed);
+        out.ask.price = s.askPrice.load(std::memory_order_relaxed);
+        out.ask.quantity = s.askQuantity.load(std::memory_order_relaxed);
+        out.ask.orders = s.askOrders.load(std::memory_order_relaxed);
+        out.updates = s.updates.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = s.version.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1) != 0);
+}
+
+bool TopOfBookTable::latest(std::string_view symbol, TopOfBook& out) const {
+    const std::uint32_t n = symbolCount();
+    for (std::uint32_t i = 0; i < n; ++i) {
+        if (symbol == std::string_view(slots()[i].symbol, ::strnlen(slots()[i].symbol, kMaxSymbolLength + 1))) {
+            read(i, out);
+            return out.updates != 0;
+        }
+    }
+    return false;
+}
+
+TopOfBookConflator::TopOfBookConflator(TopOfBookTable& table)
+    : m_table(table) {}
+
+void TopOfBookConflator::onDelta(const L2Delta& delta) {
+    if (delta.kind == DeltaKind::Trade)
+        return;
+    auto [it, inserted] = m_index.try_emplace(domain::Symbol(delta.symbol), static_cast<std::uint32_t>(m_symbols.size()));
+    if (inserted) {
+        m_symbols.push_back(Symbol{it->first});
+    }
+    Symbol& s = m_symbols[it->second];
+    if (!s.pending) {
+        s.pending = true;
+        m_pending.push_back(it->second);
+    }
+}
+
+void TopOfBookConflator::publish(Symbol& s, const LevelSummary& bid, const LevelSummary& ask) {
+    auto same = [](const LevelSummary& a, const LevelSummary& b) {
+        return a.price == b.price && a.quantity == b.quantity && a.orders == b.orders;
+    };
+    if (s.slot == kNoRoom)
+        return;
+    // deeper levels changed, the top did not
+    if (s.slot >= 0 && same(s.bid, bid) && same(s.ask, ask))
+        return;
+    if (s.slot < 0) {
+        s.slot = m_table.slotOf(s.name);
+        if (s.slot < 0) {
+            s.slot = kNoRoom;
+            ++m_dropped;
+            return;
+        }
+    }
+    s.bid = bid;
+    s.ask = ask;
+    m_table.write(s.slot, bid, ask);
+    ++m_writes;
+}
+
+}  // namespace marketdata
@@ -0,0 +1,98 @@
+#include "marketdata/trade_stats.hpp"
+
+#include "domain/order.hpp"  // printPrice
+
+#include <iomanip>
+#include <ostream>
+
+namespace marketdata {
+
+namespace {
+
+domain::Timestamp bucketStart(domain::Timestamp ts, domain::Timestamp width) {
+    const domain::Timestamp r = ts % width;
+    return ts - (r < 0 ? r + width : r);
+}
+
+void writeBar(std::ostream& os, const domain::Symbol& symbol, const TradeBar& bar) {
+    os << symbol << ',' << bar.start << ',';
+    domain::printPrice(os, bar.open);
+    os << ',';
+    domain::printPrice(os, bar.high);
+    os << ',';
+    domain::printPrice(os, bar.low);
+    os << ',';
+    domain::printPrice(os, bar.close);
+    os << ',' << bar.volume << ',';
+    domain::printPrice(os, bar.notional);
+    os << ',' << std::fixed << std::setprecision(4) << bar.vwap() / 100.0 << std::defaultfloat << ',' << bar.trades
+       << '\n';
+}
+
+constexpr const char* kCsvHeader = "symbol,start,open,high,low,close,volume,notional,vwap,trades\n";
+
+}  // namespace
+
+TradeStats::TradeStats(domain::Timestamp bucketWidth)
+    : m_bucketWidth(bucketWidth) {}
+
+std::uint32_t TradeStats::idOf(const domain::Symbol& symbol) {
+    const auto [it, inserted] = m_ids.try_emplace(symbol, static_cast<std::uint32_t>(m_stats.size()));
+    if (inserted) {
+        m_stats.emplace_back();
+        m_stats.back().symbol = symbol;
+    }
+    return it->second;
+}
+
+void TradeStats::addToBucket(std::uint32_t id,
+                             SymbolTradeStats& s,
+                             domain::Timestamp ts,
+                             domain::Price price,
+                             int quantity) {
+    const domain::Timestamp start = bucketStart(ts, m_bucketWidth);
+    if (s.bucket.trades != 0 && s.bucket.start != start) {
+        m_bars.push_back(ClosedBar{id, s.bucket});
+        s.bucket = TradeBar{};
+    }
+    if (s.bucket.trades == 0)
+        s.bucket.start = start;
+    s.bucket.add(price, quantity);
+}
+
+const SymbolTradeStats* TradeStats::find(const domain::Symbol& symbol) const {
+    const auto it = m_ids.find(symbol);
+    return it != m_ids.end() ? &m_stats[it->second] : nullptr;
+}
+
+void TradeStats::closeBuckets() {
+    for (std::uint32_t id = 0; id < m_stats.size(); ++id) {
+        TradeBar& bucket = m_stats[id].bucket;
+        if (bucket.trades != 0) {
+            m_bars.push_back(ClosedBar{id, bucket});
+            bucket = TradeBar{};
+        }
+    }
+}
+
+void TradeStats::writeSessionCsv(std::ostream& os) const {
+    os << kCsvHeader;
+    for (const auto& s : m_stats) {
+        writeBar(os, s.symbol, s.session);
+    }
+}
+
+void TradeStats::writeBarsCsv(std::ostream& os) const {
+    os << kCsvHeader;
+    for (const auto& closed : m_bars) {
+        writeBar(os, m_stats[closed.id].symbol, closed.bar);
+    }
+}
+
+void TradeStats::reset() {
+    m_ids.clear();
+    m_stats.clear();
+    m_bars.clear();
+}
+
+}  // namespace marketdata
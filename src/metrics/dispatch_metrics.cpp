@@ -0,0 +1,85 @@
+#include "metrics/dispatch_metrics.hpp"
+
+#include "metrics/tsc.hpp"
+
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+namespace metrics {
+
+const char* toString(MessageType t) {
+    switch (t) {
+    case MessageType::New:
+        return "N";
+    case MessageType::Amend:
+        return "A";
+    case MessageType::Cancel:
+        return "X";
+    case MessageType::Match:
+        return "M";
+    case MessageType::Query:
+        return "Q";
+    case MessageType::MassCancel:
+        return "C";
+    case MessageType::BatchNew:
+        return "B";
+    case MessageType::Stop:
+        return "S";
+    }
+    return "?";
+}
+
+namespace {
+
+constexpr double kPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+
+void printRow(std::ostream& os, const char* label, const LogLinearHistogram& h, double scale) {
+    os << std::left << std::setw(12) << label << std::right << std::setw(12) << h.count();
+    for (const double p : kPercentiles) {
+        os << std::setw(11) << static_cast<double>(h.valueAtPercentile(p)) / scale;
+    }
+    os << std::setw(11) << static_cast<double>(h.max()) / scale << "\n";
+}
+
+}  // namespace
+
+void DispatchMetrics::report(std::ostream& os) const {
+    const double ticksPerNs = tscTicksPerNs();
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << std::fixed << std::setprecision(1);
+
+    os << "=== LATENCY (ns, dispatch -> formatted response) ===\n"
+       << std::left << std::setw(12) << "type" << std::right << std::setw(12) << "count" << std::setw(11) << "p50"
+       << std::setw(11) << "p90" << std::setw(11) << "p99" << std::setw(11) << "p99.9" << std::setw(11) << "max"
+       << "\n";
+    for (std::size_t t = 0; t < kMessageTypes; ++t) {
+        for (int outcome = 0; outcome < 2; ++outcome) {
+            const auto& h = m_latency[t][static_cast<std::size_t>(outcome)];
+            if (h.count() == 0)
+                continue;
+            const std::string label =
+                std::string(toString(static_cast<MessageType>(t))) + (outcome == 0 ? " accept" : " reject");
+            printRow(os, label.c_str(), h, ticksPerNs);
+        }
+    }
+    if (m_fillsPerMatch.count() > 0) {
+        os << "--- fills per M ---\n";
+        printRow(os, "M fills", m_fillsPerMatch, 1.0);
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void DispatchMetrics::reset() {
+    for (auto& perType : m_latency) {
+        for (auto& h : perType) {
+            h.reset();
+        }
+    }
+    m_fillsPerMatch.reset();
+}
+
+}  // namespace metrics
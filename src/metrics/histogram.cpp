@@ -0,0 +1,47 @@
+#include "metrics/histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace metrics {
+
+std::uint64_t LogLinearHistogram::bucketHigh(std::size_t bucket) {
+    if (bucket < kSubBuckets)
+        return bucket;
+    const std::size_t shift = bucket / kSubBuckets - 1;
+    const std::uint64_t sub = bucket % kSubBuckets;
+    const std::uint64_t low = (kSubBuckets + sub) << shift;
+    return low + ((1ull << shift) - 1);
+}
+
+std::uint64_t LogLinearHistogram::valueAtPercentile(double p) const {
+    if (m_count == 0)
+        return 0;
+    p = std::clamp(p, 0.0, 100.0);
+    const auto target = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(p / 100.0 * static_cast<double>(m_count))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+        seen += m_counts[b];
+        if (seen >= target)
+            return std::min(bucketHigh(b), m_max);
+    }
+    return m_max;
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram& other) {
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+        m_counts[b] += other.m_counts[b];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_max = std::max(m_max, other.m_max);
+    m_min = std::min(m_min, other.m_min);
+}
+
+void LogLinearHistogram::reset() {
+    *this = LogLinearHistogram{};
+}
+
+}  // namespace metrics
@@ -0,0 +1,207 @@
+#include "metrics/perf_counters.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace metrics {
+
+const char* toString(PerfEvent e) {
+    switch (e) {
+    case PerfEvent::Cycles:
+        return "cycles";
+    case PerfEvent::Instructions:
+        return "instructions";
+    case PerfEvent::L1dMisses:
+        return "L1D-miss";
+    case PerfEvent::LlcMisses:
+        return "LLC-miss";
+    case PerfEvent::BranchMisses:
+        return "branch-miss";
+    case PerfEvent::DtlbMisses:
+        return "dTLB-miss";
+    case PerfEvent::PageFaults:
+        return "page-faults";
+    }
+    return "?";
+}
+
+PerfReading& PerfReading::operator+=(const PerfReading& other) {
+    for (std::size_t i = 0; i < kPerfEvents; ++i) {
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+PerfReading operator-(const PerfReading& end, const PerfReading& begin) {
+    PerfReading d;
+    for (std::size_t i = 0; i < kPerfEvents; ++i) {
+        d.values[i] = end.values[i] - begin.values[i];
+    }
+    return d;
+}
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr std::uint64_t cacheMiss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+struct EventSpec {
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+// Indexed by PerfEvent.
+constexpr EventSpec kSpecs[kPerfEvents] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+int openEvent(const EventSpec& spec, int groupFd) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = groupFd < 0 ? 1 : 0;  // members follow the leader
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+    m_fds.fill(-1);
+    for (std::size_t i = 0; i < kPerfEvents; ++i) {
+        const int fd = openEvent(kSpecs[i], m_leaderFd);
+        if (fd < 0) {
+            if (i == static_cast<std::size_t>(PerfEvent::Cycles))
+                m_reason = std::string("perf_event_open(cycles): ") + std::strerror(errno);
+            continue;
+        }
+        if (m_leaderFd < 0)
+            m_leaderFd = fd;
+        m_fds[i] = fd;
+        m_slot[i] = m_opened++;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (const int fd : m_fds) {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+void PerfCounters::start() {
+    if (m_leaderFd < 0)
+        return;
+    ioctl(m_leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounters::stop() {
+    if (m_leaderFd >= 0)
+        ioctl(m_leaderFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfReading PerfCounters::read() const {
+    PerfReading r;
+    if (m_leaderFd < 0)
+        return r;
+
+    // nr | time_enabled | time_running | value[nr]
+    std::uint64_t buf[3 + kPerfEvents]{};
+    const auto want = static_cast<ssize_t>((3 + m_opened) * sizeof(std::uint64_t));
+    if (::read(m_leaderFd, buf, sizeof(buf)) < want)
+        return r;
+
+    const std::uint64_t enabled = buf[1];
+    const std::uint64_t running = buf[2];
+    for (std::size_t i = 0; i < kPerfEvents; ++i) {
+        if (m_fds[i] < 0)
+            continue;
+        const std::uint64_t raw = buf[3 + m_slot[i]];
+        r.values[i] = (running > 0 && running < enabled)
+                          ? static_cast<std::uint64_t>(static_cast<double>(raw) * enabled / running)
+                          : raw;
+    }
+    return r;
+}
+
+#else  // !__linux__
+
+PerfCounters::PerfCounters()
+    : m_reason("perf_event_open is Linux-only") {
+    m_fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::start() {}
+
+void PerfCounters::stop() {}
+
+PerfReading PerfCounters::read() const {
+    return {};
+}
+
+#endif
+
+void PerfByType::report(std::ostream& os, const PerfCounters& counters) const {
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << std::fixed << std::setprecision(2);
+
+    os << "=== HW COUNTERS (per command) ===\n";
+    if (!counters.hardwareAvailable())
+        os << "hardware counters unavailable: " << counters.unavailableReason() << "\n";
+
+    os << std::left << std::setw(6) << "type" << std::right << std::setw(12) << "commands";
+    for (std::size_t e = 0; e < kPerfEvents; ++e) {
+        os << std::setw(14) << toString(static_cast<PerfEvent>(e));
+    }
+    os << std::setw(8) << "IPC" << "\n";
+
+    for (std::size_t t = 0; t < kMessageTypes; ++t) {
+        const auto& tally = m_types[t];
+        if (tally.commands == 0)
+            continue;
+        os << std::left << std::setw(6) << toString(static_cast<MessageType>(t)) << std::right << std::setw(12)
+           << tally.commands;
+        for (std::size_t e = 0; e < kPerfEvents; ++e) {
+            if (counters.has(static_cast<PerfEvent>(e)))
+                os << std::setw(14) << static_cast<double>(tally.total.values[e]) / static_cast<double>(tally.commands);
+            else
+                os << std::setw(14) << "n/a";
+        }
+        const auto cycles = tally.total[PerfEvent::Cycles];
+        if (cycles > 0)
+            os << std::setw(8) << static_cast<double>(tally.total[PerfEvent::Instructions]) / static_cast<double>(cycles);
+        else
+            os << std::setw(8) << "n/a";
+        os << "\n";
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+}  // namespace metrics
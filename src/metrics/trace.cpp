@@ -0,0 +1,157 @@
+#include "metrics/trace.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace metrics {
+
+thread_local constinit TraceThreadState t_trace{};
+
+const char* toString(Stage s) {
+    switch (s) {
+    case Stage::Message:
+        return "message";
+    case Stage::Tokenize:
+        return "tokenize";
+    case Stage::Parse:
+        return "parse";
+    case Stage::Validate:
+        return "validate";
+    case Stage::Book:
+        return "book";
+    case Stage::Format:
+        return "format";
+    case Stage::Risk:
+        return "risk";
+    }
+    return "?";
+}
+
+namespace {
+
+// Owns a thread's ring so it outlives the thread and can still be exported.
+struct ThreadTrace {
+    std::uint32_t tid{};
+    std::vector<TraceEvent> ring;
+    TraceThreadState* state{nullptr};  // nullptr once the thread exited / disabled
+    std::uint64_t head{0};             // valid when state == nullptr
+};
+
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadTrace>> g_registry;
+std::uint32_t g_nextTid = 1;
+
+ThreadTrace* findLocked(const TraceThreadState* state) {
+    for (auto& t : g_registry) {
+        if (t->state == state)
+            return t.get();
+    }
+    return nullptr;
+}
+
+void detachLocked(ThreadTrace* trace) {
+    trace->head = trace->state->head;
+    *trace->state = TraceThreadState{};
+    trace->state = nullptr;
+}
+
+// Only touched by enableStageTracing(); its destructor freezes the ring at thread exit.
+struct ThreadExitGuard {
+    bool armed{false};
+    ~ThreadExitGuard() {
+        if (!armed)
+            return;
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        if (auto* trace = findLocked(&t_trace))
+            detachLocked(trace);
+    }
+};
+
+thread_local ThreadExitGuard t_exitGuard;
+
+}  // namespace
+
+void enableStageTracing(std::uint32_t sampleEvery, std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if (auto* old = findLocked(&t_trace))
+        detachLocked(old);
+
+    auto trace = std::make_unique<ThreadTrace>();
+    trace->tid = g_nextTid++;
+    trace->ring.resize(std::bit_ceil(std::max<std::size_t>(capacity, 1)));
+    trace->state = &t_trace;
+
+    t_trace = TraceThreadState{};
+    t_trace.ring = trace->ring.data();
+    t_trace.mask = trace->ring.size() - 1;
+    t_trace.sampleEvery = sampleEvery;
+    t_trace.countdown = sampleEvery;
+
+    g_registry.push_back(std::move(trace));
+    t_exitGuard.armed = true;
+}
+
+void disableStageTracing() {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if (auto* trace = findLocked(&t_trace))
+        detachLocked(trace);
+}
+
+void clearStageTraces() {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    std::erase_if(g_registry, [](const auto& t) { return t->state == nullptr; });
+    for (auto& t : g_registry) {
+        t->state->head = 0;
+    }
+}
+
+void writeChromeTrace(std::ostream& os) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+
+    struct Range {
+        const ThreadTrace* trace;
+        std::uint64_t first;
+        std::uint64_t last;
+    };
+    std::vector<Range> ranges;
+    std::uint64_t base = ~0ull;
+    for (const auto& t : g_registry) {
+        const std::uint64_t head = t->state ? t->state->head : t->head;
+        const std::uint64_t count = std::min<std::uint64_t>(head, t->ring.size());
+        ranges.push_back(Range{t.get(), head - count, head});
+        for (std::uint64_t i = head - count; i < head; ++i) {
+            base = std::min(base, t->ring[i & (t->ring.size() - 1)].startTsc);
+        }
+    }
+
+    const double ticksPerUs = tscTicksPerNs() * 1000.0;
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& r : ranges) {
+        os << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << r.trace->tid
+           << ",\"args\":{\"name\":\"tracer " << r.trace->tid << "\"}}";
+        first = false;
+        for (std::uint64_t i = r.first; i < r.last; ++i) {
+            const auto& e = r.trace->ring[i & (r.trace->ring.size() - 1)];
+            os << ",\n{\"name\":\"" << toString(e.stage) << "\",\"cat\":\"stage\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+               << r.trace->tid << ",\"ts\":" << static_cast<double>(e.startTsc - base) / ticksPerUs
+               << ",\"dur\":" << static_cast<double>(e.ticks) / ticksPerUs << ",\"args\":{\"msg\":" << e.message
+               << ",\"tsc\":" << e.ticks << "}}";
+        }
+    }
+    os << "\n]}\n";
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+}  // namespace metrics
@@ -0,0 +1,26 @@
+#include "metrics/tsc.hpp"
+
+#include <thread>
+
+namespace metrics {
+
+namespace {
+
+double calibrate() {
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+    const std::uint64_t c0 = readTsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const std::uint64_t c1 = readTsc();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+    return ns > 0 && c1 > c0 ? static_cast<double>(c1 - c0) / static_cast<double>(ns) : 1.0;
+}
+
+}  // namespace
+
+double tscTicksPerNs() {
+    static const double ticksPerNs = calibrate();
+    return ticksPerNs;
+}
+
+}  // namespace metrics
@@ -0,0 +1,110 @@
+#include "parser/chunked_parser.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <string>
+
+ChunkedParser::ChunkedParser(std::istream& in, const ChunkedParserOptions& options)
+    : m_in(in),
+      m_chunkBytes(std::max<std::size_t>(options.chunkBytes, 1)) {
+    const std::size_t threads = std::max<std::size_t>(options.threads, 1);
+    m_window.resize(options.maxChunksAhead != 0 ? options.maxChunksAhead : 2 * threads);
+    m_threads.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_threads.emplace_back([this] { run(); });
+    }
+}
+
+ChunkedParser::~ChunkedParser() {
+    {
+        std::lock_guard lk(m_mutex);
+        m_stopping = true;
+    }
+    m_spaceCv.notify_all();
+    for (auto& t : m_threads) {
+        t.join();
+    }
+}
+
+bool ChunkedParser::next(ParsedChunk& chunk) {
+    std::unique_lock lk(m_mutex);
+    std::optional<ParsedChunk>& slot = m_window[m_nextOut % m_window.size()];
+    m_readyCv.wait(lk, [&] { return slot.has_value() || m_nextOut == m_endIndex; });
+    if (!slot)
+        return false;
+    chunk = std::move(*slot);
+    slot.reset();
+    ++m_nextOut;
+    lk.unlock();
+    m_spaceCv.notify_all();
+    return true;
+}
+
+void ChunkedParser::run() {
+    for (;;) {
+        ParsedChunk chunk;
+        {
+            std::lock_guard input(m_inputMutex);
+            {
+                std::unique_lock lk(m_mutex);
+                m_spaceCv.wait(lk, [&] { return m_stopping || m_nextRead < m_nextOut + m_window.size(); });
+                if (m_stopping)
+                    return;
+            }
+            if (m_inputDone)
+                return;
+            if (!readChunk(chunk.text)) {
+                m_inputDone = true;
+                {
+                    std::lock_guard lk(m_mutex);
+                    m_endIndex = m_nextRead;
+                }
+                m_readyCv.notify_all();
+                return;
+            }
+            chunk.index = m_nextRead++;
+        }
+
+        parseChunk(chunk);
+        {
+            std::lock_guard lk(m_mutex);
+            m_window[chunk.index % m_window.size()] = std::move(chunk);
+        }
+        m_readyCv.notify_all();
+    }
+}
+
+bool ChunkedParser::readChunk(std::vector<char>& text) {
+    text.resize(m_chunkBytes);
+    m_in.read(text.data(), static_cast<std::streamsize>(m_chunkBytes));
+    text.resize(static_cast<std::size_t>(m_in.gcount()));
+    if (text.empty())
+        return false;
+    // finish the line the chunk ends in
+    if (text.back() != '\n' && m_in) {
+        std::string rest;
+        if (std::getline(m_in, rest)) {
+            text.insert(text.end(), rest.begin(), rest.end());
+            text.push_back('\n');
+        }
+    }
+    return true;
+}
+
+void ChunkedParser::parseChunk(ParsedChunk& chunk) {
+    const std::string_view text(chunk.text.data(), chunk.text.size());
+    const std::size_t estimate = text.size() / 32 + 1;
+    chunk.lines.reserve(estimate);
+    chunk.commands.reserve(estimate);
+    for (std::size_t pos = 0; pos < text.size();) {
+        std::size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos)
+            end = text.size();
+        const std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (line.empty())
+            continue;
+        chunk.lines.push_back(line);
+        chunk.commands.push_back(parseCommandLine(line));
+    }
+}
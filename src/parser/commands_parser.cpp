@@ -1,10 +1,18 @@
 #include "parser/commands_parser.hpp"
 
+#include "metrics/trace.hpp"
 #include "parser/fields_parser.hpp"
 #include "parser/tokenize.hpp"
 
+#include <string_view>
+#include <vector>
+
+// views into the line being parsed; symbols are copied into the request's inline buffer
+using Tokens = std::vector<std::string_view>;
+
 // remeber that parsing also includes builing object/data_structure
-static std::optional<domain::Order> parseNew(const std::vector<std::string>& tokens) {
+// tokens[1..7] of N and S
+static std::optional<domain::Order> parseOrderFields(const Tokens& tokens) {
     auto id = parseOrderId(tokens[1]);
     if (!id)
         return std::nullopt;
@@ -32,11 +40,44 @@ static std::optional<domain::Order> parseNew(const std::vector<std::string>& tok
     if (!quantity)
         return std::nullopt;
 
-    domain::Order order(*id, *ts, tickerSymbol, *orderType, *side, *price, *quantity);
+    domain::Order order;
+    order.orderId = *id;
+    order.timeStamp = *ts;
+    order.symbol = tickerSymbol;
+    order.orderType = *orderType;
+    order.side = *side;
+    order.price = *price;
+    order.quantity = *quantity;
     return order;
 }
 
-static std::optional<AmendRequest> parseAmendRequest(const std::vector<std::string>& tokens) {
+static std::optional<domain::Order> parseNew(const Tokens& tokens) {
+    auto order = parseOrderFields(tokens);
+    if (!order)
+        return std::nullopt;
+
+    // optional good-till-time expiry, in the same units as the timestamp
+    if (tokens.size() == 9) {
+        auto expireAt = parseTimestamp(tokens[8]);
+        if (!expireAt)
+            return std::nullopt;
+        order->expireAt = *expireAt;
+    }
+    return order;
+}
+
+// S: the fields of N (no expiry), then the stop price
+static std::optional<StopOrderRequest> parseStopOrderRequest(const Tokens& tokens) {
+    auto order = parseOrderFields(tokens);
+    if (!order)
+        return std::nullopt;
+    auto stopPrice = parsePriceCents(tokens[8]);
+    if (!stopPrice)
+        return std::nullopt;
+    return StopOrderRequest{std::move(*order), *stopPrice};
+}
+
+static std::optional<AmendRequest> parseAmendRequest(const Tokens& tokens) {
     auto id = parseOrderId(tokens[1]);
     if (!id)
         return std::nullopt;
@@ -46,7 +87,7 @@ static std::optional<AmendRequest> parseAmendRequest(const std::vector<std::stri
         return std::nullopt;
 
     // there is no sperwate method to check symbols add later!
-    std::string tickerSymbol = tokens[3];
+    auto tickerSymbol = tokens[3];
 
     auto orderType = parseOrderType(tokens[4]);
     if (!orderType)
@@ -68,7 +109,7 @@ static std::optional<AmendRequest> parseAmendRequest(const std::vector<std::stri
     return amendReq;
 }
 
-static std::optional<CancelRequest> parseCancelRequest(const std::vector<std::string>& tokens) {
+static std::optional<CancelRequest> parseCancelRequest(const Tokens& tokens) {
     auto id = parseOrderId(tokens[1]);
     if (!id)
         return std::nullopt;
@@ -79,7 +120,7 @@ static std::optional<CancelRequest> parseCancelRequest(const std::vector<std::st
     return CancelRequest(*id, *ts);
 }
 
-static std::optional<MatchRequest> parseMatchRequest(const std::vector<std::string>& tokens) {
+static std::optional<MatchRequest> parseMatchRequest(const Tokens& tokens) {
     if (tokens.size() == 2) {
         auto ts = parseTimestamp(tokens[1]);
         if (!ts)
@@ -96,19 +137,118 @@ static std::optional<MatchRequest> parseMatchRequest(const std::vector<std::stri
     return std::nullopt;
 }
 
+// B,<ts>,<symbol> followed by <id>,<type>,<side>,<price>,<qty> per order, at most kMaxBatchOrders
+static std::optional<BatchNewRequest> parseBatchNewRequest(const Tokens& tokens) {
+    constexpr std::size_t kHeader = 3;
+    constexpr std::size_t kPerOrder = 5;
+    if (tokens.size() < kHeader + kPerOrder || (tokens.size() - kHeader) % kPerOrder != 0)
+        return std::nullopt;
+    if ((tokens.size() - kHeader) / kPerOrder > kMaxBatchOrders)
+        return std::nullopt;  // refused before anything is sized from the line
+    auto ts = parseTimestamp(tokens[1]);
+    if (!ts)
+        return std::nullopt;
+
+    BatchNewRequest req;
+    req.timeStamp = *ts;
+    req.symbol = tokens[2];
+    req.orders.reserve((tokens.size() - kHeader) / kPerOrder);
+    for (std::size_t i = kHeader; i < tokens.size(); i += kPerOrder) {
+        auto id = parseOrderId(tokens[i]);
+        auto orderType = parseOrderType(tokens[i + 1]);
+        auto side = parseSide(tokens[i + 2]);
+        auto price = parsePriceCents(tokens[i + 3]);
+        auto quantity = parseQuantity(tokens[i + 4]);
+        if (!id || !orderType || !side || !price || !quantity)
+            return std::nullopt;
+        req.orders.push_back(BatchOrder{*id, *orderType, *side, *price, *quantity});
+    }
+    return req;
+}
+
+// C,<ts> | C,<ts>,<symbol> | C,<ts>,<symbol>,<side>
+static std::optional<MassCancelRequest> parseMassCancelRequest(const Tokens& tokens) {
+    if (tokens.size() < 2 || tokens.size() > 4)
+        return std::nullopt;
+    auto ts = parseTimestamp(tokens[1]);
+    if (!ts)
+        return std::nullopt;
+
+    MassCancelRequest req;
+    req.timeStamp = *ts;
+    if (tokens.size() == 2)
+        return req;  // whole book
+
+    if (tokens[2].empty())
+        return std::nullopt;
+    req.symbol = tokens[2];
+    req.scope = MassCancelScope::Symbol;
+    if (tokens.size() == 4) {
+        auto side = parseSide(tokens[3]);
+        if (!side)
+            return std::nullopt;
+        req.side = *side;
+        req.scope = MassCancelScope::SymbolSide;
+    }
+    return req;
+}
+
+// Q,<ts>,O,<id> | Q,<ts>,T,<symbol> | Q,<ts>,D,<symbol>,<levels>
+static std::optional<QueryRequest> parseQueryRequest(const Tokens& tokens) {
+    if (tokens.size() < 4)
+        return std::nullopt;
+    auto ts = parseTimestamp(tokens[1]);
+    if (!ts)
+        return std::nullopt;
+
+    QueryRequest q;
+    q.timeStamp = *ts;
+    if (tokens[2] == "O" && tokens.size() == 4) {
+        auto id = parseOrderId(tokens[3]);
+        if (!id)
+            return std::nullopt;
+        q.kind = QueryKind::Order;
+        q.orderId = *id;
+        return q;
+    }
+    if (tokens[2] == "T" && tokens.size() == 4) {
+        q.kind = QueryKind::Top;
+        q.symbol = tokens[3];
+        return q;
+    }
+    if (tokens[2] == "D" && tokens.size() == 5) {
+        auto levels = parseQuantity(tokens[4]);
+        if (!levels)
+            return std::nullopt;
+        q.kind = QueryKind::Depth;
+        q.symbol = tokens[3];
+        q.levels = *levels;
+        return q;
+    }
+    return std::nullopt;
+}
+
 std::optional<ParsedCommand> parseCommandLine(std::string_view line) {
     std::optional<ParsedCommand> parsedObj;
-    std::vector<std::string> tokens = tokenize(line);
+    // reused across lines: once it has grown to the longest line, tokenizing allocates nothing
+    thread_local Tokens tokens;
+    {
+        HFT_TRACE_STAGE(Tokenize);
+        tokenizeInto(line, tokens);
+    }
     if (tokens.empty() || tokens[0].empty())
         return std::nullopt;
 
+    HFT_TRACE_STAGE(Parse);
+
     char commandSymbol = tokens[0][0];
-    if (commandSymbol != 'N' && commandSymbol != 'A' && commandSymbol != 'X' && commandSymbol != 'M') {
+    if (commandSymbol != 'N' && commandSymbol != 'A' && commandSymbol != 'X' && commandSymbol != 'M' &&
+        commandSymbol != 'Q' && commandSymbol != 'C' && commandSymbol != 'B' && commandSymbol != 'S') {
         return std::nullopt;
     }
     switch (commandSymbol) {
     case 'N': {
-        if (tokens.size() != 8)
+        if (tokens.size() != 8 && tokens.size() != 9)
             return std::nullopt;
         parsedObj = parseNew(tokens);
         return parsedObj;
@@ -131,7 +271,42 @@ std::optional<ParsedCommand> parseCommandLine(std::string_view line) {
         parsedObj = parseMatchRequest(tokens);
         return parsedObj;
     }
+    case 'Q': {
+        parsedObj = parseQueryRequest(tokens);
+        return parsedObj;
+    }
+    case 'C': {
+        parsedObj = parseMassCancelRequest(tokens);
+        return parsedObj;
+    }
+    case 'B': {
+        parsedObj = parseBatchNewRequest(tokens);
+        return parsedObj;
+    }
+    case 'S': {
+        if (tokens.size() != 9)
+            return std::nullopt;
+        parsedObj = parseStopOrderRequest(tokens);
+        return parsedObj;
+    }
     default:
         return std::nullopt;  // logically unreachable, but keeps compiler/IDE happy
     }
 }
+
+domain::Timestamp timestampOf(const ParsedCommand& cmd) {
+    if (const auto* order = std::get_if<domain::Order>(&cmd))
+        return order->timeStamp;
+    if (const auto* match = std::get_if<MatchRequest>(&cmd))
+        return match->timestamp;
+    if (const auto* stop = std::get_if<StopOrderRequest>(&cmd))
+        return stop->order.timeStamp;
+    return std::visit(
+        [](const auto& req) -> domain::Timestamp {
+            if constexpr (requires { req.timeStamp; })
+                return req.timeStamp;
+            else
+                return 0;
+        },
+        cmd);
+}
@@ -1,5 +1,6 @@
 #include "parser/fields_parser.hpp"
 #include <charconv>
+#include <climits>  // INT_MAX
 #include <optional>
 #include <system_error>
 
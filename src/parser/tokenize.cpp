@@ -16,24 +16,25 @@ static std::string_view trimView(std::string_view s) {
     return s.substr(start, end - start);
 }
 
-std::vector<std::string> tokenize(std::string_view line) {
+void tokenizeInto(std::string_view line, std::vector<std::string_view>& out) {
     // Strip trailing newline(s)
     while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
         line.remove_suffix(1);
     }
 
-    std::vector<std::string> out;
+    out.clear();
     std::size_t start = 0;
 
     for (std::size_t i = 0; i <= line.size(); ++i) {
         if (i == line.size() || line[i] == ',') {
-            std::string_view tokenView = line.substr(start, i - start);
-            tokenView = trimView(tokenView);
-
-            out.emplace_back(tokenView);
+            out.push_back(trimView(line.substr(start, i - start)));
             start = i + 1;  // skip comma
         }
     }
+}
 
-    return out;
-}
\ No newline at end of file
+std::vector<std::string> tokenize(std::string_view line) {
+    std::vector<std::string_view> views;
+    tokenizeInto(line, views);
+    return std::vector<std::string>(views.begin(), views.end());
+}
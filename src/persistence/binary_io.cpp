@@ -0,0 +1,54 @@
+#include "persistence/binary_io.hpp"
+
+#include <array>
+
+namespace persistence {
+
+namespace {
+
+// Slicing-by-8 tables: kCrcTables[0] is the classic byte table, kCrcTables[k]
+// advances a byte through k more zero bytes. Eight bytes per step instead of one.
+using CrcTables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+constexpr CrcTables makeCrcTables() {
+    CrcTables t{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        }
+        t[0][i] = c;
+    }
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        for (std::size_t k = 1; k < 8; ++k) {
+            t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+        }
+    }
+    return t;
+}
+
+constexpr CrcTables kCrcTables = makeCrcTables();
+
+}  // namespace
+
+std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t seed) {
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    std::uint32_t c = ~seed;
+
+    while (size >= 8) {
+        const std::uint32_t lo = loadFixed<std::uint32_t>(reinterpret_cast<const char*>(p)) ^ c;
+        const std::uint32_t hi = loadFixed<std::uint32_t>(reinterpret_cast<const char*>(p) + 4);
+        c = kCrcTables[7][lo & 0xFF] ^ kCrcTables[6][(lo >> 8) & 0xFF] ^
+            kCrcTables[5][(lo >> 16) & 0xFF] ^ kCrcTables[4][lo >> 24] ^
+            kCrcTables[3][hi & 0xFF] ^ kCrcTables[2][(hi >> 8) & 0xFF] ^
+            kCrcTables[1][(hi >> 16) & 0xFF] ^ kCrcTables[0][hi >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        c = kCrcTables[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+    }
+    return ~c;
+}
+
+}  // namespace persistence
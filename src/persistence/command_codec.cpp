@@ -0,0 +1,264 @@
+#include "persistence/command_codec.hpp"
+
+#include "persistence/binary_io.hpp"
+
+namespace persistence {
+
+namespace {
+
+// Optional fields of A are packed into one flags byte.
+constexpr std::uint8_t kHasPrice = 0x01;
+constexpr std::uint8_t kHasQuantity = 0x02;
+constexpr std::uint8_t kHasSymbol = 0x01;  // M
+
+void putKind(std::vector<char>& out, CommandKind kind) {
+    out.push_back(static_cast<char>(kind));
+}
+
+bool getOrderType(ByteReader& in, domain::OrderType& t) {
+    std::uint8_t v = 0;
+    if (!in.getU8(v) || v > static_cast<std::uint8_t>(domain::OrderType::IOC))
+        return false;
+    t = static_cast<domain::OrderType>(v);
+    return true;
+}
+
+bool getSide(ByteReader& in, domain::Side& s) {
+    std::uint8_t v = 0;
+    if (!in.getU8(v) || v > static_cast<std::uint8_t>(domain::Side::Sell))
+        return false;
+    s = static_cast<domain::Side>(v);
+    return true;
+}
+
+bool getOrderId(ByteReader& in, domain::OrderId& id) {
+    std::int64_t v = 0;
+    if (!in.getVarI64(v))
+        return false;
+    id = static_cast<domain::OrderId>(v);
+    return true;
+}
+
+bool getQuantity(ByteReader& in, int& qty) {
+    std::int64_t v = 0;
+    if (!in.getVarI64(v))
+        return false;
+    qty = static_cast<int>(v);
+    return true;
+}
+
+}  // namespace
+
+void encodeCommand(const ParsedCommand& cmd, std::vector<char>& out) {
+    if (const auto* o = std::get_if<domain::Order>(&cmd)) {
+        putKind(out, CommandKind::New);
+        putVarI64(out, o->orderId);
+        putVarI64(out, o->timeStamp);
+        putBytes(out, o->symbol.view());
+        out.push_back(static_cast<char>(o->orderType));
+        out.push_back(static_cast<char>(o->side));
+        putVarI64(out, o->price);
+        putVarI64(out, o->quantity);
+        // trailing and only when set, so journals written before GTT still decode
+        if (o->expireAt != 0)
+            putVarI64(out, o->expireAt);
+        return;
+    }
+
+    if (const auto* a = std::get_if<AmendRequest>(&cmd)) {
+        putKind(out, CommandKind::Amend);
+        putVarI64(out, a->orderId);
+        putVarI64(out, a->timeStamp);
+        putBytes(out, a->symbol.view());
+        out.push_back(static_cast<char>(a->orderType));
+        out.push_back(static_cast<char>(a->side));
+        std::uint8_t flags = 0;
+        if (a->newPrice)
+            flags |= kHasPrice;
+        if (a->newQuantity)
+            flags |= kHasQuantity;
+        out.push_back(static_cast<char>(flags));
+        if (a->newPrice)
+            putVarI64(out, *a->newPrice);
+        if (a->newQuantity)
+            putVarI64(out, *a->newQuantity);
+        return;
+    }
+
+    if (const auto* c = std::get_if<CancelRequest>(&cmd)) {
+        putKind(out, CommandKind::Cancel);
+        putVarI64(out, c->orderId);
+        putVarI64(out, c->timeStamp);
+        return;
+    }
+
+    if (const auto* m = std::get_if<MatchRequest>(&cmd)) {
+        putKind(out, CommandKind::Match);
+        putVarI64(out, m->timestamp);
+        out.push_back(static_cast<char>(m->symbol ? kHasSymbol : 0));
+        if (m->symbol)
+            putBytes(out, m->symbol->view());
+        return;
+    }
+
+    if (const auto* b = std::get_if<BatchNewRequest>(&cmd)) {
+        putKind(out, CommandKind::BatchNew);
+        putVarI64(out, b->timeStamp);
+        putBytes(out, b->symbol.view());
+        putVarI64(out, static_cast<std::int64_t>(b->orders.size()));
+        for (const auto& o : b->orders) {
+            putVarI64(out, o.orderId);
+            out.push_back(static_cast<char>(o.orderType));
+            out.push_back(static_cast<char>(o.side));
+            putVarI64(out, o.price);
+            putVarI64(out, o.quantity);
+        }
+        return;
+    }
+
+    if (const auto* s = std::get_if<StopOrderRequest>(&cmd)) {
+        putKind(out, CommandKind::Stop);
+        putVarI64(out, s->order.orderId);
+        putVarI64(out, s->order.timeStamp);
+        putBytes(out, s->order.symbol.view());
+        out.push_back(static_cast<char>(s->order.orderType));
+        out.push_back(static_cast<char>(s->order.side));
+        putVarI64(out, s->order.price);
+        putVarI64(out, s->order.quantity);
+        putVarI64(out, s->stopPrice);
+        return;
+    }
+
+    if (const auto* mc = std::get_if<MassCancelRequest>(&cmd)) {
+        putKind(out, CommandKind::MassCancel);
+        putVarI64(out, mc->timeStamp);
+        out.push_back(static_cast<char>(mc->scope));
+        putBytes(out, mc->symbol.view());
+        out.push_back(static_cast<char>(mc->side));
+        return;
+    }
+
+    const auto& q = std::get<QueryRequest>(cmd);
+    putKind(out, CommandKind::Query);
+    putVarI64(out, q.timeStamp);
+    out.push_back(static_cast<char>(q.kind));
+    putVarI64(out, q.orderId);
+    putBytes(out, q.symbol.view());
+    putVarI64(out, q.levels);
+}
+
+std::optional<ParsedCommand> decodeCommand(const char* data, std::size_t size) {
+    ByteReader in(data, size);
+    std::uint8_t kind = 0;
+    if (!in.getU8(kind))
+        return std::nullopt;
+
+    switch (static_cast<CommandKind>(kind)) {
+    case CommandKind::New: {
+        domain::Order o;
+        std::string_view sym;
+        if (!getOrderId(in, o.orderId) || !in.getVarI64(o.timeStamp) || !in.getBytes(sym) ||
+            !getOrderType(in, o.orderType) || !getSide(in, o.side) || !in.getVarI64(o.price) ||
+            !getQuantity(in, o.quantity))
+            return std::nullopt;
+        if (in.remaining() != 0 && !in.getVarI64(o.expireAt))
+            return std::nullopt;
+        o.symbol = sym;
+        return ParsedCommand{std::move(o)};
+    }
+    case CommandKind::Amend: {
+        AmendRequest a;
+        std::string_view sym;
+        std::uint8_t flags = 0;
+        if (!getOrderId(in, a.orderId) || !in.getVarI64(a.timeStamp) || !in.getBytes(sym) ||
+            !getOrderType(in, a.orderType) || !getSide(in, a.side) || !in.getU8(flags))
+            return std::nullopt;
+        a.symbol = sym;
+        if (flags & kHasPrice) {
+            domain::Price p = 0;
+            if (!in.getVarI64(p))
+                return std::nullopt;
+            a.newPrice = p;
+        }
+        if (flags & kHasQuantity) {
+            int q = 0;
+            if (!getQuantity(in, q))
+                return std::nullopt;
+            a.newQuantity = q;
+        }
+        return ParsedCommand{std::move(a)};
+    }
+    case CommandKind::Cancel: {
+        CancelRequest c;
+        if (!getOrderId(in, c.orderId) || !in.getVarI64(c.timeStamp))
+            return std::nullopt;
+        return ParsedCommand{c};
+    }
+    case CommandKind::Match: {
+        MatchRequest m;
+        std::uint8_t flags = 0;
+        if (!in.getVarI64(m.timestamp) || !in.getU8(flags))
+            return std::nullopt;
+        if (flags & kHasSymbol) {
+            std::string_view sym;
+            if (!in.getBytes(sym))
+                return std::nullopt;
+            m.symbol = domain::Symbol(sym);
+        }
+        return ParsedCommand{std::move(m)};
+    }
+    case CommandKind::Query: {
+        QueryRequest q;
+        std::uint8_t kind = 0;
+        std::string_view sym;
+        if (!in.getVarI64(q.timeStamp) || !in.getU8(kind) || kind > static_cast<std::uint8_t>(QueryKind::Depth) ||
+            !getOrderId(in, q.orderId) || !in.getBytes(sym) || !getQuantity(in, q.levels))
+            return std::nullopt;
+        q.kind = static_cast<QueryKind>(kind);
+        q.symbol = sym;
+        return ParsedCommand{std::move(q)};
+    }
+    case CommandKind::MassCancel: {
+        MassCancelRequest mc;
+        std::uint8_t scope = 0;
+        std::string_view sym;
+        if (!in.getVarI64(mc.timeStamp) || !in.getU8(scope) ||
+            scope > static_cast<std::uint8_t>(MassCancelScope::SymbolSide) || !in.getBytes(sym) ||
+            !getSide(in, mc.side))
+            return std::nullopt;
+        mc.scope = static_cast<MassCancelScope>(scope);
+        mc.symbol = sym;
+        return ParsedCommand{std::move(mc)};
+    }
+    case CommandKind::BatchNew: {
+        BatchNewRequest b;
+        std::string_view sym;
+        std::int64_t count = 0;
+        if (!in.getVarI64(b.timeStamp) || !in.getBytes(sym) || !in.getVarI64(count) || count < 1 ||
+            count > static_cast<std::int64_t>(kMaxBatchOrders))
+            return std::nullopt;
+        b.symbol = sym;
+        b.orders.resize(static_cast<std::size_t>(count));
+        for (auto& o : b.orders) {
+            if (!getOrderId(in, o.orderId) || !getOrderType(in, o.orderType) || !getSide(in, o.side) ||
+                !in.getVarI64(o.price) || !getQuantity(in, o.quantity))
+                return std::nullopt;
+        }
+        return ParsedCommand{std::move(b)};
+    }
+    case CommandKind::Stop: {
+        StopOrderRequest s;
+        domain::Order& o = s.order;
+        std::string_view sym;
+        if (!getOrderId(in, o.orderId) || !in.getVarI64(o.timeStamp) || !in.getBytes(sym) ||
+            !getOrderType(in, o.orderType) || !getSide(in, o.side) || !in.getVarI64(o.price) ||
+            !getQuantity(in, o.quantity) || !in.getVarI64(s.stopPrice))
+            return std::nullopt;
+        o.symbol = sym;
+        return ParsedCommand{std::move(s)};
+    }
+    }
+    return std::nullopt;
+}
+
+}  // namespace persistence
@@ -0,0 +1,357 @@
+#include "persistence/journal.hpp"
+
+#include "persistence/binary_io.hpp"
+#include "persistence/command_codec.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+namespace persistence {
+
+namespace {
+
+constexpr std::size_t kRecordHeaderSize = 4 + 4 + 8;  // bodySize | crc | seq
+constexpr const char* kSegmentPrefix = "journal-";
+constexpr const char* kSegmentSuffix = ".log";
+
+std::string segmentName(std::uint64_t firstSeq) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%s%020llu%s", kSegmentPrefix,
+                  static_cast<unsigned long long>(firstSeq), kSegmentSuffix);
+    return buf;
+}
+
+// A journal we cannot write is not a journal: fail-stop rather than keep
+// accepting orders that would be lost on restart.
+[[noreturn]] void fatalIo(const char* what) {
+    std::perror(what);
+    std::abort();
+}
+
+void writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const auto n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            fatalIo("journal write");
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+}
+
+void syncFd(int fd) {
+#if defined(__linux__)
+    const int rc = ::fdatasync(fd);
+#else
+    const int rc = ::fsync(fd);
+#endif
+    if (rc != 0)
+        fatalIo("journal fsync");
+}
+
+struct SegmentFile {
+    std::uint64_t firstSeq{};
+    std::filesystem::path path{};
+};
+
+std::vector<SegmentFile> listSegments(const std::string& directory) {
+    std::vector<SegmentFile> out;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        const auto name = entry.path().filename().string();
+        const std::string_view prefix(kSegmentPrefix);
+        const std::string_view suffix(kSegmentSuffix);
+        if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+            continue;
+        const auto digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+        out.push_back(SegmentFile{std::stoull(digits), entry.path()});
+    }
+    std::sort(out.begin(), out.end(), [](const SegmentFile& a, const SegmentFile& b) {
+        return a.firstSeq < b.firstSeq;
+    });
+    return out;
+}
+
+bool readFile(const std::filesystem::path& path, std::vector<char>& out) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    const auto size = static_cast<std::size_t>(in.tellg());
+    out.resize(size);
+    in.seekg(0);
+    return static_cast<bool>(in.read(out.data(), static_cast<std::streamsize>(size)));
+}
+
+}  // namespace
+
+// ------------------------- JournalWriter -------------------------
+
+JournalWriter::JournalWriter(JournalOptions options, std::uint64_t nextSeq)
+    : m_options(std::move(options)),
+      m_nextSeq(nextSeq),
+      m_durableSeq(nextSeq - 1) {
+    std::filesystem::create_directories(m_options.directory);
+    m_active.reserve(1u << 20);
+    m_thread = std::thread([this] { run(); });
+}
+
+JournalWriter::~JournalWriter() {
+    {
+        std::lock_guard lk(m_mutex);
+        m_stopping = true;
+    }
+    m_workCv.notify_one();
+    m_thread.join();
+}
+
+std::uint64_t JournalWriter::append(const ParsedCommand& cmd) {
+    std::unique_lock lk(m_mutex);
+    const bool wasEmpty = m_active.empty();
+    const std::uint64_t seq = m_nextSeq++;
+    if (wasEmpty)
+        m_activeFirstSeq = seq;
+
+    // header is patched once the body size is known
+    const auto start = m_active.size();
+    m_active.resize(start + kRecordHeaderSize);
+    encodeCommand(cmd, m_active);
+
+    char* rec = m_active.data() + start;
+    const auto bodySize = static_cast<std::uint32_t>(m_active.size() - start - kRecordHeaderSize);
+    std::memcpy(rec + 8, &seq, sizeof(seq));
+    const auto crc = crc32(rec + 8, 8 + bodySize);
+    std::memcpy(rec, &bodySize, sizeof(bodySize));
+    std::memcpy(rec + 4, &crc, sizeof(crc));
+
+    ++m_stats.records;
+    m_stats.bytes += kRecordHeaderSize + bodySize;
+    lk.unlock();
+
+    if (wasEmpty)
+        m_workCv.notify_one();
+    return seq;
+}
+
+void JournalWriter::waitDurable(std::uint64_t seq) {
+    std::unique_lock lk(m_mutex);
+    if (m_durableSeq >= seq)
+        return;
+    ++m_waiters;
+    m_workCv.notify_one();
+    m_durableCv.wait(lk, [&] { return m_durableSeq >= seq; });
+    --m_waiters;
+}
+
+void JournalWriter::flush() {
+    waitDurable(lastSeq());
+}
+
+std::uint64_t JournalWriter::lastSeq() const {
+    std::lock_guard lk(m_mutex);
+    return m_nextSeq - 1;
+}
+
+std::uint64_t JournalWriter::durableSeq() const {
+    std::lock_guard lk(m_mutex);
+    return m_durableSeq;
+}
+
+JournalStats JournalWriter::stats() const {
+    std::lock_guard lk(m_mutex);
+    return m_stats;
+}
+
+void JournalWriter::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::microseconds(m_options.fsyncIntervalMicros);
+
+    std::vector<char> batch;
+    batch.reserve(1u << 20);
+    std::uint64_t writtenSeq = 0;
+    std::size_t unsynced = 0;  // records written but not yet fsynced
+    Clock::time_point syncDeadline{};
+
+    for (;;) {
+        std::uint64_t firstSeq = 0;
+        std::uint64_t lastSeq = 0;
+        bool stopping = false;
+        bool waiters = false;
+        {
+            std::unique_lock lk(m_mutex);
+            auto ready = [&] {
+                return m_stopping || !m_active.empty() || (unsynced > 0 && m_waiters > 0);
+            };
+            if (unsynced == 0) {
+                m_workCv.wait(lk, ready);
+            } else {
+                m_workCv.wait_until(lk, syncDeadline, ready);
+            }
+            batch.clear();
+            batch.swap(m_active);  // double buffering: producers keep appending meanwhile
+            firstSeq = m_activeFirstSeq;
+            lastSeq = m_nextSeq - 1;
+            stopping = m_stopping;
+            waiters = m_waiters > 0;
+        }
+
+        if (!batch.empty()) {
+            writeBatch(batch, firstSeq);
+            if (unsynced == 0)
+                syncDeadline = Clock::now() + interval;
+            unsynced += static_cast<std::size_t>(lastSeq - firstSeq + 1);
+            writtenSeq = lastSeq;
+        }
+
+        const bool syncDue = unsynced > 0 &&
+                             (!m_options.fsyncEnabled || unsynced >= m_options.fsyncBatchRecords ||
+                              waiters || stopping || Clock::now() >= syncDeadline);
+        if (syncDue) {
+            syncSegment();
+            unsynced = 0;
+            {
+                std::lock_guard lk(m_mutex);
+                m_durableSeq = writtenSeq;
+                if (m_options.fsyncEnabled)
+                    ++m_stats.fsyncs;
+            }
+            m_durableCv.notify_all();
+        }
+
+        if (stopping) {
+            std::lock_guard lk(m_mutex);
+            if (m_active.empty())
+                break;
+        }
+    }
+    closeSegment();
+}
+
+void JournalWriter::writeBatch(const std::vector<char>& batch, std::uint64_t firstSeq) {
+    if (m_fd < 0 || m_segmentSize >= m_options.segmentBytes) {
+        closeSegment();
+        openSegment(firstSeq);
+    }
+    writeAll(m_fd, batch.data(), batch.size());
+    m_segmentSize += batch.size();
+
+    std::lock_guard lk(m_mutex);
+    ++m_stats.writes;
+}
+
+void JournalWriter::openSegment(std::uint64_t firstSeq) {
+    const auto path = std::filesystem::path(m_options.directory) / segmentName(firstSeq);
+    // O_TRUNC: a segment with this name can only hold a torn tail from a previous run
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (m_fd < 0)
+        fatalIo("journal open");
+    m_segmentSize = 0;
+
+    if (m_options.fsyncEnabled) {
+        // make the new directory entry itself durable
+        const int dirFd = ::open(m_options.directory.c_str(), O_RDONLY);
+        if (dirFd >= 0) {
+            ::fsync(dirFd);
+            ::close(dirFd);
+        }
+    }
+
+    std::lock_guard lk(m_mutex);
+    ++m_stats.segments;
+}
+
+void JournalWriter::closeSegment() {
+    if (m_fd < 0)
+        return;
+    syncSegment();
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+void JournalWriter::syncSegment() {
+    if (m_fd >= 0 && m_options.fsyncEnabled)
+        syncFd(m_fd);
+}
+
+// ------------------------- replay -------------------------
+
+ReplayResult replayJournal(const std::string& directory,
+                           std::uint64_t afterSeq,
+                           const std::function<void(std::uint64_t, const ParsedCommand&)>& fn) {
+    ReplayResult result;
+    result.lastSeq = afterSeq;
+
+    const auto segments = listSegments(directory);
+    std::vector<char> data;
+    bool prevKnown = false;
+    std::uint64_t prev = 0;
+
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        // every record of this segment is older than the next segment's first seq
+        if (i + 1 < segments.size() && segments[i + 1].firstSeq - 1 <= afterSeq)
+            continue;
+        if (!readFile(segments[i].path, data))
+            break;
+
+        const char* p = data.data();
+        std::size_t left = data.size();
+        while (left > 0) {
+            if (left < kRecordHeaderSize) {
+                ++result.tornTails;
+                break;
+            }
+            const auto bodySize = loadFixed<std::uint32_t>(p);
+            const auto crc = loadFixed<std::uint32_t>(p + 4);
+            const auto seq = loadFixed<std::uint64_t>(p + 8);
+            if (left - kRecordHeaderSize < bodySize || crc32(p + 8, 8 + bodySize) != crc) {
+                ++result.tornTails;
+                break;
+            }
+            const auto cmd = decodeCommand(p + kRecordHeaderSize, bodySize);
+            if (!cmd) {
+                ++result.tornTails;
+                break;
+            }
+
+            // a gap means records are missing: everything after it is unusable
+            if ((prevKnown && seq != prev + 1) || (!prevKnown && seq > afterSeq + 1))
+                return result;
+            prevKnown = true;
+            prev = seq;
+
+            if (seq > afterSeq) {
+                fn(seq, *cmd);
+                result.lastSeq = seq;
+                ++result.replayed;
+            }
+            p += kRecordHeaderSize + bodySize;
+            left -= kRecordHeaderSize + bodySize;
+        }
+    }
+    return result;
+}
+
+std::size_t pruneJournal(const std::string& directory, std::uint64_t uptoSeq) {
+    const auto segments = listSegments(directory);
+    std::size_t removed = 0;
+    for (std::size_t i = 0; i + 1 < segments.size(); ++i) {
+        if (segments[i + 1].firstSeq - 1 > uptoSeq)
+            break;
+        std::error_code ec;
+        if (std::filesystem::remove(segments[i].path, ec))
+            ++removed;
+    }
+    return removed;
+}
+
+}  // namespace persistence
@@ -0,0 +1,37 @@
+#include "persistence/recovery.hpp"
+
+#include "engine/dispatcher.hpp"
+#include "persistence/snapshot.hpp"
+
+namespace persistence {
+
+namespace {
+
+ReplayResult replayInto(OrderBook& book, const std::string& journalDir, std::uint64_t afterSeq) {
+    CommandDispatcher dispatcher(book);
+    return replayJournal(journalDir, afterSeq, [&](std::uint64_t, const ParsedCommand& cmd) {
+        dispatcher.apply(cmd);
+    });
+}
+
+}  // namespace
+
+ReplayResult recoverFromJournal(OrderBook& book, const std::string& journalDir) {
+    return replayInto(book, journalDir, 0);
+}
+
+RecoveryResult recoverBook(OrderBook& book, const std::string& snapshotDir, const std::string& journalDir) {
+    RecoveryResult res;
+    if (!snapshotDir.empty())
+        res.snapshotSeq = loadLatestSnapshot(book, snapshotDir);
+
+    const std::uint64_t afterSeq = res.snapshotSeq.value_or(0);
+    if (journalDir.empty()) {
+        res.journal.lastSeq = afterSeq;
+        return res;
+    }
+    res.journal = replayInto(book, journalDir, afterSeq);
+    return res;
+}
+
+}  // namespace persistence
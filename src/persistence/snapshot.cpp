@@ -0,0 +1,106 @@
+#include "persistence/snapshot.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace persistence {
+
+namespace {
+
+constexpr const char* kSnapshotPrefix = "snapshot-";
+constexpr const char* kSnapshotSuffix = ".bin";
+
+std::string snapshotName(std::uint64_t seq) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%s%020llu%s", kSnapshotPrefix, static_cast<unsigned long long>(seq),
+                  kSnapshotSuffix);
+    return buf;
+}
+
+struct SnapshotFile {
+    std::uint64_t seq{};
+    std::filesystem::path path{};
+};
+
+// newest first
+std::vector<SnapshotFile> listSnapshots(const std::string& directory) {
+    std::vector<SnapshotFile> out;
+    std::error_code ec;
+    const std::string_view prefix(kSnapshotPrefix);
+    const std::string_view suffix(kSnapshotSuffix);
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        const auto name = entry.path().filename().string();
+        if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+            continue;
+        const auto digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+        out.push_back(SnapshotFile{std::stoull(digits), entry.path()});
+    }
+    std::sort(out.begin(), out.end(), [](const SnapshotFile& a, const SnapshotFile& b) {
+        return a.seq > b.seq;
+    });
+    return out;
+}
+
+bool fsyncPath(const std::filesystem::path& path, int flags) {
+    const int fd = ::open(path.c_str(), flags);
+    if (fd < 0)
+        return false;
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+}  // namespace
+
+bool saveSnapshot(const OrderBook& book, const std::string& directory, std::uint64_t seq) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    const auto finalPath = std::filesystem::path(directory) / snapshotName(seq);
+    auto tmpPath = finalPath;
+    tmpPath += ".tmp";
+
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out || !book.writeSnapshot(out, seq))
+            return false;
+    }
+    if (!fsyncPath(tmpPath, O_RDONLY))
+        return false;
+    std::filesystem::rename(tmpPath, finalPath, ec);
+    if (ec)
+        return false;
+    return fsyncPath(directory, O_RDONLY);
+}
+
+std::optional<std::uint64_t> loadLatestSnapshot(OrderBook& book, const std::string& directory) {
+    for (const auto& snap : listSnapshots(directory)) {
+        std::ifstream in(snap.path, std::ios::binary);
+        if (!in)
+            continue;
+        if (auto seq = book.loadSnapshot(in))
+            return seq;
+    }
+    book.clear();
+    return std::nullopt;
+}
+
+std::size_t pruneSnapshots(const std::string& directory, std::size_t keep) {
+    const auto snaps = listSnapshots(directory);
+    std::size_t removed = 0;
+    for (std::size_t i = keep; i < snaps.size(); ++i) {
+        std::error_code ec;
+        if (std::filesystem::remove(snaps[i].path, ec))
+            ++removed;
+    }
+    return removed;
+}
+
+}  // namespace persistence
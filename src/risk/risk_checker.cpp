@@ -0,0 +1,123 @@
+#include "risk/risk_checker.hpp"
+
+#include "parser/fields_parser.hpp"
+#include "parser/tokenize.hpp"
+
+#include <fstream>
+#include <istream>
+
+namespace risk {
+
+namespace {
+
+std::optional<std::int64_t> parseLimit(const std::string& s) {
+    const auto v = parseInt64Strict(s);
+    if (!v || *v < 0)
+        return std::nullopt;
+    return v;
+}
+
+std::optional<SymbolLimits> parseLimits(const std::vector<std::string>& tokens) {
+    SymbolLimits l;
+    const auto reference = parsePriceCents(tokens[1]);
+    const auto band = parseLimit(tokens[2]);
+    const auto maxQty = parseLimit(tokens[3]);
+    const auto maxNotional = parsePriceCents(tokens[4]);
+    const auto maxOpen = parseLimit(tokens[5]);
+    if (!reference || !band || !maxQty || !maxNotional || !maxOpen)
+        return std::nullopt;
+    l.referencePrice = *reference;
+    l.bandBps = *band;
+    l.maxOrderQuantity = *maxQty;
+    l.maxNotional = *maxNotional;
+    l.maxOpenQuantity = *maxOpen;
+    return l;
+}
+
+}  // namespace
+
+const SymbolLimits& RiskConfig::limitsFor(const domain::Symbol& symbol) const {
+    const auto it = symbols.find(symbol);
+    return it != symbols.end() ? it->second : defaults;
+}
+
+std::optional<RiskConfig> parseRiskConfig(std::istream& is, std::string& error) {
+    RiskConfig config;
+    std::string line;
+    for (std::size_t lineNo = 1; std::getline(is, line); ++lineNo) {
+        const auto tokens = tokenize(line);
+        if (tokens.empty() || tokens[0].empty() || tokens[0][0] == '#')
+            continue;
+        const auto limits = tokens.size() == 6 ? parseLimits(tokens) : std::nullopt;
+        if (!limits) {
+            error = "line " + std::to_string(lineNo) + ": " + line;
+            return std::nullopt;
+        }
+        if (tokens[0] == "*")
+            config.defaults = *limits;
+        else
+            config.symbols[tokens[0]] = *limits;
+    }
+    return config;
+}
+
+std::optional<RiskConfig> loadRiskConfig(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return std::nullopt;
+    }
+    return parseRiskConfig(file, error);
+}
+
+const char* rejectMessage(RiskReject reason) {
+    switch (reason) {
+    case RiskReject::None:
+        return "";
+    case RiskReject::PriceBand:
+        return "Price outside band";
+    case RiskReject::OrderQuantity:
+        return "Quantity above limit";
+    case RiskReject::Notional:
+        return "Notional above limit";
+    case RiskReject::OpenQuantity:
+        return "Open quantity above limit";
+    }
+    return "";
+}
+
+RiskChecker::RiskChecker(RiskConfig config)
+    : m_config(std::move(config)) {}
+
+std::uint32_t RiskChecker::idOf(const domain::Symbol& symbol) {
+    const auto [it, inserted] = m_ids.try_emplace(symbol, static_cast<std::uint32_t>(m_names.size()));
+    if (inserted) {
+        m_names.push_back(symbol);
+        m_limits.push_back(m_config.limitsFor(symbol));
+        m_open.push_back(0);
+        m_lastTrade.push_back(0);
+    }
+    return it->second;
+}
+
+void RiskChecker::reload(RiskConfig config) {
+    std::vector<SymbolLimits> limits;
+    limits.reserve(m_names.size());
+    for (const auto& name : m_names) {
+        limits.push_back(config.limitsFor(name));
+    }
+    m_limits.swap(limits);
+    m_config = std::move(config);
+}
+
+std::int64_t RiskChecker::openQuantity(const domain::Symbol& symbol) const {
+    const auto it = m_ids.find(symbol);
+    return it != m_ids.end() ? m_open[it->second] : 0;
+}
+
+const SymbolLimits* RiskChecker::limits(const domain::Symbol& symbol) const {
+    const auto it = m_ids.find(symbol);
+    return it != m_ids.end() ? &m_limits[it->second] : nullptr;
+}
+
+}  // namespace risk
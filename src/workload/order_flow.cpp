@@ -0,0 +1,257 @@
+#include "workload/order_flow.hpp"
+
+#include "domain/order.hpp"  // toChar
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace workload {
+
+namespace {
+
+constexpr std::size_t kChunkBytes = 1u << 20;
+
+void appendInt(std::string& out, std::int64_t v) {
+    char buf[24];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+// cents -> "104.53"
+void appendPrice(std::string& out, domain::Price cents) {
+    appendInt(out, cents / 100);
+    const auto frac = static_cast<char>(cents % 100);
+    out += '.';
+    out += static_cast<char>('0' + frac / 10);
+    out += static_cast<char>('0' + frac % 10);
+}
+
+}  // namespace
+
+std::string symbolName(std::uint32_t index) {
+    std::string name;
+    do {
+        name += static_cast<char>('A' + index % 26);
+        index /= 26;
+    } while (index > 0);
+    if (name.size() < 3)
+        name.append(3 - name.size(), 'A');
+    std::reverse(name.begin(), name.end());
+    return name;
+}
+
+OrderFlowGenerator::OrderFlowGenerator(const OrderFlowConfig& config)
+    : m_config(config),
+      m_rng(config.seed) {
+    const auto& names = m_config.symbolNames;
+    const std::uint32_t n = names.empty() ? std::max<std::uint32_t>(m_config.symbols, 1) : static_cast<std::uint32_t>(names.size());
+    if (m_config.minQty < 1)
+        m_config.minQty = 1;
+    if (m_config.maxQty < m_config.minQty)
+        m_config.maxQty = m_config.minQty;
+    if (m_config.tick < 1)
+        m_config.tick = 1;
+
+    m_symbols.reserve(n);
+    m_popularityCdf.reserve(n);
+    m_state.reserve(n);
+
+    double total = 0.0;
+    for (std::uint32_t i = 0; i < n; ++i) {
+        m_symbols.push_back(names.empty() ? symbolName(i) : names[i]);
+        total += 1.0 / std::pow(static_cast<double>(i + 1), m_config.zipfSkew);
+        m_popularityCdf.push_back(total);
+        m_state.push_back(SymbolState{m_config.startPrice, {}});
+    }
+    for (auto& c : m_popularityCdf) {
+        c /= total;
+    }
+}
+
+std::uint64_t OrderFlowGenerator::below(std::uint64_t n) {
+    return m_rng() % n;
+}
+
+bool OrderFlowGenerator::chance(std::uint32_t pct) {
+    return below(100) < pct;
+}
+
+std::uint32_t OrderFlowGenerator::pickSymbol() {
+    const double u = static_cast<double>(m_rng() >> 11) * 0x1.0p-53;
+    const auto it = std::upper_bound(m_popularityCdf.begin(), m_popularityCdf.end(), u);
+    const auto idx = static_cast<std::uint32_t>(it - m_popularityCdf.begin());
+    return std::min(idx, static_cast<std::uint32_t>(m_popularityCdf.size() - 1));
+}
+
+domain::Price OrderFlowGenerator::quotePrice(const SymbolState& s, domain::Side side, domain::OrderType type) {
+    if (type == domain::OrderType::Market)
+        return 0;
+
+    const auto ticks = static_cast<domain::Price>(m_config.halfSpread + below(m_config.depthTicks + 1));
+    const bool aggressive = chance(m_config.crossPct);
+    const bool up = (side == domain::Side::Buy) == aggressive;
+    const domain::Price price = up ? s.mid + ticks * m_config.tick : s.mid - ticks * m_config.tick;
+    return std::max(price, m_config.tick);
+}
+
+int OrderFlowGenerator::pickQuantity() {
+    const auto span = static_cast<std::uint64_t>(m_config.maxQty - m_config.minQty) + 1;
+    return m_config.minQty + static_cast<int>(below(span));
+}
+
+void OrderFlowGenerator::appendHead(std::string& out, char action, domain::OrderId id) {
+    out += action;
+    out += ',';
+    appendInt(out, id);
+    out += ',';
+    appendInt(out, m_timestamp);
+}
+
+void OrderFlowGenerator::appendLine(std::string& out) {
+    ++m_timestamp;
+    ++m_stats.lines;
+
+    const auto roll = static_cast<std::uint32_t>(below(100));
+    const std::uint32_t sym = pickSymbol();
+    auto& s = m_state[sym];
+
+    if (chance(m_config.walkPct)) {
+        const domain::Price floor = (m_config.halfSpread + m_config.depthTicks + 1) * m_config.tick;
+        s.mid = (m_rng() & 1) ? s.mid + m_config.tick : std::max(s.mid - m_config.tick, floor);
+    }
+
+    const std::uint32_t amendEnd = m_config.newPct + m_config.amendPct;
+    const std::uint32_t cancelEnd = amendEnd + m_config.cancelPct;
+
+    if (roll < m_config.newPct) {
+        if (s.resting.size() >= m_config.depthTarget && !s.resting.empty())
+            appendCancel(out, sym);
+        else
+            appendNew(out, sym);
+    } else if (roll < cancelEnd) {
+        if (s.resting.empty())
+            appendNew(out, sym);
+        else if (roll < amendEnd)
+            appendAmend(out, sym);
+        else
+            appendCancel(out, sym);
+    } else if (roll < cancelEnd + m_config.queryPct) {
+        appendQuery(out, sym);
+    } else {
+        appendMatch(out);
+    }
+    out += '\n';
+}
+
+void OrderFlowGenerator::appendNew(std::string& out, std::uint32_t sym) {
+    auto& s = m_state[sym];
+    const auto typeRoll = static_cast<std::uint32_t>(below(100));
+    const domain::OrderType type = typeRoll < m_config.marketPct                     ? domain::OrderType::Market
+                                   : typeRoll < m_config.marketPct + m_config.iocPct ? domain::OrderType::IOC
+                                                                                     : domain::OrderType::Limit;
+    const domain::Side side = (m_rng() & 1) ? domain::Side::Buy : domain::Side::Sell;
+    const domain::Price price = quotePrice(s, side, type);
+    const domain::OrderId id = m_nextId++;
+
+    appendHead(out, 'N', id);
+    out += ',';
+    out += m_symbols[sym];
+    out += ',';
+    out += domain::toChar(type);
+    out += ',';
+    out += domain::toChar(side);
+    out += ',';
+    appendPrice(out, price);
+    out += ',';
+    appendInt(out, pickQuantity());
+
+    s.resting.push_back(Resting{id, type, side, price});
+    ++m_stats.news;
+}
+
+// Half re-quote the price around the current mid, half change the quantity only.
+void OrderFlowGenerator::appendAmend(std::string& out, std::uint32_t sym) {
+    auto& s = m_state[sym];
+    auto& o = s.resting[below(s.resting.size())];
+    if (m_rng() & 1)
+        o.price = quotePrice(s, o.side, o.type);
+
+    appendHead(out, 'A', o.id);
+    out += ',';
+    out += m_symbols[sym];
+    out += ',';
+    out += domain::toChar(o.type);
+    out += ',';
+    out += domain::toChar(o.side);
+    out += ',';
+    appendPrice(out, o.price);
+    out += ',';
+    appendInt(out, pickQuantity());
+    ++m_stats.amends;
+}
+
+void OrderFlowGenerator::appendCancel(std::string& out, std::uint32_t sym) {
+    auto& resting = m_state[sym].resting;
+    const auto pos = below(resting.size());
+    appendHead(out, 'X', resting[pos].id);
+
+    resting[pos] = resting.back();
+    resting.pop_back();
+    ++m_stats.cancels;
+}
+
+void OrderFlowGenerator::appendMatch(std::string& out) {
+    out += "M,";
+    appendInt(out, m_timestamp);
+    if (chance(m_config.matchSymbolPct)) {
+        out += ',';
+        out += m_symbols[pickSymbol()];
+    }
+    ++m_stats.matches;
+}
+
+// Order status of a resting order, top of book or 5 levels of depth, in equal shares.
+void OrderFlowGenerator::appendQuery(std::string& out, std::uint32_t sym) {
+    const auto& resting = m_state[sym].resting;
+    out += "Q,";
+    appendInt(out, m_timestamp);
+    switch (below(3)) {
+    case 0:
+        if (!resting.empty()) {
+            out += ",O,";
+            appendInt(out, resting[below(resting.size())].id);
+            break;
+        }
+        [[fallthrough]];
+    case 1:
+        out += ",T,";
+        out += m_symbols[sym];
+        break;
+    default:
+        out += ",D,";
+        out += m_symbols[sym];
+        out += ",5";
+        break;
+    }
+    ++m_stats.queries;
+}
+
+bool OrderFlowGenerator::write(std::FILE* out, std::uint64_t lines) {
+    std::string buf;
+    buf.reserve(kChunkBytes + 256);
+
+    for (std::uint64_t i = 0; i < lines; ++i) {
+        appendLine(buf);
+        if (buf.size() >= kChunkBytes) {
+            if (std::fwrite(buf.data(), 1, buf.size(), out) != buf.size())
+                return false;
+            buf.clear();
+        }
+    }
+    if (!buf.empty() && std::fwrite(buf.data(), 1, buf.size(), out) != buf.size())
+        return false;
+    return std::fflush(out) == 0;
+}
+
+}  // namespace workload
@@ -0,0 +1,82 @@
+// unit_tests/book/test_arena.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/arena.hpp"
+#include "book/indexed_order_book.hpp"
+
+#include <cstdint>
+#include <map>
+#include <sstream>
+
+namespace {
+
+bool alignedTo(const void* p, std::size_t align) {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+}  // namespace
+
+TEST(ArenaTests, FreedBlocks_AreReused_AndCounted) {
+    Arena arena(ArenaOptions{.hugePages = HugePageMode::Off, .regionBytes = 2u << 20});
+    void* a = arena.allocate(40, 8);
+    void* b = arena.allocate(128, 64);
+    EXPECT_TRUE(alignedTo(b, 64));
+    EXPECT_EQ(arena.stats().usedBytes, 48u + 128u);
+    EXPECT_EQ(arena.stats().regions, 1u);
+
+    arena.deallocate(a, 40);
+    EXPECT_EQ(arena.stats().usedBytes, 128u);
+    EXPECT_EQ(arena.stats().freeListBytes, 48u);
+    EXPECT_EQ(arena.allocate(33, 8), a);  // same 48-byte class
+    EXPECT_EQ(arena.stats().freeListBytes, 0u);
+
+    // bigger than the region: gets one of its own
+    void* big = arena.allocate(3u << 20, 16);
+    EXPECT_NE(big, nullptr);
+    EXPECT_EQ(arena.stats().regions, 2u);
+    arena.deallocate(big, 3u << 20);
+    EXPECT_EQ(arena.allocate(3u << 20, 16), big);
+}
+
+TEST(ArenaTests, Prefault_MapsAndTouchesUpFront) {
+    Arena arena(ArenaOptions{.hugePages = HugePageMode::Transparent, .regionBytes = 2u << 20, .prefaultBytes = 4u << 20});
+    const ArenaStats stats = arena.stats();
+    EXPECT_EQ(stats.prefaultedBytes, 4u << 20);
+    EXPECT_GE(stats.mappedBytes, 4u << 20);
+    EXPECT_EQ(stats.usedBytes, 0u);
+
+    std::ostringstream os;
+    arena.report(os);
+    EXPECT_NE(os.str().find("transparent"), std::string::npos);
+}
+
+TEST(ArenaTests, ExplicitHugePages_FallBackWhenThePoolIsEmpty) {
+    // whether or not the host reserved 2 MiB pages, the arena hands out usable memory
+    Arena arena(ArenaOptions{.hugePages = HugePageMode::Explicit, .regionBytes = 2u << 20});
+    auto* p = static_cast<std::uint64_t*>(arena.allocate(4096, 64));
+    p[0] = 1;
+    p[511] = 2;
+    EXPECT_EQ(p[0] + p[511], 3u);
+    EXPECT_EQ(arena.stats().regions, 1u);
+    EXPECT_LE(arena.stats().explicitRegions, arena.stats().hugeRegions);
+}
+
+TEST(ArenaTests, BooksAndAllocators_DrawFromTheBookArena) {
+    const std::size_t before = bookArena().stats().usedBytes;
+    {
+        std::map<int, int, std::less<int>, BookAllocator<std::pair<const int, int>>> m;
+        m[1] = 2;
+        IndexedOrderBook book;
+        domain::Order order{};
+        order.orderId = 1;
+        order.price = 100;
+        order.quantity = 10;
+        order.side = domain::Side::Buy;
+        order.symbol = "ABC";
+        EXPECT_TRUE(book.add(order));
+        EXPECT_GT(bookArena().stats().usedBytes, before);
+        EXPECT_FALSE(configureBookArena(ArenaOptions{}));  // in use
+    }
+    EXPECT_EQ(bookArena().stats().usedBytes, before);
+}
@@ -0,0 +1,145 @@
+// unit_tests/book/test_differential.cpp
+//
+// IndexedOrderBook against the reference OrderBook on generated streams.
+
+#include <gtest/gtest.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "engine/differential.hpp"
+#include "workload/order_flow.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> generate(const workload::OrderFlowConfig& cfg, std::size_t count) {
+    workload::OrderFlowGenerator gen(cfg);
+    std::vector<std::string> lines;
+    std::string line;
+    for (std::size_t i = 0; i < count; ++i) {
+        line.clear();
+        gen.appendLine(line);
+        line.pop_back();  // '\n'
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+void expectSameAsReference(const std::vector<std::string>& lines, std::size_t stateCheckEvery) {
+    const auto divergence = runDifferential<OrderBook, IndexedOrderBook>(lines, stateCheckEvery);
+    if (divergence) {
+        ADD_FAILURE() << divergence->what << " differs at line " << divergence->line << ": " << divergence->command
+                      << "\n--- reference\n"
+                      << divergence->expected << "--- indexed\n"
+                      << divergence->actual;
+    }
+}
+
+}  // namespace
+
+TEST(DifferentialTests, DefaultFlow_SeveralSeeds) {
+    for (std::uint64_t seed = 1; seed <= 4; ++seed) {
+        workload::OrderFlowConfig cfg;
+        cfg.seed = seed;
+        cfg.symbols = 10;
+        cfg.depthTarget = 30;
+        expectSameAsReference(generate(cfg, 4000), 1);
+    }
+}
+
+TEST(DifferentialTests, AggressiveFlow_ManyCrossesAndMarketOrders) {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 11;
+    cfg.symbols = 5;
+    cfg.crossPct = 40;
+    cfg.marketPct = 15;
+    cfg.iocPct = 20;
+    cfg.halfSpread = 0;
+    cfg.depthTicks = 3;
+    cfg.minQty = 1;
+    cfg.maxQty = 20;
+    expectSameAsReference(generate(cfg, 20000), 25);
+}
+
+TEST(DifferentialTests, DeepBook_AmendAndCancelHeavy) {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 23;
+    cfg.symbols = 50;
+    cfg.zipfSkew = 1.3;
+    cfg.newPct = 40;
+    cfg.amendPct = 35;
+    cfg.cancelPct = 23;
+    cfg.matchSymbolPct = 80;
+    cfg.depthTarget = 400;
+    expectSameAsReference(generate(cfg, 30000), 1000);
+}
+
+TEST(DifferentialTests, QueryMix_DepthTotalsAgree) {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 31;
+    cfg.symbols = 8;
+    cfg.newPct = 45;
+    cfg.amendPct = 20;
+    cfg.cancelPct = 15;
+    cfg.queryPct = 15;
+    expectSameAsReference(generate(cfg, 20000), 100);
+}
+
+TEST(DifferentialTests, PeriodicMassCancels) {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 37;
+    cfg.symbols = 6;
+    cfg.depthTarget = 200;
+    auto lines = generate(cfg, 20000);
+    // flatten one symbol (or one side of it) every 500 lines, the whole book every 5000
+    for (std::size_t i = 500; i < lines.size(); i += 500) {
+        const std::string sym = workload::symbolName(static_cast<std::uint32_t>((i / 500) % 6));
+        std::string cmd = "C," + std::to_string(i);
+        if (i % 5000 != 0)
+            cmd += "," + sym + ((i / 500) % 2 ? ",B" : "");
+        lines.insert(lines.begin() + static_cast<std::ptrdiff_t>(i), cmd);
+    }
+    expectSameAsReference(lines, 50);
+}
+
+TEST(DifferentialTests, HandWrittenEdgeCases) {
+    const std::vector<std::string> lines = {
+        "N,1,1,AAA,L,B,100.00,10",
+        "N,2,2,BBB,L,B,100.00,10",
+        "N,1,3,AAA,L,B,100.00,10",  // duplicate id
+        "A,2,4,BBB,L,B,100.00,5",   // qty down keeps priority
+        "A,1,5,AAA,L,B,100.00,20",  // qty up goes to the back
+        "A,1,6,BBB,L,B,100.00,20",  // immutable field changed
+        "N,3,7,AAA,L,S,99.00,12",
+        "M,8,BBB",
+        "M,9",
+        "X,2,10",
+        "X,2,11",  // already gone
+        "N,4,12,BBB,M,S,0.00,50",
+        "M,13",
+        "M,14,AAA",
+        "N,5,15,AAA,L,S,101.00,7",
+        "N,6,16,AAA,L,S,101.00,3",
+        "A,5,17,AAA,L,S,101.00,2",  // qty down updates the level total
+        "Q,18,O,5",
+        "Q,19,O,2",                 // cancelled
+        "Q,20,T,AAA",
+        "Q,21,D,AAA,5",
+        "Q,22,D,ZZZ,3",             // unknown symbol
+        "Q,23,D,AAA,0",             // invalid levels
+        "N,7,24,BBB,L,S,101.00,4",  // shares AAA's sell level
+        "C,25,AAA,S",
+        "Q,26,D,BBB,2",
+        "N,8,27,AAA,L,B,98.00,1",
+        "C,28,AAA",
+        "C,29,QQQ",
+        "N,5,30,AAA,L,B,97.00,9",   // id freed by the mass cancel
+        "C,31",
+        "B,32,AAA,1,L,B,100.00,5,2,L,S,100.00,3,1,L,S,99.00,1,3,M,S,0.00,2",
+        "B,33,A1A,4,L,B,100.00,5",  // bad symbol rejects the batch
+        "M,34,AAA",
+    };
+    expectSameAsReference(lines, 1);
+}
@@ -0,0 +1,103 @@
+// unit_tests/book/test_id_index.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/id_index.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+using Index = IdIndex<int>;
+
+TEST(IdIndexTests, ContiguousIds_LiveInPages_FreedWhenEmpty) {
+    Index index;
+    for (domain::OrderId id = 1; id <= 5000; ++id) {
+        ASSERT_TRUE(index.tryEmplace(id, id * 10).second);
+    }
+    EXPECT_FALSE(index.tryEmplace(42, 0).second);
+    EXPECT_EQ(*index.find(42), 420);
+    EXPECT_EQ(index.size(), 5000u);
+    EXPECT_EQ(index.livePages(), 2u);
+    EXPECT_EQ(index.hashedCount(), 0u);
+
+    for (domain::OrderId id = 1; id < static_cast<domain::OrderId>(Index::kPageSize); ++id) {
+        ASSERT_TRUE(index.erase(id));
+    }
+    EXPECT_EQ(index.livePages(), 1u);
+    EXPECT_FALSE(index.contains(1));
+    EXPECT_FALSE(index.erase(1));
+    EXPECT_TRUE(index.contains(5000));
+
+    // the freed page comes back clean
+    EXPECT_TRUE(index.tryEmplace(7, 70).second);
+    EXPECT_FALSE(index.contains(8));
+    EXPECT_EQ(index.livePages(), 2u);
+}
+
+TEST(IdIndexTests, Outliers_FallBackToHashing) {
+    Index index;
+    index.tryEmplace(100, 1);
+    index.tryEmplace(INT_MAX, 2);
+    index.tryEmplace(-5, 3);
+    EXPECT_EQ(index.hashedCount(), 2u);
+    EXPECT_EQ(*index.find(INT_MAX), 2);
+    EXPECT_EQ(*index.find(-5), 3);
+    EXPECT_FALSE(index.contains(INT_MAX - 1));
+
+    EXPECT_TRUE(index.erase(INT_MAX));
+    EXPECT_FALSE(index.erase(INT_MAX));
+    EXPECT_EQ(index.size(), 2u);
+}
+
+TEST(IdIndexTests, EmptyWindow_SlidesToTheNextId_AndAdoptsHashedIds) {
+    Index index;
+    index.tryEmplace(10, 1);
+    const domain::OrderId far = 100'000'000;
+    index.tryEmplace(far + 1, 2);  // hashed: the window at 0 is live
+    EXPECT_EQ(index.hashedCount(), 1u);
+
+    index.erase(10);
+    index.tryEmplace(far, 3);  // nothing live in the window: it moves to `far`
+    EXPECT_EQ(index.hashedCount(), 0u);
+    EXPECT_EQ(index.livePages(), 1u);
+    EXPECT_EQ(*index.find(far + 1), 2);
+    EXPECT_EQ(*index.find(far), 3);
+    EXPECT_FALSE(index.contains(10));
+}
+
+TEST(IdIndexTests, ForEach_VisitsDenseIdsInOrderThenHashed) {
+    Index index;
+    for (domain::OrderId id : {9000, 3, 4097, INT_MAX}) {
+        index.tryEmplace(id, id);
+    }
+    std::vector<domain::OrderId> seen;
+    index.forEach([&](domain::OrderId id, int& value) {
+        EXPECT_EQ(id, value);
+        seen.push_back(id);
+    });
+    EXPECT_EQ(seen, (std::vector<domain::OrderId>{3, 4097, 9000, INT_MAX}));
+
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_FALSE(index.contains(3));
+}
+
+TEST(IdIndexTests, Reserve_PreallocatesPages_AndKeepsThemAcrossClear) {
+    Index index;
+    index.reserve(3 * Index::kPageSize);
+    EXPECT_EQ(index.sparePages(), 3u);
+    EXPECT_TRUE(index.empty());
+
+    for (domain::OrderId id = 0; id < static_cast<domain::OrderId>(3 * Index::kPageSize); ++id) {
+        index.tryEmplace(id, 1);
+    }
+    EXPECT_EQ(index.livePages(), 3u);
+    EXPECT_EQ(index.sparePages(), 0u);
+
+    index.clear();
+    EXPECT_EQ(index.sparePages(), 3u);
+    EXPECT_FALSE(index.contains(5));
+    EXPECT_TRUE(index.tryEmplace(5, 2).second);
+    EXPECT_FALSE(index.contains(6));  // a recycled page starts empty
+}
@@ -0,0 +1,271 @@
+// unit_tests/book/test_indexed_order_book.cpp
+//
+// The book contract (book/book_backend.hpp) checked on every backend.
+
+#include <gtest/gtest.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "domain/order.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+domain::Order makeOrder(domain::OrderId id,
+                        domain::Side side,
+                        domain::Price priceCents,
+                        int qty = 100,
+                        const std::string& symbol = "XYZ") {
+    domain::Order o;
+    o.orderId = id;
+    o.side = side;
+    o.price = priceCents;
+    o.quantity = qty;
+    o.symbol = symbol;
+    return o;
+}
+
+template <typename Book>
+std::string dumpOf(const Book& book) {
+    std::ostringstream oss;
+    book.dump(oss);
+    return oss.str();
+}
+
+template <typename Book>
+class BookBackendTests : public ::testing::Test {
+protected:
+    Book book;
+};
+
+using Backends = ::testing::Types<OrderBook, IndexedOrderBook>;
+TYPED_TEST_SUITE(BookBackendTests, Backends);
+
+}  // namespace
+
+TYPED_TEST(BookBackendTests, Add_RejectsLiveId_AndAcceptsItAgainAfterErase) {
+    auto& book = this->book;
+    EXPECT_TRUE(book.add(makeOrder(1, domain::Side::Buy, 100)));
+    EXPECT_FALSE(book.add(makeOrder(1, domain::Side::Sell, 200)));
+    EXPECT_TRUE(book.erase(1));
+    EXPECT_FALSE(book.erase(1));
+    EXPECT_TRUE(book.add(makeOrder(1, domain::Side::Sell, 200)));
+    EXPECT_EQ(book.liveCount(), 1u);
+    EXPECT_EQ(book.buyCount(), 0u);
+    EXPECT_EQ(book.sellCount(), 1u);
+}
+
+TYPED_TEST(BookBackendTests, GlobalBest_IsFifoAcrossSymbols) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Buy, 100, 10, "AAA"));
+    book.add(makeOrder(2, domain::Side::Buy, 100, 10, "BBB"));
+    book.add(makeOrder(3, domain::Side::Buy, 90, 10, "BBB"));
+
+    ASSERT_NE(book.bestBidOrder(), nullptr);
+    EXPECT_EQ(book.bestBidOrder()->orderId, 1);
+    book.consumeBestBid(10);
+    EXPECT_EQ(book.bestBidOrder()->orderId, 2);
+    EXPECT_EQ(book.bestBidPrice(), 100);
+}
+
+TYPED_TEST(BookBackendTests, SymbolBest_SkipsOtherSymbolsAndWorseLevels) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Sell, 100, 10, "AAA"));
+    book.add(makeOrder(2, domain::Side::Sell, 101, 10, "BBB"));
+    book.add(makeOrder(3, domain::Side::Sell, 101, 10, "AAA"));
+    book.add(makeOrder(4, domain::Side::Sell, 102, 10, "BBB"));
+
+    ASSERT_NE(book.bestAskOrder("BBB"), nullptr);
+    EXPECT_EQ(book.bestAskOrder("BBB")->orderId, 2);
+    EXPECT_EQ(book.bestAskPrice("BBB"), 101);
+    EXPECT_EQ(book.bestAskOrder("CCC"), nullptr);
+    EXPECT_EQ(book.bestAskPrice("CCC"), std::nullopt);
+
+    book.consumeBestAsk(10, "BBB");
+    EXPECT_EQ(book.bestAskOrder("BBB")->orderId, 4);
+    EXPECT_EQ(book.bestAskOrder()->orderId, 1);
+    EXPECT_FALSE(book.isLive(2));
+}
+
+TYPED_TEST(BookBackendTests, Consume_IgnoresZeroAndOverfill) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Buy, 100, 10, "AAA"));
+
+    book.consumeBestBid(0);
+    book.consumeBestBid(11);
+    book.consumeBestBid(11, "AAA");
+    EXPECT_EQ(book.getById(1)->quantity, 10);
+
+    book.consumeBestBid(4, "AAA");
+    EXPECT_EQ(book.getById(1)->quantity, 6);
+}
+
+TYPED_TEST(BookBackendTests, GetById_PointerStaysValidWhileOthersComeAndGo) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Buy, 100));
+    domain::Order* first = book.getById(1);
+    for (int id = 2; id < 5000; ++id) {
+        book.add(makeOrder(id, id % 2 ? domain::Side::Buy : domain::Side::Sell, 100 + id % 50));
+        if (id % 3 == 0)
+            book.erase(id - 1);
+    }
+    ASSERT_EQ(book.getById(1), first);
+    first->quantity = 7;
+    EXPECT_EQ(book.getById(1)->quantity, 7);
+}
+
+TYPED_TEST(BookBackendTests, EraseAndFill_DropEmptyLevels) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Buy, 100, 5));
+    book.add(makeOrder(2, domain::Side::Buy, 90, 5));
+    book.erase(1);
+    EXPECT_EQ(book.bestBidPrice(), 90);
+    book.consumeBestBid(5);
+    EXPECT_FALSE(book.hasBuy());
+    EXPECT_EQ(book.bestBidPrice("XYZ"), std::nullopt);
+    EXPECT_EQ(book.liveCount(), 0u);
+}
+
+TYPED_TEST(BookBackendTests, Clear_EmptiesEverything) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Buy, 100));
+    book.add(makeOrder(2, domain::Side::Sell, 110));
+    book.clear();
+    EXPECT_EQ(book.liveCount(), 0u);
+    EXPECT_FALSE(book.hasBuy());
+    EXPECT_FALSE(book.hasSell());
+    EXPECT_TRUE(book.add(makeOrder(1, domain::Side::Buy, 100)));
+}
+
+TYPED_TEST(BookBackendTests, Relocate_SamePrice_GoesToTheTailOfItsLevel) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Buy, 100, 10));
+    book.add(makeOrder(2, domain::Side::Buy, 100, 10, "ABC"));
+    book.add(makeOrder(3, domain::Side::Buy, 100, 10));
+
+    book.relocate(*book.getById(1), 100, 25, 7);
+
+    EXPECT_EQ(book.bestBidOrder()->orderId, 2);
+    EXPECT_EQ(book.bestBidOrder("XYZ")->orderId, 3);
+    const domain::Order* moved = book.getById(1);
+    ASSERT_NE(moved, nullptr);
+    EXPECT_EQ(moved->quantity, 25);
+    EXPECT_EQ(moved->timeStamp, 7);
+
+    LevelSummary level{};
+    ASSERT_EQ(book.depth("XYZ", domain::Side::Buy, 1, &level), 1u);
+    EXPECT_EQ(level.orders, 2u);
+    EXPECT_EQ(level.quantity, 35);
+}
+
+TYPED_TEST(BookBackendTests, Relocate_NewPrice_MovesLevels_AndDropsTheEmptyOne) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Sell, 110, 10));
+    book.add(makeOrder(2, domain::Side::Sell, 105, 10));
+
+    book.relocate(*book.getById(1), 105, 4, 3);
+
+    EXPECT_EQ(book.sellCount(), 2u);
+    EXPECT_EQ(book.liveCount(), 2u);
+    EXPECT_EQ(book.bestAskOrder()->orderId, 2);
+    book.consumeBestAsk(10);
+    EXPECT_EQ(book.bestAskOrder()->orderId, 1);
+    EXPECT_EQ(book.bestAskOrder()->price, 105);
+    book.consumeBestAsk(4);
+    EXPECT_FALSE(book.hasSell());
+    LevelSummary level{};
+    EXPECT_EQ(book.depth("XYZ", domain::Side::Sell, 1, &level), 0u);
+}
+
+TYPED_TEST(BookBackendTests, AddBatch_ReportsEachOrder_LikeRepeatedAdd) {
+    auto& book = this->book;
+    book.add(makeOrder(2, domain::Side::Buy, 100));
+    const domain::Order orders[] = {
+        makeOrder(1, domain::Side::Buy, 100),
+        makeOrder(2, domain::Side::Sell, 110),  // live
+        makeOrder(3, domain::Side::Sell, 110),
+        makeOrder(1, domain::Side::Sell, 120),  // added earlier in the batch
+    };
+    bool added[4] = {};
+    EXPECT_EQ(book.addBatch(orders, 4, added), 2u);
+    EXPECT_TRUE(added[0]);
+    EXPECT_FALSE(added[1]);
+    EXPECT_TRUE(added[2]);
+    EXPECT_FALSE(added[3]);
+    EXPECT_EQ(book.liveCount(), 3u);
+    EXPECT_EQ(book.bestBidOrder("XYZ")->orderId, 2);
+
+    LevelSummary level{};
+    ASSERT_EQ(book.depth("XYZ", domain::Side::Buy, 1, &level), 1u);
+    EXPECT_EQ(level.orders, 2u);
+    EXPECT_EQ(level.quantity, 200);
+}
+
+TYPED_TEST(BookBackendTests, CancelSymbol_DropsOneSideOfOneSymbol_InBookOrder) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Buy, 100, 10, "AAA"));
+    book.add(makeOrder(2, domain::Side::Buy, 100, 10, "BBB"));  // shares the level
+    book.add(makeOrder(3, domain::Side::Buy, 101, 10, "AAA"));
+    book.add(makeOrder(4, domain::Side::Buy, 100, 10, "AAA"));
+    book.add(makeOrder(5, domain::Side::Sell, 110, 10, "AAA"));
+
+    std::vector<domain::OrderId> seen;
+    const auto removed = book.cancelSymbol("AAA", domain::Side::Buy, [&](const domain::Order& o) {
+        seen.push_back(o.orderId);
+    });
+
+    EXPECT_EQ(removed, 3u);
+    EXPECT_EQ(seen, (std::vector<domain::OrderId>{3, 1, 4}));
+    EXPECT_EQ(book.liveCount(), 2u);
+    EXPECT_EQ(book.buyCount(), 1u);
+    EXPECT_EQ(book.bestBidPrice(), 100);
+    EXPECT_EQ(book.bestBidPrice("AAA"), std::nullopt);
+    EXPECT_EQ(book.bestAskPrice("AAA"), 110);
+    EXPECT_FALSE(book.isLive(1));
+    EXPECT_TRUE(book.add(makeOrder(1, domain::Side::Buy, 100, 10, "AAA")));
+    EXPECT_EQ(book.cancelSymbol("ZZZ", domain::Side::Buy, [](const domain::Order&) {}), 0u);
+}
+
+TYPED_TEST(BookBackendTests, CancelAll_VisitsBuysThenSells_AndEmptiesTheBook) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Sell, 110));
+    book.add(makeOrder(2, domain::Side::Buy, 100));
+    book.add(makeOrder(3, domain::Side::Buy, 101, 100, "ABC"));
+
+    std::vector<domain::OrderId> seen;
+    EXPECT_EQ(book.cancelAll([&](const domain::Order& o) { seen.push_back(o.orderId); }), 3u);
+    EXPECT_EQ(seen, (std::vector<domain::OrderId>{3, 2, 1}));
+    EXPECT_EQ(book.liveCount(), 0u);
+    EXPECT_FALSE(book.hasBuy());
+    EXPECT_FALSE(book.hasSell());
+    EXPECT_EQ(book.bestBidPrice("ABC"), std::nullopt);
+}
+
+TEST(IndexedOrderBookTests, Dump_MatchesReferenceByteForByte) {
+    OrderBook reference;
+    IndexedOrderBook indexed;
+    EXPECT_EQ(dumpOf(reference), dumpOf(indexed));
+
+    const domain::Order orders[] = {
+        makeOrder(1, domain::Side::Buy, 10050, 10, "AAA"),
+        makeOrder(2, domain::Side::Buy, 10100, 20, "BBB"),
+        makeOrder(3, domain::Side::Buy, 10050, 30, "BBB"),
+        makeOrder(4, domain::Side::Sell, 10200, 40, "AAA"),
+        makeOrder(5, domain::Side::Sell, 10150, 50, "AAA"),
+        makeOrder(6, domain::Side::Sell, 10200, 60, "CCC"),
+    };
+    for (const auto& o : orders) {
+        reference.add(o);
+        indexed.add(o);
+    }
+    EXPECT_EQ(dumpOf(reference), dumpOf(indexed));
+
+    reference.erase(3);
+    indexed.erase(3);
+    reference.consumeBestAsk(50);
+    indexed.consumeBestAsk(50);
+    EXPECT_EQ(dumpOf(reference), dumpOf(indexed));
+}
@@ -223,12 +223,12 @@ TEST(AmendTests, FormatMatchesSpec) {
     AmendResult ok;
     ok.orderId = 7;
     ok.accepted = true;
-    EXPECT_EQ(AmendHandler::format(ok), "7 - AmendAccept");
+    EXPECT_EQ(AmendHandler<>::format(ok), "7 - AmendAccept");
 
     AmendResult bad;
     bad.orderId = 7;
     bad.accepted = false;
     bad.rejectCode = 404;
     bad.rejectMessage = "Order does not exist";
-    EXPECT_EQ(AmendHandler::format(bad), "7 - AmendReject - 404 - Order does not exist");
+    EXPECT_EQ(AmendHandler<>::format(bad), "7 - AmendReject - 404 - Order does not exist");
 }
\ No newline at end of file
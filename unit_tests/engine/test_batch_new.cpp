@@ -0,0 +1,105 @@
+// unit_tests/engine/test_batch_new.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/order_book.hpp"
+#include "engine/batch_new.hpp"
+#include "engine/dispatcher.hpp"
+#include "parser/commands_parser.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string runBatch(CommandDispatcher<>& dispatcher, const std::string& line) {
+    const auto cmd = parseCommandLine(line);
+    EXPECT_TRUE(cmd.has_value()) << line;
+    std::ostringstream out;
+    dispatcher.dispatchBatch(*cmd, out);
+    return out.str();
+}
+
+std::string runSingles(CommandDispatcher<>& dispatcher, const std::vector<std::string>& lines) {
+    std::string out;
+    for (const auto& line : lines) {
+        const auto cmd = parseCommandLine(line);
+        EXPECT_TRUE(cmd.has_value()) << line;
+        out += dispatcher.dispatch(*cmd);
+        out += '\n';
+    }
+    return out;
+}
+
+std::string dumpOf(const OrderBook& book) {
+    std::ostringstream oss;
+    book.dump(oss);
+    return oss.str();
+}
+
+}  // namespace
+
+TEST(BatchNewTests, SameResponsesAndBookAsTheEquivalentNewLines) {
+    OrderBook batchBook;
+    OrderBook singleBook;
+    CommandDispatcher batch(batchBook);
+    CommandDispatcher single(singleBook);
+    batch.dispatch(*parseCommandLine("N,2,1,XYZ,L,S,101.00,5"));
+    single.dispatch(*parseCommandLine("N,2,1,XYZ,L,S,101.00,5"));
+
+    const std::string batchOut = runBatch(batch,
+                                          "B,5,XYZ,"
+                                          "1,L,B,100.00,10,"  // accept
+                                          "2,L,B,99.00,10,"   // already live
+                                          "3,M,S,0.00,7,"     // market
+                                          "4,L,B,0.00,10,"    // limit without price
+                                          "1,I,B,98.00,1,"    // duplicate inside the batch
+                                          "5,L,B,100.00,3");  // FIFO behind 1
+    const std::string singleOut = runSingles(single,
+                                             {
+                                                 "N,1,5,XYZ,L,B,100.00,10",
+                                                 "N,2,5,XYZ,L,B,99.00,10",
+                                                 "N,3,5,XYZ,M,S,0.00,7",
+                                                 "N,4,5,XYZ,L,B,0.00,10",
+                                                 "N,1,5,XYZ,I,B,98.00,1",
+                                                 "N,5,5,XYZ,L,B,100.00,3",
+                                             });
+
+    EXPECT_EQ(batchOut, singleOut);
+    EXPECT_EQ(batchOut,
+              "1 - Accept\n"
+              "2 - Reject - 303 - Invalid order details\n"
+              "3 - Accept\n"
+              "4 - Reject - 303 - Invalid order details\n"
+              "1 - Reject - 303 - Invalid order details\n"
+              "5 - Accept\n");
+    EXPECT_EQ(dumpOf(batchBook), dumpOf(singleBook));
+}
+
+TEST(BatchNewTests, InvalidSharedFields_RejectEveryOrder) {
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+    EXPECT_EQ(runBatch(dispatcher, "B,5,X1Z,1,L,B,100.00,10,2,L,S,101.00,10"),
+              "1 - Reject - 303 - Invalid order details\n"
+              "2 - Reject - 303 - Invalid order details\n");
+    EXPECT_EQ(book.liveCount(), 0u);
+}
+
+TEST(BatchNewTests, OverCapacity_RejectsTheWholeBatch) {
+    OrderBook book;
+    BatchNewHandler handler(book);
+    BatchNewRequest req;
+    req.symbol = "XYZ";
+    for (std::size_t i = 0; i <= kMaxBatchOrders; ++i) {
+        req.orders.push_back(BatchOrder{static_cast<domain::OrderId>(i + 1), domain::OrderType::Limit,
+                                        domain::Side::Buy, 10000, 1});
+    }
+    const auto res = handler.execute(req);
+    EXPECT_EQ(res.accepted, 0u);
+    EXPECT_EQ(res.results.size(), kMaxBatchOrders + 1);
+    EXPECT_EQ(book.liveCount(), 0u);
+
+    req.orders.pop_back();
+    EXPECT_EQ(handler.execute(req).accepted, kMaxBatchOrders);
+}
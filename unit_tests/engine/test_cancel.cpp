@@ -118,12 +118,12 @@ TEST(CancelTests, FormatMatchesSpec) {
     CancelResponse ok;
     ok.orderId = 1;
     ok.accepted = true;
-    EXPECT_EQ(CancelHandler::format(ok), "1 - CancelAccept");
+    EXPECT_EQ(CancelHandler<>::format(ok), "1 - CancelAccept");
 
     CancelResponse bad;
     bad.orderId = 2;
     bad.accepted = false;
     bad.rejectCode = 404;
     bad.rejectMessage = "Order does not exist";
-    EXPECT_EQ(CancelHandler::format(bad), "2 - CancelReject - 404 - Order does not exist");
+    EXPECT_EQ(CancelHandler<>::format(bad), "2 - CancelReject - 404 - Order does not exist");
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "engine/dispatcher.hpp"
 
+#include <sstream>
+
 // Helper factory for domain::Order
 static domain::Order makeOrder(domain::OrderId id,
                                domain::Timestamp ts = 1,
@@ -95,4 +97,45 @@ TEST(DispatcherTests, DispatchAmend_OnMissingOrder_Prints404) {
 
     auto out = dispatcher.dispatch(cmd);
     EXPECT_EQ(out, "50 - AmendReject - 404 - Order does not exist");
-}
\ No newline at end of file
+}
+TEST(DispatcherTests, DispatchTo_RoutesEveryCommandType) {
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+    std::ostringstream out;
+    for (const char* line : {"N,1,1,XYZ,L,B,100.00,10", "B,2,XYZ,2,L,S,100.00,4,3,L,S,101.00,5", "M,3", "Q,4,O,1",
+                             "S,4,5,XYZ,L,S,90.00,5,95.00", "A,1,6,XYZ,L,B,100.00,8", "X,3,7", "C,8,XYZ"}) {
+        const auto cmd = parseCommandLine(line);
+        ASSERT_TRUE(cmd.has_value()) << line;
+        dispatcher.dispatchTo(*cmd, out);
+    }
+    EXPECT_EQ(out.str(),
+              "1 - Accept\n"
+              "2 - Accept\n3 - Accept\n"
+              "XYZ|1,L,4,10000|10000,4,L,2\n"
+              "1 - OrderStatus - XYZ,L,B,100.00,6\n"
+              "4 - Accept\n"
+              "1 - AmendAccept\n"
+              "3 - CancelAccept\n"
+              "1 - CancelAccept\n4 - CancelAccept\nXYZ - MassCancelAccept - 2\n");
+    EXPECT_EQ(book.liveCount(), 0u);
+}
+
+TEST(DispatcherTests, MessageTypeOf_MapsEveryCommandType) {
+    EXPECT_EQ(messageTypeOf(*parseCommandLine("N,1,1,XYZ,L,B,100.00,10")), metrics::MessageType::New);
+    EXPECT_EQ(messageTypeOf(*parseCommandLine("B,2,XYZ,2,L,S,100.00,4")), metrics::MessageType::BatchNew);
+    EXPECT_EQ(messageTypeOf(*parseCommandLine("A,1,6,XYZ,L,B,100.00,8")), metrics::MessageType::Amend);
+    EXPECT_EQ(messageTypeOf(*parseCommandLine("X,3,7")), metrics::MessageType::Cancel);
+    EXPECT_EQ(messageTypeOf(*parseCommandLine("M,3")), metrics::MessageType::Match);
+    EXPECT_EQ(messageTypeOf(*parseCommandLine("Q,4,O,1")), metrics::MessageType::Query);
+    EXPECT_EQ(messageTypeOf(*parseCommandLine("C,8,XYZ")), metrics::MessageType::MassCancel);
+    EXPECT_EQ(messageTypeOf(*parseCommandLine("S,4,5,XYZ,L,S,90.00,5,95.00")), metrics::MessageType::Stop);
+}
+
+TEST(DispatcherTests, Dispatch_MultiLineCommands_ReturnTheirJoinedLines) {
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+    EXPECT_EQ(dispatcher.dispatch(*parseCommandLine("B,1,XYZ,1,L,B,100.00,10,2,L,S,100.00,4")), "1 - Accept\n2 - Accept");
+    EXPECT_EQ(dispatcher.dispatch(*parseCommandLine("M,2")), "XYZ|1,L,4,10000|10000,4,L,2");
+    EXPECT_EQ(dispatcher.dispatch(*parseCommandLine("C,3,XYZ")), "1 - CancelAccept\nXYZ - MassCancelAccept - 1");
+    EXPECT_EQ(dispatcher.dispatch(*parseCommandLine("Q,4,O,1")), "1 - QueryReject - 404 - Order does not exist");
+}
@@ -0,0 +1,239 @@
+// unit_tests/engine/test_expiry_wheel.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "engine/differential.hpp"
+#include "engine/dispatcher.hpp"
+#include "engine/expiry_wheel.hpp"
+#include "parser/commands_parser.hpp"
+#include "persistence/command_codec.hpp"
+#include "persistence/journal.hpp"
+#include "persistence/recovery.hpp"
+#include "test_helpers.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Fired = std::vector<std::pair<domain::OrderId, domain::Timestamp>>;
+
+Fired advance(ExpiryWheel& wheel, domain::Timestamp now) {
+    Fired fired;
+    wheel.advance(now, [&](domain::OrderId id, domain::Timestamp at) { fired.emplace_back(id, at); });
+    return fired;
+}
+
+domain::Order gtt(domain::OrderId id,
+                  domain::Timestamp ts,
+                  domain::Timestamp expireAt,
+                  domain::Side side = domain::Side::Buy,
+                  domain::Price priceCents = 10000,
+                  int qty = 10) {
+    domain::Order o;
+    o.orderId = id;
+    o.timeStamp = ts;
+    o.symbol = "XYZ";
+    o.orderType = domain::OrderType::Limit;
+    o.side = side;
+    o.price = priceCents;
+    o.quantity = qty;
+    o.expireAt = expireAt;
+    return o;
+}
+
+class ExpiryDispatchTests : public ::testing::Test {
+protected:
+    std::string tick(domain::Timestamp now) {
+        std::ostringstream out;
+        dispatcher.advanceClock(now, out);
+        return out.str();
+    }
+
+    OrderBook book;
+    CommandDispatcher<> dispatcher{book};
+};
+
+}  // namespace
+
+TEST(ExpiryWheelTests, FiresInExpiryOrder_OnlyWhenDue) {
+    ExpiryWheel wheel;
+    wheel.schedule(1, 500);
+    wheel.schedule(2, 70);
+    wheel.schedule(3, 4100);  // two levels up
+    wheel.schedule(4, 70);
+    EXPECT_EQ(wheel.size(), 4u);
+
+    EXPECT_TRUE(advance(wheel, 69).empty());
+    EXPECT_EQ(advance(wheel, 70), (Fired{{2, 70}, {4, 70}}));
+    EXPECT_EQ(advance(wheel, 4099), (Fired{{1, 500}}));
+    EXPECT_EQ(advance(wheel, 5000), (Fired{{3, 4100}}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(ExpiryWheelTests, LargeJump_FiresEverythingDueInOrder) {
+    ExpiryWheel wheel;
+    Fired expected;
+    for (domain::OrderId id = 1; id <= 200; ++id) {
+        const domain::Timestamp at = static_cast<domain::Timestamp>(id) * 7919 % 1000003 + 1;
+        wheel.schedule(id, at);
+        expected.emplace_back(id, at);
+    }
+    wheel.schedule(999, 4'000'000'000'000);  // far beyond everything else
+    std::sort(expected.begin(), expected.end(),
+              [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    EXPECT_EQ(advance(wheel, 2'000'000), expected);
+    EXPECT_EQ(wheel.size(), 1u);
+    EXPECT_TRUE(advance(wheel, 3'999'999'999'999).empty());
+    EXPECT_EQ(advance(wheel, 4'000'000'000'000), (Fired{{999, 4'000'000'000'000}}));
+}
+
+TEST(ExpiryWheelTests, Cancel_RemovesEntry_ClockNeverGoesBack) {
+    ExpiryWheel wheel;
+    wheel.schedule(1, 100);
+    wheel.schedule(2, 100);
+    EXPECT_TRUE(wheel.cancel(1));
+    EXPECT_FALSE(wheel.cancel(1));
+    EXPECT_EQ(advance(wheel, 150), (Fired{{2, 100}}));
+    EXPECT_TRUE(advance(wheel, 10).empty());
+    EXPECT_EQ(wheel.now(), 150);
+
+    // already in the past => due on the next advance
+    wheel.schedule(3, 120);
+    EXPECT_EQ(advance(wheel, 150), (Fired{{3, 120}}));
+}
+
+TEST_F(ExpiryDispatchTests, DueOrder_LeavesBookWithExpiredMessage) {
+    EXPECT_EQ(dispatcher.dispatch(gtt(1, 10, 100)), "1 - Accept");
+    EXPECT_EQ(dispatcher.dispatch(gtt(2, 11, 200)), "2 - Accept");
+    EXPECT_EQ(dispatcher.dispatch(gtt(3, 12, 0)), "3 - Accept");  // rests until cancelled
+    EXPECT_EQ(dispatcher.pendingExpiries(), 2u);
+
+    EXPECT_EQ(tick(99), "");
+    EXPECT_EQ(tick(150), "1 - Expired\n");
+    EXPECT_FALSE(book.isLive(1));
+    EXPECT_EQ(tick(10'000), "2 - Expired\n");
+    EXPECT_EQ(book.liveCount(), 1u);
+    EXPECT_TRUE(book.isLive(3));
+}
+
+TEST_F(ExpiryDispatchTests, ExpiryNotAfterTimestamp_IsRejected) {
+    EXPECT_EQ(dispatcher.dispatch(gtt(1, 100, 100)), "1 - Reject - 303 - Invalid order details");
+    EXPECT_EQ(dispatcher.dispatch(gtt(2, 100, 50)), "2 - Reject - 303 - Invalid order details");
+    EXPECT_EQ(book.liveCount(), 0u);
+    EXPECT_EQ(dispatcher.pendingExpiries(), 0u);
+}
+
+TEST_F(ExpiryDispatchTests, ExpiryAlreadyPassedByClock_IsRejected) {
+    EXPECT_EQ(tick(100), "");
+    // timestamped behind the clock, expiry in between: due already, so never rests
+    EXPECT_EQ(dispatcher.dispatch(gtt(1, 50, 80, domain::Side::Sell)), "1 - Reject - 303 - Invalid order details");
+    EXPECT_EQ(dispatcher.dispatch(gtt(2, 50, 100, domain::Side::Sell)), "2 - Reject - 303 - Invalid order details");
+    EXPECT_EQ(dispatcher.dispatch(gtt(3, 50, 101, domain::Side::Sell)), "3 - Accept");
+    EXPECT_EQ(dispatcher.dispatch(gtt(4, 100, 0)), "4 - Accept");
+    EXPECT_EQ(dispatcher.dispatchMatch(MatchRequest{100, std::nullopt}).size(), 1u);  // only 3 trades
+    EXPECT_FALSE(book.isLive(1));
+    EXPECT_FALSE(book.isLive(2));
+    EXPECT_EQ(dispatcher.pendingExpiries(), 1u);  // 3's entry, checked against the book when it fires
+}
+
+TEST_F(ExpiryDispatchTests, CancelledFilledOrReusedIds_DoNotExpire) {
+    dispatcher.dispatch(gtt(1, 1, 100));
+    dispatcher.dispatch(gtt(2, 2, 100, domain::Side::Buy, 10000, 10));
+    dispatcher.dispatch(gtt(3, 3, 100, domain::Side::Sell, 10000, 10));
+    dispatcher.dispatch(gtt(4, 4, 100, domain::Side::Buy, 9000));
+    std::ostringstream acks;
+
+    EXPECT_EQ(dispatcher.dispatch(CancelRequest{1, 5}), "1 - CancelAccept");
+    dispatcher.dispatchMatch(MatchRequest{6, std::nullopt});  // 2 and 3 fully filled
+    dispatcher.dispatch(gtt(2, 7, 300));                      // id 2 reused with another expiry
+    dispatcher.dispatchMassCancel(MassCancelRequest{8, MassCancelScope::SymbolSide, "XYZ", domain::Side::Sell},
+                                  acks);
+
+    EXPECT_EQ(tick(100), "4 - Expired\n");
+    EXPECT_TRUE(book.isLive(2));
+    EXPECT_EQ(tick(300), "2 - Expired\n");
+    EXPECT_EQ(book.liveCount(), 0u);
+}
+
+TEST_F(ExpiryDispatchTests, Expiry_IsJournaledAsCancel_RecoveryMatches) {
+    const auto dir = makeTempDir("hft_expiry_", "journal");
+    {
+        persistence::JournalOptions opts;
+        opts.directory = dir;
+        opts.fsyncEnabled = false;
+        persistence::JournalWriter journal(opts);
+        dispatcher.attachJournal(&journal);
+        dispatcher.dispatch(gtt(1, 1, 50));
+        dispatcher.dispatch(gtt(2, 2, 0, domain::Side::Sell, 10100));
+        EXPECT_EQ(tick(60), "1 - Expired\n");
+        dispatcher.dispatch(gtt(3, 30, 0));  // older timestamp than the clock: replay must not care
+        dispatcher.attachJournal(nullptr);
+    }
+
+    OrderBook recovered;
+    const auto res = persistence::recoverFromJournal(recovered, dir);
+    EXPECT_EQ(res.lastSeq, 4u);
+    std::ostringstream expected;
+    std::ostringstream actual;
+    book.dump(expected);
+    recovered.dump(actual);
+    EXPECT_EQ(actual.str(), expected.str());
+    EXPECT_FALSE(recovered.isLive(1));
+}
+
+TEST_F(ExpiryDispatchTests, Snapshot_KeepsExpiry_RescheduleAfterLoad) {
+    dispatcher.dispatch(gtt(1, 1, 500));
+    dispatcher.dispatch(gtt(2, 2, 0));
+    std::stringstream ss;
+    ASSERT_TRUE(book.writeSnapshot(ss, 2));
+
+    OrderBook restored;
+    ASSERT_TRUE(restored.loadSnapshot(ss).has_value());
+    ASSERT_NE(restored.findOrder(1), nullptr);
+    EXPECT_EQ(restored.findOrder(1)->expireAt, 500);
+
+    CommandDispatcher<> fresh(restored);
+    fresh.rescheduleExpiries();
+    EXPECT_EQ(fresh.pendingExpiries(), 1u);
+    std::ostringstream out;
+    fresh.advanceClock(500, out);
+    EXPECT_EQ(out.str(), "1 - Expired\n");
+}
+
+TEST(ExpiryParseTests, OptionalNinthField_RoundTripsThroughCodec) {
+    const auto plain = parseCommandLine("N,1,10,XYZ,L,B,100.00,5");
+    ASSERT_TRUE(plain.has_value());
+    EXPECT_EQ(std::get<domain::Order>(*plain).expireAt, 0);
+
+    const auto timed = parseCommandLine("N,1,10,XYZ,L,B,100.00,5,250");
+    ASSERT_TRUE(timed.has_value());
+    EXPECT_EQ(std::get<domain::Order>(*timed).expireAt, 250);
+    EXPECT_EQ(timestampOf(*timed), 10);
+    EXPECT_FALSE(parseCommandLine("N,1,10,XYZ,L,B,100.00,5,soon").has_value());
+
+    for (const auto& cmd : {*plain, *timed}) {
+        std::vector<char> bytes;
+        persistence::encodeCommand(cmd, bytes);
+        const auto decoded = persistence::decodeCommand(bytes.data(), bytes.size());
+        ASSERT_TRUE(decoded.has_value());
+        EXPECT_EQ(std::get<domain::Order>(*decoded).expireAt, std::get<domain::Order>(cmd).expireAt);
+    }
+}
+
+TEST(ExpiryDifferentialTests, IndexedBookExpiresTheSame) {
+    const std::vector<std::string> lines = {
+        "N,1,1,XYZ,L,B,100.00,10,20", "N,2,2,XYZ,L,B,100.00,10",    "N,3,3,XYZ,L,S,101.00,5,15",
+        "N,4,4,ABC,L,S,99.00,5,40",   "A,1,5,XYZ,L,B,101.00,10",    "Q,16,T,XYZ",
+        "M,21",                       "N,5,30,ABC,L,B,98.00,3,31",  "X,2,32",
+        "N,6,50,XYZ,L,S,100.00,1,60", "C,61,XYZ",
+    };
+    const auto d = runDifferential<OrderBook, IndexedOrderBook>(lines);
+    EXPECT_FALSE(d.has_value()) << d->command << "\n" << d->expected << "\n---\n" << d->actual;
+}
@@ -0,0 +1,106 @@
+// unit_tests/engine/test_mass_cancel.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/order_book.hpp"
+#include "domain/order.hpp"
+#include "engine/dispatcher.hpp"
+#include "engine/mass_cancel.hpp"
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+domain::Order makeOrder(domain::OrderId id,
+                        domain::Side side,
+                        domain::Price priceCents,
+                        int qty = 100,
+                        const std::string& symbol = "XYZ") {
+    domain::Order o;
+    o.orderId = id;
+    o.side = side;
+    o.price = priceCents;
+    o.quantity = qty;
+    o.orderType = domain::OrderType::Limit;
+    o.symbol = symbol;
+    return o;
+}
+
+MassCancelRequest massCancel(MassCancelScope scope, const std::string& symbol = "", domain::Side side = domain::Side::Buy) {
+    MassCancelRequest req;
+    req.scope = scope;
+    req.symbol = symbol;
+    req.side = side;
+    return req;
+}
+
+class MassCancelTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        book.add(makeOrder(1, domain::Side::Buy, 10000, 10));
+        book.add(makeOrder(2, domain::Side::Buy, 10000, 10, "ABC"));
+        book.add(makeOrder(3, domain::Side::Buy, 10100, 10));
+        book.add(makeOrder(4, domain::Side::Sell, 10200, 10));
+        book.add(makeOrder(5, domain::Side::Sell, 10300, 10, "ABC"));
+    }
+
+    std::string run(const MassCancelRequest& req) {
+        std::ostringstream out;
+        dispatcher.dispatchMassCancel(req, out);
+        return out.str();
+    }
+
+    OrderBook book;
+    CommandDispatcher<> dispatcher{book};
+};
+
+}  // namespace
+
+TEST_F(MassCancelTests, Symbol_DropsBothSides_AcksInBookOrderThenSummary) {
+    EXPECT_EQ(run(massCancel(MassCancelScope::Symbol, "XYZ")),
+              "3 - CancelAccept\n"
+              "1 - CancelAccept\n"
+              "4 - CancelAccept\n"
+              "XYZ - MassCancelAccept - 3\n");
+    EXPECT_EQ(book.liveCount(), 2u);
+    EXPECT_TRUE(book.isLive(2));
+    EXPECT_TRUE(book.isLive(5));
+    EXPECT_EQ(book.bestBidPrice(), 10000);
+}
+
+TEST_F(MassCancelTests, SymbolSide_LeavesTheOtherSide) {
+    EXPECT_EQ(run(massCancel(MassCancelScope::SymbolSide, "XYZ", domain::Side::Sell)),
+              "4 - CancelAccept\n"
+              "XYZ,S - MassCancelAccept - 1\n");
+    EXPECT_EQ(book.liveCount(), 4u);
+    EXPECT_EQ(book.bestAskPrice("XYZ"), std::nullopt);
+    EXPECT_EQ(book.bestBidPrice("XYZ"), 10100);
+}
+
+TEST_F(MassCancelTests, All_EmptiesTheBook_AndIdsCanBeReused) {
+    EXPECT_EQ(run(massCancel(MassCancelScope::All)),
+              "3 - CancelAccept\n"
+              "1 - CancelAccept\n"
+              "2 - CancelAccept\n"
+              "4 - CancelAccept\n"
+              "5 - CancelAccept\n"
+              "* - MassCancelAccept - 5\n");
+    EXPECT_EQ(book.liveCount(), 0u);
+    EXPECT_TRUE(book.add(makeOrder(1, domain::Side::Buy, 10000)));
+}
+
+TEST_F(MassCancelTests, UnknownSymbol_AcceptsWithZero_InvalidSymbol_Rejects) {
+    EXPECT_EQ(run(massCancel(MassCancelScope::Symbol, "QQQ")), "QQQ - MassCancelAccept - 0\n");
+    EXPECT_EQ(run(massCancel(MassCancelScope::Symbol, "X1")),
+              "X1 - MassCancelReject - 101 - Invalid mass cancel details\n");
+    EXPECT_EQ(book.liveCount(), 5u);
+}
+
+TEST_F(MassCancelTests, DepthTotals_FollowTheCancel) {
+    run(massCancel(MassCancelScope::SymbolSide, "XYZ", domain::Side::Buy));
+    LevelSummary levels[4];
+    EXPECT_EQ(book.depth("XYZ", domain::Side::Buy, 4, levels), 0u);
+    ASSERT_EQ(book.depth("XYZ", domain::Side::Sell, 4, levels), 1u);
+    EXPECT_EQ(levels[0].quantity, 10);
+}
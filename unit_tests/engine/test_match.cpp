@@ -211,7 +211,7 @@ TEST(MatchFormatTests, SingleEvent_FormatsExactly) {
 
     resp.events.push_back(e);
 
-    auto out = MatchHandler::format(resp);
+    auto out = MatchHandler<>::format(resp);
     ASSERT_EQ(out.size(), 1u);
 
     // Note: price is cents (6090), because current format prints raw int.
@@ -233,7 +233,7 @@ TEST(MatchFormatTests, MultipleEvents_PreserveOrder) {
         domain::OrderType::Limit, domain::OrderType::Limit,
         100, 6090});
 
-    auto out = MatchHandler::format(resp);
+    auto out = MatchHandler<>::format(resp);
     ASSERT_EQ(out.size(), 2u);
 
     EXPECT_EQ(out[0], "ALN|1,L,100,6090|6090,100,L,10");
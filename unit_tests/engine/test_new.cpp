@@ -97,6 +97,19 @@ TEST(NewCommandTests, RejectsNonAlphaSymbol) {
     EXPECT_EQ(book.liveCount(), 0u);
 }
 
+TEST(NewCommandTests, RejectsSymbolLongerThanInlineCapacity) {
+    OrderBook book;
+    NewCommandHandler handler(book);
+
+    auto o = makeOrder(14, 1, "ABCDEFGHIJKLMNOP", domain::OrderType::Limit, domain::Side::Buy, 10000, 100);
+    ASSERT_TRUE(o.symbol.tooLong());
+    EXPECT_FALSE(handler.execute(o).accepted);
+
+    o.symbol = "ABCDEFGHIJKLMNO";  // exactly kCapacity
+    EXPECT_TRUE(handler.execute(o).accepted);
+    EXPECT_EQ(book.liveCount(), 1u);
+}
+
 TEST(NewCommandTests, RejectsNonPositiveQuantity) {
     OrderBook book;
     NewCommandHandler handler(book);
@@ -113,11 +126,11 @@ TEST(NewCommandTests, FormatMatchesSpec) {
     ok.orderId = 2;
     ok.accepted = true;
 
-    EXPECT_EQ(NewCommandHandler::format(ok), "2 - Accept");
+    EXPECT_EQ(NewCommandHandler<>::format(ok), "2 - Accept");
 
     NewCommandResponse bad;
     bad.orderId = 2;
     bad.accepted = false;
 
-    EXPECT_EQ(NewCommandHandler::format(bad), "2 - Reject - 303 - Invalid order details");
+    EXPECT_EQ(NewCommandHandler<>::format(bad), "2 - Reject - 303 - Invalid order details");
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+// unit_tests/engine/test_query.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/order_book.hpp"
+#include "domain/order.hpp"
+#include "engine/amend.hpp"
+#include "engine/query.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+domain::Order makeOrder(domain::OrderId id,
+                        domain::Side side,
+                        domain::Price priceCents,
+                        int qty = 100,
+                        const std::string& symbol = "XYZ") {
+    domain::Order o;
+    o.orderId = id;
+    o.side = side;
+    o.price = priceCents;
+    o.quantity = qty;
+    o.orderType = domain::OrderType::Limit;
+    o.symbol = symbol;
+    return o;
+}
+
+QueryRequest orderQuery(domain::OrderId id) {
+    QueryRequest q;
+    q.kind = QueryKind::Order;
+    q.orderId = id;
+    return q;
+}
+
+QueryRequest depthQuery(const std::string& symbol, int levels) {
+    QueryRequest q;
+    q.kind = QueryKind::Depth;
+    q.symbol = symbol;
+    q.levels = levels;
+    return q;
+}
+
+std::vector<std::string> run(const OrderBook& book, const QueryRequest& q) {
+    return QueryHandler<>::format(QueryHandler(book).execute(q));
+}
+
+}  // namespace
+
+TEST(QueryTests, OrderStatus_LiveOrder) {
+    OrderBook book;
+    book.add(makeOrder(7, domain::Side::Sell, 10250, 40));
+
+    const auto out = run(book, orderQuery(7));
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0], "7 - OrderStatus - XYZ,L,S,102.50,40");
+}
+
+TEST(QueryTests, OrderStatus_UnknownOrder_Rejects404) {
+    OrderBook book;
+    const auto out = run(book, orderQuery(7));
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0], "7 - QueryReject - 404 - Order does not exist");
+}
+
+TEST(QueryTests, InvalidQueries_Reject101) {
+    OrderBook book;
+    EXPECT_EQ(run(book, depthQuery("XYZ", 0))[0], "XYZ - QueryReject - 101 - Invalid query details");
+    EXPECT_EQ(run(book, depthQuery("XYZ", kMaxQueryLevels + 1))[0], "XYZ - QueryReject - 101 - Invalid query details");
+    EXPECT_EQ(run(book, depthQuery("X1", 1))[0], "X1 - QueryReject - 101 - Invalid query details");
+    EXPECT_EQ(run(book, orderQuery(0))[0], "0 - QueryReject - 101 - Invalid query details");
+}
+
+TEST(QueryTests, Top_EmptySymbol_PrintsBlankSides) {
+    OrderBook book;
+    QueryRequest q;
+    q.kind = QueryKind::Top;
+    q.symbol = "XYZ";
+    const auto out = run(book, q);
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0], "XYZ||");
+}
+
+TEST(QueryTests, Depth_AggregatesPerLevel_AndIgnoresOtherSymbols) {
+    OrderBook book;
+    book.add(makeOrder(1, domain::Side::Buy, 10000, 10));
+    book.add(makeOrder(2, domain::Side::Buy, 10000, 15));
+    book.add(makeOrder(3, domain::Side::Buy, 9900, 5));
+    book.add(makeOrder(4, domain::Side::Buy, 10100, 99, "ABC"));  // shares the global level map
+    book.add(makeOrder(5, domain::Side::Sell, 10200, 8));
+
+    const auto out = run(book, depthQuery("XYZ", 5));
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0], "XYZ|2,25,100.00|102.00,8,1");
+    EXPECT_EQ(out[1], "XYZ|1,5,99.00|");
+}
+
+TEST(QueryTests, Depth_TracksAmendConsumeAndErase) {
+    OrderBook book;
+    book.add(makeOrder(1, domain::Side::Buy, 10000, 10));
+    book.add(makeOrder(2, domain::Side::Buy, 10000, 15));
+    book.add(makeOrder(3, domain::Side::Sell, 10200, 8));
+
+    AmendHandler amend(book);
+    AmendRequest a;
+    a.orderId = 2;
+    a.timeStamp = 1;
+    a.symbol = "XYZ";
+    a.orderType = domain::OrderType::Limit;
+    a.side = domain::Side::Buy;
+    a.newPrice = 10000;
+    a.newQuantity = 5;  // qty down in place
+    ASSERT_TRUE(amend.execute(a).accepted);
+    EXPECT_EQ(run(book, depthQuery("XYZ", 1))[0], "XYZ|2,15,100.00|102.00,8,1");
+
+    book.consumeBestBid(4, "XYZ");
+    EXPECT_EQ(run(book, depthQuery("XYZ", 1))[0], "XYZ|2,11,100.00|102.00,8,1");
+
+    book.consumeBestAsk(8);
+    EXPECT_EQ(run(book, depthQuery("XYZ", 1))[0], "XYZ|2,11,100.00|");
+
+    book.erase(1);
+    EXPECT_EQ(run(book, depthQuery("XYZ", 1))[0], "XYZ|1,5,100.00|");
+}
@@ -0,0 +1,184 @@
+// unit_tests/engine/test_response_writer.cpp
+
+#include <gtest/gtest.h>
+
+#include "engine/dispatcher.hpp"
+#include "engine/response_writer.hpp"
+#include "workload/order_flow.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Generated flow with queries, then stops, a GTT expiry, a batch, mass cancels and rejects.
+std::string commandText() {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 11;
+    cfg.newPct = 50;
+    cfg.cancelPct = 20;
+    cfg.queryPct = 3;
+    workload::OrderFlowGenerator gen(cfg);
+    std::string out;
+    for (int i = 0; i < 20'000; ++i) {
+        gen.appendLine(out);
+    }
+    out +=
+        "N,9000001,900001,ZZA,L,B,100.00,10\n"
+        "N,9000002,900002,ZZA,L,S,101.00,10,900050\n"
+        "S,9000004,900004,ZZA,L,S,99.00,5,100.00\n"
+        "N,9000005,900005,ZZA,L,S,100.00,20\n"
+        "M,900006,ZZA\n"
+        "X,9000099,900007\n"
+        "A,9000099,900008,ZZA,L,B,100.00,5\n"
+        "B,900009,ZZB,9000010,L,B,5.00,3,9000011,L,S,6.00,3,9000010,L,B,1.00,1\n"
+        "Q,900010,D,ZZA,5\n"
+        "C,900060,ZZB\n"
+        "C,900070,ZZA,S\n"
+        "M,900071\n"
+        "C,900072\n";
+    return out;
+}
+
+// The app's immediate path.
+std::string runImmediate(const std::string& text) {
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+    std::ostringstream out;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto cmd = parseCommandLine(line);
+        if (!cmd)
+            continue;
+        dispatcher.advanceClock(timestampOf(*cmd), out);
+        dispatcher.dispatchTo(*cmd, out);
+    }
+    return out.str();
+}
+
+std::string runDeferred(const std::string& text, std::size_t capacity, std::size_t batchBytes,
+                        ResponseWriterStats* stats = nullptr) {
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+    std::ostringstream out;
+    ResponseWriter writer(out, capacity, batchBytes);
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto cmd = parseCommandLine(line);
+        if (!cmd)
+            continue;
+        dispatcher.advanceClock(timestampOf(*cmd), writer);
+        dispatcher.dispatchDeferred(*cmd, writer);
+    }
+    writer.close();
+    if (stats)
+        *stats = writer.stats();
+    return out.str();
+}
+
+// Counts the flushes of a stream written to it.
+class FlushCountingBuf : public std::stringbuf {
+public:
+    std::atomic<int> flushes{0};
+
+protected:
+    int sync() override {
+        ++flushes;
+        return std::stringbuf::sync();
+    }
+};
+
+}  // namespace
+
+TEST(ResponseWriterTests, DeferredDispatch_MatchesImmediateOutputByteForByte) {
+    const std::string text = commandText();
+    const std::string expected = runImmediate(text);
+    ASSERT_NE(expected.find(" - Triggered\n"), std::string::npos);
+    ASSERT_NE(expected.find(" - Expired\n"), std::string::npos);
+    ASSERT_NE(expected.find("MassCancelAccept"), std::string::npos);
+
+    EXPECT_EQ(runDeferred(text, 1u << 16, 64u << 10), expected);
+
+    // a tiny ring and batch: the engine keeps waiting for the formatter
+    ResponseWriterStats stats;
+    EXPECT_EQ(runDeferred(text, 4, 16, &stats), expected);
+    EXPECT_GT(stats.records, 0u);
+    EXPECT_GT(stats.writes, 1u);
+}
+
+TEST(ResponseWriterTests, RenderResponse_FormatsEveryKind) {
+    std::string out;
+    ResponseRecord reject;
+    reject.kind = ResponseKind::Amend;
+    reject.orderId = 7;
+    reject.rejectCode = 404;
+    reject.message = "Order does not exist";
+    renderResponse(reject, out);
+
+    ResponseRecord trade;
+    trade.kind = ResponseKind::Trade;
+    trade.symbol = "XYZ";
+    trade.orderId = 1;
+    trade.buyType = domain::OrderType::Limit;
+    trade.sellType = domain::OrderType::IOC;
+    trade.sellOrderId = 2;
+    trade.quantity = 30;
+    trade.price = 10453;
+    renderResponse(trade, out);
+
+    ResponseRecord accept;
+    accept.kind = ResponseKind::New;
+    accept.accepted = true;
+    accept.orderId = 3;
+    renderResponse(accept, out);
+
+    ResponseRecord massCancel;
+    massCancel.kind = ResponseKind::MassCancel;
+    massCancel.accepted = true;
+    massCancel.scope = MassCancelScope::SymbolSide;
+    massCancel.symbol = "XYZ";
+    massCancel.side = domain::Side::Sell;
+    massCancel.count = 12;
+    renderResponse(massCancel, out);
+
+    EXPECT_EQ(out,
+              "7 - AmendReject - 404 - Order does not exist\nXYZ|1,L,30,10453|10453,30,I,2\n3 - Accept\n"
+              "XYZ,S - MassCancelAccept - 12\n");
+}
+
+TEST(ResponseWriterTests, Close_IsIdempotentAndFlushesText) {
+    std::ostringstream out;
+    ResponseWriter writer(out);
+    writer.pushText("a\nb\n");
+    ResponseRecord expired;
+    expired.kind = ResponseKind::Expired;
+    expired.orderId = 5;
+    writer.push(expired);
+    writer.close();
+    writer.close();
+    EXPECT_EQ(out.str(), "a\nb\n5 - Expired\n");
+    EXPECT_EQ(writer.stats().records, 2u);
+}
+
+TEST(ResponseWriterTests, IdleRing_FlushesBeforeClose) {
+    FlushCountingBuf buf;
+    std::ostream out(&buf);
+    ResponseWriter writer(out);
+    ResponseRecord expired;
+    expired.kind = ResponseKind::Expired;
+    expired.orderId = 5;
+    writer.push(expired);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (buf.flushes.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_GT(buf.flushes.load(), 0);
+    writer.close();
+    EXPECT_EQ(buf.str(), "5 - Expired\n");
+}
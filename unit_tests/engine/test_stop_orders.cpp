@@ -0,0 +1,258 @@
+// unit_tests/engine/test_stop_orders.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "book/stop_book.hpp"
+#include "engine/differential.hpp"
+#include "engine/dispatcher.hpp"
+#include "parser/commands_parser.hpp"
+#include "persistence/command_codec.hpp"
+#include "persistence/journal.hpp"
+#include "persistence/recovery.hpp"
+#include "test_helpers.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+domain::Order stop(domain::OrderId id, domain::Side side, const std::string& symbol = "XYZ") {
+    domain::Order o;
+    o.orderId = id;
+    o.timeStamp = id;
+    o.symbol = symbol;
+    o.orderType = domain::OrderType::Limit;
+    o.side = side;
+    o.price = 10000;
+    o.quantity = 1;
+    return o;
+}
+
+std::vector<domain::OrderId> idsOf(const std::vector<domain::Order>& orders) {
+    std::vector<domain::OrderId> ids;
+    for (const auto& o : orders) {
+        ids.push_back(o.orderId);
+    }
+    return ids;
+}
+
+// XYZ: bid 100.00 x10, asks 100.00 x5 and 101.00 x5; a buy stop-limit that triggers at
+// 100.00, a sell stop-limit that triggers at 100.50 and a buy stop far above the market.
+const std::vector<std::string> kSetup = {
+    "N,1,1,XYZ,L,B,100.00,10",    "N,2,2,XYZ,L,S,100.00,5",      "N,4,3,XYZ,L,S,101.00,5",
+    "S,3,4,XYZ,L,B,101.00,5,100.00", "S,5,5,XYZ,L,S,99.00,5,100.50", "S,6,6,XYZ,L,B,102.00,1,105.00",
+};
+
+class StopDispatchTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (const auto& line : kSetup) {
+            ASSERT_EQ(run(line), line.substr(2, 1) + " - Accept\n") << line;
+        }
+    }
+
+    std::string run(const std::string& line) {
+        const auto cmd = parseCommandLine(line);
+        EXPECT_TRUE(cmd.has_value()) << line;
+        std::ostringstream out;
+        dispatcher.dispatchTo(*cmd, out);
+        return out.str();
+    }
+
+    OrderBook book;
+    CommandDispatcher<> dispatcher{book};
+};
+
+}  // namespace
+
+TEST(StopBookTests, Release_TakesCrossedPrefixOfEachSide_InTriggerOrder) {
+    StopBook stops;
+    ASSERT_TRUE(stops.park(stop(1, domain::Side::Buy), 10100));
+    ASSERT_TRUE(stops.park(stop(2, domain::Side::Buy), 10000));
+    ASSERT_TRUE(stops.park(stop(3, domain::Side::Buy), 10100));
+    ASSERT_TRUE(stops.park(stop(4, domain::Side::Buy), 10200));
+    ASSERT_TRUE(stops.park(stop(5, domain::Side::Sell), 9900));
+    ASSERT_TRUE(stops.park(stop(6, domain::Side::Sell), 10100));
+    ASSERT_TRUE(stops.park(stop(7, domain::Side::Buy, "ABC"), 100));
+    EXPECT_FALSE(stops.park(stop(3, domain::Side::Sell), 9000));
+
+    std::vector<domain::Order> out;
+    EXPECT_EQ(stops.release("XYZ", 10100, out), 4u);
+    EXPECT_EQ(idsOf(out), (std::vector<domain::OrderId>{2, 1, 3, 6}));  // buys lowest first, FIFO at 101.00
+    EXPECT_EQ(stops.size(), 3u);
+    EXPECT_FALSE(stops.contains(1));
+
+    out.clear();
+    EXPECT_EQ(stops.release("XYZ", 10150, out), 0u);
+    EXPECT_EQ(stops.release("XYZ", 9900, out), 1u);
+    EXPECT_EQ(idsOf(out), (std::vector<domain::OrderId>{5}));
+    EXPECT_EQ(stops.release("QQQ", 9900, out), 0u);
+}
+
+TEST(StopBookTests, EraseAndCancel_VisitInTriggerOrder) {
+    StopBook stops;
+    stops.park(stop(1, domain::Side::Sell), 9900);
+    stops.park(stop(2, domain::Side::Sell), 9950);
+    stops.park(stop(3, domain::Side::Buy), 10100);
+    stops.park(stop(4, domain::Side::Buy, "ABC"), 100);
+    EXPECT_TRUE(stops.erase(3));
+    EXPECT_FALSE(stops.erase(3));
+
+    std::vector<domain::OrderId> visited;
+    auto record = [&](const domain::Order& o) { visited.push_back(o.orderId); };
+    EXPECT_EQ(stops.cancelSymbol("XYZ", domain::Side::Sell, record), 2u);
+    EXPECT_EQ(stops.cancelAll(record), 1u);
+    EXPECT_EQ(visited, (std::vector<domain::OrderId>{2, 1, 4}));
+    EXPECT_TRUE(stops.empty());
+}
+
+TEST_F(StopDispatchTests, Fill_TriggersStops_WhichTradeInTheSameMatch) {
+    EXPECT_EQ(book.liveCount(), 3u);
+    EXPECT_EQ(book.stops().size(), 3u);
+
+    EXPECT_EQ(run("M,10,XYZ"),
+              "XYZ|1,L,5,10000|10000,5,L,2\n"
+              "3 - Triggered\n"
+              "5 - Triggered\n"
+              "XYZ|3,L,5,9900|9900,5,L,5\n");
+    ASSERT_NE(book.findOrder(1), nullptr);
+    EXPECT_EQ(book.findOrder(1)->quantity, 5);
+    EXPECT_FALSE(book.isLive(3));
+    EXPECT_TRUE(book.stops().contains(6));
+
+    // 6 waits for 105.00
+    EXPECT_EQ(run("N,7,11,XYZ,L,B,101.00,5"), "7 - Accept\n");
+    EXPECT_EQ(run("M,12"), "XYZ|7,L,5,10100|10100,5,L,4\n");
+    EXPECT_TRUE(book.stops().contains(6));
+}
+
+TEST_F(StopDispatchTests, ParkedIds_CancelByXAndC_AndStayReserved) {
+    EXPECT_EQ(run("N,6,7,XYZ,L,B,99.00,1"), "6 - Reject - 303 - Invalid order details\n");
+    EXPECT_EQ(run("S,1,8,XYZ,L,B,99.00,1,105.00"), "1 - Reject - 303 - Invalid order details\n");
+    EXPECT_EQ(run("S,8,8,XYZ,L,B,99.00,1,0.00"), "8 - Reject - 303 - Invalid order details\n");
+    EXPECT_EQ(run("S,8,8,XYZ,M,B,99.00,1,105.00"), "8 - Reject - 303 - Invalid order details\n");
+
+    EXPECT_EQ(run("X,6,9"), "6 - CancelAccept\n");
+    EXPECT_EQ(run("X,6,10"), "6 - CancelReject - 404 - Order does not exist\n");
+    EXPECT_EQ(run("C,11,XYZ,S"), "2 - CancelAccept\n4 - CancelAccept\n5 - CancelAccept\nXYZ,S - MassCancelAccept - 3\n");
+    EXPECT_EQ(book.stops().size(), 1u);
+    EXPECT_EQ(run("C,12"), "1 - CancelAccept\n3 - CancelAccept\n* - MassCancelAccept - 2\n");
+    EXPECT_TRUE(book.stops().empty());
+}
+
+TEST_F(StopDispatchTests, JournalReplayAndSnapshot_KeepParkedStops) {
+    const auto dir = makeTempDir("hft_stops_", "journal");
+    {
+        persistence::JournalOptions opts;
+        opts.directory = dir;
+        opts.fsyncEnabled = false;
+        persistence::JournalWriter journal(opts);
+        dispatcher.attachJournal(&journal);
+        run("S,8,20,ABC,M,S,0.00,3,50.00");
+        run("M,21,XYZ");
+        dispatcher.attachJournal(nullptr);
+    }
+
+    // the setup was not journaled; the stops it parked have to be in the replayed book
+    OrderBook replayed;
+    CommandDispatcher<> replay(replayed);
+    for (const auto& line : kSetup) {
+        replay.apply(*parseCommandLine(line));
+    }
+    persistence::replayJournal(dir, 0, [&](std::uint64_t, const ParsedCommand& cmd) { replay.apply(cmd); });
+    std::ostringstream expected;
+    std::ostringstream actual;
+    book.dump(expected);
+    replayed.dump(actual);
+    EXPECT_EQ(actual.str(), expected.str());
+    EXPECT_NE(expected.str().find("stop=50.00"), std::string::npos);
+
+    std::stringstream ss;
+    ASSERT_TRUE(book.writeSnapshot(ss, 2));
+    OrderBook restored;
+    ASSERT_TRUE(restored.loadSnapshot(ss).has_value());
+    std::ostringstream fromSnapshot;
+    restored.dump(fromSnapshot);
+    EXPECT_EQ(fromSnapshot.str(), expected.str());
+    EXPECT_EQ(restored.stops().size(), 2u);
+}
+
+TEST(StopTriggerTests, TriggeredStop_TradesAtTheBestAsk_AndAStopAlreadyCrossedEntersAtOnce) {
+    OrderBook book;
+    CommandDispatcher<> dispatcher(book);
+    auto run = [&dispatcher](const std::string& line) {
+        std::ostringstream out;
+        dispatcher.dispatchTo(*parseCommandLine(line), out);
+        return out.str();
+    };
+    run("N,1,1,XYZ,L,B,100.00,5");
+    run("N,2,2,XYZ,L,S,100.00,5");
+    run("N,3,3,XYZ,L,S,101.00,10");
+    EXPECT_EQ(run("S,4,4,XYZ,M,B,0.00,4,100.00"), "4 - Accept\n");  // no trade yet: parked
+    EXPECT_TRUE(book.stops().contains(4));
+
+    // the BUY stop enters as a limit at the best ask and fills in the same M
+    EXPECT_EQ(run("M,5,XYZ"),
+              "XYZ|1,L,5,10000|10000,5,L,2\n"
+              "4 - Triggered\n"
+              "XYZ|4,L,4,10100|10100,4,L,3\n");
+    EXPECT_FALSE(book.isLive(4));
+    EXPECT_EQ(book.stops().lastTrade("XYZ"), 10100);
+
+    // 101.00 is at or above 100.50: in the book right away, filled by the next M
+    EXPECT_EQ(run("S,5,6,XYZ,M,B,0.00,2,100.50"), "5 - Accept\n");
+    EXPECT_FALSE(book.stops().contains(5));
+    ASSERT_NE(book.findOrder(5), nullptr);
+    EXPECT_EQ(book.findOrder(5)->price, 10100);
+    EXPECT_EQ(run("S,6,7,XYZ,M,S,0.00,1,99.00"), "6 - Accept\n");  // SELL below the last trade: parked
+    EXPECT_TRUE(book.stops().contains(6));
+    EXPECT_EQ(run("M,8,XYZ"), "XYZ|5,L,2,10100|10100,2,L,3\n");
+
+    // the last trade survives a snapshot, so a restarted book triggers the same way
+    std::stringstream ss;
+    ASSERT_TRUE(book.writeSnapshot(ss, 1));
+    OrderBook restored;
+    ASSERT_TRUE(restored.loadSnapshot(ss).has_value());
+    EXPECT_EQ(restored.stops().lastTrade("XYZ"), 10100);
+    EXPECT_EQ(restored.stops().lastTrade("ABC"), 0);
+}
+
+TEST(StopParseTests, NineFields_RoundTripThroughCodec) {
+    const auto cmd = parseCommandLine("S,3,4,XYZ,L,B,101.00,5,100.00");
+    ASSERT_TRUE(cmd.has_value());
+    const auto& req = std::get<StopOrderRequest>(*cmd);
+    EXPECT_EQ(req.order.price, 10100);
+    EXPECT_EQ(req.stopPrice, 10000);
+    EXPECT_EQ(timestampOf(*cmd), 4);
+    EXPECT_FALSE(parseCommandLine("S,3,4,XYZ,L,B,101.00,5").has_value());
+    EXPECT_FALSE(parseCommandLine("S,3,4,XYZ,L,B,101.00,5,high").has_value());
+
+    std::vector<char> bytes;
+    persistence::encodeCommand(*cmd, bytes);
+    const auto decoded = persistence::decodeCommand(bytes.data(), bytes.size());
+    ASSERT_TRUE(decoded.has_value());
+    const auto& back = std::get<StopOrderRequest>(*decoded);
+    EXPECT_EQ(back.order.orderId, 3);
+    EXPECT_EQ(back.order.symbol, "XYZ");
+    EXPECT_EQ(back.stopPrice, 10000);
+}
+
+TEST(StopDifferentialTests, IndexedBookTriggersTheSame) {
+    std::vector<std::string> lines = kSetup;
+    lines.insert(lines.end(), {
+                                  "S,9,7,XYZ,I,S,98.00,2,99.50",
+                                  "S,10,8,ABC,L,B,10.00,1,9.00",
+                                  "N,11,9,ABC,L,S,9.00,1",
+                                  "N,12,10,ABC,L,B,9.00,1",
+                                  "M,11",
+                                  "N,13,12,XYZ,L,B,99.00,3",
+                                  "M,13,XYZ",
+                                  "X,6,14",
+                                  "C,15,XYZ",
+                              });
+    const auto d = runDifferential<OrderBook, IndexedOrderBook>(lines);
+    EXPECT_FALSE(d.has_value()) << d->command << "\n" << d->expected << "\n---\n" << d->actual;
+}
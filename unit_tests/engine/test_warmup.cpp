@@ -0,0 +1,76 @@
+// unit_tests/engine/test_warmup.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "engine/differential.hpp"
+#include "engine/warmup.hpp"
+#include "workload/order_flow.hpp"
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::optional<Universe> parse(const std::string& text, std::string& error) {
+    std::istringstream is(text);
+    return parseUniverse(is, error);
+}
+
+// A warmed-up book must answer a session exactly like a fresh one.
+template <typename Book>
+void expectWarmBookMatchesColdBook() {
+    std::string error;
+    const auto universe = parse("AAA,5000\nAAB,3000\nAAC\n", error);
+    ASSERT_TRUE(universe) << error;
+
+    Book warm;
+    const WarmupResult result = warmUp(warm, *universe, 5000);
+    EXPECT_EQ(result.symbols, 3u);
+    EXPECT_EQ(result.reservedOrders, 8000u);
+    EXPECT_EQ(warm.liveCount(), 0u);
+    EXPECT_TRUE(warm.stops().empty());
+
+    Book cold;
+    CommandDispatcher<Book> warmDispatcher(warm);
+    CommandDispatcher<Book> coldDispatcher(cold);
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 7;
+    cfg.symbolNames = {"AAA", "AAB", "AAC", "ZZZ"};
+    workload::OrderFlowGenerator gen(cfg);
+    std::string line;
+    for (int i = 0; i < 3000; ++i) {
+        line.clear();
+        gen.appendLine(line);
+        line.pop_back();
+        const auto cmd = parseCommandLine(line);
+        ASSERT_TRUE(cmd);
+        ASSERT_EQ(detail::runCommand(warmDispatcher, *cmd), detail::runCommand(coldDispatcher, *cmd)) << line;
+    }
+    EXPECT_EQ(detail::bookState(warm), detail::bookState(cold));
+}
+
+}  // namespace
+
+TEST(WarmupTests, ParseUniverse_SumsExpectedOrders_SkipsComments) {
+    std::string error;
+    const auto universe = parse("# symbol,expected_orders\n\nXYZ,200\nABC\nQQ,0\n", error);
+    ASSERT_TRUE(universe) << error;
+    ASSERT_EQ(universe->symbols.size(), 3u);
+    EXPECT_EQ(universe->symbols[1], domain::Symbol("ABC"));
+    EXPECT_EQ(universe->expectedOrders, 200u);
+}
+
+TEST(WarmupTests, ParseUniverse_RejectsMalformedLines) {
+    for (const char* text : {"X1Z,10\n", "XYZ,-1\n", "XYZ,ten\n", "XYZ,1,2\n", "XYZ\nXYZ\n", "ABCDEFGHIJKLMNOP\n"}) {
+        std::string error;
+        EXPECT_FALSE(parse(text, error)) << text;
+        EXPECT_NE(error.find("line "), std::string::npos);
+    }
+}
+
+TEST(WarmupTests, WarmedUpBook_AnswersLikeAColdOne) {
+    expectWarmBookMatchesColdBook<OrderBook>();
+    expectWarmBookMatchesColdBook<IndexedOrderBook>();
+}
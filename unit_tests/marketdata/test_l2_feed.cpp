@@ -0,0 +1,350 @@
+// unit_tests/marketdata/test_l2_feed.cpp
+//
+// L2 deltas published by both book backends, and the consumer rebuilding from them.
+
+#include <gtest/gtest.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "marketdata/l2_book_builder.hpp"
+#include "marketdata/l2_codec.hpp"
+#include "marketdata/l2_feed.hpp"
+#include "parser/commands_parser.hpp"
+#include "workload/order_flow.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using marketdata::DeltaKind;
+
+domain::Order makeOrder(domain::OrderId id,
+                        domain::Side side,
+                        domain::Price priceCents,
+                        int qty = 100,
+                        const std::string& symbol = "XYZ") {
+    domain::Order o;
+    o.orderId = id;
+    o.side = side;
+    o.price = priceCents;
+    o.quantity = qty;
+    o.orderType = domain::OrderType::Limit;
+    o.symbol = symbol;
+    return o;
+}
+
+struct Recorded {
+    std::string symbol;
+    std::uint64_t seq;
+    DeltaKind kind;
+    domain::Side side;
+    domain::Price price;
+    std::int64_t quantity;
+    std::uint32_t orders;
+};
+
+class RecordingSink : public marketdata::L2Sink {
+public:
+    void onDelta(const marketdata::L2Delta& d) override {
+        deltas.push_back(Recorded{std::string(d.symbol), d.seq, d.kind, d.side, d.price, d.quantity, d.orders});
+    }
+    void onSnapshot(const marketdata::L2Snapshot& s) override { snapshots.push_back(s); }
+
+    std::vector<Recorded> deltas;
+    std::vector<marketdata::L2Snapshot> snapshots;
+};
+
+// Forwards to `next`, except the deltas whose position falls in [dropFrom, dropTo).
+class LossySink : public marketdata::L2Sink {
+public:
+    LossySink(marketdata::L2Sink& next, std::size_t dropFrom, std::size_t dropTo)
+        : m_next(next), m_dropFrom(dropFrom), m_dropTo(dropTo) {}
+
+    void onDelta(const marketdata::L2Delta& d) override {
+        const std::size_t i = m_count++;
+        if (i < m_dropFrom || i >= m_dropTo)
+            m_next.onDelta(d);
+    }
+    void onSnapshot(const marketdata::L2Snapshot& s) override { m_next.onSnapshot(s); }
+
+private:
+    marketdata::L2Sink& m_next;
+    std::size_t m_dropFrom;
+    std::size_t m_dropTo;
+    std::size_t m_count{0};
+};
+
+class TeeSink : public marketdata::L2Sink {
+public:
+    TeeSink(marketdata::L2Sink& a, marketdata::L2Sink& b)
+        : m_a(a), m_b(b) {}
+
+    void onDelta(const marketdata::L2Delta& d) override {
+        m_a.onDelta(d);
+        m_b.onDelta(d);
+    }
+    void onSnapshot(const marketdata::L2Snapshot& s) override {
+        m_a.onSnapshot(s);
+        m_b.onSnapshot(s);
+    }
+
+private:
+    marketdata::L2Sink& m_a;
+    marketdata::L2Sink& m_b;
+};
+
+std::vector<std::string> generate(std::uint64_t seed, std::size_t count) {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = seed;
+    cfg.symbols = 8;
+    cfg.depthTarget = 30;
+    cfg.queryPct = 2;
+    workload::OrderFlowGenerator gen(cfg);
+    std::vector<std::string> lines;
+    std::string line;
+    for (std::size_t i = 0; i < count; ++i) {
+        line.clear();
+        gen.appendLine(line);
+        line.pop_back();  // '\n'
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+template <typename Book>
+void run(CommandDispatcher<Book>& dispatcher, const std::string& line) {
+    const auto cmd = parseCommandLine(line);
+    if (!cmd)
+        return;
+    std::ostringstream sink;
+    dispatcher.dispatchTo(*cmd, sink);
+}
+
+template <typename Book>
+void expectSameDepth(const Book& book, const marketdata::L2BookBuilder& builder, const std::string& symbol) {
+    constexpr std::size_t kMax = 256;
+    for (const auto side : {domain::Side::Buy, domain::Side::Sell}) {
+        LevelSummary expected[kMax];
+        LevelSummary actual[kMax];
+        const std::size_t n = book.depth(symbol, side, kMax, expected);
+        ASSERT_EQ(builder.depth(symbol, side, kMax, actual), n) << symbol;
+        for (std::size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(actual[i].price, expected[i].price) << symbol << " level " << i;
+            EXPECT_EQ(actual[i].quantity, expected[i].quantity) << symbol << " level " << i;
+            EXPECT_EQ(actual[i].orders, expected[i].orders) << symbol << " level " << i;
+        }
+    }
+}
+
+template <typename Book>
+class L2FeedTests : public ::testing::Test {
+protected:
+    Book book;
+};
+
+using Backends = ::testing::Types<OrderBook, IndexedOrderBook>;
+TYPED_TEST_SUITE(L2FeedTests, Backends);
+
+}  // namespace
+
+TYPED_TEST(L2FeedTests, LevelLifecycle_AddChangeDelete_WithPerSymbolSeq) {
+    auto& book = this->book;
+    RecordingSink sink;
+    marketdata::L2Publisher publisher(sink);
+    book.attachMarketData(&publisher);
+
+    book.add(makeOrder(1, domain::Side::Buy, 10000, 10));
+    book.add(makeOrder(2, domain::Side::Buy, 10000, 15));
+    book.add(makeOrder(3, domain::Side::Sell, 10100, 5, "ABC"));
+    book.consumeBestBid(4, "XYZ");
+    book.erase(1);
+    book.erase(2);
+
+    ASSERT_EQ(sink.deltas.size(), 6u);
+    const auto& d = sink.deltas;
+    EXPECT_EQ(d[0].kind, DeltaKind::LevelAdd);
+    EXPECT_EQ(d[0].quantity, 10);
+    EXPECT_EQ(d[1].kind, DeltaKind::LevelChange);
+    EXPECT_EQ(d[1].quantity, 25);
+    EXPECT_EQ(d[1].orders, 2u);
+    EXPECT_EQ(d[2].symbol, "ABC");
+    EXPECT_EQ(d[2].seq, 1u);
+    EXPECT_EQ(d[2].side, domain::Side::Sell);
+    EXPECT_EQ(d[3].kind, DeltaKind::LevelChange);
+    EXPECT_EQ(d[3].quantity, 21);
+    EXPECT_EQ(d[4].quantity, 15);
+    EXPECT_EQ(d[4].orders, 1u);
+    EXPECT_EQ(d[5].kind, DeltaKind::LevelDelete);
+    EXPECT_EQ(d[5].quantity, 0);
+    EXPECT_EQ(d[5].seq, 5u);
+    EXPECT_EQ(publisher.seqOf("XYZ"), 5u);
+}
+
+TYPED_TEST(L2FeedTests, Relocate_ReportsBothLevels_AndSkipsUnchangedTotals) {
+    auto& book = this->book;
+    book.add(makeOrder(1, domain::Side::Sell, 10100, 10));
+    book.add(makeOrder(2, domain::Side::Sell, 10100, 10));
+
+    RecordingSink sink;
+    marketdata::L2Publisher publisher(sink);
+    book.attachMarketData(&publisher);
+
+    book.relocate(*book.getById(1), 10100, 10, 1);  // priority only
+    EXPECT_TRUE(sink.deltas.empty());
+
+    book.relocate(*book.getById(1), 10200, 7, 2);
+    ASSERT_EQ(sink.deltas.size(), 2u);
+    EXPECT_EQ(sink.deltas[0].kind, DeltaKind::LevelChange);
+    EXPECT_EQ(sink.deltas[0].price, 10100);
+    EXPECT_EQ(sink.deltas[0].quantity, 10);
+    EXPECT_EQ(sink.deltas[1].kind, DeltaKind::LevelAdd);
+    EXPECT_EQ(sink.deltas[1].price, 10200);
+    EXPECT_EQ(sink.deltas[1].quantity, 7);
+}
+
+TYPED_TEST(L2FeedTests, MatchPublishesTradeBeforeLevelChanges) {
+    auto& book = this->book;
+    CommandDispatcher<TypeParam> dispatcher(book);
+    RecordingSink sink;
+    marketdata::L2Publisher publisher(sink);
+    dispatcher.attachMarketData(&publisher);
+
+    run(dispatcher, "N,1,1,XYZ,L,B,100.00,10");
+    run(dispatcher, "N,2,2,XYZ,L,S,100.00,4");
+    sink.deltas.clear();
+    run(dispatcher, "M,3,XYZ");
+
+    ASSERT_EQ(sink.deltas.size(), 3u);
+    EXPECT_EQ(sink.deltas[0].kind, DeltaKind::Trade);
+    EXPECT_EQ(sink.deltas[0].quantity, 4);
+    EXPECT_EQ(sink.deltas[0].seq, 3u);
+    EXPECT_EQ(sink.deltas[1].kind, DeltaKind::LevelDelete);
+    EXPECT_EQ(sink.deltas[1].side, domain::Side::Sell);
+    EXPECT_EQ(sink.deltas[2].kind, DeltaKind::LevelChange);
+    EXPECT_EQ(sink.deltas[2].quantity, 6);
+}
+
+TYPED_TEST(L2FeedTests, MassCancel_DeletesEveryLevelItDrops) {
+    auto& book = this->book;
+    CommandDispatcher<TypeParam> dispatcher(book);
+    marketdata::L2BookBuilder builder;
+    marketdata::L2Publisher publisher(builder);
+    dispatcher.attachMarketData(&publisher);
+
+    run(dispatcher, "N,1,1,XYZ,L,B,100.00,10");
+    run(dispatcher, "N,2,2,XYZ,L,B,99.00,10");
+    run(dispatcher, "N,3,3,ABC,L,S,50.00,10");
+    run(dispatcher, "C,4,XYZ,B");
+    expectSameDepth(book, builder, "XYZ");
+    EXPECT_EQ(publisher.seqOf("XYZ"), 4u);
+
+    run(dispatcher, "C,5");
+    expectSameDepth(book, builder, "ABC");
+    EXPECT_TRUE(builder.isLive("ABC"));
+}
+
+TYPED_TEST(L2FeedTests, BuilderTracksGeneratedFlow) {
+    auto& book = this->book;
+    CommandDispatcher<TypeParam> dispatcher(book);
+    marketdata::L2BookBuilder builder;
+    marketdata::L2Publisher publisher(builder);
+    dispatcher.attachMarketData(&publisher);
+
+    const auto lines = generate(7, 5000);
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        run(dispatcher, lines[i]);
+        if (i % 500 == 499) {
+            for (std::uint32_t s = 0; s < 8; ++s) {
+                expectSameDepth(book, builder, workload::symbolName(s));
+            }
+        }
+    }
+    EXPECT_EQ(builder.gaps(), 0u);
+}
+
+TYPED_TEST(L2FeedTests, DroppedDeltas_MarkStale_NextSnapshotRecovers) {
+    auto& book = this->book;
+    CommandDispatcher<TypeParam> dispatcher(book);
+    marketdata::L2BookBuilder builder;
+    LossySink lossy(builder, 1000, 1100);
+    marketdata::L2Publisher publisher(lossy, 50);
+    dispatcher.attachMarketData(&publisher);
+
+    const auto lines = generate(11, 4000);
+    for (const auto& line : lines) {
+        run(dispatcher, line);
+    }
+    // every symbol took far more than 50 deltas after the loss, so a snapshot followed it
+    EXPECT_GT(builder.gaps(), 0u);
+    for (std::uint32_t s = 0; s < 8; ++s) {
+        const std::string symbol = workload::symbolName(s);
+        EXPECT_TRUE(builder.isLive(symbol)) << symbol;
+        EXPECT_EQ(builder.seqOf(symbol), publisher.seqOf(symbol)) << symbol;
+        expectSameDepth(book, builder, symbol);
+    }
+}
+
+TYPED_TEST(L2FeedTests, BinaryStream_ReplaysToTheSameLevels) {
+    auto& book = this->book;
+    CommandDispatcher<TypeParam> dispatcher(book);
+    std::ostringstream os;
+    marketdata::L2StreamSink stream(os);
+    marketdata::L2BookBuilder direct;
+    TeeSink tee(stream, direct);
+    marketdata::L2Publisher publisher(tee, 200);
+    dispatcher.attachMarketData(&publisher);
+
+    for (const auto& line : generate(3, 3000)) {
+        run(dispatcher, line);
+    }
+    EXPECT_GT(stream.snapshots(), 8u);
+
+    std::istringstream is(os.str());
+    marketdata::L2BookBuilder replayed;
+    ASSERT_TRUE(marketdata::readL2Stream(is, replayed));
+    for (std::uint32_t s = 0; s < 8; ++s) {
+        const std::string symbol = workload::symbolName(s);
+        EXPECT_EQ(replayed.seqOf(symbol), direct.seqOf(symbol));
+        expectSameDepth(book, replayed, symbol);
+    }
+}
+
+TEST(L2CodecTests, DeltaAndSnapshotRoundTrip_RejectTruncation) {
+    marketdata::L2Delta trade;
+    trade.symbol = "XYZ";
+    trade.seq = 300;
+    trade.kind = DeltaKind::Trade;
+    trade.price = 10050;
+    trade.quantity = 7;
+    trade.buyOrderId = 11;
+    trade.sellOrderId = 12;
+
+    std::vector<char> buf;
+    marketdata::encodeDelta(trade, buf);
+    marketdata::L2Delta back;
+    ASSERT_TRUE(marketdata::decodeDelta(buf.data(), buf.size(), back));
+    EXPECT_EQ(back.symbol, "XYZ");
+    EXPECT_EQ(back.seq, 300u);
+    EXPECT_EQ(back.kind, DeltaKind::Trade);
+    EXPECT_EQ(back.price, 10050);
+    EXPECT_EQ(back.quantity, 7);
+    EXPECT_EQ(back.buyOrderId, 11);
+    EXPECT_EQ(back.sellOrderId, 12);
+    EXPECT_FALSE(marketdata::decodeDelta(buf.data(), buf.size() - 1, back));
+
+    marketdata::L2Snapshot snap{"ABC", 42, {{10000, 25, 2}, {9900, 5, 1}}, {{10100, 8, 1}}};
+    buf.clear();
+    marketdata::encodeSnapshot(snap, buf);
+    marketdata::L2Snapshot snapBack;
+    ASSERT_TRUE(marketdata::decodeSnapshot(buf.data(), buf.size(), snapBack));
+    EXPECT_EQ(snapBack.symbol, "ABC");
+    EXPECT_EQ(snapBack.seq, 42u);
+    ASSERT_EQ(snapBack.bids.size(), 2u);
+    EXPECT_EQ(snapBack.bids[1].price, 9900);
+    ASSERT_EQ(snapBack.asks.size(), 1u);
+    EXPECT_EQ(snapBack.asks[0].quantity, 8);
+    EXPECT_FALSE(marketdata::decodeSnapshot(buf.data(), buf.size() - 1, snapBack));
+}
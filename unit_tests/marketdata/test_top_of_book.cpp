@@ -0,0 +1,207 @@
+// unit_tests/marketdata/test_top_of_book.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "marketdata/l2_feed.hpp"
+#include "marketdata/top_of_book.hpp"
+#include "parser/commands_parser.hpp"
+#include "workload/order_flow.hpp"
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using marketdata::TopOfBook;
+using marketdata::TopOfBookTable;
+
+LevelSummary level(domain::Price price, std::int64_t qty, std::uint32_t orders = 1) {
+    return LevelSummary{price, qty, orders};
+}
+
+template <typename Book>
+std::string dispatchLine(CommandDispatcher<Book>& dispatcher, const std::string& line) {
+    const auto cmd = parseCommandLine(line);
+    if (!cmd)
+        return {};
+    if (std::holds_alternative<MatchRequest>(*cmd)) {
+        (void)dispatcher.dispatchMatch(*cmd);
+        return {};
+    }
+    if (std::holds_alternative<QueryRequest>(*cmd))
+        return {};
+    return dispatcher.dispatch(*cmd);
+}
+
+template <typename Book>
+class TopOfBookDispatchTests : public ::testing::Test {
+protected:
+    Book book;
+};
+
+using Backends = ::testing::Types<OrderBook, IndexedOrderBook>;
+TYPED_TEST_SUITE(TopOfBookDispatchTests, Backends);
+
+}  // namespace
+
+TEST(TopOfBookTableTests, ManyWritesBeforeDrain_DeliverOnlyTheLatest) {
+    TopOfBookTable table(8);
+    const auto xyz = table.slotOf("XYZ");
+    const auto abc = table.slotOf("ABC");
+    for (int i = 1; i <= 100; ++i) {
+        table.write(xyz, level(10000, i), level(10100, 5));
+    }
+    table.write(abc, level(5000, 1), LevelSummary{});
+
+    std::map<std::string, TopOfBook> seen;
+    EXPECT_EQ(table.drain([&](const TopOfBook& t) { seen[std::string(t.symbol)] = t; }), 2u);
+    EXPECT_EQ(seen["XYZ"].bid.quantity, 100);
+    EXPECT_EQ(seen["XYZ"].updates, 100u);
+    EXPECT_EQ(seen["ABC"].ask.orders, 0u);
+    EXPECT_EQ(table.drain([](const TopOfBook&) {}), 0u);
+
+    table.write(xyz, level(10000, 7), level(10100, 5));
+    EXPECT_EQ(table.drain([](const TopOfBook&) {}), 1u);
+}
+
+TEST(TopOfBookTableTests, Full_RejectsNewSymbols) {
+    TopOfBookTable table(2);
+    EXPECT_EQ(table.slotOf("AAA"), 0);
+    EXPECT_EQ(table.slotOf("BBB"), 1);
+    EXPECT_EQ(table.slotOf("CCC"), -1);
+    EXPECT_EQ(table.slotOf("AAA"), 0);
+    EXPECT_EQ(table.slotOf("SIXTEEN_CHARS_XX"), -1);
+}
+
+TEST(TopOfBookTableTests, SharedSegment_ReaderSeesWriterValues) {
+    const std::string name = "/hft_top_test_" + std::to_string(::getpid());
+    auto writer = TopOfBookTable::createShared(name, 16);
+    ASSERT_NE(writer, nullptr);
+    auto reader = TopOfBookTable::openShared(name);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(reader->capacity(), 16u);
+
+    writer->write(writer->slotOf("XYZ"), level(10000, 3), level(10200, 4, 2));
+    TopOfBook top;
+    ASSERT_TRUE(reader->latest("XYZ", top));
+    EXPECT_EQ(top.ask.orders, 2u);
+    EXPECT_FALSE(reader->latest("ABC", top));
+
+    std::size_t n = reader->drain([&](const TopOfBook& t) {
+        EXPECT_EQ(t.symbol, "XYZ");
+        EXPECT_EQ(t.bid.price, 10000);
+    });
+    EXPECT_EQ(n, 1u);
+
+    reader.reset();
+    writer.reset();
+    EXPECT_EQ(TopOfBookTable::openShared(name), nullptr);  // the creator unlinked it
+}
+
+TEST(TopOfBookTableTests, ConcurrentReader_NeverSeesTornValues) {
+    TopOfBookTable table(4);
+    const std::int32_t slots[2] = {table.slotOf("AAA"), table.slotOf("BBB")};
+    constexpr int kWrites = 200'000;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::int64_t last[2] = {0, 0};
+
+    std::thread reader([&] {
+        auto check = [&](const TopOfBook& t) {
+            // the writer keeps every field of a value equal to the same counter
+            if (t.bid.quantity != t.ask.quantity || t.bid.price != t.bid.quantity ||
+                static_cast<std::int64_t>(t.updates) != t.bid.quantity)
+                ++torn;
+            std::int64_t& l = last[t.symbol == "AAA" ? 0 : 1];
+            if (t.bid.quantity < l)
+                ++torn;
+            l = t.bid.quantity;
+        };
+        while (!done.load(std::memory_order_acquire)) {
+            table.drain(check);
+        }
+        table.drain(check);
+    });
+    for (int i = 1; i <= kWrites; ++i) {
+        const std::int32_t slot = slots[i & 1];
+        const std::int64_t v = (i + 1) / 2;  // per-slot write counter
+        table.write(slot, level(v, v), level(v, v));
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(last[0], kWrites / 2);
+    EXPECT_EQ(last[1], kWrites / 2);
+}
+
+TYPED_TEST(TopOfBookDispatchTests, OnlyTopChangesAreWritten) {
+    CommandDispatcher<TypeParam> dispatcher(this->book);
+    TopOfBookTable table(8);
+    marketdata::TopOfBookConflator conflator(table);
+    marketdata::L2Publisher publisher(conflator);
+    dispatcher.attachMarketData(&publisher);
+    dispatcher.attachTopOfBook(&conflator);
+
+    dispatchLine(dispatcher, "N,1,1,XYZ,L,B,100.00,10");
+    dispatchLine(dispatcher, "N,2,2,XYZ,L,S,101.00,10");
+    EXPECT_EQ(conflator.writes(), 2u);
+    dispatchLine(dispatcher, "N,3,3,XYZ,L,B,99.00,10");  // behind the best bid
+    dispatchLine(dispatcher, "N,4,4,XYZ,L,S,102.00,10");
+    EXPECT_EQ(conflator.writes(), 2u);
+    dispatchLine(dispatcher, "X,1,5");  // best bid gone, 99.00 takes over
+    EXPECT_EQ(conflator.writes(), 3u);
+
+    TopOfBook top;
+    ASSERT_TRUE(table.latest("XYZ", top));
+    EXPECT_EQ(top.bid.price, 9900);
+    EXPECT_EQ(top.ask.price, 10100);
+    EXPECT_EQ(table.drain([](const TopOfBook&) {}), 1u);
+}
+
+TYPED_TEST(TopOfBookDispatchTests, GeneratedFlow_TableMatchesBookTops) {
+    CommandDispatcher<TypeParam> dispatcher(this->book);
+    TopOfBookTable table(64);
+    marketdata::TopOfBookConflator conflator(table);
+    marketdata::L2Publisher publisher(conflator);
+    dispatcher.attachMarketData(&publisher);
+    dispatcher.attachTopOfBook(&conflator);
+
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 5;
+    cfg.symbols = 12;
+    workload::OrderFlowGenerator gen(cfg);
+    std::string line;
+    std::size_t drained = 0;
+    for (int i = 0; i < 6000; ++i) {
+        line.clear();
+        gen.appendLine(line);
+        line.pop_back();
+        dispatchLine(dispatcher, line);
+        if (i % 100 == 0)
+            drained += table.drain([](const TopOfBook&) {});
+    }
+    EXPECT_LT(drained, conflator.writes());  // conflated
+
+    for (std::uint32_t s = 0; s < cfg.symbols; ++s) {
+        const std::string symbol = workload::symbolName(s);
+        TopOfBook top;
+        if (!table.latest(symbol, top))
+            continue;
+        LevelSummary bid{};
+        LevelSummary ask{};
+        this->book.depth(symbol, domain::Side::Buy, 1, &bid);
+        this->book.depth(symbol, domain::Side::Sell, 1, &ask);
+        EXPECT_EQ(top.bid.price, bid.price) << symbol;
+        EXPECT_EQ(top.bid.quantity, bid.quantity) << symbol;
+        EXPECT_EQ(top.bid.orders, bid.orders) << symbol;
+        EXPECT_EQ(top.ask.price, ask.price) << symbol;
+        EXPECT_EQ(top.ask.quantity, ask.quantity) << symbol;
+    }
+}
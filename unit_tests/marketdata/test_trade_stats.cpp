@@ -0,0 +1,125 @@
+// unit_tests/marketdata/test_trade_stats.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/indexed_order_book.hpp"
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "marketdata/trade_stats.hpp"
+#include "parser/commands_parser.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename Book>
+std::vector<std::string> run(CommandDispatcher<Book>& dispatcher, const std::vector<std::string>& lines) {
+    std::vector<std::string> fills;
+    for (const auto& line : lines) {
+        const auto cmd = parseCommandLine(line);
+        if (!cmd)
+            continue;
+        if (std::holds_alternative<MatchRequest>(*cmd)) {
+            for (auto& f : dispatcher.dispatchMatch(*cmd)) {
+                fills.push_back(std::move(f));
+            }
+        } else {
+            (void)dispatcher.dispatch(*cmd);
+        }
+    }
+    return fills;
+}
+
+template <typename Book>
+class TradeStatsDispatchTests : public ::testing::Test {
+protected:
+    Book book;
+};
+
+using Backends = ::testing::Types<OrderBook, IndexedOrderBook>;
+TYPED_TEST_SUITE(TradeStatsDispatchTests, Backends);
+
+}  // namespace
+
+TEST(TradeStatsTests, Record_UpdatesOhlcVolumeVwapAndFillTypes) {
+    marketdata::TradeStats stats;
+    const auto id = stats.idOf("XYZ");
+    EXPECT_EQ(stats.idOf("ABC"), id + 1);
+    EXPECT_EQ(stats.idOf("XYZ"), id);
+
+    stats.record(id, 10, 10000, 10, domain::OrderType::Limit, domain::OrderType::Limit);
+    stats.record(id, 11, 10200, 30, domain::OrderType::Market, domain::OrderType::Limit);
+    stats.record(id, 12, 9900, 10, domain::OrderType::IOC, domain::OrderType::Limit);
+
+    const auto* s = stats.find("XYZ");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->session.start, 10);
+    EXPECT_EQ(s->session.open, 10000);
+    EXPECT_EQ(s->session.high, 10200);
+    EXPECT_EQ(s->session.low, 9900);
+    EXPECT_EQ(s->session.close, 9900);
+    EXPECT_EQ(s->session.volume, 50);
+    EXPECT_EQ(s->session.trades, 3u);
+    EXPECT_DOUBLE_EQ(s->session.vwap(), (10000.0 * 10 + 10200.0 * 30 + 9900.0 * 10) / 50);
+    EXPECT_EQ(s->fillsByType[static_cast<std::size_t>(domain::OrderType::Limit)], 4u);
+    EXPECT_EQ(s->fillsByType[static_cast<std::size_t>(domain::OrderType::Market)], 1u);
+    EXPECT_EQ(s->fillsByType[static_cast<std::size_t>(domain::OrderType::IOC)], 1u);
+    EXPECT_EQ(stats.find("QQQ"), nullptr);
+}
+
+TEST(TradeStatsTests, Buckets_CloseOnNextBucketAndExport) {
+    marketdata::TradeStats stats(100);
+    const auto id = stats.idOf("XYZ");
+    stats.record(id, 105, 10000, 1, domain::OrderType::Limit, domain::OrderType::Limit);
+    stats.record(id, 199, 10100, 2, domain::OrderType::Limit, domain::OrderType::Limit);
+    EXPECT_TRUE(stats.bars().empty());
+    stats.record(id, 250, 9900, 3, domain::OrderType::Limit, domain::OrderType::Limit);
+    ASSERT_EQ(stats.bars().size(), 1u);
+    EXPECT_EQ(stats.bars()[0].bar.start, 100);
+    EXPECT_EQ(stats.bars()[0].bar.close, 10100);
+    EXPECT_EQ(stats.bars()[0].bar.volume, 3);
+
+    stats.closeBuckets();
+    ASSERT_EQ(stats.bars().size(), 2u);
+    EXPECT_EQ(stats.bars()[1].bar.start, 200);
+
+    std::ostringstream os;
+    stats.writeBarsCsv(os);
+    EXPECT_EQ(os.str(),
+              "symbol,start,open,high,low,close,volume,notional,vwap,trades\n"
+              "XYZ,100,100.00,101.00,100.00,101.00,3,302.00,100.6667,2\n"
+              "XYZ,200,99.00,99.00,99.00,99.00,3,297.00,99.0000,1\n");
+}
+
+TYPED_TEST(TradeStatsDispatchTests, MatchFeedsStats_ForSymbolAndMatchAll) {
+    CommandDispatcher<TypeParam> dispatcher(this->book);
+    marketdata::TradeStats stats;
+    dispatcher.attachTradeStats(&stats);
+
+    const auto fills = run(dispatcher,
+                           {
+                               "N,1,1,XYZ,L,B,101.00,7",
+                               "N,2,2,XYZ,L,S,100.00,4",
+                               "N,3,3,XYZ,L,S,100.50,3",
+                               "M,4,XYZ",
+                               "N,4,5,ABC,I,B,50.00,5",
+                               "N,5,6,ABC,L,S,49.50,5",
+                               "M,7",
+                               "M,8,QQQ",
+                           });
+    ASSERT_EQ(fills.size(), 3u);
+
+    const auto* xyz = stats.find("XYZ");
+    ASSERT_NE(xyz, nullptr);
+    EXPECT_EQ(xyz->session.trades, 2u);
+    EXPECT_EQ(xyz->session.volume, 7);
+    EXPECT_EQ(xyz->session.start, 4);
+    const auto* abc = stats.find("ABC");
+    ASSERT_NE(abc, nullptr);
+    EXPECT_EQ(abc->session.close, 4950);
+    EXPECT_EQ(abc->fillsByType[static_cast<std::size_t>(domain::OrderType::IOC)], 1u);
+    EXPECT_EQ(stats.find("QQQ"), nullptr);  // matched nothing, never allocated
+    EXPECT_EQ(stats.symbolCount(), 2u);
+}
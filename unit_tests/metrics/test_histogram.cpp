@@ -0,0 +1,111 @@
+// unit_tests/metrics/test_histogram.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "metrics/histogram.hpp"
+
+#include <sstream>
+
+using metrics::LogLinearHistogram;
+
+TEST(LogLinearHistogramTests, SmallValues_AreExact) {
+    LogLinearHistogram h;
+    for (std::uint64_t v = 0; v < 64; ++v) {
+        h.record(v);
+    }
+    EXPECT_EQ(h.count(), 64u);
+    EXPECT_EQ(h.min(), 0u);
+    EXPECT_EQ(h.max(), 63u);
+    EXPECT_EQ(h.valueAtPercentile(50.0), 31u);
+    EXPECT_EQ(h.valueAtPercentile(100.0), 63u);
+}
+
+TEST(LogLinearHistogramTests, BucketEdges_AreContiguousAndBounded) {
+    for (std::uint64_t v : {64ull, 127ull, 128ull, 1000ull, 123456789ull, ~0ull}) {
+        const auto b = LogLinearHistogram::bucketOf(v);
+        ASSERT_LT(b, LogLinearHistogram::kBuckets);
+        const auto high = LogLinearHistogram::bucketHigh(b);
+        EXPECT_GE(high, v);
+        EXPECT_LE(static_cast<double>(high - v), static_cast<double>(v) / 64.0) << v;
+        if (high != ~0ull) {
+            EXPECT_EQ(LogLinearHistogram::bucketOf(high + 1), b + 1);
+        }
+    }
+}
+
+TEST(LogLinearHistogramTests, Percentiles_WithinRelativeError) {
+    LogLinearHistogram h;
+    for (std::uint64_t v = 1; v <= 100'000; ++v) {
+        h.record(v);
+    }
+    EXPECT_NEAR(static_cast<double>(h.valueAtPercentile(50.0)), 50'000.0, 50'000.0 / 64);
+    EXPECT_NEAR(static_cast<double>(h.valueAtPercentile(99.0)), 99'000.0, 99'000.0 / 64);
+    EXPECT_NEAR(static_cast<double>(h.valueAtPercentile(99.9)), 99'900.0, 99'900.0 / 64);
+    EXPECT_EQ(h.valueAtPercentile(100.0), 100'000u);
+    EXPECT_DOUBLE_EQ(h.mean(), 50'000.5);
+}
+
+TEST(LogLinearHistogramTests, MergeAndReset) {
+    LogLinearHistogram a;
+    LogLinearHistogram b;
+    a.record(10);
+    b.record(5000);
+    a.merge(b);
+    EXPECT_EQ(a.count(), 2u);
+    EXPECT_EQ(a.min(), 10u);
+    EXPECT_EQ(a.max(), 5000u);
+
+    a.reset();
+    EXPECT_EQ(a.count(), 0u);
+    EXPECT_EQ(a.valueAtPercentile(99.0), 0u);
+}
+
+#if HFT_LATENCY_METRICS
+TEST(DispatchMetricsTests, Dispatcher_RecordsPerTypeAndOutcome) {
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+
+    domain::Order buy;
+    buy.orderId = 1;
+    buy.timeStamp = 1;
+    buy.symbol = "XYZ";
+    buy.side = domain::Side::Buy;
+    buy.price = 10000;
+    buy.quantity = 10;
+    auto sell = buy;
+    sell.orderId = 2;
+    sell.side = domain::Side::Sell;
+
+    dispatcher.dispatch(buy);
+    dispatcher.dispatch(sell);
+    dispatcher.dispatch(buy);  // duplicate -> reject
+    dispatcher.dispatch(CancelRequest{99, 2});
+    dispatcher.dispatchMatch(MatchRequest{3, std::nullopt});
+
+    const auto* m = dispatcher.latencyMetrics();
+    ASSERT_NE(m, nullptr);
+    EXPECT_EQ(m->latency(metrics::MessageType::New, true).count(), 2u);
+    EXPECT_EQ(m->latency(metrics::MessageType::New, false).count(), 1u);
+    EXPECT_EQ(m->latency(metrics::MessageType::Cancel, false).count(), 1u);
+    EXPECT_EQ(m->latency(metrics::MessageType::Match, true).count(), 1u);
+    EXPECT_EQ(m->fillsPerMatch().max(), 1u);
+
+    std::ostringstream oss;
+    dispatcher.reportLatency(oss);
+    EXPECT_NE(oss.str().find("N accept"), std::string::npos);
+    EXPECT_NE(oss.str().find("X reject"), std::string::npos);
+    EXPECT_NE(oss.str().find("M fills"), std::string::npos);
+}
+
+TEST(DispatchMetricsTests, Sampling_TimesEveryNthMessage) {
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+    dispatcher.setLatencySampling(4);
+    for (int i = 0; i < 100; ++i) {
+        dispatcher.dispatch(CancelRequest{i + 1, i});
+    }
+    EXPECT_EQ(dispatcher.latencyMetrics()->latency(metrics::MessageType::Cancel, false).count(), 25u);
+}
+#endif
@@ -0,0 +1,73 @@
+// unit_tests/metrics/test_perf_counters.cpp
+
+#include <gtest/gtest.h>
+
+#include "metrics/perf_counters.hpp"
+
+#include <sstream>
+#include <vector>
+
+using metrics::PerfEvent;
+
+TEST(PerfCountersTests, Reading_DeltaAndAccumulate) {
+    metrics::PerfReading a;
+    metrics::PerfReading b;
+    a.values[0] = 10;
+    b.values[0] = 25;
+    b.values[3] = 7;
+
+    auto d = b - a;
+    EXPECT_EQ(d[PerfEvent::Cycles], 15u);
+    EXPECT_EQ(d[PerfEvent::LlcMisses], 7u);
+    d += d;
+    EXPECT_EQ(d[PerfEvent::Cycles], 30u);
+}
+
+// Must work on any host: with counters they move, without them everything reads 0.
+TEST(PerfCountersTests, Counters_DegradeGracefully) {
+    metrics::PerfCounters counters;
+    counters.start();
+    const auto begin = counters.read();
+    std::vector<char> touched(8u << 20, 1);  // fresh pages => page faults
+    const auto end = counters.read();
+    counters.stop();
+
+    const auto delta = end - begin;
+    if (!counters.available()) {
+        EXPECT_FALSE(counters.hardwareAvailable());
+        EXPECT_EQ(delta[PerfEvent::PageFaults], 0u);
+        return;
+    }
+    if (counters.has(PerfEvent::PageFaults)) {
+        EXPECT_GT(delta[PerfEvent::PageFaults], 0u);
+    }
+    if (counters.has(PerfEvent::Instructions)) {
+        EXPECT_GT(delta[PerfEvent::Instructions], 0u);
+    }
+    if (!counters.hardwareAvailable()) {
+        EXPECT_FALSE(counters.unavailableReason().empty());
+    }
+    EXPECT_EQ(touched.back(), 1);
+}
+
+TEST(PerfCountersTests, ByType_ReportsPerCommandAverages) {
+    metrics::PerfCounters counters;
+    metrics::PerfByType byType;
+    metrics::PerfReading r;
+    r.values[static_cast<std::size_t>(PerfEvent::PageFaults)] = 30;
+    byType.add(metrics::MessageType::Cancel, r);
+    byType.add(metrics::MessageType::Cancel, r);
+
+    EXPECT_EQ(byType.commands(metrics::MessageType::Cancel), 2u);
+    EXPECT_EQ(byType.total(metrics::MessageType::Cancel)[PerfEvent::PageFaults], 60u);
+    EXPECT_EQ(byType.commands(metrics::MessageType::New), 0u);
+
+    std::ostringstream oss;
+    byType.report(oss, counters);
+    const auto text = oss.str();
+    EXPECT_NE(text.find("\nX "), std::string::npos);
+    EXPECT_EQ(text.find("\nN "), std::string::npos);
+    if (!counters.has(PerfEvent::Cycles)) {
+        EXPECT_NE(text.find("n/a"), std::string::npos);
+    }
+}
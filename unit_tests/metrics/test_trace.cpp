@@ -0,0 +1,127 @@
+// unit_tests/metrics/test_trace.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "metrics/trace.hpp"
+#include "parser/commands_parser.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::size_t countOf(const std::string& haystack, const std::string& needle) {
+    std::size_t n = 0;
+    for (auto pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+std::string exportTrace() {
+    std::ostringstream oss;
+    metrics::writeChromeTrace(oss);
+    return oss.str();
+}
+
+// RAII so a failing test never leaves tracing on for the next one.
+struct TracingSession {
+    TracingSession(std::uint32_t sampleEvery, std::size_t capacity) {
+        metrics::clearStageTraces();
+        metrics::enableStageTracing(sampleEvery, capacity);
+    }
+    ~TracingSession() {
+        metrics::disableStageTracing();
+        metrics::clearStageTraces();
+    }
+};
+
+}  // namespace
+
+TEST(StageTraceTests, ProbesOutsideMessage_RecordNothing) {
+    TracingSession session(1, 64);
+    {
+        metrics::ScopedStage stage(metrics::Stage::Book);
+    }
+    EXPECT_EQ(metrics::t_trace.head, 0u);
+}
+
+TEST(StageTraceTests, Sampling_TracesOneInN) {
+    TracingSession session(3, 64);
+    for (int i = 0; i < 9; ++i) {
+        metrics::ScopedMessage msg;
+        metrics::ScopedStage stage(metrics::Stage::Parse);
+    }
+    EXPECT_EQ(metrics::t_trace.head, 6u);  // 3 messages x (parse + message)
+
+    const auto json = exportTrace();
+    EXPECT_EQ(countOf(json, "\"name\":\"parse\""), 3u);
+    EXPECT_EQ(countOf(json, "\"name\":\"message\""), 3u);
+    EXPECT_NE(json.find("\"msg\":3"), std::string::npos);
+    EXPECT_NE(json.find("\"msg\":9"), std::string::npos);
+}
+
+TEST(StageTraceTests, Ring_KeepsNewestEvents) {
+    TracingSession session(1, 4);
+    for (int i = 0; i < 10; ++i) {
+        metrics::ScopedMessage msg;
+    }
+    const auto json = exportTrace();
+    EXPECT_EQ(countOf(json, "\"ph\":\"X\""), 4u);
+    EXPECT_EQ(json.find("\"msg\":6,"), std::string::npos);
+    EXPECT_NE(json.find("\"msg\":7,"), std::string::npos);
+    EXPECT_NE(json.find("\"msg\":10,"), std::string::npos);
+}
+
+TEST(StageTraceTests, Disabled_RecordsNothing) {
+    metrics::clearStageTraces();
+    {
+        metrics::ScopedMessage msg;
+        metrics::ScopedStage stage(metrics::Stage::Book);
+    }
+    EXPECT_EQ(countOf(exportTrace(), "\"ph\":\"X\""), 0u);
+}
+
+TEST(StageTraceTests, ExitedThread_StillExported) {
+    metrics::clearStageTraces();
+    std::thread worker([] {
+        metrics::enableStageTracing(1, 16);
+        metrics::ScopedMessage msg;
+    });
+    worker.join();
+
+    const auto json = exportTrace();
+    EXPECT_EQ(countOf(json, "\"name\":\"thread_name\""), 1u);
+    EXPECT_EQ(countOf(json, "\"name\":\"message\""), 1u);
+    metrics::clearStageTraces();
+}
+
+#if HFT_STAGE_TRACING
+TEST(StageTraceTests, Pipeline_RecordsEveryStage) {
+    TracingSession session(1, 256);
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+
+    for (const char* line : {"N,1,1,XYZ,L,B,100.00,10", "N,2,2,XYZ,L,S,99.00,10", "M,3"}) {
+        HFT_TRACE_MESSAGE();
+        const auto cmd = parseCommandLine(line);
+        ASSERT_TRUE(cmd.has_value());
+        if (std::holds_alternative<MatchRequest>(*cmd))
+            dispatcher.dispatchMatch(*cmd);
+        else
+            dispatcher.dispatch(*cmd);
+    }
+
+    const auto json = exportTrace();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(countOf(json, "\"name\":\"message\""), 3u);
+    EXPECT_EQ(countOf(json, "\"name\":\"tokenize\""), 3u);
+    EXPECT_EQ(countOf(json, "\"name\":\"parse\""), 3u);
+    EXPECT_EQ(countOf(json, "\"name\":\"validate\""), 2u);  // M has no validation step
+    EXPECT_EQ(countOf(json, "\"name\":\"book\""), 3u);
+    EXPECT_EQ(countOf(json, "\"name\":\"format\""), 3u);
+}
+#endif
@@ -0,0 +1,103 @@
+// unit_tests/parser/test_chunked_parser.cpp
+
+#include <gtest/gtest.h>
+
+#include "parser/chunked_parser.hpp"
+#include "workload/order_flow.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string generated(std::size_t lines) {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 5;
+    cfg.queryPct = 5;
+    workload::OrderFlowGenerator gen(cfg);
+    std::string out;
+    for (std::size_t i = 0; i < lines; ++i) {
+        gen.appendLine(out);
+        if (i % 97 == 0)
+            out += "garbage line\n\n";
+    }
+    out += "M,99999999";  // no trailing newline
+    return out;
+}
+
+struct Flat {
+    std::vector<std::string> lines;
+    std::vector<std::optional<ParsedCommand>> commands;
+};
+
+Flat sequential(const std::string& text) {
+    Flat flat;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty())
+            continue;
+        flat.lines.push_back(line);
+        flat.commands.push_back(parseCommandLine(line));
+    }
+    return flat;
+}
+
+Flat chunked(const std::string& text, const ChunkedParserOptions& options) {
+    Flat flat;
+    std::istringstream in(text);
+    ChunkedParser parser(in, options);
+    ParsedChunk chunk;
+    std::uint64_t expectedIndex = 0;
+    while (parser.next(chunk)) {
+        EXPECT_EQ(chunk.index, expectedIndex++);
+        EXPECT_EQ(chunk.lines.size(), chunk.commands.size());
+        for (std::size_t i = 0; i < chunk.lines.size(); ++i) {
+            flat.lines.emplace_back(chunk.lines[i]);
+            flat.commands.push_back(chunk.commands[i]);
+        }
+    }
+    return flat;
+}
+
+}  // namespace
+
+TEST(ChunkedParserTests, AnyThreadCountAndChunkSize_MatchesSequentialParse) {
+    const std::string text = generated(5000);
+    const Flat expected = sequential(text);
+    for (std::size_t threads : {1u, 3u, 8u}) {
+        for (std::size_t chunkBytes : {1u, 100u, 64u * 1024}) {
+            const Flat actual = chunked(text, ChunkedParserOptions{.threads = threads, .chunkBytes = chunkBytes, .maxChunksAhead = 3});
+            ASSERT_EQ(actual.lines, expected.lines) << threads << " threads, " << chunkBytes << " bytes";
+            for (std::size_t i = 0; i < expected.commands.size(); ++i) {
+                ASSERT_EQ(actual.commands[i].has_value(), expected.commands[i].has_value()) << expected.lines[i];
+                if (expected.commands[i]) {
+                    ASSERT_EQ(actual.commands[i]->index(), expected.commands[i]->index());
+                    ASSERT_EQ(timestampOf(*actual.commands[i]), timestampOf(*expected.commands[i]));
+                }
+            }
+        }
+    }
+}
+
+TEST(ChunkedParserTests, EmptyInput_EndsAtOnce) {
+    std::istringstream in("");
+    ChunkedParser parser(in);
+    ParsedChunk chunk;
+    EXPECT_FALSE(parser.next(chunk));
+    EXPECT_FALSE(parser.next(chunk));
+}
+
+TEST(ChunkedParserTests, StoppingEarly_JoinsTheWorkers) {
+    const std::string text = generated(2000);
+    std::istringstream in(text);
+    {
+        ChunkedParser parser(in, ChunkedParserOptions{.threads = 4, .chunkBytes = 256, .maxChunksAhead = 2});
+        ParsedChunk chunk;
+        ASSERT_TRUE(parser.next(chunk));
+        EXPECT_EQ(chunk.index, 0u);
+        EXPECT_FALSE(chunk.lines.empty());
+    }  // workers blocked on the full window must wake up and exit
+    SUCCEED();
+}
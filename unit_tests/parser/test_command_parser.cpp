@@ -2,6 +2,9 @@
 
 #include "parser/commands_parser.hpp"
 
+#include <cstring>
+#include <string>
+
 // Helpers to check variant type
 template <typename T>
 static bool holds(const ParsedCommand& cmd) {
@@ -127,4 +130,118 @@ TEST(CommandParserTests, MatchCommand_InvalidTimestamp_ReturnsNullopt) {
 
 TEST(CommandParserTests, MatchCommand_EmptySymbol_ReturnsNullopt) {
     EXPECT_FALSE(parseCommandLine("M,00000010,").has_value());  // symbol cannot be empty
-}
\ No newline at end of file
+}
+TEST(CommandParserTests, QueryCommand_AllForms_ParseToQueryRequest) {
+    auto order = parseCommandLine("Q,00000010,O,42");
+    ASSERT_TRUE(order.has_value());
+    ASSERT_TRUE(holds<QueryRequest>(*order));
+    EXPECT_EQ(std::get<QueryRequest>(*order).kind, QueryKind::Order);
+    EXPECT_EQ(std::get<QueryRequest>(*order).orderId, 42);
+
+    auto top = parseCommandLine("Q,00000011,T,XYZ");
+    ASSERT_TRUE(top.has_value());
+    EXPECT_EQ(std::get<QueryRequest>(*top).kind, QueryKind::Top);
+    EXPECT_EQ(std::get<QueryRequest>(*top).symbol, "XYZ");
+
+    auto depth = parseCommandLine("Q,00000012,D,XYZ,5");
+    ASSERT_TRUE(depth.has_value());
+    const auto& req = std::get<QueryRequest>(*depth);
+    EXPECT_EQ(req.kind, QueryKind::Depth);
+    EXPECT_EQ(req.timeStamp, 12);
+    EXPECT_EQ(req.symbol, "XYZ");
+    EXPECT_EQ(req.levels, 5);
+}
+
+TEST(CommandParserTests, QueryCommand_InvalidShape_ReturnsNullopt) {
+    EXPECT_FALSE(parseCommandLine("Q").has_value());
+    EXPECT_FALSE(parseCommandLine("Q,10").has_value());
+    EXPECT_FALSE(parseCommandLine("Q,10,O").has_value());
+    EXPECT_FALSE(parseCommandLine("Q,10,O,abc").has_value());
+    EXPECT_FALSE(parseCommandLine("Q,10,T,XYZ,1").has_value());  // T takes no level count
+    EXPECT_FALSE(parseCommandLine("Q,10,D,XYZ").has_value());    // D needs a level count
+    EXPECT_FALSE(parseCommandLine("Q,10,Z,XYZ").has_value());
+}
+
+TEST(CommandParserTests, MassCancelCommand_AllScopes_ParseToMassCancelRequest) {
+    auto all = parseCommandLine("C,00000010");
+    ASSERT_TRUE(all.has_value());
+    ASSERT_TRUE(holds<MassCancelRequest>(*all));
+    EXPECT_EQ(std::get<MassCancelRequest>(*all).scope, MassCancelScope::All);
+    EXPECT_EQ(std::get<MassCancelRequest>(*all).timeStamp, 10);
+
+    auto symbol = parseCommandLine("C,00000011,XYZ");
+    ASSERT_TRUE(symbol.has_value());
+    EXPECT_EQ(std::get<MassCancelRequest>(*symbol).scope, MassCancelScope::Symbol);
+    EXPECT_EQ(std::get<MassCancelRequest>(*symbol).symbol, "XYZ");
+
+    auto side = parseCommandLine("C,00000012,XYZ,S");
+    ASSERT_TRUE(side.has_value());
+    const auto& req = std::get<MassCancelRequest>(*side);
+    EXPECT_EQ(req.scope, MassCancelScope::SymbolSide);
+    EXPECT_EQ(req.symbol, "XYZ");
+    EXPECT_EQ(req.side, domain::Side::Sell);
+}
+
+TEST(CommandParserTests, MassCancelCommand_InvalidShape_ReturnsNullopt) {
+    EXPECT_FALSE(parseCommandLine("C").has_value());
+    EXPECT_FALSE(parseCommandLine("C,abc").has_value());
+    EXPECT_FALSE(parseCommandLine("C,10,").has_value());         // empty symbol
+    EXPECT_FALSE(parseCommandLine("C,10,XYZ,Q").has_value());    // bad side
+    EXPECT_FALSE(parseCommandLine("C,10,XYZ,B,1").has_value());  // too many fields
+}
+
+TEST(CommandParserTests, BatchNewCommand_ParsesEveryOrder) {
+    auto cmd = parseCommandLine("B,00000010,XYZ,1,L,B,104.53,100,2,M,S,0.00,5");
+    ASSERT_TRUE(cmd.has_value());
+    ASSERT_TRUE(holds<BatchNewRequest>(*cmd));
+
+    const auto& req = std::get<BatchNewRequest>(*cmd);
+    EXPECT_EQ(req.timeStamp, 10);
+    EXPECT_EQ(req.symbol, "XYZ");
+    ASSERT_EQ(req.orders.size(), 2u);
+    EXPECT_EQ(req.orders[0].orderId, 1);
+    EXPECT_EQ(req.orders[0].price, 10453);
+    EXPECT_EQ(req.orders[0].quantity, 100);
+    EXPECT_EQ(req.orders[1].orderType, domain::OrderType::Market);
+    EXPECT_EQ(req.orders[1].side, domain::Side::Sell);
+}
+
+TEST(CommandParserTests, BatchNewCommand_InvalidShape_ReturnsNullopt) {
+    EXPECT_FALSE(parseCommandLine("B,10,XYZ").has_value());                       // no orders
+    EXPECT_FALSE(parseCommandLine("B,10,XYZ,1,L,B,104.53").has_value());          // partial order
+    EXPECT_FALSE(parseCommandLine("B,10,XYZ,1,L,B,104.53,100,2").has_value());    // trailing field
+    EXPECT_FALSE(parseCommandLine("B,10,XYZ,1,L,B,104.53,abc").has_value());      // bad quantity
+    EXPECT_FALSE(parseCommandLine("B,-1,XYZ,1,L,B,104.53,100").has_value());      // bad timestamp
+}
+
+TEST(CommandParserTests, BatchNewCommand_OverMaxOrders_ReturnsNullopt) {
+    std::string line = "B,10,XYZ";
+    for (std::size_t i = 1; i <= kMaxBatchOrders; ++i)
+        line += "," + std::to_string(i) + ",L,B,1.00,1";
+    auto full = parseCommandLine(line);
+    ASSERT_TRUE(full.has_value());
+    EXPECT_EQ(std::get<BatchNewRequest>(*full).orders.size(), kMaxBatchOrders);
+
+    line += ",999,L,B,1.00,1";
+    EXPECT_FALSE(parseCommandLine(line).has_value());
+}
+
+TEST(CommandParserTests, Symbol_IsInline_SoCommandsCopyAsBytes) {
+    auto cmd = parseCommandLine("A,2,3,ABCDEFGHIJKLMNO,L,S,10.00,5");
+    ASSERT_TRUE(cmd.has_value());
+    const auto& amend = std::get<AmendRequest>(*cmd);
+    EXPECT_EQ(amend.symbol.view(), "ABCDEFGHIJKLMNO");
+    EXPECT_FALSE(amend.symbol.tooLong());
+
+    AmendRequest copy;
+    std::memcpy(static_cast<void*>(&copy), &amend, sizeof(AmendRequest));
+    EXPECT_EQ(copy.symbol, "ABCDEFGHIJKLMNO");
+    EXPECT_EQ(copy.newQuantity, 5);
+
+    // one char over capacity still parses; the handler rejects it with the order id
+    cmd = parseCommandLine("N,2,3,ABCDEFGHIJKLMNOP,L,S,10.00,5");
+    ASSERT_TRUE(cmd.has_value());
+    const auto& order = std::get<domain::Order>(*cmd);
+    EXPECT_TRUE(order.symbol.tooLong());
+    EXPECT_NE(order.symbol, "ABCDEFGHIJKLMNO");
+}
@@ -81,4 +81,19 @@ TEST(TokenizeTests, TypicalOrderLine_Produces8Tokens) {
     EXPECT_EQ(tokens[5], "B");
     EXPECT_EQ(tokens[6], "104.53");
     EXPECT_EQ(tokens[7], "100");
-}
\ No newline at end of file
+}
+
+TEST(TokenizeTests, TokenizeInto_ReusesOutputAndViewsTheLine) {
+    const std::string line = " N , 2,XYZ\n";
+    std::vector<std::string_view> tokens{"stale"};
+    tokenizeInto(line, tokens);
+    ASSERT_EQ(tokens.size(), 3u);
+    EXPECT_EQ(tokens[0], "N");
+    EXPECT_EQ(tokens[1], "2");
+    EXPECT_EQ(tokens[2], "XYZ");
+    EXPECT_EQ(tokens[2].data(), line.data() + 7);
+
+    tokenizeInto("A", tokens);
+    ASSERT_EQ(tokens.size(), 1u);
+    EXPECT_EQ(tokens[0], "A");
+}
@@ -0,0 +1,272 @@
+// unit_tests/persistence/test_journal.cpp
+
+#include <gtest/gtest.h>
+
+#include "engine/dispatcher.hpp"
+#include "persistence/command_codec.hpp"
+#include "persistence/journal.hpp"
+#include "persistence/recovery.hpp"
+#include "risk/risk_checker.hpp"
+#include "test_helpers.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+domain::Order makeOrder(domain::OrderId id,
+                        domain::Side side,
+                        domain::Price priceCents,
+                        int qty = 100,
+                        const std::string& symbol = "XYZ") {
+    domain::Order o;
+    o.orderId = id;
+    o.timeStamp = id;
+    o.symbol = symbol;
+    o.orderType = domain::OrderType::Limit;
+    o.side = side;
+    o.price = priceCents;
+    o.quantity = qty;
+    return o;
+}
+
+persistence::JournalOptions fastOptions(const std::string& dir) {
+    persistence::JournalOptions o;
+    o.directory = dir;
+    o.fsyncEnabled = false;  // tests only care about content, not durability
+    return o;
+}
+
+std::vector<std::uint64_t> replaySeqs(const std::string& dir, std::uint64_t afterSeq = 0) {
+    std::vector<std::uint64_t> seqs;
+    persistence::replayJournal(dir, afterSeq, [&](std::uint64_t seq, const ParsedCommand&) {
+        seqs.push_back(seq);
+    });
+    return seqs;
+}
+
+}  // namespace
+
+TEST(CommandCodecTests, RoundTrip_AllCommandKinds) {
+    AmendRequest amend{};
+    amend.orderId = 7;
+    amend.timeStamp = 9;
+    amend.symbol = "ABC";
+    amend.orderType = domain::OrderType::IOC;
+    amend.side = domain::Side::Sell;
+    amend.newQuantity = 40;  // price left as nullopt
+
+    const std::vector<ParsedCommand> cmds = {
+        makeOrder(1, domain::Side::Buy, 10453),
+        amend,
+        CancelRequest{3, 12},
+        MatchRequest{15, std::nullopt},
+        MatchRequest{16, std::string("XYZ")},
+        QueryRequest{17, QueryKind::Depth, 0, "XYZ", 5},
+        MassCancelRequest{18, MassCancelScope::SymbolSide, "XYZ", domain::Side::Sell},
+        BatchNewRequest{19, "XYZ", {BatchOrder{20, domain::OrderType::IOC, domain::Side::Sell, 10500, 3},
+                                    BatchOrder{21, domain::OrderType::Market, domain::Side::Buy, 0, 4}}},
+    };
+
+    for (const auto& cmd : cmds) {
+        std::vector<char> buf;
+        persistence::encodeCommand(cmd, buf);
+        auto decoded = persistence::decodeCommand(buf.data(), buf.size());
+        ASSERT_TRUE(decoded.has_value());
+        ASSERT_EQ(decoded->index(), cmd.index());
+    }
+
+    std::vector<char> buf;
+    persistence::encodeCommand(amend, buf);
+    const auto decoded = std::get<AmendRequest>(*persistence::decodeCommand(buf.data(), buf.size()));
+    EXPECT_EQ(decoded.orderId, 7);
+    EXPECT_EQ(decoded.symbol, "ABC");
+    EXPECT_EQ(decoded.orderType, domain::OrderType::IOC);
+    EXPECT_EQ(decoded.side, domain::Side::Sell);
+    EXPECT_FALSE(decoded.newPrice.has_value());
+    EXPECT_EQ(decoded.newQuantity, 40);
+}
+
+TEST(CommandCodecTests, TruncatedInput_ReturnsNullopt) {
+    std::vector<char> buf;
+    persistence::encodeCommand(makeOrder(1, domain::Side::Buy, 10453), buf);
+    for (std::size_t n = 0; n < buf.size(); ++n) {
+        EXPECT_FALSE(persistence::decodeCommand(buf.data(), n).has_value()) << "prefix " << n;
+    }
+}
+
+TEST(JournalTests, AppendThenReplay_DeliversRecordsInOrder) {
+    const auto dir = makeTempDir("hft_journal_", "append_replay");
+    {
+        persistence::JournalWriter journal(fastOptions(dir));
+        for (int i = 1; i <= 100; ++i) {
+            EXPECT_EQ(journal.append(makeOrder(i, domain::Side::Buy, 10000 + i)), static_cast<std::uint64_t>(i));
+        }
+        journal.flush();
+        EXPECT_EQ(journal.durableSeq(), 100u);
+    }
+
+    std::vector<domain::OrderId> ids;
+    const auto res = persistence::replayJournal(dir, 0, [&](std::uint64_t, const ParsedCommand& cmd) {
+        ids.push_back(std::get<domain::Order>(cmd).orderId);
+    });
+    EXPECT_EQ(res.replayed, 100u);
+    EXPECT_EQ(res.lastSeq, 100u);
+    ASSERT_EQ(ids.size(), 100u);
+    EXPECT_EQ(ids.front(), 1);
+    EXPECT_EQ(ids.back(), 100);
+}
+
+TEST(JournalTests, ReplayAfterSeq_SkipsOlderRecords) {
+    const auto dir = makeTempDir("hft_journal_", "after_seq");
+    {
+        persistence::JournalWriter journal(fastOptions(dir));
+        for (int i = 1; i <= 10; ++i) {
+            journal.append(CancelRequest{i, i});
+        }
+    }
+    const auto seqs = replaySeqs(dir, 7);
+    EXPECT_EQ(seqs, (std::vector<std::uint64_t>{8, 9, 10}));
+}
+
+TEST(JournalTests, SmallSegments_RotateAndReplayAcrossSegments) {
+    const auto dir = makeTempDir("hft_journal_", "rotate");
+    auto opts = fastOptions(dir);
+    opts.segmentBytes = 64;
+    {
+        persistence::JournalWriter journal(opts);
+        for (int i = 1; i <= 50; ++i) {
+            journal.append(makeOrder(i, domain::Side::Sell, 10000));
+            journal.flush();  // one batch per record => many rotations
+        }
+        EXPECT_GT(journal.stats().segments, 1u);
+    }
+    EXPECT_EQ(replaySeqs(dir).size(), 50u);
+    EXPECT_EQ(replaySeqs(dir, 30).size(), 20u);
+}
+
+TEST(JournalTests, TornTail_IsIgnored_AndNextWriterContinues) {
+    const auto dir = makeTempDir("hft_journal_", "torn");
+    {
+        persistence::JournalWriter journal(fastOptions(dir));
+        for (int i = 1; i <= 5; ++i) {
+            journal.append(makeOrder(i, domain::Side::Buy, 10000));
+        }
+    }
+    // simulate a crash in the middle of a write
+    const auto segment = std::filesystem::directory_iterator(dir)->path();
+    const auto size = std::filesystem::file_size(segment);
+    std::filesystem::resize_file(segment, size - 3);
+
+    auto res = persistence::replayJournal(dir, 0, [](std::uint64_t, const ParsedCommand&) {});
+    EXPECT_EQ(res.lastSeq, 4u);
+    EXPECT_EQ(res.tornTails, 1u);
+
+    {
+        persistence::JournalWriter journal(fastOptions(dir), res.lastSeq + 1);
+        EXPECT_EQ(journal.append(makeOrder(50, domain::Side::Buy, 10000)), 5u);
+    }
+    EXPECT_EQ(replaySeqs(dir), (std::vector<std::uint64_t>{1, 2, 3, 4, 5}));
+}
+
+TEST(JournalTests, Dispatcher_JournalsOnlyCommandsThatChangeTheBook) {
+    const auto dir = makeTempDir("hft_journal_", "dispatcher");
+    {
+        OrderBook book;
+        CommandDispatcher dispatcher(book);
+        persistence::JournalWriter journal(fastOptions(dir));
+        dispatcher.attachJournal(&journal);
+
+        dispatcher.dispatch(makeOrder(1, domain::Side::Buy, 10000));       // accept
+        dispatcher.dispatch(makeOrder(1, domain::Side::Buy, 10000));       // duplicate -> reject
+        dispatcher.dispatch(CancelRequest{99, 1});                         // 404
+        dispatcher.dispatchMatch(MatchRequest{2, std::nullopt});           // no fills
+        dispatcher.dispatch(makeOrder(2, domain::Side::Sell, 10000, 40));  // accept
+        dispatcher.dispatchMatch(MatchRequest{3, std::nullopt});           // fills
+
+        std::ostringstream acks;
+        dispatcher.dispatchMassCancel(MassCancelRequest{4, MassCancelScope::Symbol, "ABC"}, acks);  // nothing
+        dispatcher.dispatchMassCancel(MassCancelRequest{5, MassCancelScope::All}, acks);            // drops 1
+
+        EXPECT_EQ(journal.lastSeq(), 4u);
+    }
+    EXPECT_EQ(replaySeqs(dir).size(), 4u);
+}
+
+TEST(RecoveryTests, RecoverFromJournal_RebuildsSameBook) {
+    const auto dir = makeTempDir("hft_journal_", "recovery");
+    OrderBook live;
+    {
+        CommandDispatcher dispatcher(live);
+        persistence::JournalWriter journal(fastOptions(dir));
+        dispatcher.attachJournal(&journal);
+
+        dispatcher.dispatch(makeOrder(1, domain::Side::Buy, 10000, 100));
+        dispatcher.dispatch(makeOrder(2, domain::Side::Buy, 10100, 50));
+        dispatcher.dispatch(makeOrder(3, domain::Side::Sell, 10050, 70));
+        dispatcher.dispatchMatch(MatchRequest{4, std::nullopt});  // 2 fully filled, 3 partially
+        dispatcher.dispatch(CancelRequest{1, 5});
+
+        AmendRequest amend{};
+        amend.orderId = 3;
+        amend.timeStamp = 6;
+        amend.symbol = "XYZ";
+        amend.orderType = domain::OrderType::Limit;
+        amend.side = domain::Side::Sell;
+        amend.newPrice = 10200;
+        dispatcher.dispatch(amend);
+
+        dispatcher.dispatch(makeOrder(4, domain::Side::Buy, 9900, 10, "ABC"));
+        dispatcher.dispatch(makeOrder(5, domain::Side::Buy, 9800, 10, "ABC"));
+        std::ostringstream acks;
+        dispatcher.dispatchMassCancel(MassCancelRequest{9, MassCancelScope::SymbolSide, "ABC", domain::Side::Buy},
+                                      acks);
+    }
+
+    OrderBook recovered;
+    const auto res = persistence::recoverFromJournal(recovered, dir);
+    EXPECT_EQ(res.lastSeq, 9u);
+
+    std::ostringstream expected;
+    std::ostringstream actual;
+    live.dump(expected);
+    recovered.dump(actual);
+    EXPECT_EQ(actual.str(), expected.str());
+    EXPECT_EQ(recovered.liveCount(), 1u);
+    ASSERT_NE(recovered.getById(3), nullptr);
+    EXPECT_EQ(recovered.getById(3)->quantity, 20);
+    EXPECT_EQ(recovered.getById(3)->price, 10200);
+}
+
+TEST(RecoveryTests, PartlyRiskRejectedBatch_RecoversOnlyAcceptedOrders) {
+    const auto dir = makeTempDir("hft_journal_", "risk_batch");
+    OrderBook live;
+    {
+        std::istringstream limits("XYZ,100.00,500,1000,0.00,1500\n");
+        std::string error;
+        auto config = risk::parseRiskConfig(limits, error);
+        ASSERT_TRUE(config.has_value()) << error;
+        risk::RiskChecker checker(std::move(*config));
+
+        CommandDispatcher dispatcher(live);
+        persistence::JournalWriter journal(fastOptions(dir));
+        dispatcher.attachJournal(&journal);
+        dispatcher.attachRisk(&checker);
+
+        std::ostringstream out;
+        const auto batch = parseCommandLine("B,1,XYZ,1,L,B,100.00,900,2,L,B,120.00,1,3,L,B,100.00,700,4,L,S,101.00,500");
+        ASSERT_TRUE(batch.has_value());
+        EXPECT_EQ(dispatcher.dispatchBatch(*batch, out), 2u);  // 2 out of band, 3 over the open limit
+    }
+
+    OrderBook recovered;
+    persistence::recoverFromJournal(recovered, dir);
+    EXPECT_TRUE(recovered.isLive(1));
+    EXPECT_FALSE(recovered.isLive(2));
+    EXPECT_FALSE(recovered.isLive(3));
+    EXPECT_TRUE(recovered.isLive(4));
+    EXPECT_EQ(recovered.liveCount(), live.liveCount());
+}
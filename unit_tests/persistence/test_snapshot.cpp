@@ -0,0 +1,162 @@
+// unit_tests/persistence/test_snapshot.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "persistence/journal.hpp"
+#include "persistence/recovery.hpp"
+#include "persistence/snapshot.hpp"
+#include "test_helpers.hpp"
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+domain::Order makeOrder(domain::OrderId id,
+                        domain::Side side,
+                        domain::Price priceCents,
+                        int qty = 100,
+                        const std::string& symbol = "XYZ",
+                        domain::OrderType type = domain::OrderType::Limit) {
+    domain::Order o;
+    o.orderId = id;
+    o.timeStamp = 1000 + id;
+    o.symbol = symbol;
+    o.orderType = type;
+    o.side = side;
+    o.price = priceCents;
+    o.quantity = qty;
+    return o;
+}
+
+std::string dumpOf(const OrderBook& book) {
+    std::ostringstream oss;
+    book.dump(oss);
+    return oss.str();
+}
+
+void fillBook(OrderBook& book) {
+    book.add(makeOrder(1, domain::Side::Buy, 10000, 10, "XYZ"));
+    book.add(makeOrder(2, domain::Side::Buy, 10000, 20, "ABC"));
+    book.add(makeOrder(3, domain::Side::Buy, 10100, 30, "XYZ", domain::OrderType::IOC));
+    book.add(makeOrder(4, domain::Side::Sell, 10200, 40, "ABC"));
+    book.add(makeOrder(5, domain::Side::Sell, 10200, 50, "XYZ"));
+    book.add(makeOrder(6, domain::Side::Sell, 10300, 60, "QQQ"));
+}
+
+}  // namespace
+
+TEST(OrderBookSnapshotTests, RoundTrip_PreservesLevelsFifoAndLiveIds) {
+    OrderBook book;
+    fillBook(book);
+
+    std::stringstream ss;
+    ASSERT_TRUE(book.writeSnapshot(ss, 42));
+
+    OrderBook restored;
+    restored.add(makeOrder(99, domain::Side::Buy, 1, 1));  // must be replaced, not merged
+    const auto seq = restored.loadSnapshot(ss);
+    ASSERT_TRUE(seq.has_value());
+    EXPECT_EQ(*seq, 42u);
+
+    EXPECT_EQ(dumpOf(restored), dumpOf(book));
+    EXPECT_EQ(restored.liveCount(), 6u);
+    EXPECT_FALSE(restored.isLive(99));
+    EXPECT_TRUE(restored.isLive(3));
+
+    // FIFO order at 100.00 is kept: id 1 before id 2
+    ASSERT_NE(restored.getById(2), nullptr);
+    restored.consumeBestBid(30);  // removes id 3 (best level)
+    EXPECT_EQ(restored.bestBidOrder()->orderId, 1);
+}
+
+TEST(OrderBookSnapshotTests, EmptyBook_RoundTrips) {
+    OrderBook book;
+    std::stringstream ss;
+    ASSERT_TRUE(book.writeSnapshot(ss, 0));
+
+    OrderBook restored;
+    ASSERT_TRUE(restored.loadSnapshot(ss).has_value());
+    EXPECT_EQ(restored.liveCount(), 0u);
+    EXPECT_FALSE(restored.hasBuy());
+    EXPECT_FALSE(restored.hasSell());
+}
+
+TEST(OrderBookSnapshotTests, CorruptedData_IsRejected_AndBookLeftEmpty) {
+    OrderBook book;
+    fillBook(book);
+    std::stringstream ss;
+    ASSERT_TRUE(book.writeSnapshot(ss, 7));
+
+    std::string bytes = ss.str();
+    bytes[bytes.size() / 2] ^= 0x5A;
+    std::stringstream corrupted(bytes);
+
+    OrderBook restored;
+    EXPECT_FALSE(restored.loadSnapshot(corrupted).has_value());
+    EXPECT_EQ(restored.liveCount(), 0u);
+
+    std::stringstream truncated(ss.str().substr(0, 20));
+    EXPECT_FALSE(restored.loadSnapshot(truncated).has_value());
+}
+
+TEST(SnapshotFileTests, LoadLatest_PicksNewestValidSnapshot) {
+    const auto dir = makeTempDir("hft_snapshot_", "latest");
+
+    OrderBook book;
+    book.add(makeOrder(1, domain::Side::Buy, 10000));
+    ASSERT_TRUE(persistence::saveSnapshot(book, dir, 5));
+    book.add(makeOrder(2, domain::Side::Sell, 10100));
+    ASSERT_TRUE(persistence::saveSnapshot(book, dir, 9));
+
+    OrderBook restored;
+    auto seq = persistence::loadLatestSnapshot(restored, dir);
+    ASSERT_TRUE(seq.has_value());
+    EXPECT_EQ(*seq, 9u);
+    EXPECT_EQ(restored.liveCount(), 2u);
+
+    EXPECT_EQ(persistence::pruneSnapshots(dir, 1), 1u);
+    EXPECT_EQ(*persistence::loadLatestSnapshot(restored, dir), 9u);
+}
+
+TEST(RecoveryTests, SnapshotPlusJournalTail_EqualsFullReplay) {
+    const auto snapDir = makeTempDir("hft_snapshot_", "recover_snap");
+    const auto journalDir = makeTempDir("hft_snapshot_", "recover_journal");
+
+    persistence::JournalOptions opts;
+    opts.directory = journalDir;
+    opts.fsyncEnabled = false;
+
+    OrderBook live;
+    {
+        CommandDispatcher dispatcher(live);
+        persistence::JournalWriter journal(opts);
+        dispatcher.attachJournal(&journal);
+
+        dispatcher.dispatch(makeOrder(1, domain::Side::Buy, 10000, 100));
+        dispatcher.dispatch(makeOrder(2, domain::Side::Sell, 10100, 50));
+        journal.flush();
+        ASSERT_TRUE(persistence::saveSnapshot(live, snapDir, journal.lastSeq()));
+
+        // tail after the snapshot
+        dispatcher.dispatch(makeOrder(3, domain::Side::Sell, 9900, 30));
+        dispatcher.dispatchMatch(MatchRequest{10, std::nullopt});
+        dispatcher.dispatch(CancelRequest{2, 11});
+    }
+
+    OrderBook recovered;
+    const auto res = persistence::recoverBook(recovered, snapDir, journalDir);
+    ASSERT_TRUE(res.snapshotSeq.has_value());
+    EXPECT_EQ(*res.snapshotSeq, 2u);
+    EXPECT_EQ(res.journal.replayed, 3u);
+    EXPECT_EQ(res.lastSeq(), 5u);
+    EXPECT_EQ(dumpOf(recovered), dumpOf(live));
+
+    // segments fully covered by the snapshot can go; the result must not change
+    persistence::pruneJournal(journalDir, *res.snapshotSeq);
+    OrderBook again;
+    persistence::recoverBook(again, snapDir, journalDir);
+    EXPECT_EQ(dumpOf(again), dumpOf(live));
+}
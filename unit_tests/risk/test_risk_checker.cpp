@@ -0,0 +1,134 @@
+// unit_tests/risk/test_risk_checker.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "parser/commands_parser.hpp"
+#include "risk/risk_checker.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+risk::RiskConfig configOf(const std::string& text) {
+    std::istringstream is(text);
+    std::string error;
+    auto config = risk::parseRiskConfig(is, error);
+    EXPECT_TRUE(config.has_value()) << error;
+    return config.value_or(risk::RiskConfig{});
+}
+
+// XYZ: collar 5% around 100.00, max 1000 per order, max 100000.00 notional, 1500 open
+const char* kLimits =
+    "# symbol,reference,band_bps,max_qty,max_notional,max_open\n"
+    "*,0.00,0,0,0.00,0\n"
+    "XYZ,100.00,500,1000,100000.00,1500\n";
+
+class RiskDispatchTests : public ::testing::Test {
+protected:
+    void SetUp() override { dispatcher.attachRisk(&checker); }
+
+    std::string run(const std::string& line) {
+        const auto cmd = parseCommandLine(line);
+        EXPECT_TRUE(cmd.has_value()) << line;
+        std::ostringstream out;
+        dispatcher.dispatchTo(*cmd, out);
+        return out.str();
+    }
+
+    OrderBook book;
+    CommandDispatcher<> dispatcher{book};
+    risk::RiskChecker checker{configOf(kLimits)};
+};
+
+}  // namespace
+
+TEST(RiskConfigTests, Parse_DefaultsAndSymbols_RejectsMalformedLines) {
+    const auto config = configOf(kLimits);
+    EXPECT_EQ(config.limitsFor("XYZ").referencePrice, 10000);
+    EXPECT_EQ(config.limitsFor("XYZ").bandBps, 500);
+    EXPECT_EQ(config.limitsFor("XYZ").maxNotional, 10000000);
+    EXPECT_EQ(config.limitsFor("ABC").maxOrderQuantity, 0);
+
+    std::string error;
+    std::istringstream bad("*,0.00,0,0,0.00,0\nXYZ,100,500,1000,50000.00,1500\n");
+    EXPECT_FALSE(risk::parseRiskConfig(bad, error).has_value());
+    EXPECT_NE(error.find("line 2"), std::string::npos);
+    std::istringstream negative("XYZ,100.00,-1,0,0.00,0\n");
+    EXPECT_FALSE(risk::parseRiskConfig(negative, error).has_value());
+}
+
+TEST_F(RiskDispatchTests, EachLimit_RejectsWith305AndItsReason) {
+    EXPECT_EQ(run("N,1,1,XYZ,L,B,100.00,1001"), "1 - Reject - 305 - Quantity above limit\n");
+    EXPECT_EQ(run("N,2,2,XYZ,L,B,106.00,10"), "2 - Reject - 305 - Price outside band\n");
+    EXPECT_EQ(run("N,3,3,XYZ,L,B,94.00,10"), "3 - Reject - 305 - Price outside band\n");
+    EXPECT_EQ(run("N,4,4,XYZ,L,B,104.00,1000"), "4 - Reject - 305 - Notional above limit\n");
+    EXPECT_EQ(run("N,5,5,XYZ,L,B,100.00,400"), "5 - Accept\n");
+    EXPECT_EQ(run("N,6,6,ABC,L,B,1.00,100000"), "6 - Accept\n");  // defaults: no limits
+    EXPECT_EQ(checker.rejects(), 4u);
+    EXPECT_EQ(book.liveCount(), 2u);
+}
+
+TEST_F(RiskDispatchTests, OpenQuantity_FollowsCancelsFillsAmendsAndMassCancel) {
+    EXPECT_EQ(run("N,1,1,XYZ,L,B,100.00,800"), "1 - Accept\n");
+    EXPECT_EQ(run("N,2,2,XYZ,L,S,101.00,700"), "2 - Accept\n");
+    EXPECT_EQ(run("N,3,3,XYZ,L,S,101.00,1"), "3 - Reject - 305 - Open quantity above limit\n");
+    EXPECT_EQ(checker.openQuantity("XYZ"), 1500);
+
+    EXPECT_EQ(run("X,2,4"), "2 - CancelAccept\n");
+    EXPECT_EQ(checker.openQuantity("XYZ"), 800);
+    EXPECT_EQ(run("N,3,5,XYZ,L,S,100.00,300"), "3 - Accept\n");
+    run("M,6,XYZ");  // 300 filled on both sides
+    EXPECT_EQ(checker.openQuantity("XYZ"), 500);
+
+    EXPECT_EQ(run("A,1,7,XYZ,L,B,100.00,1600"), "1 - AmendReject - 305 - Quantity above limit\n");
+    EXPECT_EQ(run("A,1,8,XYZ,L,B,100.00,900"), "1 - AmendAccept\n");
+    EXPECT_EQ(checker.openQuantity("XYZ"), 900);
+    EXPECT_EQ(run("C,9,XYZ"), "1 - CancelAccept\nXYZ - MassCancelAccept - 1\n");
+    EXPECT_EQ(checker.openQuantity("XYZ"), 0);
+}
+
+TEST_F(RiskDispatchTests, Collar_MovesWithLastTrade) {
+    run("N,1,1,XYZ,L,B,104.00,10");
+    run("N,2,2,XYZ,L,S,104.00,10");
+    run("M,3,XYZ");  // last trade 104.00 => band 98.80 .. 109.20
+    EXPECT_EQ(run("N,3,4,XYZ,L,B,109.00,1"), "3 - Accept\n");
+    EXPECT_EQ(run("N,4,5,XYZ,L,B,98.00,1"), "4 - Reject - 305 - Price outside band\n");
+    EXPECT_EQ(run("A,3,6,XYZ,L,B,110.00,1"), "3 - AmendReject - 305 - Price outside band\n");
+}
+
+TEST_F(RiskDispatchTests, Batch_ChecksEachOrderAgainstTheOnesBefore) {
+    EXPECT_EQ(run("B,1,XYZ,1,L,B,100.00,900,2,L,B,120.00,1,3,L,B,100.00,700,4,L,S,101.00,500,1,L,S,101.00,1"),
+              "1 - Accept\n"
+              "2 - Reject - 305 - Price outside band\n"
+              "3 - Reject - 305 - Open quantity above limit\n"
+              "4 - Accept\n"
+              "1 - Reject - 303 - Invalid order details\n");
+    EXPECT_EQ(checker.openQuantity("XYZ"), 1400);  // the duplicate id is not counted
+}
+
+TEST_F(RiskDispatchTests, Batch_DuplicateIds_DoNotCountTowardsLaterOrders) {
+    EXPECT_EQ(run("N,5,1,XYZ,L,S,101.00,100"), "5 - Accept\n");
+    // both duplicates (of an earlier order in the batch, of a live one) would have pushed 3 over 1500
+    EXPECT_EQ(run("B,2,XYZ,1,L,B,100.00,900,1,L,B,100.00,500,5,L,B,100.00,400,3,L,B,100.00,500"),
+              "1 - Accept\n"
+              "1 - Reject - 303 - Invalid order details\n"
+              "5 - Reject - 303 - Invalid order details\n"
+              "3 - Accept\n");
+    EXPECT_EQ(checker.openQuantity("XYZ"), 1500);
+}
+
+TEST_F(RiskDispatchTests, Reload_SwapsLimitsKeepsOpenQuantity) {
+    run("N,1,1,XYZ,L,B,100.00,1000");
+    checker.reload(configOf("XYZ,100.00,500,5000,0.00,0\n"));
+    EXPECT_EQ(checker.limits("XYZ")->maxOrderQuantity, 5000);
+    EXPECT_EQ(run("N,2,2,XYZ,L,B,100.00,2000"), "2 - Accept\n");
+    EXPECT_EQ(checker.openQuantity("XYZ"), 3000);
+
+    risk::RiskChecker rebuilt;
+    rebuilt.rebuildOpen(book);
+    EXPECT_EQ(rebuilt.openQuantity("XYZ"), 3000);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// Shared helpers for the unit tests.
+
+#include <filesystem>
+#include <string>
+
+// Fresh, empty directory per test: <temp>/<prefix><name>.
+inline std::string makeTempDir(const std::string& prefix, const std::string& name) {
+    const auto dir = std::filesystem::temp_directory_path() / (prefix + name);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir.string();
+}
@@ -0,0 +1,148 @@
+// unit_tests/workload/test_order_flow.cpp
+
+#include <gtest/gtest.h>
+
+#include "book/order_book.hpp"
+#include "engine/dispatcher.hpp"
+#include "parser/commands_parser.hpp"
+#include "workload/order_flow.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> generate(const workload::OrderFlowConfig& cfg, std::size_t count) {
+    workload::OrderFlowGenerator gen(cfg);
+    std::vector<std::string> lines;
+    std::string line;
+    for (std::size_t i = 0; i < count; ++i) {
+        line.clear();
+        gen.appendLine(line);
+        EXPECT_EQ(line.back(), '\n');
+        line.pop_back();
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+}  // namespace
+
+TEST(OrderFlowTests, SymbolName_IsAlphabeticAndUnique) {
+    EXPECT_EQ(workload::symbolName(0), "AAA");
+    EXPECT_EQ(workload::symbolName(1), "AAB");
+    EXPECT_EQ(workload::symbolName(26), "ABA");
+    EXPECT_EQ(workload::symbolName(26 * 26 * 26), "BAAA");
+}
+
+TEST(OrderFlowTests, SameSeed_ProducesIdenticalStream) {
+    workload::OrderFlowConfig cfg;
+    cfg.seed = 7;
+    EXPECT_EQ(generate(cfg, 5000), generate(cfg, 5000));
+
+    auto other = cfg;
+    other.seed = 8;
+    EXPECT_NE(generate(cfg, 5000), generate(other, 5000));
+}
+
+TEST(OrderFlowTests, EveryLine_ParsesAndMostCommandsAreAccepted) {
+    workload::OrderFlowConfig cfg;
+    cfg.symbols = 20;
+    const auto lines = generate(cfg, 20000);
+
+    OrderBook book;
+    CommandDispatcher dispatcher(book);
+    std::size_t rejects = 0;
+    for (const auto& line : lines) {
+        const auto parsed = parseCommandLine(line);
+        ASSERT_TRUE(parsed.has_value()) << line;
+        if (std::holds_alternative<MatchRequest>(*parsed)) {
+            dispatcher.dispatchMatch(*parsed);
+        } else if (dispatcher.dispatch(*parsed).find("Reject") != std::string::npos) {
+            ++rejects;
+        }
+    }
+    // only amends / cancels of already traded orders are expected to bounce
+    EXPECT_LT(rejects, lines.size() / 5);
+    EXPECT_GT(book.liveCount(), 0u);
+}
+
+TEST(OrderFlowTests, Mix_FollowsConfiguredRatios) {
+    workload::OrderFlowConfig cfg;
+    cfg.newPct = 50;
+    cfg.amendPct = 20;
+    cfg.cancelPct = 20;
+    cfg.depthTarget = 1'000'000;  // never throttled
+    workload::OrderFlowGenerator gen(cfg);
+    std::string sink;
+    for (int i = 0; i < 100'000; ++i) {
+        gen.appendLine(sink);
+        sink.clear();
+    }
+
+    const auto& st = gen.stats();
+    EXPECT_EQ(st.lines, 100'000u);
+    EXPECT_EQ(st.news + st.amends + st.cancels + st.matches, st.lines);
+    EXPECT_NEAR(static_cast<double>(st.matches) / st.lines, 0.10, 0.01);
+    EXPECT_NEAR(static_cast<double>(st.amends) / st.lines, 0.20, 0.01);
+    EXPECT_NEAR(static_cast<double>(st.cancels) / st.lines, 0.20, 0.01);
+}
+
+TEST(OrderFlowTests, DepthTarget_BoundsRestingOrdersPerSymbol) {
+    workload::OrderFlowConfig cfg;
+    cfg.symbols = 4;
+    cfg.newPct = 90;
+    cfg.amendPct = 5;
+    cfg.cancelPct = 5;
+    cfg.depthTarget = 50;
+    const auto lines = generate(cfg, 50'000);
+
+    std::map<std::string, int> resting;
+    std::map<int, std::string> symbolOf;
+    for (const auto& line : lines) {
+        const auto parsed = parseCommandLine(line);
+        ASSERT_TRUE(parsed.has_value());
+        if (const auto* o = std::get_if<domain::Order>(&*parsed)) {
+            symbolOf[o->orderId] = o->symbol.str();
+            EXPECT_LE(++resting[o->symbol.str()], 50) << line;
+        } else if (const auto* x = std::get_if<CancelRequest>(&*parsed)) {
+            --resting[symbolOf.at(x->orderId)];
+        }
+    }
+}
+
+TEST(OrderFlowTests, ZipfSkew_FavoursLowRankSymbols) {
+    workload::OrderFlowConfig cfg;
+    cfg.symbols = 50;
+    cfg.zipfSkew = 1.2;
+    cfg.newPct = 100;
+    cfg.amendPct = 0;
+    cfg.cancelPct = 0;
+    cfg.depthTarget = 1'000'000;
+
+    std::map<std::string, int> hits;
+    for (const auto& line : generate(cfg, 20'000)) {
+        const auto parsed = parseCommandLine(line);
+        ASSERT_TRUE(parsed.has_value());
+        ++hits[std::get<domain::Order>(*parsed).symbol.str()];
+    }
+    EXPECT_GT(hits["AAA"], hits["AAB"]);
+    EXPECT_GT(hits["AAB"], 4 * hits[workload::symbolName(49)]);
+}
+
+TEST(OrderFlowTests, Write_StreamsExactLineCount) {
+    workload::OrderFlowConfig cfg;
+    workload::OrderFlowGenerator gen(cfg);
+    std::FILE* f = std::tmpfile();
+    ASSERT_NE(f, nullptr);
+    ASSERT_TRUE(gen.write(f, 100'000));
+
+    std::rewind(f);
+    std::size_t newlines = 0;
+    for (int c = std::fgetc(f); c != EOF; c = std::fgetc(f)) {
+        newlines += (c == '\n');
+    }
+    std::fclose(f);
+    EXPECT_EQ(newlines, 100'000u);
+}